@@ -140,10 +140,10 @@ namespace JSC {
             if (!result)
                 return 0;
 
-            if (Q_UNLIKELY(!ExecutableAllocator::makeWritable(result->memoryStart(), result->memorySize())))
+            if (Q_UNLIKELY(!ExecutableAllocator::makeWritable(result.get())))
                 return 0;
 
-            memcpy(result->codeStart(), m_buffer, m_index);
+            memcpy(result->writableCodeStart(), m_buffer, m_index);
             
             return result.release();
         }
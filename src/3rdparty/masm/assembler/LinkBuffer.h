@@ -172,6 +172,13 @@ public:
         return CodeLocationLabel(MacroAssembler::getLinkerAddress(code(), applyOffset(label.m_label)));
     }
 
+    // The address the code at the label is executed at. This differs from locationOf(label) if
+    // the executable memory is mapped a second time for writing.
+    CodeLocationLabel executableLocationOf(Label label)
+    {
+        return CodeLocationLabel(MacroAssembler::getLinkerAddress(m_executableMemory->codeStart(), applyOffset(label.m_label)));
+    }
+
     CodeLocationDataLabelPtr locationOf(DataLabelPtr label)
     {
         return CodeLocationDataLabelPtr(MacroAssembler::getLinkerAddress(code(), applyOffset(label.m_label)));
@@ -333,7 +340,7 @@ inline void LinkBufferBase<MacroAssembler, ExecutableOffsetCalculator>::linkCode
     m_executableMemory = m_assembler->m_assembler.executableCopy(*m_globalData, ownerUID, effort);
     if (!m_executableMemory)
         return;
-    m_code = m_executableMemory->codeStart();
+    m_code = m_executableMemory->writableCodeStart();
     m_size = m_assembler->m_assembler.codeSize();
     ASSERT(m_code);
 }
@@ -355,6 +362,11 @@ void LinkBufferBase<MacroAssembler, ExecutableOffsetCalculator>::performFinaliza
 template <typename MacroAssembler, template <typename T> class ExecutableOffsetCalculator>
 inline bool LinkBufferBase<MacroAssembler, ExecutableOffsetCalculator>::makeExecutable()
 {
+    if (m_executableMemory->isDualMapped()) {
+        // The code was flushed at the address it was written to. Also flush it where it runs.
+        MacroAssembler::cacheFlush(m_executableMemory->codeStart(), m_size);
+        return true;
+    }
     return ExecutableAllocator::makeExecutable(m_executableMemory->memoryStart(),
                                                m_executableMemory->memorySize());
 }
@@ -430,6 +442,10 @@ void BranchCompactingLinkBuffer<MacroAssembler>::performFinalization()
 template <typename MacroAssembler>
 inline bool BranchCompactingLinkBuffer<MacroAssembler>::makeExecutable()
 {
+    if (m_executableMemory->isDualMapped()) {
+        MacroAssembler::cacheFlush(m_executableMemory->codeStart(), m_size);
+        return true;
+    }
     return ExecutableAllocator::makeExecutable(code(), m_initialSize);
 }
 
@@ -443,11 +459,11 @@ inline void BranchCompactingLinkBuffer<MacroAssembler>::linkCode(void* ownerUID,
     m_executableMemory = m_globalData->executableAllocator.allocate(*m_globalData, m_initialSize, ownerUID, effort);
     if (!m_executableMemory)
         return;
-    if (Q_UNLIKELY(!ExecutableAllocator::makeWritable(m_executableMemory->memoryStart(), m_executableMemory->memorySize()))) {
+    if (Q_UNLIKELY(!ExecutableAllocator::makeWritable(m_executableMemory.get()))) {
         m_executableMemory = {};
         return;
     }
-    m_code = (uint8_t*)m_executableMemory->codeStart();
+    m_code = (uint8_t*)m_executableMemory->writableCodeStart();
     ASSERT(m_code);
     uint8_t* inData = (uint8_t*)m_assembler->unlinkedCode();
     uint8_t* outData = reinterpret_cast<uint8_t*>(m_code);
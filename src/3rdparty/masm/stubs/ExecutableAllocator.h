@@ -91,6 +91,10 @@ struct ExecutableMemoryHandle : public RefCounted<ExecutableMemoryHandle> {
     void *codeStart() { return m_allocation->codeStart(); }
     size_t codeSize() { return m_size; }
 
+    void *writableMemoryStart() { return m_allocation->writableMemoryStart(); }
+    void *writableCodeStart() { return m_allocation->writableCodeStart(); }
+    bool isDualMapped() const { return m_allocation->isDualMapped(); }
+
     QV4::ExecutableAllocator::ChunkOfPages *chunk() const
     { return m_allocator->chunkForAllocation(m_allocation); }
 
@@ -184,6 +188,20 @@ struct ExecutableAllocator {
         return true;
     }
 
+    // Memory mapped twice is always writable through its second mapping and always
+    // executable through its first one.
+    static bool makeWritable(ExecutableMemoryHandle *memory)
+    {
+        return memory->isDualMapped()
+                || makeWritable(memory->memoryStart(), memory->memorySize());
+    }
+
+    static bool makeExecutable(ExecutableMemoryHandle *memory)
+    {
+        return memory->isDualMapped()
+                || makeExecutable(memory->memoryStart(), memory->memorySize());
+    }
+
     QV4::ExecutableAllocator *realAllocator;
 };
 
@@ -9,8 +9,11 @@
 #include <private/qv4qobjectwrapper_p.h>
 #include <private/qqmldebugservice_p.h>
 #include <private/qv4jscall_p.h>
+#include <private/qv4heapsnapshot_p.h>
 
 #include <QtQml/qqmlengine.h>
+#include <QtCore/qbuffer.h>
+#include <QtCore/qfile.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -241,6 +244,33 @@ const QStringList &GatherSourcesJob::result() const
     return sources;
 }
 
+HeapSnapshotJob::HeapSnapshotJob(QV4::ExecutionEngine *engine, const QString &fileName)
+    : engine(engine), fileName(fileName), success(false)
+{}
+
+void HeapSnapshotJob::run()
+{
+    if (fileName.isEmpty()) {
+        QBuffer buffer(&snapshot);
+        buffer.open(QIODevice::WriteOnly);
+        success = QV4::HeapSnapshot::write(engine, &buffer);
+    } else {
+        QFile file(fileName);
+        success = file.open(QIODevice::WriteOnly | QIODevice::Truncate)
+                && QV4::HeapSnapshot::write(engine, &file);
+    }
+}
+
+bool HeapSnapshotJob::wasSuccessful() const
+{
+    return success;
+}
+
+const QByteArray &HeapSnapshotJob::result() const
+{
+    return snapshot;
+}
+
 EvalJob::EvalJob(QV4::ExecutionEngine *engine, const QString &script) :
     JavaScriptJob(engine, /*frameNr*/-1, /*context*/ -1, script), result(false)
 {}
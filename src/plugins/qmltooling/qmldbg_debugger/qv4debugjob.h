@@ -116,6 +116,21 @@ public:
     const QStringList &result() const;
 };
 
+class HeapSnapshotJob: public QV4DebugJob
+{
+    QV4::ExecutionEngine *engine;
+    QString fileName;
+    QByteArray snapshot;
+    bool success;
+
+public:
+    // Writes the snapshot to fileName, or keeps it in memory if fileName is empty.
+    HeapSnapshotJob(QV4::ExecutionEngine *engine, const QString &fileName);
+    void run() override;
+    bool wasSuccessful() const;
+    const QByteArray &result() const;
+};
+
 class EvalJob: public JavaScriptJob
 {
     bool result;
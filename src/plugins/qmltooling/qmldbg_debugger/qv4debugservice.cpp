@@ -637,6 +637,53 @@ public:
         }
     }
 };
+
+// Writes a heap snapshot of the engine in the .heapsnapshot format of the Chrome DevTools.
+// If a "file" argument is given, the snapshot is written to that file on the device the
+// application runs on. Otherwise, the snapshot is sent back as the body of the response.
+class V4HeapSnapshotRequest: public V4CommandHandler
+{
+public:
+    V4HeapSnapshotRequest(): V4CommandHandler(QStringLiteral("heapsnapshot")) {}
+
+    void handleRequest() override
+    {
+        QJsonObject arguments = req.value(QLatin1String("arguments")).toObject();
+        const QString fileName = arguments.value(QLatin1String("file")).toString();
+
+        QV4Debugger *debugger = debugService->debuggerAgent.pausedDebugger();
+        if (!debugger) {
+            const QList<QV4Debugger *> &debuggers = debugService->debuggerAgent.debuggers();
+            if (debuggers.size() > 1) {
+                createErrorResponse(QStringLiteral("Cannot write a heap snapshot if multiple debuggers are running and none is paused"));
+                return;
+            } else if (debuggers.size() == 0) {
+                createErrorResponse(QStringLiteral("No debuggers available to write a heap snapshot"));
+                return;
+            }
+            debugger = debuggers.first();
+        }
+
+        HeapSnapshotJob job(debugger->engine(), fileName);
+        debugger->runInEngine(&job);
+        if (!job.wasSuccessful()) {
+            createErrorResponse(QStringLiteral("Failed to write the heap snapshot"));
+            return;
+        }
+
+        QJsonObject body;
+        if (fileName.isEmpty())
+            body = QJsonDocument::fromJson(job.result()).object();
+        else
+            body[QLatin1String("file")] = fileName;
+
+        addCommand();
+        addRequestSequence();
+        addSuccess(true);
+        addRunning();
+        addBody(body);
+    }
+};
 } // anonymous namespace
 
 void QV4DebugServiceImpl::addHandler(V4CommandHandler* handler)
@@ -671,6 +718,7 @@ QV4DebugServiceImpl::QV4DebugServiceImpl(QObject *parent) :
     addHandler(new V4SetExceptionBreakRequest);
     addHandler(new V4ScriptsRequest);
     addHandler(new V4EvaluateRequest);
+    addHandler(new V4HeapSnapshotRequest);
 }
 
 QV4DebugServiceImpl::~QV4DebugServiceImpl()
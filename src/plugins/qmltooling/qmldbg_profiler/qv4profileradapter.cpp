@@ -41,6 +41,10 @@ qint64 QV4ProfilerAdapter::appendMemoryEvents(qint64 until, QList<QByteArray> &m
     while (memoryData.size() > m_memoryPos && memoryData[m_memoryPos].timestamp <= until) {
         const QV4::Profiling::MemoryAllocationProperties &props = memoryData[m_memoryPos];
         d << props.timestamp << int(MemoryAllocation) << int(props.type) << props.size;
+        if (props.type == QV4::Profiling::AllocationSample) {
+            const QV4::Profiling::AllocationSite site = m_allocationSites.value(props.allocationSite);
+            d << site.location.file << site.location.line << site.location.column << site.stack;
+        }
         ++m_memoryPos;
         messages.append(d.squeezedData());
         d.clear();
@@ -64,6 +68,7 @@ qint64 QV4ProfilerAdapter::finalizeMessages(qint64 until, QList<QByteArray> &mes
 
     if (memoryNext == -1) {
         m_memoryData.clear();
+        m_allocationSites.clear();
         m_memoryPos = 0;
         return callNext;
     }
@@ -125,7 +130,8 @@ qint64 QV4ProfilerAdapter::sendMessages(qint64 until, QList<QByteArray> &message
 void QV4ProfilerAdapter::receiveData(
         const QV4::Profiling::FunctionLocationHash &locations,
         const QVector<QV4::Profiling::FunctionCallProperties> &functionCallData,
-        const QVector<QV4::Profiling::MemoryAllocationProperties> &memoryData)
+        const QVector<QV4::Profiling::MemoryAllocationProperties> &memoryData,
+        const QV4::Profiling::AllocationSiteHash &allocationSites)
 {
     // In rare cases it could be that another flush or stop event is processed while data from
     // the previous one is still pending. In that case we just append the data.
@@ -144,6 +150,11 @@ void QV4ProfilerAdapter::receiveData(
     else
         m_memoryData.append(memoryData);
 
+    if (m_allocationSites.isEmpty())
+        m_allocationSites = allocationSites;
+    else
+        m_allocationSites.insert(allocationSites);
+
     service->dataReady(this);
 }
 
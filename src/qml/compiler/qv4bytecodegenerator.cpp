@@ -128,8 +128,146 @@ void BytecodeGenerator::compressInstructions()
     adjustJumpOffsets();
 }
 
+static Instr::Type fusedCompareAndJump(Instr::Type compare, Instr::Type jump)
+{
+    const bool jumpTrue = (jump == Instr::Type::JumpTrue);
+    switch (compare) {
+    case Instr::Type::CmpGt:
+        return jumpTrue ? Instr::Type::CmpGtJumpTrue : Instr::Type::CmpGtJumpFalse;
+    case Instr::Type::CmpGe:
+        return jumpTrue ? Instr::Type::CmpGeJumpTrue : Instr::Type::CmpGeJumpFalse;
+    case Instr::Type::CmpLt:
+        return jumpTrue ? Instr::Type::CmpLtJumpTrue : Instr::Type::CmpLtJumpFalse;
+    case Instr::Type::CmpLe:
+        return jumpTrue ? Instr::Type::CmpLeJumpTrue : Instr::Type::CmpLeJumpFalse;
+    case Instr::Type::CmpStrictEqual:
+        return jumpTrue ? Instr::Type::CmpStrictEqualJumpTrue
+                        : Instr::Type::CmpStrictEqualJumpFalse;
+    case Instr::Type::CmpStrictNotEqual:
+        return jumpTrue ? Instr::Type::CmpStrictNotEqualJumpTrue
+                        : Instr::Type::CmpStrictNotEqualJumpFalse;
+    default:
+        return Instr::Type::Nop;
+    }
+}
+
+/*
+    Replaces frequent sequences of instructions by a single instruction with the same effect, so
+    that the interpreter only needs to dispatch once for them. The fused instructions leave the
+    accumulator and the registers in the same state as the original sequence.
+
+    Only the first instruction of a sequence may be a jump target, and all of them have to belong
+    to the same line and statement, so that neither the control flow nor the line number mapping
+    changes. Code with a source location table is left alone, as the AOT compiler analyzes it
+    instruction by instruction, and so is code compiled in debug mode.
+*/
+void BytecodeGenerator::fuseInstructions()
+{
+    if (debugMode || m_sourceLocationTable || instructions.size() < 2)
+        return;
+
+    const qsizetype count = instructions.size();
+    std::vector<bool> isJumpTarget(count + 1, false);
+    for (int label : std::as_const(labels)) {
+        if (label != -1)
+            isJumpTarget[label] = true;
+    }
+
+    // At this point all instructions are still encoded in their wide form.
+    const auto argument = [](const I &instr, int n) {
+        return qFromLittleEndian<qint32>(
+                instr.packed + Instr::encodedLength(instr.type) + n * sizeof(int));
+    };
+    const auto canFuse = [&](qsizetype first, qsizetype next) {
+        return next < count && !isJumpTarget[next]
+                && instructions.at(next).line == instructions.at(first).line
+                && instructions.at(next).statement == instructions.at(first).statement;
+    };
+
+    QVector<I> fused;
+    fused.reserve(count);
+    QVector<int> newIndex(count + 1);
+
+    for (qsizetype index = 0; index < count;) {
+        const I &first = instructions.at(index);
+        Instr::Type type = Instr::Type::Nop;
+        Instr instr;
+        int offsetOfOffset = -1;
+        int linkedLabel = -1;
+        qsizetype length = 1;
+
+        if (canFuse(index, index + 1)) {
+            const I &second = instructions.at(index + 1);
+            if (first.type == Instr::Type::LoadReg && second.type == Instr::Type::GetLookup) {
+                if (canFuse(index, index + 2)
+                        && instructions.at(index + 2).type == Instr::Type::StoreReg) {
+                    type = Instr::Type::GetLookupFromRegToReg;
+                    instr.GetLookupFromRegToReg.index = argument(second, 0);
+                    instr.GetLookupFromRegToReg.base = argument(first, 0);
+                    instr.GetLookupFromRegToReg.destReg = argument(instructions.at(index + 2), 0);
+                    length = 3;
+                } else {
+                    type = Instr::Type::GetLookupFromReg;
+                    instr.GetLookupFromReg.index = argument(second, 0);
+                    instr.GetLookupFromReg.base = argument(first, 0);
+                    length = 2;
+                }
+            } else if (second.type == Instr::Type::Add
+                       && (first.type == Instr::Type::LoadInt
+                           || first.type == Instr::Type::LoadConst)) {
+                if (first.type == Instr::Type::LoadInt) {
+                    type = Instr::Type::AddInt;
+                    instr.AddInt.lhs = argument(second, 0);
+                    instr.AddInt.value = argument(first, 0);
+                } else {
+                    type = Instr::Type::AddConst;
+                    instr.AddConst.lhs = argument(second, 0);
+                    instr.AddConst.index = argument(first, 0);
+                }
+                length = 2;
+            } else if (second.type == Instr::Type::JumpTrue
+                       || second.type == Instr::Type::JumpFalse) {
+                type = fusedCompareAndJump(first.type, second.type);
+                if (type != Instr::Type::Nop) {
+                    // All the compare-and-jump instructions have the same layout.
+                    instr.CmpLtJumpTrue.lhs = argument(first, 0);
+                    instr.CmpLtJumpTrue.offset = 0;
+                    offsetOfOffset = offsetof(Instruction::CmpLtJumpTrue, offset);
+                    linkedLabel = second.linkedLabel;
+                    length = 2;
+                }
+            }
+        }
+
+        for (qsizetype i = 0; i < length; ++i)
+            newIndex[index + i] = fused.size();
+
+        if (type == Instr::Type::Nop) {
+            fused.append(first);
+        } else {
+            I combined = encodeInstruction(type, instr, offsetOfOffset);
+            combined.line = first.line;
+            combined.statement = first.statement;
+            combined.linkedLabel = linkedLabel;
+            fused.append(combined);
+        }
+        index += length;
+    }
+
+    if (fused.size() == count)
+        return;
+
+    newIndex[count] = fused.size();
+    for (int &label : labels) {
+        if (label != -1)
+            label = newIndex.at(label);
+    }
+    instructions = std::move(fused);
+}
+
 void BytecodeGenerator::finalize(Compiler::Context *context)
 {
+    fuseInstructions();
     compressInstructions();
 
     // collect content and line numbers
@@ -166,6 +304,34 @@ void BytecodeGenerator::finalize(Compiler::Context *context)
         context->labelInfo.push_back(instructions.at(labels.at(li.labelIndex)).position);
 }
 
+BytecodeGenerator::I BytecodeGenerator::encodeInstruction(
+        Instr::Type type, const Instr &i, int offsetOfOffset) const
+{
+    const int argCount = Moth::InstrInfo::argumentCount[static_cast<int>(type)];
+    int s = argCount*sizeof(int);
+    if (offsetOfOffset != -1)
+        offsetOfOffset += Instr::encodedLength(type);
+    I instr {
+        type,
+        static_cast<short>(s + Instr::encodedLength(type)),
+        0,
+        currentLine,
+        currentStatement,
+        offsetOfOffset,
+        -1,
+        "\0\0"
+    };
+    uchar *code = instr.packed;
+    code = Instr::pack(code, Instr::wideInstructionType(type));
+
+    for (int j = 0; j < argCount; ++j) {
+        qToLittleEndian<qint32>(i.argumentsAsInts[j], code);
+        code += sizeof(int);
+    }
+
+    return instr;
+}
+
 int BytecodeGenerator::addInstructionHelper(Instr::Type type, const Instr &i, int offsetOfOffset) {
     if (lastInstrType == int(Instr::Type::StoreReg)) {
         if (type == Instr::Type::LoadReg) {
@@ -202,29 +368,7 @@ QT_WARNING_POP
 
     const int pos = instructions.size();
 
-    const int argCount = Moth::InstrInfo::argumentCount[static_cast<int>(type)];
-    int s = argCount*sizeof(int);
-    if (offsetOfOffset != -1)
-        offsetOfOffset += Instr::encodedLength(type);
-    I instr {
-        type,
-        static_cast<short>(s + Instr::encodedLength(type)),
-        0,
-        currentLine,
-        currentStatement,
-        offsetOfOffset,
-        -1,
-        "\0\0"
-    };
-    uchar *code = instr.packed;
-    code = Instr::pack(code, Instr::wideInstructionType(type));
-
-    for (int j = 0; j < argCount; ++j) {
-        qToLittleEndian<qint32>(i.argumentsAsInts[j], code);
-        code += sizeof(int);
-    }
-
-    instructions.append(instr);
+    instructions.append(encodeInstruction(type, i, offsetOfOffset));
     if (m_sourceLocationTable)
         m_sourceLocationTable->entries.append({ 0, currentSourceLocation });
 
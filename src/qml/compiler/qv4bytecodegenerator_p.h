@@ -286,6 +286,8 @@ private:
         unsigned char packed[sizeof(Instr) + 2]; // 2 for instruction type
     };
 
+    I encodeInstruction(Moth::Instr::Type type, const Instr &i, int offsetOfOffset) const;
+    void fuseInstructions();
     void compressInstructions();
     void packInstruction(I &i);
     void adjustJumpOffsets();
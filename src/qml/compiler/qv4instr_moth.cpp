@@ -261,6 +261,15 @@ void dumpBytecode(
             d << "acc(" << index << "), jump(" << ABSOLUTE_OFFSET() << ")";
         MOTH_END_INSTR(GetOptionalLookup)
 
+        MOTH_BEGIN_INSTR(GetLookupFromReg)
+            d << dumpRegister(base, nFormals) << "(" << index << ")";
+        MOTH_END_INSTR(GetLookupFromReg)
+
+        MOTH_BEGIN_INSTR(GetLookupFromRegToReg)
+            d << dumpRegister(destReg, nFormals) << ", " << dumpRegister(base, nFormals)
+              << "(" << index << ")";
+        MOTH_END_INSTR(GetLookupFromRegToReg)
+
         MOTH_BEGIN_INSTR(StoreProperty)
             d << dumpRegister(base, nFormals) << "[" << name<< "]";
         MOTH_END_INSTR(StoreProperty)
@@ -531,6 +540,54 @@ void dumpBytecode(
             d << dumpRegister(lhs, nFormals);
         MOTH_END_INSTR(CmpStrictNotEqual)
 
+        MOTH_BEGIN_INSTR(CmpGtJumpTrue)
+            d << dumpRegister(lhs, nFormals) << ", jump(" << ABSOLUTE_OFFSET() << ")";
+        MOTH_END_INSTR(CmpGtJumpTrue)
+
+        MOTH_BEGIN_INSTR(CmpGtJumpFalse)
+            d << dumpRegister(lhs, nFormals) << ", jump(" << ABSOLUTE_OFFSET() << ")";
+        MOTH_END_INSTR(CmpGtJumpFalse)
+
+        MOTH_BEGIN_INSTR(CmpGeJumpTrue)
+            d << dumpRegister(lhs, nFormals) << ", jump(" << ABSOLUTE_OFFSET() << ")";
+        MOTH_END_INSTR(CmpGeJumpTrue)
+
+        MOTH_BEGIN_INSTR(CmpGeJumpFalse)
+            d << dumpRegister(lhs, nFormals) << ", jump(" << ABSOLUTE_OFFSET() << ")";
+        MOTH_END_INSTR(CmpGeJumpFalse)
+
+        MOTH_BEGIN_INSTR(CmpLtJumpTrue)
+            d << dumpRegister(lhs, nFormals) << ", jump(" << ABSOLUTE_OFFSET() << ")";
+        MOTH_END_INSTR(CmpLtJumpTrue)
+
+        MOTH_BEGIN_INSTR(CmpLtJumpFalse)
+            d << dumpRegister(lhs, nFormals) << ", jump(" << ABSOLUTE_OFFSET() << ")";
+        MOTH_END_INSTR(CmpLtJumpFalse)
+
+        MOTH_BEGIN_INSTR(CmpLeJumpTrue)
+            d << dumpRegister(lhs, nFormals) << ", jump(" << ABSOLUTE_OFFSET() << ")";
+        MOTH_END_INSTR(CmpLeJumpTrue)
+
+        MOTH_BEGIN_INSTR(CmpLeJumpFalse)
+            d << dumpRegister(lhs, nFormals) << ", jump(" << ABSOLUTE_OFFSET() << ")";
+        MOTH_END_INSTR(CmpLeJumpFalse)
+
+        MOTH_BEGIN_INSTR(CmpStrictEqualJumpTrue)
+            d << dumpRegister(lhs, nFormals) << ", jump(" << ABSOLUTE_OFFSET() << ")";
+        MOTH_END_INSTR(CmpStrictEqualJumpTrue)
+
+        MOTH_BEGIN_INSTR(CmpStrictEqualJumpFalse)
+            d << dumpRegister(lhs, nFormals) << ", jump(" << ABSOLUTE_OFFSET() << ")";
+        MOTH_END_INSTR(CmpStrictEqualJumpFalse)
+
+        MOTH_BEGIN_INSTR(CmpStrictNotEqualJumpTrue)
+            d << dumpRegister(lhs, nFormals) << ", jump(" << ABSOLUTE_OFFSET() << ")";
+        MOTH_END_INSTR(CmpStrictNotEqualJumpTrue)
+
+        MOTH_BEGIN_INSTR(CmpStrictNotEqualJumpFalse)
+            d << dumpRegister(lhs, nFormals) << ", jump(" << ABSOLUTE_OFFSET() << ")";
+        MOTH_END_INSTR(CmpStrictNotEqualJumpFalse)
+
         MOTH_BEGIN_INSTR(UNot)
         MOTH_END_INSTR(UNot)
 
@@ -553,6 +610,14 @@ void dumpBytecode(
             d << dumpRegister(lhs, nFormals) << ", acc";
         MOTH_END_INSTR(Add)
 
+        MOTH_BEGIN_INSTR(AddInt)
+            d << dumpRegister(lhs, nFormals) << ", " << value;
+        MOTH_END_INSTR(AddInt)
+
+        MOTH_BEGIN_INSTR(AddConst)
+            d << dumpRegister(lhs, nFormals) << ", C" << index;
+        MOTH_END_INSTR(AddConst)
+
         MOTH_BEGIN_INSTR(BitAnd)
             d << dumpRegister(lhs, nFormals) << ", acc";
         MOTH_END_INSTR(BitAnd)
@@ -56,6 +56,8 @@ QT_BEGIN_NAMESPACE
 #define INSTR_LoadOptionalProperty(op) INSTRUCTION(op, LoadOptionalProperty, 2, name, offset)
 #define INSTR_GetLookup(op) INSTRUCTION(op, GetLookup, 1, index)
 #define INSTR_GetOptionalLookup(op) INSTRUCTION(op, GetOptionalLookup, 2, index, offset)
+#define INSTR_GetLookupFromReg(op) INSTRUCTION(op, GetLookupFromReg, 2, index, base)
+#define INSTR_GetLookupFromRegToReg(op) INSTRUCTION(op, GetLookupFromRegToReg, 3, index, base, destReg)
 #define INSTR_LoadIdObject(op) INSTRUCTION(op, LoadIdObject, 2, index, base)
 #define INSTR_Yield(op) INSTRUCTION(op, Yield, 0)
 #define INSTR_YieldStar(op) INSTRUCTION(op, YieldStar, 0)
@@ -129,6 +131,18 @@ QT_BEGIN_NAMESPACE
 #define INSTR_CmpLe(op) INSTRUCTION(op, CmpLe, 1, lhs)
 #define INSTR_CmpStrictEqual(op) INSTRUCTION(op, CmpStrictEqual, 1, lhs)
 #define INSTR_CmpStrictNotEqual(op) INSTRUCTION(op, CmpStrictNotEqual, 1, lhs)
+#define INSTR_CmpGtJumpTrue(op) INSTRUCTION(op, CmpGtJumpTrue, 2, lhs, offset)
+#define INSTR_CmpGtJumpFalse(op) INSTRUCTION(op, CmpGtJumpFalse, 2, lhs, offset)
+#define INSTR_CmpGeJumpTrue(op) INSTRUCTION(op, CmpGeJumpTrue, 2, lhs, offset)
+#define INSTR_CmpGeJumpFalse(op) INSTRUCTION(op, CmpGeJumpFalse, 2, lhs, offset)
+#define INSTR_CmpLtJumpTrue(op) INSTRUCTION(op, CmpLtJumpTrue, 2, lhs, offset)
+#define INSTR_CmpLtJumpFalse(op) INSTRUCTION(op, CmpLtJumpFalse, 2, lhs, offset)
+#define INSTR_CmpLeJumpTrue(op) INSTRUCTION(op, CmpLeJumpTrue, 2, lhs, offset)
+#define INSTR_CmpLeJumpFalse(op) INSTRUCTION(op, CmpLeJumpFalse, 2, lhs, offset)
+#define INSTR_CmpStrictEqualJumpTrue(op) INSTRUCTION(op, CmpStrictEqualJumpTrue, 2, lhs, offset)
+#define INSTR_CmpStrictEqualJumpFalse(op) INSTRUCTION(op, CmpStrictEqualJumpFalse, 2, lhs, offset)
+#define INSTR_CmpStrictNotEqualJumpTrue(op) INSTRUCTION(op, CmpStrictNotEqualJumpTrue, 2, lhs, offset)
+#define INSTR_CmpStrictNotEqualJumpFalse(op) INSTRUCTION(op, CmpStrictNotEqualJumpFalse, 2, lhs, offset)
 #define INSTR_CmpIn(op) INSTRUCTION(op, CmpIn, 1, lhs)
 #define INSTR_CmpInstanceOf(op) INSTRUCTION(op, CmpInstanceOf, 1, lhs)
 #define INSTR_UNot(op) INSTRUCTION(op, UNot, 0)
@@ -138,6 +152,8 @@ QT_BEGIN_NAMESPACE
 #define INSTR_Increment(op) INSTRUCTION(op, Increment, 0)
 #define INSTR_Decrement(op) INSTRUCTION(op, Decrement, 0)
 #define INSTR_Add(op) INSTRUCTION(op, Add, 1, lhs)
+#define INSTR_AddInt(op) INSTRUCTION(op, AddInt, 2, lhs, value)
+#define INSTR_AddConst(op) INSTRUCTION(op, AddConst, 2, lhs, index)
 #define INSTR_BitAnd(op) INSTRUCTION(op, BitAnd, 1, lhs)
 #define INSTR_BitOr(op) INSTRUCTION(op, BitOr, 1, lhs)
 #define INSTR_BitXor(op) INSTRUCTION(op, BitXor, 1, lhs)
@@ -198,6 +214,8 @@ QT_BEGIN_NAMESPACE
     F(LoadOptionalProperty) \
     F(GetLookup) \
     F(GetOptionalLookup) \
+    F(GetLookupFromReg) \
+    F(GetLookupFromRegToReg) \
     F(StoreProperty) \
     F(SetLookup) \
     F(LoadSuperProperty) \
@@ -222,6 +240,18 @@ QT_BEGIN_NAMESPACE
     F(CmpLe) \
     F(CmpStrictEqual) \
     F(CmpStrictNotEqual) \
+    F(CmpGtJumpTrue) \
+    F(CmpGtJumpFalse) \
+    F(CmpGeJumpTrue) \
+    F(CmpGeJumpFalse) \
+    F(CmpLtJumpTrue) \
+    F(CmpLtJumpFalse) \
+    F(CmpLeJumpTrue) \
+    F(CmpLeJumpFalse) \
+    F(CmpStrictEqualJumpTrue) \
+    F(CmpStrictEqualJumpFalse) \
+    F(CmpStrictNotEqualJumpTrue) \
+    F(CmpStrictNotEqualJumpFalse) \
     F(CmpIn) \
     F(CmpInstanceOf) \
     F(UNot) \
@@ -231,6 +261,8 @@ QT_BEGIN_NAMESPACE
     F(Increment) \
     F(Decrement) \
     F(Add) \
+    F(AddInt) \
+    F(AddConst) \
     F(BitAnd) \
     F(BitOr) \
     F(BitXor) \
@@ -143,6 +143,12 @@ qt_extra_definition("QT_QML_JIT_SUPPORTED_IMPL" "0
 #endif
 " PRIVATE)
 # special case end
+qt_feature("qml-lookup-counters" PRIVATE
+    SECTION "QML"
+    LABEL "QML lookup counters"
+    PURPOSE "Counts how often the property lookups of each JavaScript function hit their caches, and prints the numbers when the function is destroyed."
+    AUTODETECT OFF
+)
 qt_feature("qml-debug" PUBLIC
     SECTION "QML"
     LABEL "QML debugging and profiling support"
@@ -7,6 +7,7 @@
 
 #include "qv4engine_p.h"
 #include "qv4assemblercommon_p.h"
+#include "qv4jitcodecache_p.h"
 #include <private/qv4function_p.h>
 #include <private/qv4functiontable_p.h>
 #include <private/qv4runtime_p.h>
@@ -90,6 +91,21 @@ JIT::PlatformAssemblerCommon::~PlatformAssemblerCommon()
 {}
 
 void PlatformAssemblerCommon::link(Function *function, const char *jitKind)
+{
+    function->codeRef = linkCode(function, jitKind, &function->jittedCode,
+                                 &function->jitCacheRecord);
+}
+
+void PlatformAssemblerCommon::linkOptimized(Function *function, const char *jitKind)
+{
+    // Optimized code is not cached. It relies on the function having run hot in this process,
+    // and may be discarded again when it deoptimizes.
+    function->optimizedCodeRef = linkCode(function, jitKind, &function->optimizedCode, nullptr);
+}
+
+JSC::MacroAssemblerCodeRef *PlatformAssemblerCommon::linkCode(
+        Function *function, const char *jitKind, Function::JittedCode *entryPoint,
+        QByteArray *cacheRecord)
 {
     for (const auto &jumpTarget : jumpsToLink)
         jumpTarget.jump.linkTo(labelForOffset[jumpTarget.offset], this);
@@ -99,9 +115,48 @@ void PlatformAssemblerCommon::link(Function *function, const char *jitKind)
 
     for (const auto &ehTarget : ehTargets) {
         auto targetLabel = labelForOffset.value(ehTarget.offset);
-        linkBuffer.patch(ehTarget.label, linkBuffer.locationOf(targetLabel));
+        linkBuffer.patch(ehTarget.label, linkBuffer.executableLocationOf(targetLabel));
     }
 
+#ifdef QV4_JIT_RELOCATABLE_CODE
+    if (cacheRecord && CodeCache::isWriteEnabled(function->internalClass->engine)) {
+        const char *codeStart = static_cast<const char *>(linkBuffer.debugAddress());
+        const auto offsetInCode = [&](DataLabelPtr label) {
+            return quint32(static_cast<const char *>(linkBuffer.locationOf(label).dataLocation())
+                           - codeStart);
+        };
+
+        std::vector<CodeCache::Relocation> relocations;
+        relocations.reserve(runtimeCallTargets.size() + ehTargets.size());
+        bool relocatable = true;
+        for (const auto &callTarget : runtimeCallTargets) {
+            // The library layout only covers known functions. Helpers have to be listed in
+            // BaselineAssembler::helperSymbolTable() for the code to be cached.
+            Q_ASSERT(CodeCache::isRelocationTarget(callTarget.funcPtr));
+            if (!CodeCache::isRelocationTarget(callTarget.funcPtr)) {
+                relocatable = false;
+                break;
+            }
+            relocations.push_back({ offsetInCode(callTarget.label),
+                                    CodeCache::Relocation::LibraryAddress,
+                                    CodeCache::libraryOffset(callTarget.funcPtr) });
+        }
+        for (const auto &ehTarget : ehTargets) {
+            relocations.push_back({ offsetInCode(ehTarget.label),
+                                    CodeCache::Relocation::CodeAddress,
+                                    qint64(linkBuffer.offsetOf(
+                                            labelForOffset.value(ehTarget.offset))) });
+        }
+
+        if (relocatable) {
+            *cacheRecord = CodeCache::createRecord(
+                    function, codeStart, quint32(linkBuffer.debugSize()), relocations);
+        }
+    }
+#else
+    Q_UNUSED(cacheRecord);
+#endif
+
     JSC::MacroAssemblerCodeRef codeRef;
 
     static const bool showCode = lcAsm().isDebugEnabled();
@@ -121,13 +176,14 @@ void PlatformAssemblerCommon::link(Function *function, const char *jitKind)
         codeRef = linkBuffer.finalizeCodeWithoutDisassembly();
     }
 
-    function->codeRef = new JSC::MacroAssemblerCodeRef(codeRef);
-    function->jittedCode = reinterpret_cast<Function::JittedCode>(function->codeRef->code().executableAddress());
+    *entryPoint = reinterpret_cast<Function::JittedCode>(codeRef.code().executableAddress());
 
     generateFunctionTable(function, &codeRef);
 
     if (Q_UNLIKELY(!linkBuffer.makeExecutable()))
-        function->jittedCode = nullptr; // The function is not executable, but the coderef exists.
+        *entryPoint = nullptr; // The function is not executable, but the coderef exists.
+
+    return new JSC::MacroAssemblerCodeRef(codeRef);
 }
 
 void PlatformAssemblerCommon::prepareCallWithArgCount(int argc)
@@ -290,7 +346,11 @@ void PlatformAssemblerCommon::callRuntimeUnchecked(const void *funcPtr, const ch
 {
     Q_ASSERT(functionName || Runtime::symbolTable().contains(funcPtr));
     functions.insert(funcPtr, functionName);
+#ifdef QV4_JIT_RELOCATABLE_CODE
+    runtimeCallTargets.push_back({ callAbsolute(funcPtr), funcPtr });
+#else
     callAbsolute(funcPtr);
+#endif
 }
 
 void PlatformAssemblerCommon::tailCallRuntime(const void *funcPtr, const char *functionName)
@@ -301,7 +361,11 @@ void PlatformAssemblerCommon::tailCallRuntime(const void *funcPtr, const char *f
     setTailCallArg(CppStackFrameRegister, 0);
     freeStackSpace();
     generatePlatformFunctionExit(/*tailCall =*/ true);
+#ifdef QV4_JIT_RELOCATABLE_CODE
+    runtimeCallTargets.push_back({ jumpAbsolute(funcPtr), funcPtr });
+#else
     jumpAbsolute(funcPtr);
+#endif
 }
 
 void PlatformAssemblerCommon::setTailCallArg(RegisterID src, int arg)
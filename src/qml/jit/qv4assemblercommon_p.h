@@ -30,6 +30,12 @@ namespace QV4 {
 namespace JIT {
 
 #if defined(Q_PROCESSOR_X86_64) || defined(ENABLE_ALL_ASSEMBLERS_FOR_REFACTORING_PURPOSES)
+
+// On x86_64 the generated code is copied verbatim into executable memory, and all absolute
+// addresses are loaded from patchable immediates. Therefore the code can be saved, and loaded
+// again at a different address, see qv4jitcodecache.cpp.
+#define QV4_JIT_RELOCATABLE_CODE
+
 #if defined(Q_OS_LINUX) || defined(Q_OS_QNX) || defined(Q_OS_FREEBSD) || defined(Q_OS_DARWIN) || defined(Q_OS_SOLARIS)
 
 class PlatformAssembler_X86_64_SysV : public JSC::MacroAssembler<JSC::MacroAssemblerX86_64>
@@ -91,16 +97,18 @@ public:
             ret();
     }
 
-    void callAbsolute(const void *funcPtr)
+    DataLabelPtr callAbsolute(const void *funcPtr)
     {
-        move(TrustedImmPtr(funcPtr), ScratchRegister);
+        DataLabelPtr label = moveWithPatch(TrustedImmPtr(funcPtr), ScratchRegister);
         call(ScratchRegister);
+        return label;
     }
 
-    void jumpAbsolute(const void *funcPtr)
+    DataLabelPtr jumpAbsolute(const void *funcPtr)
     {
-        move(TrustedImmPtr(funcPtr), ScratchRegister);
+        DataLabelPtr label = moveWithPatch(TrustedImmPtr(funcPtr), ScratchRegister);
         jump(ScratchRegister);
+        return label;
     }
 
     void pushAligned(RegisterID reg)
@@ -138,6 +146,7 @@ public:
     static const RegisterID StackPointerRegister  = RegisterID::esp;
     static const RegisterID FramePointerRegister  = RegisterID::ebp;
     static const FPRegisterID FPScratchRegister   = FPRegisterID::xmm1;
+    static const FPRegisterID FPScratchRegister2  = FPRegisterID::xmm2;
 
     static const RegisterID Arg0Reg = RegisterID::ecx;
     static const RegisterID Arg1Reg = RegisterID::edx;
@@ -177,18 +186,20 @@ public:
             ret();
     }
 
-    void callAbsolute(const void *funcPtr)
+    DataLabelPtr callAbsolute(const void *funcPtr)
     {
-        move(TrustedImmPtr(funcPtr), ScratchRegister);
+        DataLabelPtr label = moveWithPatch(TrustedImmPtr(funcPtr), ScratchRegister);
         subPtr(TrustedImm32(4 * PointerSize), StackPointerRegister);
         call(ScratchRegister);
         addPtr(TrustedImm32(4 * PointerSize), StackPointerRegister);
+        return label;
     }
 
-    void jumpAbsolute(const void *funcPtr)
+    DataLabelPtr jumpAbsolute(const void *funcPtr)
     {
-        move(TrustedImmPtr(funcPtr), ScratchRegister);
+        DataLabelPtr label = moveWithPatch(TrustedImmPtr(funcPtr), ScratchRegister);
         jump(ScratchRegister);
+        return label;
     }
 
     void pushAligned(RegisterID reg)
@@ -318,6 +329,7 @@ public:
     static const RegisterID StackPointerRegister  = JSC::ARM64Registers::sp;
     static const RegisterID FramePointerRegister  = JSC::ARM64Registers::fp;
     static const FPRegisterID FPScratchRegister   = JSC::ARM64Registers::q1;
+    static const FPRegisterID FPScratchRegister2  = JSC::ARM64Registers::q2;
 
     static const RegisterID Arg0Reg = JSC::ARM64Registers::x0;
     static const RegisterID Arg1Reg = JSC::ARM64Registers::x1;
@@ -655,6 +667,7 @@ public:
     }
 
     void link(Function *function, const char *jitKind);
+    void linkOptimized(Function *function, const char *jitKind);
 
     Value constant(int idx) const
     { return constantTable[idx]; }
@@ -679,6 +692,9 @@ public:
     void storeInt32AsValue(int srcInt, Address destAddr);
 
 private:
+    JSC::MacroAssemblerCodeRef *linkCode(Function *function, const char *jitKind,
+                                         Function::JittedCode *entryPoint,
+                                         QByteArray *cacheRecord);
     void passAccumulatorAsArg_internal(int arg, bool doPush);
     static Address argStackAddress(int arg);
 
@@ -688,6 +704,10 @@ private:
     std::vector<JumpTarget> jumpsToLink;
     struct ExceptionHanlderTarget { JSC::MacroAssemblerBase::DataLabelPtr label; int offset; };
     std::vector<ExceptionHanlderTarget> ehTargets;
+#ifdef QV4_JIT_RELOCATABLE_CODE
+    struct RuntimeCallTarget { JSC::MacroAssemblerBase::DataLabelPtr label; const void *funcPtr; };
+    std::vector<RuntimeCallTarget> runtimeCallTargets;
+#endif
     QHash<int, JSC::MacroAssemblerBase::Label> labelForOffset;
     QHash<const void *, const char *> functions;
     std::vector<Jump> catchyJumps;
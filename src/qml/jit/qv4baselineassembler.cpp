@@ -8,8 +8,11 @@
 #include "qv4baselineassembler_p.h"
 #include "qv4assemblercommon_p.h"
 #include <private/qv4function_p.h>
+#include <private/qv4lookup_p.h>
+#include <private/qv4memberdata_p.h>
 #include <private/qv4runtime_p.h>
 #include <private/qv4stackframe_p.h>
+#include <private/qv4vme_moth_p.h>
 
 #include <wtf/Vector.h>
 #include <assembler/MacroAssembler.h>
@@ -42,6 +45,17 @@ static ReturnedValue toInt32Helper(ReturnedValue v)
     return Encode(Value::fromReturnedValue(v).toInt32());
 }
 
+static void writeBarrierHelper(ExecutionEngine *engine, const Value &v, const Value &context, int level)
+{
+    Heap::ExecutionContext *ctx = static_cast<Heap::ExecutionContext *>(context.heapObject());
+    while (level--)
+        ctx = ctx->outer;
+    if (engine->isGCOngoing)
+        WriteBarrier::markValue(engine, v.asReturnedValue());
+    else
+        WriteBarrier::rememberValue(engine, ctx, v.asReturnedValue());
+}
+
 #if QT_POINTER_SIZE == 8 || defined(ENABLE_ALL_ASSEMBLERS_FOR_REFACTORING_PURPOSES)
 class PlatformAssembler64 : public PlatformAssemblerCommon
 {
@@ -343,6 +357,82 @@ public:
         passAsArg(AccumulatorRegister, 0);
         doCall();
     }
+
+    // loads an integer or double from src into dest, anything else jumps to notNumber
+    void unboxNumber(RegisterID src, FPRegisterID dest, JumpList *notNumber)
+    {
+        urshift64(src, TrustedImm32(Value::QuickType_Shift), ScratchRegister2);
+        Jump notInt = branch32(NotEqual, TrustedImm32(Value::QT_Int), ScratchRegister2);
+        convertInt32ToDouble(src, dest);
+        Jump done = jump();
+
+        notInt.link(this);
+        move(TrustedImm64(Value::DoubleMask), ScratchRegister2);
+        and64(src, ScratchRegister2);
+        notNumber->append(branch64(Below, ScratchRegister2,
+                                   TrustedImm64(Value::DoubleDiscriminator)));
+        move(TrustedImm64(Value::EncodeMask), ScratchRegister2);
+        xor64(src, ScratchRegister2);
+        move64ToDouble(ScratchRegister2, dest);
+
+        done.link(this);
+    }
+
+    void boxDoubleIntoAccumulator(FPRegisterID src)
+    {
+        Jump isNaN = branchDouble(DoubleNotEqualOrUnordered, src, src);
+        encodeDoubleIntoAccumulator(src);
+        Jump done = jump();
+
+        // NaNs need to be stored in their canonical form, see Value::setDouble()
+        isNaN.link(this);
+        loadValue(Encode(qt_qnan()));
+
+        done.link(this);
+    }
+
+    // lhs ends up in FPScratchRegister, the accumulator in FPScratchRegister2
+    void numberBinop(Address lhsAddr, std::function<Jump(void)> intPath,
+                     std::function<void(void)> doublePath,
+                     std::function<void(void)> deoptimize)
+    {
+        Jump intDone;
+        if (intPath)
+            intDone = binopBothIntPath(lhsAddr, intPath);
+
+        // at least one double, or the integer operation overflowed
+        JumpList notNumber;
+        load64(lhsAddr, ScratchRegister);
+        unboxNumber(ScratchRegister, FPScratchRegister, &notNumber);
+        unboxNumber(AccumulatorRegister, FPScratchRegister2, &notNumber);
+        doublePath();
+        Jump doubleDone = jump();
+
+        notNumber.link(this);
+        deoptimize();
+
+        if (intDone.isSet())
+            intDone.link(this);
+        doubleDone.link(this);
+    }
+
+    // the accumulator ends up in FPScratchRegister
+    void numberUnop(std::function<Jump(void)> intPath, std::function<void(void)> doublePath,
+                    std::function<void(void)> deoptimize)
+    {
+        Jump intDone = unopIntPath(intPath);
+
+        JumpList notNumber;
+        unboxNumber(AccumulatorRegister, FPScratchRegister, &notNumber);
+        doublePath();
+        Jump doubleDone = jump();
+
+        notNumber.link(this);
+        deoptimize();
+
+        intDone.link(this);
+        doubleDone.link(this);
+    }
 };
 
 typedef PlatformAssembler64 PlatformAssembler;
@@ -793,6 +883,7 @@ typedef PlatformAssembler::TrustedImmPtr TrustedImmPtr;
 typedef PlatformAssembler::TrustedImm32 TrustedImm32;
 typedef PlatformAssembler::TrustedImm64 TrustedImm64;
 typedef PlatformAssembler::Address Address;
+typedef PlatformAssembler::BaseIndex BaseIndex;
 typedef PlatformAssembler::RegisterID RegisterID;
 typedef PlatformAssembler::FPRegisterID FPRegisterID;
 
@@ -826,6 +917,11 @@ void BaselineAssembler::link(Function *function)
     pasm()->link(function, "BaselineJIT");
 }
 
+void BaselineAssembler::linkOptimized(Function *function)
+{
+    pasm()->linkOptimized(function, "OptimizingJIT");
+}
+
 void BaselineAssembler::addLabel(int offset)
 {
     pasm()->addLabelForOffset(offset);
@@ -877,12 +973,37 @@ void BaselineAssembler::storeLocal(int index, int level)
 {
     Heap::CallContext ctx;
     Q_UNUSED(ctx);
+    const int contextLevel = level;
     pasm()->loadPtr(regAddr(CallData::Context), PlatformAssembler::ScratchRegister);
     while (level) {
         pasm()->loadPtr(Address(PlatformAssembler::ScratchRegister, ctx.outer.offset), PlatformAssembler::ScratchRegister);
         --level;
     }
     pasm()->storeAccumulator(Address(PlatformAssembler::ScratchRegister, ctx.locals.offset + offsetof(ValueArray<0>, values) + sizeof(Value)*index));
+
+    // The context may already have been marked by an ongoing incremental GC,
+    // or it may belong to the old generation.
+    Q_STATIC_ASSERT(sizeof(QV4::EngineBase::isGCOngoing) == 1);
+    Q_STATIC_ASSERT(sizeof(QV4::EngineBase::isGenerationalGC) == 1);
+    auto gcOngoing = pasm()->branch8(PlatformAssembler::NotEqual,
+                                     Address(PlatformAssembler::EngineRegister,
+                                             offsetof(EngineBase, isGCOngoing)),
+                                     TrustedImm32(0));
+    auto noBarrier = pasm()->branch8(PlatformAssembler::Equal,
+                                     Address(PlatformAssembler::EngineRegister,
+                                             offsetof(EngineBase, isGenerationalGC)),
+                                     TrustedImm32(0));
+    gcOngoing.link(pasm());
+    saveAccumulatorInFrame();
+    prepareCallWithArgCount(4);
+    passInt32AsArg(contextLevel, 3);
+    passJSSlotAsArg(CallData::Context, 2);
+    passAccumulatorAsArg(1);
+    passEngineAsArg(0);
+    pasm()->PlatformAssemblerCommon::callRuntime(reinterpret_cast<void *>(&writeBarrierHelper),
+                                                 "writeBarrierHelper");
+    loadAccumulatorFromFrame();
+    noBarrier.link(pasm());
 }
 
 void BaselineAssembler::loadString(int stringId)
@@ -1223,6 +1344,275 @@ void BaselineAssembler::sub(int lhs)
     done.link(pasm());
 }
 
+static ReturnedValue deoptimizeHelper(JSTypesStackFrame *frame, ExecutionEngine *engine,
+                                      int instructionOffset)
+{
+    Function *function = frame->v4Function;
+
+    // The optimized code has to stay around, it may still be running further up the stack.
+    function->optimizedCode = nullptr;
+    function->optimizationDisabled = true;
+
+    return Moth::VME::interpret(frame, engine, function->codeData + instructionOffset);
+}
+
+void BaselineAssembler::getLookup(int index, int nextInstructionOffset)
+{
+    storeInstructionPointer(nextInstructionOffset);
+    saveAccumulatorInFrame();
+    prepareCallWithArgCount(4);
+    passInt32AsArg(index, 3);
+    passAccumulatorAsArg(2);
+    passFunctionAsArg(1);
+    passEngineAsArg(0);
+    ASM_GENERATE_RUNTIME_CALL(GetLookup, CallResultDestination::InAccumulator);
+    checkException();
+}
+
+void BaselineAssembler::deoptimize(int instructionOffset)
+{
+    // Registers live in the JS stack frame in both the JIT and the interpreter, so only the
+    // accumulator needs to be handed over. The interpreter then runs the function to completion.
+    saveAccumulatorInFrame();
+    pasm()->prepareCallWithArgCount(3);
+    pasm()->passInt32AsArg(instructionOffset, 2);
+    pasm()->passEngineAsArg(1);
+    pasm()->passCppFrameAsArg(0);
+    pasm()->PlatformAssemblerCommon::callRuntime(reinterpret_cast<void *>(&deoptimizeHelper),
+                                                 "deoptimizeHelper");
+    pasm()->saveReturnValueInAccumulator();
+    pasm()->generateFunctionExit();
+}
+
+#if QT_POINTER_SIZE == 8
+
+void BaselineAssembler::speculativeInc(int instructionOffset)
+{
+    pasm()->numberUnop([this]() {
+        auto overflowed = pasm()->branchAdd32(PlatformAssembler::Overflow,
+                                              PlatformAssembler::AccumulatorRegisterValue,
+                                              TrustedImm32(1),
+                                              PlatformAssembler::ScratchRegister);
+        pasm()->setAccumulatorTag(IntegerTag, PlatformAssembler::ScratchRegister);
+        return overflowed;
+    }, [this]() {
+        pasm()->convertInt32ToDouble(TrustedImm32(1), PlatformAssembler::FPScratchRegister2);
+        pasm()->addDouble(PlatformAssembler::FPScratchRegister2,
+                          PlatformAssembler::FPScratchRegister);
+        pasm()->boxDoubleIntoAccumulator(PlatformAssembler::FPScratchRegister);
+    }, [this, instructionOffset]() {
+        deoptimize(instructionOffset);
+    });
+}
+
+void BaselineAssembler::speculativeDec(int instructionOffset)
+{
+    pasm()->numberUnop([this]() {
+        auto overflowed = pasm()->branchSub32(PlatformAssembler::Overflow,
+                                              PlatformAssembler::AccumulatorRegisterValue,
+                                              TrustedImm32(1),
+                                              PlatformAssembler::ScratchRegister);
+        pasm()->setAccumulatorTag(IntegerTag, PlatformAssembler::ScratchRegister);
+        return overflowed;
+    }, [this]() {
+        pasm()->convertInt32ToDouble(TrustedImm32(1), PlatformAssembler::FPScratchRegister2);
+        pasm()->subDouble(PlatformAssembler::FPScratchRegister2,
+                          PlatformAssembler::FPScratchRegister);
+        pasm()->boxDoubleIntoAccumulator(PlatformAssembler::FPScratchRegister);
+    }, [this, instructionOffset]() {
+        deoptimize(instructionOffset);
+    });
+}
+
+void BaselineAssembler::speculativeAdd(int lhs, int instructionOffset)
+{
+    pasm()->numberBinop(regAddr(lhs), [this]() {
+        auto overflowed = pasm()->branchAdd32(PlatformAssembler::Overflow,
+                                              PlatformAssembler::AccumulatorRegisterValue,
+                                              PlatformAssembler::ScratchRegister);
+        pasm()->setAccumulatorTag(IntegerTag, PlatformAssembler::ScratchRegister);
+        return overflowed;
+    }, [this]() {
+        pasm()->addDouble(PlatformAssembler::FPScratchRegister2,
+                          PlatformAssembler::FPScratchRegister);
+        pasm()->boxDoubleIntoAccumulator(PlatformAssembler::FPScratchRegister);
+    }, [this, instructionOffset]() {
+        deoptimize(instructionOffset);
+    });
+}
+
+void BaselineAssembler::speculativeSub(int lhs, int instructionOffset)
+{
+    pasm()->numberBinop(regAddr(lhs), [this]() {
+        auto overflowed = pasm()->branchSub32(PlatformAssembler::Overflow,
+                                              PlatformAssembler::AccumulatorRegisterValue,
+                                              PlatformAssembler::ScratchRegister);
+        pasm()->setAccumulatorTag(IntegerTag, PlatformAssembler::ScratchRegister);
+        return overflowed;
+    }, [this]() {
+        pasm()->subDouble(PlatformAssembler::FPScratchRegister2,
+                          PlatformAssembler::FPScratchRegister);
+        pasm()->boxDoubleIntoAccumulator(PlatformAssembler::FPScratchRegister);
+    }, [this, instructionOffset]() {
+        deoptimize(instructionOffset);
+    });
+}
+
+void BaselineAssembler::speculativeMul(int lhs, int instructionOffset)
+{
+    pasm()->numberBinop(regAddr(lhs), [this]() {
+        auto overflowed = pasm()->branchMul32(PlatformAssembler::Overflow,
+                                              PlatformAssembler::AccumulatorRegisterValue,
+                                              PlatformAssembler::ScratchRegister);
+        pasm()->setAccumulatorTag(IntegerTag, PlatformAssembler::ScratchRegister);
+        return overflowed;
+    }, [this]() {
+        pasm()->mulDouble(PlatformAssembler::FPScratchRegister2,
+                          PlatformAssembler::FPScratchRegister);
+        pasm()->boxDoubleIntoAccumulator(PlatformAssembler::FPScratchRegister);
+    }, [this, instructionOffset]() {
+        deoptimize(instructionOffset);
+    });
+}
+
+void BaselineAssembler::speculativeDiv(int lhs, int instructionOffset)
+{
+    // Integer division rarely produces an integer, so always divide as double.
+    pasm()->numberBinop(regAddr(lhs), nullptr, [this]() {
+        pasm()->divDouble(PlatformAssembler::FPScratchRegister2,
+                          PlatformAssembler::FPScratchRegister);
+        pasm()->boxDoubleIntoAccumulator(PlatformAssembler::FPScratchRegister);
+    }, [this, instructionOffset]() {
+        deoptimize(instructionOffset);
+    });
+}
+
+void BaselineAssembler::speculativeCmp(int cond, int doubleCond, int lhs, int instructionOffset)
+{
+    auto c = static_cast<PlatformAssembler::RelationalCondition>(cond);
+    auto dc = static_cast<PlatformAssembler::DoubleCondition>(doubleCond);
+    pasm()->numberBinop(regAddr(lhs), [this, c]() {
+        pasm()->compare32(c, PlatformAssembler::ScratchRegister,
+                          PlatformAssembler::AccumulatorRegisterValue,
+                          PlatformAssembler::AccumulatorRegisterValue);
+        pasm()->setAccumulatorTag(QV4::Value::ValueTypeInternal::Boolean);
+        return PlatformAssembler::Jump();
+    }, [this, dc]() {
+        // The double conditions are all false for NaN operands, as required.
+        auto isTrue = pasm()->branchDouble(dc, PlatformAssembler::FPScratchRegister,
+                                           PlatformAssembler::FPScratchRegister2);
+        pasm()->loadValue(Encode(false));
+        auto done = pasm()->jump();
+        isTrue.link(pasm());
+        pasm()->loadValue(Encode(true));
+        done.link(pasm());
+    }, [this, instructionOffset]() {
+        deoptimize(instructionOffset);
+    });
+}
+
+void BaselineAssembler::speculativeCmpgt(int lhs, int instructionOffset)
+{
+    speculativeCmp(PlatformAssembler::GreaterThan, PlatformAssembler::DoubleGreaterThan,
+                   lhs, instructionOffset);
+}
+
+void BaselineAssembler::speculativeCmpge(int lhs, int instructionOffset)
+{
+    speculativeCmp(PlatformAssembler::GreaterThanOrEqual,
+                   PlatformAssembler::DoubleGreaterThanOrEqual, lhs, instructionOffset);
+}
+
+void BaselineAssembler::speculativeCmplt(int lhs, int instructionOffset)
+{
+    speculativeCmp(PlatformAssembler::LessThan, PlatformAssembler::DoubleLessThan,
+                   lhs, instructionOffset);
+}
+
+void BaselineAssembler::speculativeCmple(int lhs, int instructionOffset)
+{
+    speculativeCmp(PlatformAssembler::LessThanOrEqual, PlatformAssembler::DoubleLessThanOrEqual,
+                   lhs, instructionOffset);
+}
+
+void BaselineAssembler::getOwnPropertyLookup(int index, Lookup *lookup, int nextInstructionOffset)
+{
+    // Inline version of Lookup::getter0Inline and Lookup::getter0MemberData. The getter, the
+    // internal class and the offset are read from the lookup at run time, so the code stays
+    // correct when a miss updates the lookup.
+    Q_ASSERT(lookup->getter == Lookup::getter0Inline
+             || lookup->getter == Lookup::getter0MemberData);
+    const bool inMemberData = lookup->getter == Lookup::getter0MemberData;
+    Heap::Object object;
+    Heap::MemberData memberData;
+    Q_UNUSED(object);
+    Q_UNUSED(memberData);
+
+    PlatformAssembler::JumpList slowPath;
+    pasm()->move(TrustedImm64(Value::ManagedMask), PlatformAssembler::ScratchRegister);
+    slowPath.append(pasm()->branchTest64(PlatformAssembler::NonZero,
+                                         PlatformAssembler::AccumulatorRegister,
+                                         PlatformAssembler::ScratchRegister));
+    slowPath.append(pasm()->branchTest64(PlatformAssembler::Zero,
+                                         PlatformAssembler::AccumulatorRegister));
+
+    pasm()->move(TrustedImmPtr(lookup), PlatformAssembler::ScratchRegister);
+    slowPath.append(pasm()->branchPtr(PlatformAssembler::NotEqual,
+                                      Address(PlatformAssembler::ScratchRegister,
+                                              offsetof(Lookup, getter)),
+                                      TrustedImmPtr(reinterpret_cast<void *>(lookup->getter))));
+    pasm()->loadPtr(Address(PlatformAssembler::ScratchRegister, offsetof(Lookup, objectLookup.ic)),
+                    PlatformAssembler::ScratchRegister2);
+    slowPath.append(pasm()->branchPtr(PlatformAssembler::NotEqual,
+                                      Address(PlatformAssembler::AccumulatorRegister,
+                                              offsetof(Heap::Base, internalClass)),
+                                      PlatformAssembler::ScratchRegister2));
+
+    pasm()->load32(Address(PlatformAssembler::ScratchRegister,
+                           offsetof(Lookup, objectLookup.offset)),
+                   PlatformAssembler::ScratchRegister);
+    if (inMemberData) {
+        pasm()->loadPtr(Address(PlatformAssembler::AccumulatorRegister, object.memberData.offset),
+                        PlatformAssembler::AccumulatorRegister);
+        pasm()->load64(BaseIndex(PlatformAssembler::AccumulatorRegister,
+                                 PlatformAssembler::ScratchRegister, PlatformAssembler::TimesEight,
+                                 memberData.values.offset + offsetof(ValueArray<0>, values)),
+                       PlatformAssembler::AccumulatorRegister);
+    } else {
+        // The offset of inline properties already includes the object header.
+        pasm()->load64(BaseIndex(PlatformAssembler::AccumulatorRegister,
+                                 PlatformAssembler::ScratchRegister, PlatformAssembler::TimesEight),
+                       PlatformAssembler::AccumulatorRegister);
+    }
+    auto done = pasm()->jump();
+
+    slowPath.link(pasm());
+    getLookup(index, nextInstructionOffset);
+
+    done.link(pasm());
+}
+
+#else
+
+// The optimizing JIT is only enabled on 64bit platforms, see ExecutionEngine::canOptimize().
+void BaselineAssembler::speculativeInc(int) { inc(); }
+void BaselineAssembler::speculativeDec(int) { dec(); }
+void BaselineAssembler::speculativeAdd(int lhs, int) { add(lhs); }
+void BaselineAssembler::speculativeSub(int lhs, int) { sub(lhs); }
+void BaselineAssembler::speculativeMul(int lhs, int) { mul(lhs); }
+void BaselineAssembler::speculativeDiv(int lhs, int) { div(lhs); }
+void BaselineAssembler::speculativeCmpgt(int lhs, int) { cmpgt(lhs); }
+void BaselineAssembler::speculativeCmpge(int lhs, int) { cmpge(lhs); }
+void BaselineAssembler::speculativeCmplt(int lhs, int) { cmplt(lhs); }
+void BaselineAssembler::speculativeCmple(int lhs, int) { cmple(lhs); }
+
+void BaselineAssembler::getOwnPropertyLookup(int index, Lookup *, int nextInstructionOffset)
+{
+    getLookup(index, nextInstructionOffset);
+}
+
+#endif // QT_POINTER_SIZE == 8
+
 void BaselineAssembler::cmpeqNull()
 {
     pasm()->isNullOrUndefined();
@@ -1608,6 +1998,22 @@ void BaselineAssembler::ret()
     pasm()->generateFunctionExit();
 }
 
+QHash<const void *, const char *> BaselineAssembler::helperSymbolTable()
+{
+#define HELPER_SYMBOL(x) { reinterpret_cast<const void *>(&x), #x }
+    return {
+        HELPER_SYMBOL(Value::toBooleanImpl),
+        HELPER_SYMBOL(toNumberHelper),
+        HELPER_SYMBOL(toInt32Helper),
+        HELPER_SYMBOL(writeBarrierHelper),
+        HELPER_SYMBOL(incHelper),
+        HELPER_SYMBOL(decHelper),
+        HELPER_SYMBOL(deoptimizeHelper),
+        HELPER_SYMBOL(TheJitIs__Tail_Calling__ToTheRuntimeSoTheJitFrameIsMissing)
+    };
+#undef HELPER_SYMBOL
+}
+
 } // JIT namespace
 } // QV4 namepsace
 
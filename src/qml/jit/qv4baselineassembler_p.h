@@ -37,10 +37,14 @@ public:
     BaselineAssembler(const Value* constantTable);
     ~BaselineAssembler();
 
+    // The functions other than the runtime functions that the generated code calls.
+    static QHash<const void *, const char *> helperSymbolTable();
+
     // codegen infrastructure
     void generatePrologue();
     void generateEpilogue();
     void link(Function *function);
+    void linkOptimized(Function *function);
     void addLabel(int offset);
 
     // loads/stores/moves
@@ -81,6 +85,23 @@ public:
     void mod(int lhs);
     void sub(int lhs);
 
+    // speculative numeric ops, these resume in the interpreter at instructionOffset if
+    // an operand is not a number
+    void speculativeInc(int instructionOffset);
+    void speculativeDec(int instructionOffset);
+    void speculativeAdd(int lhs, int instructionOffset);
+    void speculativeSub(int lhs, int instructionOffset);
+    void speculativeMul(int lhs, int instructionOffset);
+    void speculativeDiv(int lhs, int instructionOffset);
+    void speculativeCmpgt(int lhs, int instructionOffset);
+    void speculativeCmpge(int lhs, int instructionOffset);
+    void speculativeCmplt(int lhs, int instructionOffset);
+    void speculativeCmple(int lhs, int instructionOffset);
+    void deoptimize(int instructionOffset);
+
+    // property lookups, inlined while the lookup keeps finding the same own property
+    void getOwnPropertyLookup(int index, Lookup *lookup, int nextInstructionOffset);
+
     // comparissons
     void cmpeqNull();
     void cmpneNull();
@@ -140,6 +161,8 @@ protected:
 private:
     typedef unsigned(*CmpFunc)(const Value&,const Value&);
     void cmp(int cond, CmpFunc function, int lhs);
+    void speculativeCmp(int cond, int doubleCond, int lhs, int instructionOffset);
+    void getLookup(int index, int nextInstructionOffset);
 };
 
 } // namespace JIT
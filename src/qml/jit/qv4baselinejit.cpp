@@ -273,6 +273,19 @@ void BaselineJIT::generate_GetOptionalLookup(int index, int offset)
     generate_GetLookup(index);
 }
 
+void BaselineJIT::generate_GetLookupFromReg(int index, int base)
+{
+    generate_LoadReg(base);
+    generate_GetLookup(index);
+}
+
+void BaselineJIT::generate_GetLookupFromRegToReg(int index, int base, int destReg)
+{
+    generate_LoadReg(base);
+    generate_GetLookup(index);
+    generate_StoreReg(destReg);
+}
+
 void BaselineJIT::generate_StoreProperty(int name, int base)
 {
     STORE_IP();
@@ -799,6 +812,81 @@ void BaselineJIT::generate_CmpLe(int lhs) { as->cmple(lhs); }
 void BaselineJIT::generate_CmpStrictEqual(int lhs) { as->cmpStrictEqual(lhs); }
 void BaselineJIT::generate_CmpStrictNotEqual(int lhs) { as->cmpStrictNotEqual(lhs); }
 
+// The fused compare-and-jump instructions still leave the result of the comparison in the
+// accumulator, as the code at the jump target may use it.
+
+void BaselineJIT::generate_CmpGtJumpTrue(int lhs, int offset)
+{
+    generate_CmpGt(lhs);
+    generate_JumpTrue(offset);
+}
+
+void BaselineJIT::generate_CmpGtJumpFalse(int lhs, int offset)
+{
+    generate_CmpGt(lhs);
+    generate_JumpFalse(offset);
+}
+
+void BaselineJIT::generate_CmpGeJumpTrue(int lhs, int offset)
+{
+    generate_CmpGe(lhs);
+    generate_JumpTrue(offset);
+}
+
+void BaselineJIT::generate_CmpGeJumpFalse(int lhs, int offset)
+{
+    generate_CmpGe(lhs);
+    generate_JumpFalse(offset);
+}
+
+void BaselineJIT::generate_CmpLtJumpTrue(int lhs, int offset)
+{
+    generate_CmpLt(lhs);
+    generate_JumpTrue(offset);
+}
+
+void BaselineJIT::generate_CmpLtJumpFalse(int lhs, int offset)
+{
+    generate_CmpLt(lhs);
+    generate_JumpFalse(offset);
+}
+
+void BaselineJIT::generate_CmpLeJumpTrue(int lhs, int offset)
+{
+    generate_CmpLe(lhs);
+    generate_JumpTrue(offset);
+}
+
+void BaselineJIT::generate_CmpLeJumpFalse(int lhs, int offset)
+{
+    generate_CmpLe(lhs);
+    generate_JumpFalse(offset);
+}
+
+void BaselineJIT::generate_CmpStrictEqualJumpTrue(int lhs, int offset)
+{
+    generate_CmpStrictEqual(lhs);
+    generate_JumpTrue(offset);
+}
+
+void BaselineJIT::generate_CmpStrictEqualJumpFalse(int lhs, int offset)
+{
+    generate_CmpStrictEqual(lhs);
+    generate_JumpFalse(offset);
+}
+
+void BaselineJIT::generate_CmpStrictNotEqualJumpTrue(int lhs, int offset)
+{
+    generate_CmpStrictNotEqual(lhs);
+    generate_JumpTrue(offset);
+}
+
+void BaselineJIT::generate_CmpStrictNotEqualJumpFalse(int lhs, int offset)
+{
+    generate_CmpStrictNotEqual(lhs);
+    generate_JumpFalse(offset);
+}
+
 void BaselineJIT::generate_CmpIn(int lhs)
 {
     STORE_IP();
@@ -838,6 +926,18 @@ void BaselineJIT::generate_Increment() { as->inc(); }
 void BaselineJIT::generate_Decrement() { as->dec(); }
 void BaselineJIT::generate_Add(int lhs) { as->add(lhs); }
 
+void BaselineJIT::generate_AddInt(int lhs, int value)
+{
+    generate_LoadInt(value);
+    generate_Add(lhs);
+}
+
+void BaselineJIT::generate_AddConst(int lhs, int index)
+{
+    generate_LoadConst(index);
+    generate_Add(lhs);
+}
+
 void BaselineJIT::generate_BitAnd(int lhs) { as->bitAnd(lhs); }
 void BaselineJIT::generate_BitOr(int lhs) { as->bitOr(lhs); }
 void BaselineJIT::generate_BitXor(int lhs) { as->bitXor(lhs); }
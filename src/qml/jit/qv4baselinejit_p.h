@@ -30,7 +30,7 @@ namespace JIT {
 
 class BaselineAssembler;
 
-class BaselineJIT final: public Moth::ByteCodeHandler
+class BaselineJIT : public Moth::ByteCodeHandler
 {
 public:
     BaselineJIT(QV4::Function *);
@@ -70,6 +70,8 @@ public:
     void generate_LoadOptionalProperty(int name, int offset) override;
     void generate_GetLookup(int index) override;
     void generate_GetOptionalLookup(int index, int offset) override;
+    void generate_GetLookupFromReg(int index, int base) override;
+    void generate_GetLookupFromRegToReg(int index, int base, int destReg) override;
     void generate_StoreProperty(int name, int base) override;
     void generate_SetLookup(int index, int base) override;
     void generate_LoadSuperProperty(int property) override;
@@ -142,6 +144,18 @@ public:
     void generate_CmpLe(int lhs) override;
     void generate_CmpStrictEqual(int lhs) override;
     void generate_CmpStrictNotEqual(int lhs) override;
+    void generate_CmpGtJumpTrue(int lhs, int offset) override;
+    void generate_CmpGtJumpFalse(int lhs, int offset) override;
+    void generate_CmpGeJumpTrue(int lhs, int offset) override;
+    void generate_CmpGeJumpFalse(int lhs, int offset) override;
+    void generate_CmpLtJumpTrue(int lhs, int offset) override;
+    void generate_CmpLtJumpFalse(int lhs, int offset) override;
+    void generate_CmpLeJumpTrue(int lhs, int offset) override;
+    void generate_CmpLeJumpFalse(int lhs, int offset) override;
+    void generate_CmpStrictEqualJumpTrue(int lhs, int offset) override;
+    void generate_CmpStrictEqualJumpFalse(int lhs, int offset) override;
+    void generate_CmpStrictNotEqualJumpTrue(int lhs, int offset) override;
+    void generate_CmpStrictNotEqualJumpFalse(int lhs, int offset) override;
     void generate_CmpIn(int lhs) override;
     void generate_CmpInstanceOf(int lhs) override;
     void generate_As(int lhs) override;
@@ -152,6 +166,8 @@ public:
     void generate_Increment() override;
     void generate_Decrement() override;
     void generate_Add(int lhs) override;
+    void generate_AddInt(int lhs, int value) override;
+    void generate_AddConst(int lhs, int index) override;
     void generate_BitAnd(int lhs) override;
     void generate_BitOr(int lhs) override;
     void generate_BitXor(int lhs) override;
@@ -176,7 +192,7 @@ public:
     Verdict startInstruction(Moth::Instr::Type instr) override;
     void endInstruction(Moth::Instr::Type instr) override;
 
-private:
+protected:
     QV4::Function *function;
     QScopedPointer<BaselineAssembler> as;
     QSet<int> labels;
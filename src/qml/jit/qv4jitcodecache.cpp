@@ -0,0 +1,386 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qv4jitcodecache_p.h"
+#include "qv4assemblercommon_p.h"
+#include "qv4baselineassembler_p.h"
+
+#include <private/qv4engine_p.h>
+#include <private/qv4executablecompilationunit_p.h>
+#include <private/qv4function_p.h>
+#include <private/qv4functiontable_p.h>
+#include <private/qv4runtimeapi_p.h>
+
+#include <QtQml/qqmlfile.h>
+
+#include <QtCore/qcryptographichash.h>
+#include <QtCore/qfile.h>
+#include <QtCore/qloggingcategory.h>
+
+#include <assembler/MacroAssemblerCodeRef.h>
+#include <assembler/LinkBuffer.h>
+
+#include <algorithm>
+
+#if QT_CONFIG(qml_jit)
+
+Q_DECLARE_LOGGING_CATEGORY(DBG_DISK_CACHE)
+
+QT_BEGIN_NAMESPACE
+
+namespace QV4 {
+namespace JIT {
+
+enum : quint32 { CodeCacheVersion = 1 };
+
+static const char codeCacheMagic[8] = { 'q', 'v', '4', 'j', 'i', 't', '\0', '\0' };
+
+namespace {
+
+struct FileHeader
+{
+    char magic[8];
+    quint32 version;
+    quint32 recordCount;
+    char libraryVersionHash[CompiledData::QmlCompileHashSpace];
+    char libraryLayout[20];     // SHA1 of the offsets of all functions the code may call
+    char unitChecksum[16];      // copied from the compilation unit
+    quint32 unitSize;
+    quint32 payloadSize;
+    char payloadChecksum[20];   // SHA1 of everything following the header
+};
+
+struct RecordHeader
+{
+    quint32 functionIndex;
+    quint32 codeSize;
+    quint32 relocationCount;
+    quint16 byteCodeChecksum;
+    quint16 unused;
+};
+
+// Followed by the code and the relocations, each padded to 8 bytes.
+static_assert(sizeof(RecordHeader) % 8 == 0);
+static_assert(sizeof(CodeCache::Relocation) == 16);
+
+} // anonymous namespace
+
+static quint32 paddedSize(quint32 size)
+{
+    return (size + 7) & ~quint32(7);
+}
+
+static quintptr libraryAnchor()
+{
+    return reinterpret_cast<quintptr>(&Runtime::symbolTable);
+}
+
+// All functions the generated code may call: the runtime functions and the helpers of the
+// baseline assembler. Code calling anything else is not cached.
+static const QHash<const void *, const char *> &relocationTargets()
+{
+    static const QHash<const void *, const char *> targets = []() {
+        QHash<const void *, const char *> targets = Runtime::symbolTable();
+        targets.insert(BaselineAssembler::helperSymbolTable());
+        return targets;
+    }();
+    return targets;
+}
+
+// The code refers to the functions it calls by their offset from a known symbol in the
+// library. This is only valid for the exact same build of the library. The compile hash does not
+// change for local modifications, so we additionally hash the positions of all possible targets.
+static QByteArray libraryLayout()
+{
+    static const QByteArray layout = []() {
+        const QHash<const void *, const char *> &symbols = relocationTargets();
+        std::vector<std::pair<QByteArray, qint64>> offsets;
+        offsets.reserve(symbols.size());
+        for (auto it = symbols.cbegin(), end = symbols.cend(); it != end; ++it)
+            offsets.emplace_back(QByteArray(it.value()), CodeCache::libraryOffset(it.key()));
+        std::sort(offsets.begin(), offsets.end());
+
+        QCryptographicHash hash(QCryptographicHash::Sha1);
+        for (const auto &offset : offsets) {
+            hash.addData(offset.first);
+            hash.addData(QByteArrayView(reinterpret_cast<const char *>(&offset.second),
+                                        sizeof(offset.second)));
+        }
+        return hash.result();
+    }();
+    return layout;
+}
+
+static QByteArray payloadChecksum(QByteArrayView payload)
+{
+    return QCryptographicHash::hash(payload, QCryptographicHash::Sha1);
+}
+
+static quint16 byteCodeChecksum(const Function *function)
+{
+    return qChecksum(QByteArrayView(function->codeData, function->compiledFunction->codeSize));
+}
+
+#ifdef QV4_JIT_RELOCATABLE_CODE
+static bool installCode(Function *function, const char *code, quint32 codeSize,
+                        const char *relocations, quint32 relocationCount)
+{
+    using Assembler = PlatformAssemblerBase::AssemblerType_T;
+
+    std::vector<CodeCache::Relocation> patches(relocationCount);
+    if (relocationCount)
+        memcpy(patches.data(), relocations, relocationCount * sizeof(CodeCache::Relocation));
+    for (const CodeCache::Relocation &relocation : patches) {
+        if (relocation.offset < sizeof(void *) || relocation.offset > codeSize)
+            return false;
+    }
+
+    JSC::JSGlobalData globalData(function->internalClass->engine->executableAllocator);
+    RefPtr<JSC::ExecutableMemoryHandle> memory = globalData.executableAllocator.allocate(
+            globalData, codeSize, nullptr, JSC::JITCompilationCanFail);
+    if (!memory || !JSC::ExecutableAllocator::makeWritable(memory.get()))
+        return false;
+
+    // Code addresses refer to where the code runs, not to where we write it.
+    char *codeStart = static_cast<char *>(memory->codeStart());
+    char *writableCodeStart = static_cast<char *>(memory->writableCodeStart());
+    memcpy(writableCodeStart, code, codeSize);
+
+    for (const CodeCache::Relocation &relocation : patches) {
+        const quintptr base = relocation.kind == CodeCache::Relocation::LibraryAddress
+                ? libraryAnchor()
+                : reinterpret_cast<quintptr>(codeStart);
+        Assembler::repatchPointer(writableCodeStart + relocation.offset,
+                                  reinterpret_cast<void *>(base + relocation.target));
+    }
+    Assembler::cacheFlush(writableCodeStart, codeSize);
+    if (writableCodeStart != codeStart)
+        Assembler::cacheFlush(codeStart, codeSize);
+
+    JSC::ExecutableMemoryHandle *handle = memory.get();
+    auto codeRef = new JSC::MacroAssemblerCodeRef(memory.release());
+
+    function->codeRef = codeRef;
+    function->jittedCode = reinterpret_cast<Function::JittedCode>(
+            codeRef->code().executableAddress());
+
+    generateFunctionTable(function, codeRef);
+
+    if (Q_UNLIKELY(!JSC::ExecutableAllocator::makeExecutable(handle))) {
+        function->jittedCode = nullptr; // The function is not executable, but the coderef exists.
+    }
+
+    return true;
+}
+#endif
+
+bool CodeCache::isReadEnabled(ExecutionEngine *engine)
+{
+#ifdef QV4_JIT_RELOCATABLE_CODE
+    static const bool forceInterpreter = qEnvironmentVariableIsSet("QV4_FORCE_INTERPRETER");
+    return !forceInterpreter && engine->canJIT()
+            && (engine->diskCacheOptions() & ExecutionEngine::DiskCache::JitRead);
+#else
+    Q_UNUSED(engine);
+    return false;
+#endif
+}
+
+bool CodeCache::isWriteEnabled(ExecutionEngine *engine)
+{
+#ifdef QV4_JIT_RELOCATABLE_CODE
+    return engine->diskCacheOptions() & ExecutionEngine::DiskCache::JitWrite;
+#else
+    Q_UNUSED(engine);
+    return false;
+#endif
+}
+
+qint64 CodeCache::libraryOffset(const void *address)
+{
+    return qint64(reinterpret_cast<quintptr>(address) - libraryAnchor());
+}
+
+bool CodeCache::isRelocationTarget(const void *address)
+{
+    return relocationTargets().contains(address);
+}
+
+QByteArray CodeCache::createRecord(const Function *function, const char *code, quint32 codeSize,
+                                   const std::vector<Relocation> &relocations)
+{
+    const ExecutableCompilationUnit *unit = function->executableCompilationUnit();
+
+    RecordHeader header;
+    header.functionIndex = quint32(std::find(unit->runtimeFunctions.cbegin(),
+                                             unit->runtimeFunctions.cend(), function)
+                                   - unit->runtimeFunctions.cbegin());
+    header.codeSize = codeSize;
+    header.relocationCount = quint32(relocations.size());
+    header.byteCodeChecksum = byteCodeChecksum(function);
+    header.unused = 0;
+
+    QByteArray record(sizeof(RecordHeader) + paddedSize(codeSize)
+                      + relocations.size() * sizeof(Relocation), Qt::Uninitialized);
+    char *data = record.data();
+    memcpy(data, &header, sizeof(header));
+    data += sizeof(header);
+
+    memcpy(data, code, codeSize);
+    memset(data + codeSize, 0, paddedSize(codeSize) - codeSize);
+
+    // The pointers are patched on load. Clear them, so that the record doesn't contain any
+    // addresses of this process.
+    for (const Relocation &relocation : relocations) {
+        Q_ASSERT(relocation.offset >= sizeof(void *) && relocation.offset <= codeSize);
+        memset(data + relocation.offset - sizeof(void *), 0, sizeof(void *));
+    }
+    data += paddedSize(codeSize);
+
+    if (!relocations.empty())
+        memcpy(data, relocations.data(), relocations.size() * sizeof(Relocation));
+
+    return record;
+}
+
+QString CodeCache::cacheFilePath(const ExecutableCompilationUnit *unit)
+{
+    const QUrl url = unit->url();
+    if (!QQmlFile::isLocalFile(url))
+        return QString();
+    return ExecutableCompilationUnit::localCacheFilePath(url) + QLatin1String(".jit");
+}
+
+static bool validateHeader(const FileHeader &header, const ExecutableCompilationUnit *unit,
+                           QByteArrayView payload)
+{
+    const CompiledData::Unit *data = unit->unitData();
+    return memcmp(header.magic, codeCacheMagic, sizeof(codeCacheMagic)) == 0
+            && header.version == CodeCacheVersion
+            && memcmp(header.libraryVersionHash, data->libraryVersionHash,
+                      sizeof(header.libraryVersionHash)) == 0
+            && QByteArrayView(header.libraryLayout, sizeof(header.libraryLayout))
+                    == libraryLayout()
+            && memcmp(header.unitChecksum, data->md5Checksum, sizeof(header.unitChecksum)) == 0
+            && header.unitSize == data->unitSize
+            && header.payloadSize == quint32(payload.size())
+            && QByteArrayView(header.payloadChecksum, sizeof(header.payloadChecksum))
+                    == payloadChecksum(payload);
+}
+
+int CodeCache::load(ExecutableCompilationUnit *unit)
+{
+#ifdef QV4_JIT_RELOCATABLE_CODE
+    const QString path = cacheFilePath(unit);
+    if (path.isEmpty())
+        return 0;
+
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+        return 0;
+
+    const QByteArray contents = file.readAll();
+    if (contents.size() < qsizetype(sizeof(FileHeader)))
+        return 0;
+
+    FileHeader header;
+    memcpy(&header, contents.constData(), sizeof(header));
+    const QByteArrayView payload = QByteArrayView(contents).sliced(sizeof(header));
+    if (!validateHeader(header, unit, payload)) {
+        qCDebug(DBG_DISK_CACHE) << "Ignoring stale JIT code cache" << path;
+        return 0;
+    }
+
+    const bool keepRecords = isWriteEnabled(unit->engine);
+    int loaded = 0;
+    qsizetype position = 0;
+    for (quint32 i = 0; i < header.recordCount; ++i) {
+        if (payload.size() - position < qsizetype(sizeof(RecordHeader)))
+            break;
+
+        RecordHeader record;
+        memcpy(&record, payload.data() + position, sizeof(record));
+        const qsizetype recordSize = sizeof(RecordHeader) + paddedSize(record.codeSize)
+                + qsizetype(record.relocationCount) * sizeof(Relocation);
+        if (payload.size() - position < recordSize)
+            break;
+
+        const char *code = payload.data() + position + sizeof(RecordHeader);
+        const char *relocations = code + paddedSize(record.codeSize);
+        position += recordSize;
+
+        if (record.functionIndex >= quint32(unit->runtimeFunctions.size()))
+            continue;
+
+        Function *function = unit->runtimeFunctions[record.functionIndex];
+        if (!function || function->kind == Function::AotCompiled || function->isGenerator()
+                || function->codeRef || byteCodeChecksum(function) != record.byteCodeChecksum) {
+            continue;
+        }
+
+        if (installCode(function, code, record.codeSize, relocations, record.relocationCount)) {
+            // Keep the record, so that the cache stays complete when it's written again.
+            if (keepRecords) {
+                function->jitCacheRecord = payload.sliced(position - recordSize, recordSize)
+                        .toByteArray();
+            }
+            ++loaded;
+        }
+    }
+
+    qCDebug(DBG_DISK_CACHE) << "Loaded" << loaded << "functions from JIT code cache" << path;
+    return loaded;
+#else
+    Q_UNUSED(unit);
+    return 0;
+#endif
+}
+
+bool CodeCache::save(const ExecutableCompilationUnit *unit, QString *errorString)
+{
+    QByteArray payload;
+    quint32 recordCount = 0;
+    for (const Function *function : unit->runtimeFunctions) {
+        if (function && !function->jitCacheRecord.isEmpty()) {
+            payload += function->jitCacheRecord;
+            ++recordCount;
+        }
+    }
+
+    // Nothing was compiled since the cache was loaded.
+    if (recordCount == quint32(unit->cachedJitFunctionCount)) {
+        errorString->clear();
+        return true;
+    }
+
+    const QString path = cacheFilePath(unit);
+    if (path.isEmpty()) {
+        *errorString = QStringLiteral("File has to be a local file.");
+        return false;
+    }
+
+    const CompiledData::Unit *data = unit->unitData();
+    FileHeader header;
+    memcpy(header.magic, codeCacheMagic, sizeof(header.magic));
+    header.version = CodeCacheVersion;
+    header.recordCount = recordCount;
+    memcpy(header.libraryVersionHash, data->libraryVersionHash, sizeof(header.libraryVersionHash));
+    const QByteArray layout = libraryLayout();
+    memcpy(header.libraryLayout, layout.constData(), sizeof(header.libraryLayout));
+    memcpy(header.unitChecksum, data->md5Checksum, sizeof(header.unitChecksum));
+    header.unitSize = data->unitSize;
+    header.payloadSize = quint32(payload.size());
+    const QByteArray checksum = payloadChecksum(payload);
+    memcpy(header.payloadChecksum, checksum.constData(), sizeof(header.payloadChecksum));
+
+    payload.prepend(reinterpret_cast<const char *>(&header), sizeof(header));
+    return CompiledData::SaveableUnitPointer::writeDataToFile(
+            path, payload.constData(), quint32(payload.size()), errorString);
+}
+
+} // namespace JIT
+} // namespace QV4
+
+QT_END_NAMESPACE
+
+#endif // QT_CONFIG(qml_jit)
@@ -0,0 +1,77 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QV4JITCODECACHE_P_H
+#define QV4JITCODECACHE_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <private/qv4global_p.h>
+
+#include <QtCore/qbytearray.h>
+#include <QtCore/qstring.h>
+
+#include <vector>
+
+#if QT_CONFIG(qml_jit)
+
+QT_BEGIN_NAMESPACE
+
+namespace QV4 {
+
+class ExecutableCompilationUnit;
+
+namespace JIT {
+
+// Stores the code generated by the baseline JIT next to the disk cache file of a compilation
+// unit, so that a later run of the same program doesn't have to interpret and JIT-compile its
+// hot functions again. All absolute addresses in the code are recorded as relocations and
+// patched when the code is loaded. The cache is only used if the compilation unit, its byte
+// code, and the layout of the QtQml library all match what the code was generated for.
+// Otherwise the functions are interpreted and JIT-compiled as usual.
+class CodeCache
+{
+public:
+    struct Relocation
+    {
+        enum Kind : quint32 {
+            LibraryAddress, // target is relative to the QtQml library
+            CodeAddress     // target is relative to the start of the code
+        };
+
+        quint32 offset; // location of the patchable pointer, as a DataLabelPtr
+        Kind kind;
+        qint64 target;
+    };
+
+    static bool isReadEnabled(ExecutionEngine *engine);
+    static bool isWriteEnabled(ExecutionEngine *engine);
+
+    static qint64 libraryOffset(const void *address);
+    static bool isRelocationTarget(const void *address);
+
+    static QByteArray createRecord(const Function *function, const char *code, quint32 codeSize,
+                                   const std::vector<Relocation> &relocations);
+
+    static QString cacheFilePath(const ExecutableCompilationUnit *unit);
+    static int load(ExecutableCompilationUnit *unit);
+    static bool save(const ExecutableCompilationUnit *unit, QString *errorString);
+};
+
+} // namespace JIT
+} // namespace QV4
+
+QT_END_NAMESPACE
+
+#endif // QT_CONFIG(qml_jit)
+
+#endif // QV4JITCODECACHE_P_H
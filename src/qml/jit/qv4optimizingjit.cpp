@@ -0,0 +1,177 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qv4optimizingjit_p.h"
+#include "qv4baselineassembler_p.h"
+#include <private/qv4executablecompilationunit_p.h>
+#include <private/qv4lookup_p.h>
+
+#if QT_CONFIG(qml_jit)
+
+QT_USE_NAMESPACE
+using namespace QV4;
+using namespace QV4::JIT;
+using namespace QV4::Moth;
+
+OptimizingJIT::OptimizingJIT(Function *function)
+    : BaselineJIT(function)
+{}
+
+OptimizingJIT::~OptimizingJIT()
+{}
+
+void OptimizingJIT::generate()
+{
+    const char *code = function->codeData;
+    uint len = function->compiledFunction->codeSize;
+
+    for (unsigned i = 0, ei = function->compiledFunction->nLabelInfos; i != ei; ++i)
+        labels.insert(int(function->compiledFunction->labelInfoTable()[i]));
+
+    as->generatePrologue();
+    // Make sure the ACC register is initialized and not clobbered by the caller.
+    as->loadAccumulatorFromFrame();
+    decode(code, len);
+
+    if (!canDeoptimize) {
+        // Drop the code, and don't try again.
+        function->optimizationDisabled = true;
+        return;
+    }
+
+    as->generateEpilogue();
+    as->linkOptimized(function);
+}
+
+void OptimizingJIT::generate_SetUnwindHandler(int offset)
+{
+    canDeoptimize = false;
+    BaselineJIT::generate_SetUnwindHandler(offset);
+}
+
+void OptimizingJIT::generate_UnwindDispatch()
+{
+    canDeoptimize = false;
+    BaselineJIT::generate_UnwindDispatch();
+}
+
+void OptimizingJIT::generate_UnwindToLabel(int level, int offset)
+{
+    canDeoptimize = false;
+    BaselineJIT::generate_UnwindToLabel(level, offset);
+}
+
+void OptimizingJIT::generate_CmpGt(int lhs)
+{
+    as->speculativeCmpgt(lhs, currentInstructionOffset());
+}
+
+void OptimizingJIT::generate_CmpGe(int lhs)
+{
+    as->speculativeCmpge(lhs, currentInstructionOffset());
+}
+
+void OptimizingJIT::generate_CmpLt(int lhs)
+{
+    as->speculativeCmplt(lhs, currentInstructionOffset());
+}
+
+void OptimizingJIT::generate_CmpLe(int lhs)
+{
+    as->speculativeCmple(lhs, currentInstructionOffset());
+}
+
+void OptimizingJIT::generate_Increment()
+{
+    as->speculativeInc(currentInstructionOffset());
+}
+
+void OptimizingJIT::generate_Decrement()
+{
+    as->speculativeDec(currentInstructionOffset());
+}
+
+void OptimizingJIT::generate_Add(int lhs)
+{
+    as->speculativeAdd(lhs, currentInstructionOffset());
+}
+
+void OptimizingJIT::generate_Mul(int lhs)
+{
+    as->speculativeMul(lhs, currentInstructionOffset());
+}
+
+void OptimizingJIT::generate_Div(int lhs)
+{
+    as->speculativeDiv(lhs, currentInstructionOffset());
+}
+
+void OptimizingJIT::generate_Sub(int lhs)
+{
+    as->speculativeSub(lhs, currentInstructionOffset());
+}
+
+void OptimizingJIT::generate_LoadReg(int reg)
+{
+    if (reg == accumulatorRegister)
+        return;
+    BaselineJIT::generate_LoadReg(reg);
+    accumulatorRegister = reg;
+}
+
+void OptimizingJIT::generate_StoreReg(int reg)
+{
+    BaselineJIT::generate_StoreReg(reg);
+    accumulatorRegister = reg;
+}
+
+void OptimizingJIT::generate_MoveReg(int srcReg, int destReg)
+{
+    BaselineJIT::generate_MoveReg(srcReg, destReg);
+    if (destReg == accumulatorRegister)
+        accumulatorRegister = -1;
+}
+
+void OptimizingJIT::generate_MoveConst(int constIndex, int destTemp)
+{
+    BaselineJIT::generate_MoveConst(constIndex, destTemp);
+    if (destTemp == accumulatorRegister)
+        accumulatorRegister = -1;
+}
+
+void OptimizingJIT::generate_GetLookup(int index)
+{
+    // By now the interpreter and the baseline code have run the lookup often enough for its
+    // getter to tell us what kind of objects it sees.
+    Lookup *l = function->executableCompilationUnit()->runtimeLookups + index;
+    if (l->getter == Lookup::getter0Inline || l->getter == Lookup::getter0MemberData)
+        as->getOwnPropertyLookup(index, l, nextInstructionOffset());
+    else
+        BaselineJIT::generate_GetLookup(index);
+}
+
+ByteCodeHandler::Verdict OptimizingJIT::startInstruction(Instr::Type instr)
+{
+    // Other code can jump here with anything in the accumulator.
+    if (labels.contains(currentInstructionOffset()))
+        accumulatorRegister = -1;
+    return BaselineJIT::startInstruction(instr);
+}
+
+void OptimizingJIT::endInstruction(Instr::Type instr)
+{
+    switch (Instr::narrowInstructionType(instr)) {
+    case Instr::Type::LoadReg:
+    case Instr::Type::StoreReg:
+    case Instr::Type::MoveReg:
+    case Instr::Type::MoveConst:
+        break;
+    default:
+        // Everything else may change the accumulator or the JS registers.
+        accumulatorRegister = -1;
+        break;
+    }
+    BaselineJIT::endInstruction(instr);
+}
+
+#endif // QT_CONFIG(qml_jit)
@@ -0,0 +1,82 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QV4OPTIMIZINGJIT_P_H
+#define QV4OPTIMIZINGJIT_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <private/qv4baselinejit_p.h>
+
+#if QT_CONFIG(qml_jit)
+
+QT_BEGIN_NAMESPACE
+
+namespace QV4 {
+namespace JIT {
+
+// Second JIT tier for functions that keep running in the baseline JIT. It speculates that
+// arithmetic and relational operators only ever see numbers, and keeps doubles unboxed in
+// FP registers within an instruction instead of calling into the runtime. If an operand turns
+// out not to be a number, the function deoptimizes: the interpreter takes over at the
+// offending instruction, and further calls run the baseline code again.
+//
+// Property lookups that have only ever found the same own property of objects with one internal
+// class are compiled into a guarded inline load, with the runtime lookup as the fallback.
+// Within a basic block, the tier remembers which JS register the accumulator register holds,
+// and doesn't reload it from the stack frame.
+class OptimizingJIT final : public BaselineJIT
+{
+public:
+    OptimizingJIT(QV4::Function *);
+    ~OptimizingJIT() override;
+
+    void generate();
+
+    void generate_SetUnwindHandler(int offset) override;
+    void generate_UnwindDispatch() override;
+    void generate_UnwindToLabel(int level, int offset) override;
+    void generate_CmpGt(int lhs) override;
+    void generate_CmpGe(int lhs) override;
+    void generate_CmpLt(int lhs) override;
+    void generate_CmpLe(int lhs) override;
+    void generate_Increment() override;
+    void generate_Decrement() override;
+    void generate_Add(int lhs) override;
+    void generate_Mul(int lhs) override;
+    void generate_Div(int lhs) override;
+    void generate_Sub(int lhs) override;
+    void generate_LoadReg(int reg) override;
+    void generate_StoreReg(int reg) override;
+    void generate_MoveReg(int srcReg, int destReg) override;
+    void generate_MoveConst(int constIndex, int destTemp) override;
+    void generate_GetLookup(int index) override;
+
+    Verdict startInstruction(Moth::Instr::Type instr) override;
+    void endInstruction(Moth::Instr::Type instr) override;
+
+private:
+    // The interpreter can only take over if no unwind handlers are installed in the JIT'ed frame.
+    bool canDeoptimize = true;
+
+    // The JS register that holds the same value as the accumulator register, or -1.
+    int accumulatorRegister = -1;
+};
+
+} // namespace JIT
+} // namespace QV4
+
+QT_END_NAMESPACE
+
+#endif // QT_CONFIG(qml_jit)
+
+#endif // QV4OPTIMIZINGJIT_P_H
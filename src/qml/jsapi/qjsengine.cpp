@@ -8,6 +8,7 @@
 
 #include "private/qv4engine_p.h"
 #include "private/qv4mm_p.h"
+#include "private/qv4heapsnapshot_p.h"
 #include "private/qv4errorobject_p.h"
 #include "private/qv4globalobject_p.h"
 #include "private/qv4script_p.h"
@@ -397,6 +398,34 @@ void QJSEngine::collectGarbage()
     m_v4Engine->memoryManager->runGC();
 }
 
+/*!
+    \since 6.6
+
+    Runs the garbage collector and writes a snapshot of all remaining JavaScript objects
+    to the file \a fileName. Returns \c true on success.
+
+    The snapshot records every object together with its size and the references between the
+    objects. QObjects exposed to JavaScript are included as native objects, referenced by
+    their wrappers. The file uses the \c .heapsnapshot format of the Chrome DevTools, so
+    that it can be loaded into their memory panel, or into other tools that read this
+    format, to find out which objects keep others alive.
+
+    This function has to be called from the thread the engine lives in. It fails if it is
+    called from within the garbage collector, for example from a destructor.
+
+    \sa collectGarbage()
+*/
+bool QJSEngine::writeHeapSnapshot(const QString &fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning("QJSEngine: Cannot open %s for writing the heap snapshot: %s",
+                 qPrintable(fileName), qPrintable(file.errorString()));
+        return false;
+    }
+    return QV4::HeapSnapshot::write(m_v4Engine, &file);
+}
+
 /*!
     \since 5.6
 
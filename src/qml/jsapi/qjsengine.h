@@ -271,6 +271,7 @@ public:
     }
 
     void collectGarbage();
+    bool writeHeapSnapshot(const QString &fileName);
 
     enum ObjectOwnership { CppOwnership, JavaScriptOwnership };
     static void setObjectOwnership(QObject *, ObjectOwnership);
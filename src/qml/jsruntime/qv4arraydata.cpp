@@ -9,6 +9,9 @@
 #include "qv4string_p.h"
 #include "qv4jscall_p.h"
 
+#include <charconv>
+#include <string_view>
+
 using namespace QV4;
 
 DEFINE_MANAGED_VTABLE(ArrayData);
@@ -95,10 +98,14 @@ void ArrayData::realloc(Object *o, Type newType, uint requested, bool enforceAtt
         n->init();
         n->offset = 0;
         n->values.size = d ? d->d()->values.size : 0;
+        n->elementKind = !d ? Heap::ArrayData::PackedInt32
+                            : d->type() == Heap::ArrayData::Simple ? d->d()->elementKind
+                                                                   : Heap::ArrayData::Generic;
         newData = n;
     } else {
         Heap::SparseArrayData *n = scope.engine->memoryManager->allocManaged<SparseArrayData>(size);
         n->init();
+        n->elementKind = Heap::ArrayData::Generic;
         newData = n;
     }
     newData->setAlloc(alloc);
@@ -193,6 +200,8 @@ bool SimpleArrayData::put(Object *o, uint index, const Value &value)
     Q_ASSERT(index >= dd->values.size || !dd->attrs || !dd->attrs[index].isAccessor());
     // ### honour attributes
     dd->setData(o->engine(), index, value);
+    if (index > dd->values.size)
+        dd->elementKind = Heap::ArrayData::Generic;
     if (index >= dd->values.size) {
         if (dd->attrs)
             dd->attrs[index] = Attr_Data;
@@ -693,7 +702,7 @@ void ArrayData::sort(ExecutionEngine *engine, Object *thisObject, const Value &c
             len = d->values.size;
 
         // sort empty values to the end
-        for (uint i = 0; i < len; i++) {
+        for (uint i = d->isPacked() ? len : 0; i < len; i++) {
             if (d->data(i).isEmpty()) {
                 while (--len > i)
                     if (!d->data(len).isEmpty())
@@ -709,10 +718,21 @@ void ArrayData::sort(ExecutionEngine *engine, Object *thisObject, const Value &c
     }
 
 
-    ArrayElementLessThan lessThan(engine, comparefn);
-
     Value *begin = thisObject->arrayData()->values.values;
-    sortHelper(begin, begin + len, lessThan);
+    if (comparefn.isUndefined() && thisObject->d()->arrayData->elementKind == Heap::ArrayData::PackedInt32) {
+        // Without a compare function the elements are ordered by their string representation.
+        // For integers we can produce that without allocating any strings.
+        sortHelper(begin, begin + len, [](Value v1, Value v2) {
+            char s1[12];
+            char s2[12];
+            const char *e1 = std::to_chars(s1, s1 + sizeof s1, v1.int_32()).ptr;
+            const char *e2 = std::to_chars(s2, s2 + sizeof s2, v2.int_32()).ptr;
+            return std::string_view(s1, e1 - s1) < std::string_view(s2, e2 - s2);
+        });
+    } else {
+        ArrayElementLessThan lessThan(engine, comparefn);
+        sortHelper(begin, begin + len, lessThan);
+    }
 
 #ifdef CHECK_SPARSE_ARRAYS
     thisObject->initSparseArray();
@@ -56,7 +56,7 @@ namespace Heap {
 
 #define ArrayDataMembers(class, Member) \
     Member(class, NoMark, ushort, type) \
-    Member(class, NoMark, ushort, unused) \
+    Member(class, NoMark, ushort, elementKind) \
     Member(class, NoMark, uint, offset) \
     Member(class, NoMark, PropertyAttributes *, attrs) \
     Member(class, NoMark, SparseArray *, sparse) \
@@ -67,7 +67,18 @@ DECLARE_HEAP_OBJECT(ArrayData, Base) {
 
     enum Type { Simple = 0, Sparse = 1, Custom = 2 };
 
+    // What is known about the elements of a simple array: PackedInt32 and PackedDouble
+    // mean that there are no holes below values.size, and that all elements are integers or
+    // numbers, respectively. Transitions only go towards Generic.
+    enum ElementKind { PackedInt32 = 0, PackedDouble = 1, Generic = 2 };
+
     bool isSparse() const { return type == Sparse; }
+    bool isPacked() const { return elementKind != Generic; }
+
+    void noteElement(Value v) {
+        if (elementKind != Generic && !v.isInteger())
+            elementKind = v.isDouble() ? PackedDouble : Generic;
+    }
 
     const ArrayVTable *vtable() const { return reinterpret_cast<const ArrayVTable *>(internalClass->vtable); }
 
@@ -88,6 +99,7 @@ DECLARE_HEAP_OBJECT(ArrayData, Base) {
     }
 
     void setArrayData(EngineBase *e, uint index, Value newVal) {
+        noteElement(newVal);
         values.set(e, index, newVal);
     }
 
@@ -99,6 +111,7 @@ struct SimpleArrayData : public ArrayData {
     uint mappedIndex(uint index) const { index += offset; if (index >= values.alloc) index -= values.alloc; return index; }
     const Value &data(uint index) const { return values[mappedIndex(index)]; }
     void setData(EngineBase *e, uint index, Value newVal) {
+        noteElement(newVal);
         values.set(e, mappedIndex(index), newVal);
     }
 
@@ -332,6 +345,7 @@ void ArrayData::setProperty(QV4::EngineBase *e, uint index, const Property *p)
 {
     uint mapped = mappedIndex(index);
     Q_ASSERT(mapped != UINT_MAX);
+    noteElement(p->value);
     values.set(e, mapped, p->value);
     if (attributes(index).isAccessor())
         values.set(e, mapped + 1 /*QV4::Object::SetterOffset*/, p->set);
@@ -126,6 +126,19 @@ ReturnedValue ArrayPrototype::method_isArray(const FunctionObject *, const Value
     return Encode(argv->objectValue()->isArray());
 }
 
+// Reads element k directly if the object is an array without holes below its array data size.
+// Such an element always exists and doesn't have to be looked up through the prototype chain.
+static inline bool getPackedElement(const Object *o, uint k, Value *value)
+{
+    if (!o->isArrayObject())
+        return false;
+    const Heap::ArrayData *d = o->d()->arrayData;
+    if (!d || d->type != Heap::ArrayData::Simple || !d->isPacked() || k >= d->values.size)
+        return false;
+    *value = static_cast<const Heap::SimpleArrayData *>(d)->data(k);
+    return true;
+}
+
 static ScopedObject createObjectFromCtorOrArray(Scope &scope, ScopedFunctionObject ctor, bool useLen, int len)
 {
     ScopedObject a(scope, Value::undefinedValue());
@@ -1089,6 +1102,25 @@ ReturnedValue ArrayPrototype::method_indexOf(const FunctionObject *b, const Valu
         Heap::SimpleArrayData *sa = instance->d()->arrayData.cast<Heap::SimpleArrayData>();
         if (len > sa->values.size)
             len = sa->values.size;
+        if (sa->isPacked()) {
+            // Only numbers can be strictly equal to the elements of a packed array.
+            if (!searchValue->isNumber())
+                return Encode(-1);
+            if (sa->elementKind == Heap::ArrayData::PackedInt32 && searchValue->isInteger()) {
+                const int needle = searchValue->int_32();
+                for (uint idx = fromIndex; idx < len; ++idx) {
+                    if (sa->data(idx).int_32() == needle)
+                        return Encode(idx);
+                }
+            } else {
+                const double needle = searchValue->asDouble();
+                for (uint idx = fromIndex; idx < len; ++idx) {
+                    if (sa->data(idx).asDouble() == needle)
+                        return Encode(idx);
+                }
+            }
+            return Encode(-1);
+        }
         uint idx = fromIndex;
         while (idx < len) {
             value = sa->data(idx);
@@ -1321,10 +1353,12 @@ ReturnedValue ArrayPrototype::method_map(const FunctionObject *b, const Value *t
     Value *arguments = scope.alloc(3);
 
     for (uint k = 0; k < len; ++k) {
-        bool exists;
-        arguments[0] = instance->get(k, &exists);
-        if (!exists)
-            continue;
+        if (!getPackedElement(instance, k, arguments)) {
+            bool exists;
+            arguments[0] = instance->get(k, &exists);
+            if (!exists)
+                continue;
+        }
 
         arguments[1] = Value::fromDouble(k);
         arguments[2] = instance;
@@ -1408,8 +1442,9 @@ ReturnedValue ArrayPrototype::method_reduce(const FunctionObject *b, const Value
     Value *arguments = scope.alloc(4);
 
     while (k < len) {
-        bool kPresent;
-        v = instance->get(k, &kPresent);
+        bool kPresent = getPackedElement(instance, k, v);
+        if (!kPresent)
+            v = instance->get(k, &kPresent);
         if (kPresent) {
             arguments[0] = acc;
             arguments[1] = v;
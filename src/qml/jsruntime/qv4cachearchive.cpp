@@ -0,0 +1,264 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qv4cachearchive_p.h"
+
+#include <private/qv4compileddata_p.h>
+
+#include <QtCore/qdir.h>
+#include <QtCore/qendian.h>
+#include <QtCore/qfile.h>
+#include <QtCore/qfileinfo.h>
+#include <QtCore/qloggingcategory.h>
+
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <vector>
+
+QT_BEGIN_NAMESPACE
+
+Q_DECLARE_LOGGING_CATEGORY(DBG_DISK_CACHE)
+
+using namespace QV4;
+
+namespace {
+
+// An archive starts with the header, followed by the index entries sorted by path hash, the
+// UTF-8 encoded relative paths of the source files, and the units. All numbers are little endian.
+struct ArchiveHeader
+{
+    char magic[8];
+    quint32_le version;
+    quint32_le entryCount;
+};
+static_assert(sizeof(ArchiveHeader) == 16);
+
+struct ArchiveEntry
+{
+    quint64_le pathHash;
+    quint32_le pathOffset;
+    quint32_le pathSize;
+    quint32_le unitOffset;
+    quint32_le unitSize;
+};
+static_assert(sizeof(ArchiveEntry) == 24);
+
+const char archiveMagic[8] = { 'q', 'm', 'l', 'c', 'a', 'r', 'c', '\0' };
+constexpr quint32 archiveVersion = 1;
+constexpr quint32 unitAlignment = 16;
+
+class MappedArchive
+{
+public:
+    bool open(const QString &filePath, QString *errorString);
+    const CompiledData::Unit *findUnit(QByteArrayView relativePath) const;
+
+    // The absolute path of the directory containing the archive, with a trailing slash.
+    QString directory;
+
+private:
+    // The file stays open, as closing it would unmap the data.
+    std::unique_ptr<QFile> file;
+    const uchar *data = nullptr;
+    quint64 size = 0;
+    const ArchiveEntry *entries = nullptr;
+    quint32 entryCount = 0;
+};
+
+struct CacheArchives
+{
+    CacheArchives();
+
+    std::vector<MappedArchive> archives;
+};
+
+}
+
+Q_GLOBAL_STATIC(CacheArchives, cacheArchives)
+
+// Unlike qHash(), this does not depend on the process or the platform.
+static quint64 pathHash(QByteArrayView path)
+{
+    quint64 hash = 14695981039346656037ull;
+    for (char c : path) {
+        hash ^= quint8(c);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+bool MappedArchive::open(const QString &filePath, QString *errorString)
+{
+    file = std::make_unique<QFile>(filePath);
+    if (!file->open(QIODevice::ReadOnly)) {
+        *errorString = file->errorString();
+        return false;
+    }
+
+    size = file->size();
+    if (size < sizeof(ArchiveHeader)) {
+        *errorString = QStringLiteral("File too small for the header fields");
+        return false;
+    }
+
+    data = file->map(0, size);
+    if (!data) {
+        *errorString = file->errorString();
+        return false;
+    }
+
+    const ArchiveHeader *header = reinterpret_cast<const ArchiveHeader *>(data);
+    if (memcmp(header->magic, archiveMagic, sizeof(archiveMagic)) != 0) {
+        *errorString = QStringLiteral("Magic bytes in the header do not match");
+        return false;
+    }
+
+    if (header->version != archiveVersion) {
+        *errorString = QString::fromUtf8("Archive version mismatch. Found %1 expected %2")
+                               .arg(quint32(header->version)).arg(archiveVersion);
+        return false;
+    }
+
+    if ((size - sizeof(ArchiveHeader)) / sizeof(ArchiveEntry) < header->entryCount) {
+        *errorString = QStringLiteral("File too small for the index");
+        return false;
+    }
+
+    entries = reinterpret_cast<const ArchiveEntry *>(data + sizeof(ArchiveHeader));
+    entryCount = header->entryCount;
+    directory = QFileInfo(filePath).absolutePath() + QLatin1Char('/');
+    return true;
+}
+
+const CompiledData::Unit *MappedArchive::findUnit(QByteArrayView relativePath) const
+{
+    const quint64 hash = pathHash(relativePath);
+    const ArchiveEntry *end = entries + entryCount;
+    auto it = std::lower_bound(entries, end, hash, [](const ArchiveEntry &entry, quint64 hash) {
+        return entry.pathHash < hash;
+    });
+
+    for (; it != end && it->pathHash == hash; ++it) {
+        if (quint64(it->pathOffset) + it->pathSize > size
+                || quint64(it->unitOffset) + it->unitSize > size
+                || it->unitOffset % unitAlignment != 0
+                || it->unitSize < sizeof(CompiledData::Unit)) {
+            qCDebug(DBG_DISK_CACHE) << "Corrupt index entry in cache archive" << file->fileName();
+            return nullptr;
+        }
+
+        if (QByteArrayView(data + it->pathOffset, it->pathSize) != relativePath)
+            continue;
+
+        // The memory is never freed, and the compilation unit must not try to either.
+        const auto *unit = reinterpret_cast<const CompiledData::Unit *>(data + it->unitOffset);
+        if (unit->unitSize != it->unitSize || !(unit->flags & CompiledData::Unit::StaticData))
+            return nullptr;
+        return unit;
+    }
+
+    return nullptr;
+}
+
+CacheArchives::CacheArchives()
+{
+    const QString filePaths = qEnvironmentVariable("QML_DISK_CACHE_ARCHIVE");
+    for (const QString &filePath : filePaths.split(QDir::listSeparator(), Qt::SkipEmptyParts)) {
+        MappedArchive archive;
+        QString error;
+        if (archive.open(filePath, &error))
+            archives.push_back(std::move(archive));
+        else
+            qCDebug(DBG_DISK_CACHE) << "Error opening cache archive" << filePath << ":" << error;
+    }
+}
+
+const CompiledData::Unit *CacheArchive::findUnit(const QString &sourcePath)
+{
+    for (const MappedArchive &archive : cacheArchives->archives) {
+        if (!sourcePath.startsWith(archive.directory))
+            continue;
+        const QByteArray relativePath
+                = QStringView(sourcePath).sliced(archive.directory.size()).toUtf8();
+        if (const CompiledData::Unit *unit = archive.findUnit(relativePath))
+            return unit;
+    }
+    return nullptr;
+}
+
+bool CacheArchive::write(const QString &archiveFilePath, const QList<Entry> &entries,
+                         QString *errorString)
+{
+    struct Item
+    {
+        quint64 hash;
+        QByteArray path;
+        const QByteArray *unitData;
+    };
+
+    std::vector<Item> items;
+    items.reserve(entries.size());
+    for (const Entry &entry : entries) {
+        QByteArray path = entry.relativePath.toUtf8();
+        const quint64 hash = pathHash(path);
+        items.push_back({ hash, std::move(path), &entry.unitData });
+    }
+
+    std::sort(items.begin(), items.end(), [](const Item &a, const Item &b) {
+        return a.hash != b.hash ? a.hash < b.hash : a.path < b.path;
+    });
+
+    const auto duplicate = std::adjacent_find(
+            items.begin(), items.end(), [](const Item &a, const Item &b) {
+        return a.path == b.path;
+    });
+    if (duplicate != items.end()) {
+        *errorString = QStringLiteral("Duplicate entry for %1")
+                               .arg(QString::fromUtf8(duplicate->path));
+        return false;
+    }
+
+    std::vector<ArchiveEntry> index(items.size());
+    quint64 offset = sizeof(ArchiveHeader) + items.size() * sizeof(ArchiveEntry);
+    for (size_t i = 0; i < items.size(); ++i) {
+        index[i].pathHash = items[i].hash;
+        index[i].pathOffset = quint32(offset);
+        index[i].pathSize = quint32(items[i].path.size());
+        offset += items[i].path.size();
+    }
+    for (size_t i = 0; i < items.size(); ++i) {
+        offset = (offset + unitAlignment - 1) & ~quint64(unitAlignment - 1);
+        index[i].unitOffset = quint32(offset);
+        index[i].unitSize = quint32(items[i].unitData->size());
+        offset += items[i].unitData->size();
+    }
+
+    if (offset > std::numeric_limits<quint32>::max()) {
+        *errorString = QStringLiteral("Archive too large");
+        return false;
+    }
+
+    QByteArray archive(qsizetype(offset), '\0');
+
+    ArchiveHeader header;
+    memcpy(header.magic, archiveMagic, sizeof(archiveMagic));
+    header.version = archiveVersion;
+    header.entryCount = quint32(items.size());
+    memcpy(archive.data(), &header, sizeof(header));
+    if (!index.empty()) {
+        memcpy(archive.data() + sizeof(header), index.data(),
+               index.size() * sizeof(ArchiveEntry));
+    }
+    for (size_t i = 0; i < items.size(); ++i) {
+        memcpy(archive.data() + index[i].pathOffset, items[i].path.constData(),
+               items[i].path.size());
+        memcpy(archive.data() + index[i].unitOffset, items[i].unitData->constData(),
+               items[i].unitData->size());
+    }
+
+    return CompiledData::SaveableUnitPointer::writeDataToFile(
+            archiveFilePath, archive.constData(), quint32(archive.size()), errorString);
+}
+
+QT_END_NAMESPACE
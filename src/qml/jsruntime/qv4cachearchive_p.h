@@ -0,0 +1,59 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QV4CACHEARCHIVE_P_H
+#define QV4CACHEARCHIVE_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <private/qv4global_p.h>
+
+#include <QtCore/qbytearray.h>
+#include <QtCore/qlist.h>
+#include <QtCore/qstring.h>
+
+QT_BEGIN_NAMESPACE
+
+namespace QV4 {
+
+namespace CompiledData {
+struct Unit;
+}
+
+// A single file holding the compilation units of many QML and JavaScript files, for example of
+// all files of an application or a module. It starts with an index table sorted by the hashes
+// of the paths of the source files, relative to the directory of the archive. The archives
+// listed in QML_DISK_CACHE_ARCHIVE are mapped into memory once, and are never unmapped, like
+// the cache files with static data in CompilationUnitMapper. Looking up a unit then only takes
+// a binary search, instead of opening and mapping a cache file for each source file.
+class Q_QML_PRIVATE_EXPORT CacheArchive
+{
+public:
+    struct Entry
+    {
+        QString relativePath;
+        QByteArray unitData;
+    };
+
+    static bool write(const QString &archiveFilePath, const QList<Entry> &entries,
+                      QString *errorString);
+
+    // Returns the unit for the local source file from the first archive containing it. The header
+    // of the unit is not verified yet.
+    static const CompiledData::Unit *findUnit(const QString &sourcePath);
+};
+
+}
+
+QT_END_NAMESPACE
+
+#endif // QV4CACHEARCHIVE_P_H
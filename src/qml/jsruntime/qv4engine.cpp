@@ -108,6 +108,7 @@ using namespace QV4;
 static QBasicAtomicInt engineSerial = Q_BASIC_ATOMIC_INITIALIZER(1);
 int ExecutionEngine::s_maxCallDepth = -1;
 int ExecutionEngine::s_jitCallCountThreshold = 3;
+int ExecutionEngine::s_optimizingJitCallCountThreshold = -1;
 int ExecutionEngine::s_maxJSStackSize = 4 * 1024 * 1024;
 int ExecutionEngine::s_maxGCStackSize = 2 * 1024 * 1024;
 
@@ -316,6 +317,12 @@ void ExecutionEngine::initializeStaticMembers()
     if (qEnvironmentVariableIsSet("QV4_FORCE_INTERPRETER"))
         s_jitCallCountThreshold = std::numeric_limits<int>::max();
 
+    // The optimizing tier is opt-in. A negative threshold disables it.
+    ok = false;
+    s_optimizingJitCallCountThreshold = qEnvironmentVariableIntValue("QV4_JIT_OPTIMIZE_THRESHOLD", &ok);
+    if (!ok || s_jitCallCountThreshold == std::numeric_limits<int>::max())
+        s_optimizingJitCallCountThreshold = -1;
+
     qMetaTypeId<QJSValue>();
     qMetaTypeId<QList<int> >();
 
@@ -330,9 +337,9 @@ void ExecutionEngine::initializeStaticMembers()
 }
 
 ExecutionEngine::ExecutionEngine(QJSEngine *jsEngine)
-    : executableAllocator(new QV4::ExecutableAllocator)
+    : executableAllocator(new QV4::ExecutableAllocator(
+              this, QV4::ExecutableAllocator::optionsFromEnvironment()))
     , regExpAllocator(new QV4::ExecutableAllocator)
-    , bumperPointerAllocator(new WTF::BumpPointerAllocator)
     , jsStack(new WTF::PageAllocation)
     , gcStack(new WTF::PageAllocation)
     , globalCode(nullptr)
@@ -862,7 +869,6 @@ ExecutionEngine::~ExecutionEngine()
     while (!compilationUnits.isEmpty())
         (*compilationUnits.begin())->unlink();
 
-    delete bumperPointerAllocator;
     delete regExpCache;
     delete regExpAllocator;
     delete executableAllocator;
@@ -931,6 +937,19 @@ Heap::String *ExecutionEngine::newString(const QString &s)
     return memoryManager->allocWithStringData<String>(s.size() * sizeof(QChar), s);
 }
 
+Heap::String *ExecutionEngine::newString(QLatin1StringView s)
+{
+    return memoryManager->allocWithStringData<String>(s.size(), QByteArray(s.data(), s.size()));
+}
+
+Heap::String *ExecutionEngine::newCompactString(const QString &s)
+{
+    // If s is shared, its UTF-16 data stays alive anyway, and a Latin-1 copy would only add to it.
+    if (!s.isDetached() || !QtPrivate::isLatin1(QStringView(s)))
+        return newString(s);
+    return memoryManager->allocWithStringData<String>(s.size(), s.toLatin1());
+}
+
 Heap::String *ExecutionEngine::newIdentifier(const QString &text)
 {
     Scope scope(this);
@@ -985,6 +1004,9 @@ Heap::ArrayObject *ExecutionEngine::newArrayObject(const Value *values, int leng
         d->offset = 0;
         d->values.alloc = length;
         d->values.size = length;
+        d->elementKind = Heap::ArrayData::PackedInt32;
+        for (int i = 0; i < length; ++i)
+            d->noteElement(values[i]);
         // this doesn't require a write barrier, things will be ok, when the new array data gets inserted into
         // the parent object
         memcpy(&d->values.values, values, length*sizeof(Value));
@@ -1132,7 +1154,7 @@ Heap::Object *ExecutionEngine::newURIErrorObject(const Value &message)
 Heap::PromiseObject *ExecutionEngine::newPromiseObject()
 {
     if (!m_reactionHandler) {
-        m_reactionHandler.reset(new Promise::ReactionHandler);
+        m_reactionHandler.reset(new Promise::ReactionHandler(this));
     }
 
     Scope scope(this);
@@ -1143,7 +1165,7 @@ Heap::PromiseObject *ExecutionEngine::newPromiseObject()
 Heap::Object *ExecutionEngine::newPromiseObject(const QV4::FunctionObject *thisObject, const QV4::PromiseCapability *capability)
 {
     if (!m_reactionHandler) {
-        m_reactionHandler.reset(new Promise::ReactionHandler);
+        m_reactionHandler.reset(new Promise::ReactionHandler(this));
     }
 
     Scope scope(this);
@@ -1326,6 +1348,9 @@ void ExecutionEngine::markObjects(MarkStack *markStack)
 
     for (auto compilationUnit: compilationUnits)
         compilationUnit->markObjects(markStack);
+
+    if (m_reactionHandler)
+        m_reactionHandler->markObjects(markStack);
 }
 
 ReturnedValue ExecutionEngine::throwError(const Value &value)
@@ -2204,6 +2229,12 @@ static ExecutionEngine::DiskCacheOptions transFormDiskCache(const char *v)
             result |= DiskCache::QmlcWrite;
         else if (option == "qmlc")
             result |= DiskCache::Qmlc;
+        else if (option == "jit-read")
+            result |= DiskCache::JitRead;
+        else if (option == "jit-write")
+            result |= DiskCache::JitWrite;
+        else if (option == "jit")
+            result |= DiskCache::Jit;
         else
             qWarning() << "Ignoring unknown option to QML_DISK_CACHE:" << option;
     }
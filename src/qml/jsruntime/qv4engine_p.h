@@ -32,7 +32,6 @@
 #include <private/qv4stacklimits_p.h>
 
 namespace WTF {
-class BumpPointerAllocator;
 class PageAllocation;
 }
 
@@ -145,8 +144,11 @@ public:
         AotNative   = 1 << 1,
         QmlcRead    = 1 << 2,
         QmlcWrite   = 1 << 3,
+        JitRead     = 1 << 4,
+        JitWrite    = 1 << 5,
         Aot         = AotByteCode | AotNative,
         Qmlc        = QmlcRead | QmlcWrite,
+        Jit         = JitRead | JitWrite,
         Enabled     = Aot | Qmlc,
 
     };
@@ -156,8 +158,6 @@ public:
     ExecutableAllocator *executableAllocator;
     ExecutableAllocator *regExpAllocator;
 
-    WTF::BumpPointerAllocator *bumperPointerAllocator; // Used by Yarr Regex engine.
-
     WTF::PageAllocation *jsStack;
 
     WTF::PageAllocation *gcStack;
@@ -547,6 +547,9 @@ public:
     Heap::Object *newObject(Heap::InternalClass *internalClass);
 
     Heap::String *newString(const QString &s = QString());
+    Heap::String *newString(QLatin1StringView s);
+    // Stores s with one byte per character if possible and nothing else refers to its data.
+    Heap::String *newCompactString(const QString &s);
     Heap::String *newIdentifier(const QString &text);
 
     Heap::Object *newStringObject(const String *string);
@@ -690,6 +693,22 @@ public:
 #endif
     }
 
+    bool canOptimize(Function *f = nullptr)
+    {
+#if QT_CONFIG(qml_jit) && QT_POINTER_SIZE == 8
+        if (!m_canAllocateExecutableMemory || s_optimizingJitCallCountThreshold < 0)
+            return false;
+        if (f) {
+            return !f->optimizationDisabled
+                    && f->jittedCallCount >= s_optimizingJitCallCountThreshold;
+        }
+        return true;
+#else
+        Q_UNUSED(f);
+        return false;
+#endif
+    }
+
     QV4::ReturnedValue global();
     void initQmlGlobalObject();
     void initializeGlobal();
@@ -827,6 +846,7 @@ private:
 
     static int s_maxCallDepth;
     static int s_jitCallCountThreshold;
+    static int s_optimizingJitCallCountThreshold;
     static int s_maxJSStackSize;
     static int s_maxGCStackSize;
 
@@ -45,7 +45,8 @@ struct Q_QML_EXPORT EngineBase {
 
     quint8 isExecutingInRegExpJIT = false;
     quint8 isInitialized = false;
-    quint8 padding[2];
+    quint8 isGCOngoing = false; // incremental marking is in progress, between the mutator's steps
+    quint8 isGenerationalGC = false; // stores of young objects into old ones need to be remembered
     MemoryManager *memoryManager = nullptr;
 
     union {
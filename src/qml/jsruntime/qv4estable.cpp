@@ -4,32 +4,43 @@
 #include "qv4estable_p.h"
 #include "qv4object_p.h"
 
+#include <QtCore/qhashfunctions.h>
+
 using namespace QV4;
 
 // The ES spec requires that Map/Set be implemented using a data structure that
 // is a little different from most; it requires nonlinear access, and must also
 // preserve the order of insertion of items in a deterministic way.
 //
-// This class implements those requirements, except for fast access: that
-// will be addressed in a followup patch.
+// The entries are kept in insertion order in the m_keys and m_values arrays,
+// and an open addressed hash index (with linear probing) maps keys to their
+// entry. Removing an entry only clears its key, so that the position of all
+// other entries, and thus any running iteration, stays intact. The holes are
+// squeezed out once the table runs out of space.
+//
+// Keys with a custom notion of equality, such as QObject wrappers, can compare
+// equal to other heap objects and have no stable hash. They are not put into
+// the index, but found by a linear scan over the entries.
 
 ESTable::ESTable()
     : m_capacity(8)
 {
-    m_keys = (Value*)malloc(m_capacity * sizeof(Value));
-    m_values = (Value*)malloc(m_capacity * sizeof(Value));
-    memset(m_keys, 0, m_capacity);
-    memset(m_values, 0, m_capacity);
+    m_keys = (Value*)calloc(m_capacity, sizeof(Value));
+    m_values = (Value*)calloc(m_capacity, sizeof(Value));
+    m_index = (uint*)calloc(2 * m_capacity, sizeof(uint));
 }
 
 ESTable::~ESTable()
 {
     free(m_keys);
     free(m_values);
+    free(m_index);
     m_size = 0;
+    m_count = 0;
     m_capacity = 0;
     m_keys = nullptr;
     m_values = nullptr;
+    m_index = nullptr;
 }
 
 void ESTable::markObjects(MarkStack *s, bool isWeakMap)
@@ -46,27 +57,23 @@ void ESTable::markObjects(MarkStack *s, bool isWeakMap)
 void ESTable::clear()
 {
     m_size = 0;
+    m_count = 0;
+    m_customKeys = 0;
+    memset(m_index, 0, 2 * m_capacity * sizeof(uint));
 }
 
 // Update the table to contain \a value for a given \a key. The key is
 // normalized, as required by the ES spec.
 void ESTable::set(const Value &key, const Value &value)
 {
-    for (uint i = 0; i < m_size; ++i) {
-        if (m_keys[i].sameValueZero(key)) {
-            m_values[i] = value;
-            return;
-        }
+    const uint entry = findEntry(key);
+    if (entry != UINT_MAX) {
+        m_values[entry] = value;
+        return;
     }
 
-    if (m_capacity == m_size) {
-        uint oldCap = m_capacity;
-        m_capacity *= 2;
-        m_keys = (Value*)realloc(m_keys, m_capacity * sizeof(Value));
-        m_values = (Value*)realloc(m_values, m_capacity * sizeof(Value));
-        memset(m_keys + oldCap, 0, m_capacity - oldCap);
-        memset(m_values + oldCap, 0, m_capacity - oldCap);
-    }
+    if (m_capacity == m_size)
+        grow();
 
     Value nk = key;
     if (nk.isDouble()) {
@@ -76,88 +83,191 @@ void ESTable::set(const Value &key, const Value &value)
 
     m_keys[m_size] = nk;
     m_values[m_size] = value;
+    if (hasCustomEquality(nk))
+        m_customKeys++;
+    else
+        insertIndex(hashKey(nk), m_size);
 
     m_size++;
+    m_count++;
 }
 
 // Returns true if the table contains \a key, false otherwise.
 bool ESTable::has(const Value &key) const
 {
-    for (uint i = 0; i < m_size; ++i) {
-        if (m_keys[i].sameValueZero(key))
-            return true;
-    }
-
-    return false;
+    return findEntry(key) != UINT_MAX;
 }
 
 // Fetches the value for the given \a key, and if \a hasValue is passed in,
 // it is set depending on whether or not the given key was found.
 ReturnedValue ESTable::get(const Value &key, bool *hasValue) const
 {
-    for (uint i = 0; i < m_size; ++i) {
-        if (m_keys[i].sameValueZero(key)) {
-            if (hasValue)
-                *hasValue = true;
-            return m_values[i].asReturnedValue();
-        }
-    }
-
+    const uint entry = findEntry(key);
     if (hasValue)
-        *hasValue = false;
-    return Encode::undefined();
+        *hasValue = entry != UINT_MAX;
+    if (entry == UINT_MAX)
+        return Encode::undefined();
+    return m_values[entry].asReturnedValue();
 }
 
 // Removes the given \a key from the table
 bool ESTable::remove(const Value &key)
 {
-    bool found = false;
-    uint idx = 0;
-    for (; idx < m_size; ++idx) {
-        if (m_keys[idx].sameValueZero(key)) {
-            found = true;
-            break;
-        }
-    }
+    const uint entry = findEntry(key);
+    if (entry == UINT_MAX)
+        return false;
 
-    if (found == true) {
-        memmove(m_keys + idx, m_keys + idx + 1, (m_size - idx)*sizeof(Value));
-        memmove(m_values + idx, m_values + idx + 1, (m_size - idx)*sizeof(Value));
-        m_size--;
-    }
-    return found;
+    // The bucket keeps pointing to the emptied entry. Lookups skip it, and it
+    // goes away with the next rebuild of the index.
+    if (hasCustomEquality(m_keys[entry]))
+        m_customKeys--;
+    m_keys[entry] = Value::emptyValue();
+    m_values[entry] = Value::undefinedValue();
+    m_count--;
+    return true;
 }
 
-// Returns the size of the table. Note that the size may not match the underlying allocation.
+// Returns the number of entries in the table. Note that the size may not match
+// the underlying allocation.
 uint ESTable::size() const
 {
-    return m_size;
+    return m_count;
 }
 
-// Retrieves a key and value for a given \a idx, and places them in \a key and
-// \a value. They must be valid pointers.
-void ESTable::iterate(uint idx, Value *key, Value *value)
+// Retrieves the first entry at or after position \a idx, and places its key and
+// value in \a key and \a value. They must be valid pointers. On success, \a idx
+// is advanced past the entry. Returns false if there are no more entries.
+bool ESTable::iterate(uint *idx, Value *key, Value *value) const
 {
-    Q_ASSERT(idx < m_size);
+    Q_ASSERT(idx);
     Q_ASSERT(key);
     Q_ASSERT(value);
-    *key = m_keys[idx];
-    *value = m_values[idx];
+    for (uint i = *idx; i < m_size; ++i) {
+        if (m_keys[i].isEmpty())
+            continue;
+        *key = m_keys[i];
+        *value = m_values[i];
+        *idx = i + 1;
+        return true;
+    }
+    *idx = m_size;
+    return false;
 }
 
 void ESTable::removeUnmarkedKeys()
 {
-    uint idx = 0;
-    uint toIdx = 0;
-    for (; idx < m_size; ++idx) {
+    for (uint idx = 0; idx < m_size; ++idx) {
+        if (m_keys[idx].isEmpty())
+            continue;
         Q_ASSERT(m_keys[idx].isObject());
         Object &o = static_cast<Object &>(m_keys[idx]);
-        if (o.d()->isMarked()) {
-            m_keys[toIdx] = m_keys[idx];
-            m_values[toIdx] = m_values[idx];
-            ++toIdx;
+        if (!o.d()->isMarked()) {
+            if (hasCustomEquality(m_keys[idx]))
+                m_customKeys--;
+            m_keys[idx] = Value::emptyValue();
+            m_values[idx] = Value::undefinedValue();
+            m_count--;
         }
     }
+    if (m_count != m_size)
+        compact();
+}
+
+// Keys that are SameValueZero equal need to produce the same hash. Numbers are
+// hashed by their double value, so that the integer and double encodings of
+// the same number (as well as +0 and -0) end up in the same bucket. Other heap
+// objects are equal only to themselves, and the heap doesn't move them.
+uint ESTable::hashKey(const Value &key)
+{
+    if (const String *s = key.stringValue())
+        return s->hashValue();
+    if (key.isNumber())
+        return uint(qHash(key.asDouble()));
+    if (key.isManaged())
+        return uint(qHash(quintptr(key.m())));
+    return uint(qHash(key.rawValue()));
+}
+
+bool ESTable::hasCustomEquality(const Value &key)
+{
+    if (!key.isManaged() || key.isString())
+        return false;
+    return key.m()->internalClass->vtable->isEqualTo != Object::staticVTable()->isEqualTo;
+}
+
+uint ESTable::findEntry(const Value &key) const
+{
+    if (hasCustomEquality(key)) {
+        if (!m_customKeys)
+            return UINT_MAX;
+        for (uint entry = 0; entry < m_size; ++entry) {
+            if (hasCustomEquality(m_keys[entry]) && m_keys[entry].sameValueZero(key))
+                return entry;
+        }
+        return UINT_MAX;
+    }
+
+    const uint mask = 2 * m_capacity - 1;
+    for (uint bucket = hashKey(key) & mask; m_index[bucket]; bucket = (bucket + 1) & mask) {
+        const uint entry = m_index[bucket] - 1;
+        if (!m_keys[entry].isEmpty() && m_keys[entry].sameValueZero(key))
+            return entry;
+    }
+    return UINT_MAX;
+}
+
+void ESTable::insertIndex(uint hash, uint entry)
+{
+    const uint mask = 2 * m_capacity - 1;
+    uint bucket = hash & mask;
+    while (m_index[bucket])
+        bucket = (bucket + 1) & mask;
+    m_index[bucket] = entry + 1;
+}
+
+void ESTable::rebuildIndex()
+{
+    memset(m_index, 0, 2 * m_capacity * sizeof(uint));
+    for (uint i = 0; i < m_size; ++i) {
+        if (!hasCustomEquality(m_keys[i]))
+            insertIndex(hashKey(m_keys[i]), i);
+    }
+}
+
+// Squeezes out the holes left behind by removed entries. This shifts the
+// position of entries, and thus affects iterators that are currently running
+// over the table, so it's only done when we would otherwise have to grow.
+void ESTable::compact()
+{
+    uint toIdx = 0;
+    for (uint idx = 0; idx < m_size; ++idx) {
+        if (m_keys[idx].isEmpty())
+            continue;
+        m_keys[toIdx] = m_keys[idx];
+        m_values[toIdx] = m_values[idx];
+        ++toIdx;
+    }
+    Q_ASSERT(toIdx == m_count);
     m_size = toIdx;
+    rebuildIndex();
 }
 
+void ESTable::grow()
+{
+    // If at least half of the table consists of holes, reclaiming them is
+    // enough to make room.
+    if (m_size - m_count >= m_capacity / 2) {
+        compact();
+        return;
+    }
+
+    const uint oldCap = m_capacity;
+    m_capacity *= 2;
+    m_keys = (Value*)realloc(m_keys, m_capacity * sizeof(Value));
+    m_values = (Value*)realloc(m_values, m_capacity * sizeof(Value));
+    memset(m_keys + oldCap, 0, (m_capacity - oldCap) * sizeof(Value));
+    memset(m_values + oldCap, 0, (m_capacity - oldCap) * sizeof(Value));
+    free(m_index);
+    m_index = (uint*)malloc(2 * m_capacity * sizeof(uint));
+    compact();
+}
@@ -35,15 +35,31 @@ public:
     ReturnedValue get(const Value &k, bool *hasValue = nullptr) const;
     bool remove(const Value &k);
     uint size() const;
-    void iterate(uint idx, Value *k, Value *v);
+    bool iterate(uint *idx, Value *k, Value *v) const;
 
     void removeUnmarkedKeys();
 
 private:
+    static uint hashKey(const Value &k);
+    static bool hasCustomEquality(const Value &k);
+    uint findEntry(const Value &k) const;
+    void insertIndex(uint hash, uint entry);
+    void rebuildIndex();
+    void compact();
+    void grow();
+
+    // m_keys and m_values hold the entries in insertion order. Removed
+    // entries leave a hole (an empty key) behind until the table is compacted.
     Value *m_keys = nullptr;
     Value *m_values = nullptr;
+    // Open addressed hash index into the entry arrays. Each bucket holds
+    // the entry index plus one, so that zero denotes an empty bucket.
+    uint *m_index = nullptr;
     uint m_size = 0;
+    uint m_count = 0;
     uint m_capacity = 0;
+    // Number of keys that are not in the index, see hasCustomEquality().
+    uint m_customKeys = 0;
 };
 
 }
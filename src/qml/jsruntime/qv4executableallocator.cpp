@@ -3,12 +3,31 @@
 
 #include "qv4executableallocator_p.h"
 #include <QtQml/private/qv4functiontable_p.h>
+#include <QtQml/private/qv4profiling_p.h>
 
 #include <wtf/StdLibExtras.h>
 #include <wtf/PageAllocation.h>
 
+#if OS(LINUX)
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#ifndef MFD_CLOEXEC
+#define MFD_CLOEXEC 0x0001U
+#endif
+#endif
+
+// Mapping the same memory twice only works if the generated code doesn't depend on the address
+// it's written to. This is the case for the relative branches of x86_64 and ARM64, as long as
+// the absolute code addresses we patch into the code are adjusted.
+#if OS(LINUX) && !defined(__ANDROID__) && defined(SYS_memfd_create) && (CPU(X86_64) || CPU(ARM64))
+#  define QV4_EXECUTABLE_DUAL_MAPPING
+#endif
+
 using namespace QV4;
 
+static const size_t HugePageSize = 2 * 1024 * 1024;
+
 void *ExecutableAllocator::Allocation::exceptionHandlerStart() const
 {
     return reinterpret_cast<void*>(addr);
@@ -29,6 +48,11 @@ void *ExecutableAllocator::Allocation::codeStart() const
     return reinterpret_cast<void*>(addr + exceptionHandlerSize());
 }
 
+void *ExecutableAllocator::Allocation::writableCodeStart() const
+{
+    return reinterpret_cast<void*>(addr + writableOffset + exceptionHandlerSize());
+}
+
 void ExecutableAllocator::Allocation::deallocate(ExecutableAllocator *allocator)
 {
     if (isValid())
@@ -51,6 +75,7 @@ ExecutableAllocator::Allocation *ExecutableAllocator::Allocation::split(size_t d
     remainder->size = size - dividingSize;
     remainder->free = free;
     remainder->addr = addr + dividingSize;
+    remainder->writableOffset = writableOffset;
     size = dividingSize;
 
     return remainder;
@@ -105,8 +130,18 @@ ExecutableAllocator::ChunkOfPages::~ChunkOfPages()
             delete alloc;
         alloc = next;
     }
-    pages->deallocate();
-    delete pages;
+
+    if (pages) {
+        pages->deallocate();
+        delete pages;
+        return;
+    }
+
+#if OS(LINUX)
+    munmap(reinterpret_cast<void *>(base), size);
+    if (writableOffset)
+        munmap(reinterpret_cast<void *>(base + writableOffset), size);
+#endif
 }
 
 bool ExecutableAllocator::ChunkOfPages::contains(Allocation *alloc) const
@@ -120,8 +155,35 @@ bool ExecutableAllocator::ChunkOfPages::contains(Allocation *alloc) const
     return false;
 }
 
-ExecutableAllocator::ExecutableAllocator()
-    = default;
+ExecutableAllocator::ExecutableAllocator(ExecutionEngine *engine, Options options)
+    : m_engine(engine)
+    , m_options(options)
+{
+}
+
+ExecutableAllocator::Options ExecutableAllocator::optionsFromEnvironment()
+{
+    static const Options options = []() {
+        Options result = NoOptions;
+        if (qEnvironmentVariableIsSet("QV4_JIT_HUGE_PAGES"))
+            result |= HugePages;
+        if (qEnvironmentVariableIsSet("QV4_JIT_DUAL_MAPPING"))
+            result |= DualMapping;
+        return result;
+    }();
+    return options;
+}
+
+ExecutableAllocator::Statistics ExecutableAllocator::statistics() const
+{
+    QMutexLocker locker(&mutex);
+    Statistics result;
+    result.liveBytes = m_liveBytes;
+    result.mappedBytes = m_mappedBytes;
+    result.wastedBytes = m_mappedBytes - m_liveBytes;
+    result.chunkCount = chunks.size();
+    return result;
+}
 
 ExecutableAllocator::~ExecutableAllocator()
 {
@@ -149,13 +211,15 @@ ExecutableAllocator::Allocation *ExecutableAllocator::allocate(size_t size)
     }
 
     if (!allocation) {
-        ChunkOfPages *chunk = new ChunkOfPages;
-        size_t allocSize = WTF::roundUpToMultipleOf(WTF::pageSize(), size);
-        chunk->pages = new WTF::PageAllocation(WTF::PageAllocation::allocate(allocSize, OSAllocator::JSJITCodePages));
-        chunks.insert(reinterpret_cast<quintptr>(chunk->pages->base()) - 1, chunk);
+        ChunkOfPages *chunk = allocateChunk(size);
+        chunks.insert(chunk->base - 1, chunk);
+        m_mappedBytes += chunk->size;
+        if (m_engine)
+            Q_V4_PROFILE_ALLOC(m_engine, chunk->size, Profiling::JitCodePage);
         allocation = new Allocation;
-        allocation->addr = reinterpret_cast<quintptr>(chunk->pages->base());
-        allocation->size = allocSize;
+        allocation->addr = chunk->base;
+        allocation->writableOffset = chunk->writableOffset;
+        allocation->size = chunk->size;
         allocation->free = true;
         chunk->firstAllocation = allocation;
     }
@@ -172,6 +236,7 @@ ExecutableAllocator::Allocation *ExecutableAllocator::allocate(size_t size)
             freeAllocations.insert(remainder->size, remainder);
     }
 
+    m_liveBytes += allocation->size;
     return allocation;
 }
 
@@ -182,6 +247,7 @@ void ExecutableAllocator::free(Allocation *allocation)
     Q_ASSERT(allocation);
 
     allocation->free = true;
+    m_liveBytes -= allocation->size;
 
     QMap<quintptr, ChunkOfPages*>::Iterator it = chunks.lowerBound(allocation->addr);
     if (it != chunks.begin())
@@ -200,6 +266,9 @@ void ExecutableAllocator::free(Allocation *allocation)
     if (!chunk->firstAllocation->next) {
         freeAllocations.remove(chunk->firstAllocation->size, chunk->firstAllocation);
         chunks.erase(it);
+        m_mappedBytes -= chunk->size;
+        if (m_engine)
+            Q_V4_PROFILE_DEALLOC(m_engine, chunk->size, Profiling::JitCodePage);
         delete chunk;
         return;
     }
@@ -217,3 +286,99 @@ ExecutableAllocator::ChunkOfPages *ExecutableAllocator::chunkForAllocation(Alloc
     return *it;
 }
 
+#if OS(LINUX)
+// Reserves an address range of the given size that starts at a multiple of alignment.
+static quintptr reserveAligned(size_t size, size_t alignment)
+{
+    const size_t reservedSize = size + alignment;
+    void *reserved = mmap(nullptr, reservedSize, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE,
+                          -1, 0);
+    if (reserved == MAP_FAILED)
+        return 0;
+
+    const quintptr start = reinterpret_cast<quintptr>(reserved);
+    const quintptr aligned = WTF::roundUpToMultipleOf(alignment, start);
+    if (aligned > start)
+        munmap(reserved, aligned - start);
+    const quintptr end = start + reservedSize;
+    if (end > aligned + size)
+        munmap(reinterpret_cast<void *>(aligned + size), end - aligned - size);
+    return aligned;
+}
+
+static void adviseHugePages(quintptr base, size_t size)
+{
+#ifdef MADV_HUGEPAGE
+    madvise(reinterpret_cast<void *>(base), size, MADV_HUGEPAGE);
+#else
+    Q_UNUSED(base);
+    Q_UNUSED(size);
+#endif
+}
+#endif
+
+ExecutableAllocator::ChunkOfPages *ExecutableAllocator::allocateChunk(size_t size)
+{
+    ChunkOfPages *chunk = new ChunkOfPages;
+
+#if OS(LINUX)
+    const bool hugePages = m_options & HugePages;
+    const size_t alignment = hugePages ? HugePageSize : WTF::pageSize();
+    chunk->size = WTF::roundUpToMultipleOf(alignment, size);
+
+#ifdef QV4_EXECUTABLE_DUAL_MAPPING
+    if (m_options & DualMapping) {
+        // Both mappings share the same memory file. The executable one is never writable and
+        // the writable one is never executable. Therefore, nothing needs to be mprotect()ed
+        // when code is added.
+        const int fd = syscall(SYS_memfd_create, "JITCode:QtQml", MFD_CLOEXEC);
+        if (fd != -1 && ftruncate(fd, chunk->size) == 0) {
+            const quintptr executable = reserveAligned(chunk->size, alignment);
+            const quintptr writable = executable ? reserveAligned(chunk->size, alignment) : 0;
+            if (writable
+                    && mmap(reinterpret_cast<void *>(executable), chunk->size,
+                            PROT_READ | PROT_EXEC, MAP_SHARED | MAP_FIXED, fd, 0) != MAP_FAILED
+                    && mmap(reinterpret_cast<void *>(writable), chunk->size,
+                            PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) != MAP_FAILED) {
+                close(fd);
+                if (hugePages) {
+                    adviseHugePages(executable, chunk->size);
+                    adviseHugePages(writable, chunk->size);
+                }
+                chunk->base = executable;
+                chunk->writableOffset = qptrdiff(writable - executable);
+                return chunk;
+            }
+
+            if (executable)
+                munmap(reinterpret_cast<void *>(executable), chunk->size);
+            if (writable)
+                munmap(reinterpret_cast<void *>(writable), chunk->size);
+        }
+        if (fd != -1)
+            close(fd);
+        // Fall back to a single mapping.
+    }
+#endif
+
+    if (hugePages) {
+        const quintptr base = reserveAligned(chunk->size, alignment);
+        if (base && mmap(reinterpret_cast<void *>(base), chunk->size, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1, 0) != MAP_FAILED) {
+            adviseHugePages(base, chunk->size);
+            chunk->base = base;
+            return chunk;
+        }
+        if (base)
+            munmap(reinterpret_cast<void *>(base), chunk->size);
+        chunk->size = WTF::roundUpToMultipleOf(WTF::pageSize(), size);
+    }
+#else
+    chunk->size = WTF::roundUpToMultipleOf(WTF::pageSize(), size);
+#endif
+
+    chunk->pages = new WTF::PageAllocation(
+            WTF::PageAllocation::allocate(chunk->size, OSAllocator::JSJITCodePages));
+    chunk->base = reinterpret_cast<quintptr>(chunk->pages->base());
+    return chunk;
+}
@@ -31,15 +31,36 @@ QT_BEGIN_NAMESPACE
 
 namespace QV4 {
 
+struct ExecutionEngine;
+
 class Q_QML_AUTOTEST_EXPORT ExecutableAllocator
 {
 public:
     struct ChunkOfPages;
     struct Allocation;
 
-    ExecutableAllocator();
+    enum Option {
+        NoOptions   = 0x0,
+        HugePages   = 0x1, // Map chunks in multiples of 2MB, so that huge pages can back them.
+        DualMapping = 0x2  // Map chunks twice, writable and executable, instead of mprotect().
+    };
+    Q_DECLARE_FLAGS(Options, Option)
+
+    struct Statistics
+    {
+        size_t liveBytes = 0;   // handed out and not freed yet
+        size_t wastedBytes = 0; // mapped, but not handed out
+        size_t mappedBytes = 0;
+        int chunkCount = 0;
+    };
+
+    ExecutableAllocator(ExecutionEngine *engine = nullptr, Options options = NoOptions);
     ~ExecutableAllocator();
 
+    static Options optionsFromEnvironment();
+    Options options() const { return m_options; }
+    Statistics statistics() const;
+
     Allocation *allocate(size_t size);
     void free(Allocation *allocation);
 
@@ -58,6 +79,12 @@ public:
 
         void *codeStart() const;
 
+        // The addresses to write the code to. They differ from the ones above if the chunk is
+        // mapped twice. Then the executable mapping is never writable.
+        void *writableMemoryStart() const { return reinterpret_cast<void *>(addr + writableOffset); }
+        void *writableCodeStart() const;
+        bool isDualMapped() const { return writableOffset != 0; }
+
         void invalidate() { addr = 0; }
         bool isValid() const { return addr != 0; }
         void deallocate(ExecutableAllocator *allocator);
@@ -72,6 +99,7 @@ public:
         bool mergePrevious(ExecutableAllocator *allocator);
 
         quintptr addr = 0;
+        qptrdiff writableOffset = 0;
         uint size : 31; // More than 2GB of function code? nah :)
         uint free : 1;
         Allocation *next = nullptr;
@@ -89,7 +117,10 @@ public:
         {}
         ~ChunkOfPages();
 
-        WTF::PageAllocation *pages = nullptr;
+        WTF::PageAllocation *pages = nullptr; // unless mapped by the allocator itself
+        quintptr base = 0;
+        size_t size = 0;
+        qptrdiff writableOffset = 0;
         Allocation *firstAllocation = nullptr;
 
         bool contains(Allocation *alloc) const;
@@ -98,11 +129,19 @@ public:
     ChunkOfPages *chunkForAllocation(Allocation *allocation) const;
 
 private:
+    ChunkOfPages *allocateChunk(size_t size);
+
     QMultiMap<size_t, Allocation*> freeAllocations;
     QMap<quintptr, ChunkOfPages*> chunks;
     mutable QRecursiveMutex mutex;
+    ExecutionEngine *m_engine;
+    Options m_options;
+    size_t m_liveBytes = 0;
+    size_t m_mappedBytes = 0;
 };
 
+Q_DECLARE_OPERATORS_FOR_FLAGS(ExecutableAllocator::Options)
+
 }
 
 QT_END_NAMESPACE
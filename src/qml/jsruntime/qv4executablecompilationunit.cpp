@@ -16,12 +16,16 @@
 #include <private/qqmlvaluetypewrapper_p.h>
 #include <private/qqmlscriptdata_p.h>
 #include <private/qv4module_p.h>
+#include <private/qv4cachearchive_p.h>
 #include <private/qv4compilationunitmapper_p.h>
 #include <private/qml_compile_hash_p.h>
 #include <private/qqmltypewrapper_p.h>
 #include <private/inlinecomponentutils_p.h>
 #include <private/qv4resolvedtypereference_p.h>
 #include <private/qv4objectiterator_p.h>
+#if QT_CONFIG(qml_jit)
+#include <private/qv4jitcodecache_p.h>
+#endif
 
 #include <QtQml/qqmlfile.h>
 #include <QtQml/qqmlpropertymap.h>
@@ -31,6 +35,7 @@
 #include <QtCore/qfileinfo.h>
 #include <QtCore/qscopeguard.h>
 #include <QtCore/qcryptographichash.h>
+#include <QtCore/qloggingcategory.h>
 #include <QtCore/QScopedValueRollback>
 
 static_assert(QV4::CompiledData::QmlCompileHashSpace > QML_COMPILE_HASH_LENGTH);
@@ -48,6 +53,8 @@ static_assert(sizeof(QV4::CompiledData::Unit::libraryVersionHash) > QML_COMPILE_
 #  error "QML_COMPILE_HASH must be defined for the build of QtDeclarative to ensure version checking for cache files"
 #endif
 
+Q_DECLARE_LOGGING_CATEGORY(DBG_DISK_CACHE)
+
 QT_BEGIN_NAMESPACE
 
 namespace QV4 {
@@ -116,7 +123,7 @@ QV4::Function *ExecutableCompilationUnit::linkToEngine(ExecutionEngine *engine)
     // memset the strings to 0 in case a GC run happens while we're within the loop below
     memset(runtimeStrings, 0, stringCount * sizeof(QV4::Heap::String*));
     for (uint i = 0; i < stringCount; ++i)
-        runtimeStrings[i] = engine->newString(stringAt(i));
+        runtimeStrings[i] = engine->newCompactString(stringAt(i));
 
     runtimeRegularExpressions
             = new QV4::Value[data->regexpTableSize];
@@ -203,6 +210,11 @@ QV4::Function *ExecutableCompilationUnit::linkToEngine(ExecutionEngine *engine)
                                                     advanceAotFunction(i));
     }
 
+#if QT_CONFIG(qml_jit)
+    if (JIT::CodeCache::isReadEnabled(engine))
+        cachedJitFunctionCount = JIT::CodeCache::load(this);
+#endif
+
     Scope scope(engine);
     Scoped<InternalClass> ic(scope);
 
@@ -295,6 +307,16 @@ void ExecutableCompilationUnit::unlink()
     qDeleteAll(resolvedTypes);
     resolvedTypes.clear();
 
+#if QT_CONFIG(qml_jit)
+    if (engine && JIT::CodeCache::isWriteEnabled(engine)) {
+        QString errorString;
+        if (!JIT::CodeCache::save(this, &errorString)) {
+            qCDebug(DBG_DISK_CACHE) << "Error saving JIT code cache for" << fileName() << ":"
+                                    << errorString;
+        }
+    }
+#endif
+
     engine = nullptr;
     qmlEngine = nullptr;
 
@@ -829,14 +851,8 @@ bool ExecutableCompilationUnit::loadFromDisk(const QUrl &url, const QDateTime &s
     }
 
     const QString sourcePath = QQmlFile::urlToLocalFileOrQrc(url);
-    auto cacheFile = std::make_unique<CompilationUnitMapper>();
-
-    const QStringList cachePaths = { sourcePath + QLatin1Char('c'), localCacheFilePath(url) };
-    for (const QString &cachePath : cachePaths) {
-        CompiledData::Unit *mappedUnit = cacheFile->get(cachePath, sourceTimeStamp, errorString);
-        if (!mappedUnit)
-            continue;
 
+    const auto useUnit = [&](const CompiledData::Unit *unit, const QString &fileName = QString()) {
         const CompiledData::Unit * const oldDataPtr
                 = (data && !(data->flags & QV4::CompiledData::Unit::StaticData)) ? data
                                                                                      : nullptr;
@@ -844,21 +860,46 @@ bool ExecutableCompilationUnit::loadFromDisk(const QUrl &url, const QDateTime &s
         auto dataPtrRevert = qScopeGuard([this, oldData](){
             setUnitData(oldData);
         });
-        setUnitData(mappedUnit);
+        setUnitData(unit, nullptr, fileName, fileName);
 
         if (data->sourceFileIndex != 0) {
             if (data->sourceFileIndex >= data->stringTableSize + dynamicStrings.size()) {
                 *errorString = QStringLiteral("QML source file index is invalid.");
-                continue;
+                return false;
             }
             if (sourcePath != QQmlFile::urlToLocalFileOrQrc(stringAt(data->sourceFileIndex))) {
                 *errorString = QStringLiteral("QML source file has moved to a different location.");
-                continue;
+                return false;
             }
         }
 
         dataPtrRevert.dismiss();
         free(const_cast<CompiledData::Unit*>(oldDataPtr));
+        return true;
+    };
+
+    // The archives stay mapped, so there is no backing file to keep. The archived units are
+    // relocatable and don't know their location, which is needed to resolve relative module
+    // imports and to report errors.
+    if (const CompiledData::Unit *archivedUnit = CacheArchive::findUnit(sourcePath)) {
+        if (verifyHeader(archivedUnit, sourceTimeStamp, errorString)
+                && useUnit(archivedUnit, url.toString())) {
+            backingFile.reset();
+            return true;
+        }
+    }
+
+    auto cacheFile = std::make_unique<CompilationUnitMapper>();
+
+    const QStringList cachePaths = { sourcePath + QLatin1Char('c'), localCacheFilePath(url) };
+    for (const QString &cachePath : cachePaths) {
+        CompiledData::Unit *mappedUnit = cacheFile->get(cachePath, sourceTimeStamp, errorString);
+        if (!mappedUnit)
+            continue;
+
+        if (!useUnit(mappedUnit))
+            continue;
+
         backingFile = std::move(cacheFile);
         return true;
     }
@@ -106,6 +106,7 @@ public:
 
     QV4::Lookup *runtimeLookups = nullptr;
     QVector<QV4::Function *> runtimeFunctions;
+    int cachedJitFunctionCount = 0; // Functions whose code was loaded from the JIT code cache
     QVector<QV4::Heap::InternalClass *> runtimeBlocks;
     mutable QVector<QV4::Heap::Object *> templateObjects;
     mutable QQmlNullableValue<QUrl> m_url;
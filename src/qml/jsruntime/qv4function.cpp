@@ -183,10 +183,26 @@ Function::Function(ExecutionEngine *engine, ExecutableCompilationUnit *unit,
 
 Function::~Function()
 {
+#if QT_CONFIG(qml_lookup_counters)
+    if (const quint64 total = lookupHits + lookupFallbacks) {
+        // Don't use name() here, the string may already be gone.
+        QString name = executableCompilationUnit()->stringAt(compiledFunction->nameIndex);
+        if (name.isEmpty())
+            name = QStringLiteral("<anonymous>");
+        qDebug("Lookups in %s (%s:%d): %llu, %.1f%% hits, %.1f%% generic, %llu resolutions, "
+               "%u megamorphic sites", qPrintable(name), qPrintable(sourceFile()),
+               compiledFunction->location.line(), total, 100.0 * lookupHits / total,
+               100.0 * lookupFallbacks / total, lookupResolutions, megamorphicLookups);
+    }
+#endif
     if (codeRef) {
         destroyFunctionTable(this, codeRef);
         delete codeRef;
     }
+    if (optimizedCodeRef) {
+        destroyFunctionTable(this, optimizedCodeRef);
+        delete optimizedCodeRef;
+    }
     if (kind == JsTyped)
         delete typedFunction;
 }
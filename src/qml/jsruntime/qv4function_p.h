@@ -74,15 +74,33 @@ public:
     typedef ReturnedValue (*JittedCode)(CppStackFrame *, ExecutionEngine *);
     JittedCode jittedCode;
     JSC::MacroAssemblerCodeRef *codeRef;
+
+    // Code generated by the optimizing JIT tier. The code ref is kept alive until the function is
+    // destroyed, even after deoptimization, as the code may still be on the stack.
+    JittedCode optimizedCode = nullptr;
+    JSC::MacroAssemblerCodeRef *optimizedCodeRef = nullptr;
+
+    // The baseline code, in the format of the JIT code cache. Only kept if the cache is written.
+    QByteArray jitCacheRecord;
     const QQmlPrivate::TypedFunction *typedFunction = nullptr;
 
     // first nArguments names in internalClass are the actual arguments
     Heap::InternalClass *internalClass;
     int interpreterCallCount = 0;
+    int jittedCallCount = 0;
     quint16 nFormals;
     enum Kind : quint8 { JsUntyped, JsTyped, AotCompiled, Eval };
     Kind kind = JsUntyped;
     bool detectedInjectedParameters = false;
+    bool optimizationDisabled = false;
+
+#if QT_CONFIG(qml_lookup_counters)
+    // Printed when the function is destroyed.
+    quint64 lookupHits = 0;         // served from the lookup's cache
+    quint64 lookupResolutions = 0;  // the lookup was resolved again for a new internal class
+    quint64 lookupFallbacks = 0;    // took the generic path
+    quint32 megamorphicLookups = 0; // sites that gave up caching
+#endif
 
     static Function *create(ExecutionEngine *engine, ExecutableCompilationUnit *unit,
                             const CompiledData::Function *function,
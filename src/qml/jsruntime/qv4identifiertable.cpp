@@ -111,15 +111,51 @@ Heap::String *IdentifierTable::insertString(const QString &s)
     return resolveStringEntry(s, hash, subtype);
 }
 
-Heap::String *IdentifierTable::resolveStringEntry(const QString &s, uint hash, uint subtype)
+Heap::String *IdentifierTable::insertString(QLatin1StringView s)
+{
+    uint subtype;
+    uint hash = String::createHashValue(s.data(), s.size(), &subtype);
+    if (subtype == Heap::String::StringType_ArrayIndex) {
+        Heap::String *str = engine->newString(s);
+        str->stringHash = hash;
+        str->subtype = subtype;
+        str->identifier = PropertyKey::fromArrayIndex(hash);
+        return str;
+    }
+    return resolveStringEntry(s, hash, subtype);
+}
+
+template<typename StringView>
+Heap::String *IdentifierTable::findStringEntry(StringView s, uint hash) const
 {
+    // Both kinds of text hash to the same value, and can be compared without converting them.
     uint idx = hash % alloc;
     while (Heap::StringOrSymbol *e = entriesByHash[idx]) {
-        if (e->stringHash == hash && e->toQString() == s)
+        if (e->stringHash == hash && e->textEquals(s))
             return static_cast<Heap::String *>(e);
         ++idx;
         idx %= alloc;
     }
+    return nullptr;
+}
+
+Heap::String *IdentifierTable::resolveStringEntry(const QString &s, uint hash, uint subtype)
+{
+    if (Heap::String *str = findStringEntry(QStringView(s), hash))
+        return str;
+
+    // Identifiers live long. Store them compactly where we can.
+    Heap::String *str = engine->newCompactString(s);
+    str->stringHash = hash;
+    str->subtype = subtype;
+    addEntry(str);
+    return str;
+}
+
+Heap::String *IdentifierTable::resolveStringEntry(QLatin1StringView s, uint hash, uint subtype)
+{
+    if (Heap::String *str = findStringEntry(s, hash))
+        return str;
 
     Heap::String *str = engine->newString(s);
     str->stringHash = hash;
@@ -136,7 +172,7 @@ Heap::Symbol *IdentifierTable::insertSymbol(const QString &s)
     uint hash = String::createHashValue(s.constData(), s.size(), &subtype);
     uint idx = hash % alloc;
     while (Heap::StringOrSymbol *e = entriesByHash[idx]) {
-        if (e->stringHash == hash && e->toQString() == s)
+        if (e->stringHash == hash && e->textEquals(QStringView(s)))
             return static_cast<Heap::Symbol *>(e);
         ++idx;
         idx %= alloc;
@@ -163,7 +199,7 @@ PropertyKey IdentifierTable::asPropertyKeyImpl(const Heap::String *str)
 
     uint idx = hash % alloc;
     while (Heap::StringOrSymbol *e = entriesByHash[idx]) {
-        if (e->stringHash == hash && e->toQString() == str->toQString()) {
+        if (e->stringHash == hash && e->hasEqualText(str)) {
             str->identifier = e->identifier;
             return e->identifier;
         }
@@ -264,7 +300,7 @@ PropertyKey IdentifierTable::asPropertyKey(const char *s, int len)
     uint hash = String::createHashValue(s, len, &subtype);
     if (subtype == Heap::String::StringType_ArrayIndex)
         return PropertyKey::fromArrayIndex(hash);
-    return resolveStringEntry(QString::fromLatin1(s, len), hash, subtype)->identifier;
+    return resolveStringEntry(QLatin1StringView(s, len), hash, subtype)->identifier;
 }
 
 }
@@ -44,6 +44,7 @@ public:
     ~IdentifierTable();
 
     Heap::String *insertString(const QString &s);
+    Heap::String *insertString(QLatin1StringView s);
     Heap::Symbol *insertSymbol(const QString &s);
 
     PropertyKey asPropertyKey(const Heap::String *str) {
@@ -76,6 +77,9 @@ public:
 
 private:
     Heap::String *resolveStringEntry(const QString &s, uint hash, uint subtype);
+    Heap::String *resolveStringEntry(QLatin1StringView s, uint hash, uint subtype);
+    template<typename StringView>
+    Heap::String *findStringEntry(StringView s, uint hash) const;
 };
 
 }
@@ -73,6 +73,7 @@ SharedInternalClassDataPrivate<PropertyKey>::SharedInternalClassDataPrivate(cons
     if (other.alloc()) {
         const uint s = other.size();
         data = MemberData::allocate(engine, other.alloc(), other.data);
+        WriteBarrier::writeExternal(engine, data);
         setSize(s);
     }
 }
@@ -83,6 +84,7 @@ SharedInternalClassDataPrivate<PropertyKey>::SharedInternalClassDataPrivate(cons
       engine(other.engine)
 {
     data = MemberData::allocate(engine, other.alloc(), nullptr);
+    WriteBarrier::writeExternal(engine, data);
     memcpy(data, other.data, sizeof(Heap::MemberData) - sizeof(Value) + pos*sizeof(Value));
     data->values.size = pos + 1;
     data->values.set(engine, pos, Value::fromReturnedValue(value.id()));
@@ -93,6 +95,7 @@ void SharedInternalClassDataPrivate<PropertyKey>::grow()
     const uint a = alloc() * 2;
     const uint s = size();
     data = MemberData::allocate(engine, a, data);
+    WriteBarrier::writeExternal(engine, data);
     setSize(s);
     Q_ASSERT(alloc() >= a);
 }
@@ -122,7 +125,7 @@ PropertyKey SharedInternalClassDataPrivate<PropertyKey>::at(uint i) const
 void SharedInternalClassDataPrivate<PropertyKey>::set(uint i, PropertyKey t)
 {
     Q_ASSERT(data && i < size());
-    data->values.values[i].rawValueRef() = t.id();
+    data->values.set(engine, i, Value::fromReturnedValue(t.id()));
 }
 
 void SharedInternalClassDataPrivate<PropertyKey>::mark(MarkStack *s)
@@ -11,12 +11,21 @@
 #include <qv4variantobject_p.h>
 #include "qv4jscall_p.h"
 #include <qv4symbol_p.h>
+#include <private/qv4identifiertable_p.h>
 
+#include <qiodevice.h>
 #include <qstack.h>
+#include <qstringconverter.h>
 #include <qstringlist.h>
+#include <qvarlengtharray.h>
+
+#include <private/qlocale_tools_p.h>
+#include <private/qsimd_p.h>
 
 #include <wtf/MathExtras.h>
 
+#include <charconv>
+
 using namespace QV4;
 
 //#define PARSER_DEBUG
@@ -36,9 +45,14 @@ DEFINE_OBJECT_VTABLE(JsonObject);
 
 static const int nestingLimit = 1024;
 
+// Members of an object are collected before the object is created, up to this number.
+static const int maxBufferedMembers = 32;
+static const int shapeCacheSize = 8;
+
 
 JsonParser::JsonParser(ExecutionEngine *engine, const QChar *json, int length)
-    : engine(engine), head(json), json(json), nestingLevel(0), lastError(QJsonParseError::NoError)
+    : engine(engine), head(json), json(json), shapes(nullptr), nextShape(0), nestingLevel(0)
+    , lastError(QJsonParseError::NoError)
 {
     end = json + length;
 }
@@ -82,22 +96,114 @@ enum {
     EndObject = 0x7d,
     NameSeparator = 0x3a,
     ValueSeparator = 0x2c,
-    Quote = 0x22
+    Quote = 0x22,
+    Backslash = 0x5c,
+    LastControlCharacter = 0x1f
 };
 
-bool JsonParser::eatSpace()
+static inline bool isWhitespace(char16_t ch)
 {
-    while (json < end) {
-        const char16_t ch = json->unicode();
-        if (ch > Space)
-            break;
-        if (ch != Space &&
-            ch != Tab &&
-            ch != LineFeed &&
-            ch != Return)
-            break;
-        ++json;
+    return ch == Space || ch == Tab || ch == LineFeed || ch == Return;
+}
+
+static inline bool isStringSpecial(char16_t ch)
+{
+    return ch == Quote || ch == Backslash || ch <= LastControlCharacter;
+}
+
+#ifdef __SSE2__
+static inline uint whitespaceMask(__m128i data)
+{
+    __m128i mask = _mm_or_si128(_mm_cmpeq_epi16(data, _mm_set1_epi16(Space)),
+                                _mm_cmpeq_epi16(data, _mm_set1_epi16(Tab)));
+    mask = _mm_or_si128(mask, _mm_cmpeq_epi16(data, _mm_set1_epi16(LineFeed)));
+    mask = _mm_or_si128(mask, _mm_cmpeq_epi16(data, _mm_set1_epi16(Return)));
+    return _mm_movemask_epi8(mask);
+}
+
+static inline uint stringSpecialMask(__m128i data)
+{
+    __m128i mask = _mm_or_si128(_mm_cmpeq_epi16(data, _mm_set1_epi16(Quote)),
+                                _mm_cmpeq_epi16(data, _mm_set1_epi16(Backslash)));
+    // The saturating subtraction yields 0 exactly for the control characters.
+    const __m128i control = _mm_subs_epu16(data, _mm_set1_epi16(LastControlCharacter));
+    mask = _mm_or_si128(mask, _mm_cmpeq_epi16(control, _mm_setzero_si128()));
+    return _mm_movemask_epi8(mask);
+}
+#endif
+
+#if defined(Q_PROCESSOR_X86) && QT_COMPILER_SUPPORTS_HERE(AVX2)
+QT_FUNCTION_TARGET(AVX2)
+static const QChar *findStringSpecialAvx2(const QChar *ch, const QChar *end)
+{
+    const __m256i quote = _mm256_set1_epi16(Quote);
+    const __m256i backslash = _mm256_set1_epi16(Backslash);
+    const __m256i lastControlCharacter = _mm256_set1_epi16(LastControlCharacter);
+    for (; end - ch >= 16; ch += 16) {
+        const __m256i data = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(ch));
+        __m256i mask = _mm256_or_si256(_mm256_cmpeq_epi16(data, quote),
+                                       _mm256_cmpeq_epi16(data, backslash));
+        const __m256i control = _mm256_subs_epu16(data, lastControlCharacter);
+        mask = _mm256_or_si256(mask, _mm256_cmpeq_epi16(control, _mm256_setzero_si256()));
+        if (const uint bits = _mm256_movemask_epi8(mask))
+            return ch + qCountTrailingZeroBits(bits) / 2;
     }
+    return ch;
+}
+#endif
+
+/*
+    Whitespace between tokens is mostly absent or consists of a line break and some
+    indentation. Check the first character before looking at whole vectors.
+*/
+static const QChar *skipWhitespace(const QChar *ch, const QChar *end)
+{
+    if (ch == end || !isWhitespace(ch->unicode()))
+        return ch;
+
+#ifdef __SSE2__
+    for (; end - ch >= 8; ch += 8) {
+        const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(ch));
+        if (const uint bits = ~whitespaceMask(data) & 0xffff)
+            return ch + qCountTrailingZeroBits(bits) / 2;
+    }
+#endif
+
+    while (ch < end && isWhitespace(ch->unicode()))
+        ++ch;
+    return ch;
+}
+
+/*
+    Returns the first quote, backslash or control character in [ch, end), or end. Everything
+    before it can be copied into the string verbatim.
+*/
+static const QChar *findStringSpecial(const QChar *ch, const QChar *end)
+{
+#if defined(Q_PROCESSOR_X86) && QT_COMPILER_SUPPORTS_HERE(AVX2)
+    if (qCpuHasFeature(AVX2)) {
+        ch = findStringSpecialAvx2(ch, end);
+        if (end - ch >= 16)
+            return ch;
+    }
+#endif
+
+#ifdef __SSE2__
+    for (; end - ch >= 8; ch += 8) {
+        const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(ch));
+        if (const uint bits = stringSpecialMask(data))
+            return ch + qCountTrailingZeroBits(bits) / 2;
+    }
+#endif
+
+    while (ch < end && !isStringSpecial(ch->unicode()))
+        ++ch;
+    return ch;
+}
+
+bool JsonParser::eatSpace()
+{
+    json = skipWhitespace(json, end);
     return (json < end);
 }
 
@@ -136,6 +242,7 @@ ReturnedValue JsonParser::parse(QJsonParseError *error)
     eatSpace();
 
     Scope scope(engine);
+    shapes = scope.alloc(shapeCacheSize);
     ScopedValue v(scope);
     if (!parseValue(v)) {
 #ifdef PARSER_DEBUG
@@ -162,6 +269,17 @@ ReturnedValue JsonParser::parse(QJsonParseError *error)
     return v->asReturnedValue();
 }
 
+static void insertMember(Object *o, String *key, const Value &val)
+{
+    PropertyKey skey = key->toPropertyKey();
+    if (skey.isArrayIndex()) {
+        o->put(skey.asArrayIndex(), val);
+    } else {
+        // avoid trouble with properties named __proto__
+        o->insertMember(key, val);
+    }
+}
+
 /*
     object = begin-object [ member *( value-separator member ) ]
     end-object
@@ -177,12 +295,29 @@ ReturnedValue JsonParser::parseObject()
     BEGIN << "parseObject pos=" << json;
     Scope scope(engine);
 
-    ScopedObject o(scope, engine->newObject());
+    // Collect the members on the JS stack first, so that objects with the same keys as a
+    // previous one can be created with its internal class right away. Very large objects are
+    // created once the buffer is full, and get the remaining members one by one.
+    ScopedObject o(scope);
+    Value *members = nullptr;
+    int memberCount = 0;
 
     QChar token = nextToken();
     while (token.unicode() == Quote) {
-        if (!parseMember(o))
+        Value *member = o ? members : scope.alloc(2);
+        if (!members)
+            members = member;
+        Q_ASSERT(o || member == members + 2 * memberCount);
+
+        if (!parseMember(member, member + 1))
             return Encode::undefined();
+
+        if (o) {
+            insertMember(o, member[0].as<String>(), member[1]);
+        } else if (++memberCount == maxBufferedMembers) {
+            o = createObject(members, memberCount);
+        }
+
         token = nextToken();
         if (token.unicode() != ValueSeparator)
             break;
@@ -199,6 +334,9 @@ ReturnedValue JsonParser::parseObject()
         return Encode::undefined();
     }
 
+    if (!o)
+        o = createObject(members, memberCount);
+
     END;
 
     --nestingLevel;
@@ -208,36 +346,69 @@ ReturnedValue JsonParser::parseObject()
 /*
     member = string name-separator value
 */
-bool JsonParser::parseMember(Object *o)
+bool JsonParser::parseMember(Value *key, Value *val)
 {
     BEGIN << "parseMember";
-    Scope scope(engine);
 
-    QString key;
-    if (!parseString(&key))
+    QString name;
+    if (!parseString(&name))
         return false;
     QChar token = nextToken();
     if (token.unicode() != NameSeparator) {
         lastError = QJsonParseError::MissingNameSeparator;
         return false;
     }
-    ScopedValue val(scope);
+
+    // Keys tend to repeat. Share one identifier for them.
+    *key = Value::fromHeapObject(engine->identifierTable->insertString(name));
+
     if (!parseValue(val))
         return false;
 
-    ScopedString s(scope, engine->newString(key));
-    PropertyKey skey = s->toPropertyKey();
-    if (skey.isArrayIndex()) {
-        o->put(skey.asArrayIndex(), val);
-    } else {
-        // avoid trouble with properties named __proto__
-        o->insertMember(s, val);
-    }
-
     END;
     return true;
 }
 
+/*
+    Creates an object from count key/value pairs. If a recently created object had exactly
+    the same keys, its internal class is reused and the values are stored directly.
+    Otherwise the members are added one by one, and the resulting internal class is
+    remembered if it maps each key to its own slot.
+*/
+ReturnedValue JsonParser::createObject(Value *members, int count)
+{
+    Scope scope(engine);
+    ScopedObject o(scope);
+
+    for (int i = 0; i < shapeCacheSize; ++i) {
+        Heap::InternalClass *ic = static_cast<Heap::InternalClass *>(shapes[i].heapObject());
+        if (!ic || ic->size != uint(count))
+            continue;
+
+        int j = 0;
+        while (j < count && ic->nameMap.at(j) == members[2 * j].as<String>()->toPropertyKey())
+            ++j;
+        if (j != count)
+            continue;
+
+        o = engine->newObject(ic);
+        for (j = 0; j < count; ++j)
+            o->setProperty(j, members[2 * j + 1]);
+        return o.asReturnedValue();
+    }
+
+    o = engine->newObject();
+    for (int i = 0; i < count; ++i)
+        insertMember(o, members[2 * i].as<String>(), members[2 * i + 1]);
+
+    Heap::InternalClass *ic = o->internalClass();
+    if (count && ic->size == uint(count)) {
+        shapes[nextShape] = Value::fromHeapObject(ic);
+        nextShape = (nextShape + 1) % shapeCacheSize;
+    }
+    return o.asReturnedValue();
+}
+
 /*
     array = begin-array [ value *( value-separator value ) ] end-array
 */
@@ -260,8 +431,8 @@ ReturnedValue JsonParser::parseArray()
         nextToken();
     } else {
         uint index = 0;
+        ScopedValue val(scope);
         while (1) {
-            ScopedValue val(scope);
             if (!parseValue(val))
                 return Encode::undefined();
             array->arraySet(index, val);
@@ -348,7 +519,7 @@ bool JsonParser::parseValue(Value *val)
             return false;
         DEBUG << "value: string";
         END;
-        *val = Value::fromHeapObject(engine->newString(value));
+        *val = Value::fromHeapObject(engine->newCompactString(value));
         return true;
     }
     case BeginArray: {
@@ -436,22 +607,38 @@ bool JsonParser::parseNumber(Value *val)
             ++json;
     }
 
-    QString number(start, json - start);
-    DEBUG << "numberstring" << number;
-
-    if (isInt) {
-        bool ok;
-        int n = number.toInt(&ok);
-        if (ok && n < (1<<25) && n > -(1<<25)) {
-            *val = Value::fromInt32(n);
-            END;
-            return true;
+    const qsizetype length = json - start;
+    DEBUG << "numberstring" << QStringView(start, length);
+
+    if (isInt && length) {
+        // Small integers are common, and don't need a conversion from text.
+        const QChar *digit = start;
+        const bool negative = (*digit == u'-');
+        if (negative)
+            ++digit;
+        if (digit != json && json - digit <= 8) {
+            int n = 0;
+            for (; digit != json; ++digit)
+                n = n * 10 + (digit->unicode() - u'0');
+            if (n < (1<<25)) {
+                *val = Value::fromInt32(negative ? -n : n);
+                END;
+                return true;
+            }
         }
     }
 
-    bool ok;
-    double d;
-    d = number.toDouble(&ok);
+    // The number only contains ASCII characters.
+    QVarLengthArray<char, 64> number(length + 1);
+    for (qsizetype i = 0; i < length; ++i)
+        number[i] = char(start[i].unicode());
+    number[length] = '\0';
+
+    bool ok = false;
+    const char *numberEnd = nullptr;
+    double d = qstrtod(number.constData(), &numberEnd, &ok);
+    if (!length || numberEnd != number.constData() + length)
+        ok = false;
 
     if (!ok) {
         lastError = QJsonParseError::IllegalNumber;
@@ -549,6 +736,14 @@ bool JsonParser::parseString(QString *string)
     BEGIN << "parse string stringPos=" << json;
 
     while (json < end) {
+        // Copy everything up to the next character that needs attention in one go.
+        const QChar *run = json;
+        json = findStringSpecial(json, end);
+        if (json != run)
+            string->append(run, json - run);
+        if (json == end)
+            break;
+
         if (*json == u'"')
             break;
         else if (*json == u'\\') {
@@ -563,12 +758,8 @@ bool JsonParser::parseString(QString *string)
                 *string += QChar(ch);
             }
         } else {
-            if (json->unicode() <= 0x1f) {
-                lastError = QJsonParseError::IllegalEscapeSequence;
-                return false;
-            }
-            *string += *json;
-            ++json;
+            lastError = QJsonParseError::IllegalEscapeSequence;
+            return false;
         }
     }
     ++json;
@@ -583,6 +774,10 @@ bool JsonParser::parseString(QString *string)
 }
 
 
+// The JSON text is collected in a QString. If it is written as UTF-8, it is converted and
+// passed on whenever this many characters have accumulated.
+static const qsizetype flushThreshold = 64 * 1024;
+
 struct Stringify
 {
     ExecutionEngine *v4;
@@ -593,6 +788,26 @@ struct Stringify
     QString indent;
     QStack<Object *> stack;
 
+    QString result;
+    QByteArray *utf8Output;
+    QIODevice *deviceOutput;
+    QStringEncoder encoder;
+    QByteArray chunk;
+    bool outputFailed;
+
+    // The enumerable members of recently serialized internal classes, with their keys
+    // already quoted. The internal classes themselves are kept on the JS stack.
+    struct Member {
+        PropertyKey key;
+        uint index;
+        QString prefix;
+    };
+    Value *shapes;
+    QList<Member> shapeMembers[shapeCacheSize];
+    int nextShape;
+
+    String *toJSON;
+
     bool stackContains(Object *o) {
         for (int i = 0; i < stack.size(); ++i)
             if (stack.at(i)->d() == o->d())
@@ -600,13 +815,27 @@ struct Stringify
         return false;
     }
 
-    Stringify(ExecutionEngine *e) : v4(e), replacerFunction(nullptr), propertyList(nullptr), propertyListSize(0) {}
-
-    QString Str(const QString &key, const Value &v);
-    QString JA(Object *a);
-    QString JO(Object *o);
+    Stringify(Scope &scope)
+        : v4(scope.engine), replacerFunction(nullptr), propertyList(nullptr), propertyListSize(0)
+        , utf8Output(nullptr), deviceOutput(nullptr), encoder(QStringEncoder::Utf8)
+        , outputFailed(false), shapes(scope.alloc(shapeCacheSize)), nextShape(0)
+    {
+        Value *name = scope.alloc();
+        *name = Value::fromHeapObject(v4->newIdentifier(QStringLiteral("toJSON")));
+        toJSON = static_cast<String *>(name);
+    }
 
-    QString makeMember(const QString &key, const Value &v);
+    bool Str(const Value &key, const Value &v);
+    void JA(Object *a);
+    void JO(Object *o);
+
+    void appendEscaped(char16_t c);
+    void quote(QStringView str);
+    void quote(QLatin1StringView str);
+    QString memberPrefix(QStringView key);
+    void appendMember(bool *empty, QStringView prefix, const Value &key, const Value &v);
+    bool plainMembers(Object *o, QList<Member> *members);
+    void flush(bool force = false);
 };
 
 class [[nodiscard]] CallDepthAndCycleChecker
@@ -631,72 +860,108 @@ private:
     ExecutionEngineCallDepthRecorder<1> m_callDepthRecorder;
 };
 
-static QString quote(const QString &str)
+void Stringify::appendEscaped(char16_t c)
 {
-    QString product;
-    const int length = str.size();
-    product.reserve(length + 2);
-    product += u'"';
-    for (int i = 0; i < length; ++i) {
-        QChar c = str.at(i);
-        switch (c.unicode()) {
-        case u'"':
-            product += QLatin1String("\\\"");
-            break;
-        case u'\\':
-            product += QLatin1String("\\\\");
-            break;
-        case u'\b':
-            product += QLatin1String("\\b");
-            break;
-        case u'\f':
-            product += QLatin1String("\\f");
-            break;
-        case u'\n':
-            product += QLatin1String("\\n");
-            break;
-        case u'\r':
-            product += QLatin1String("\\r");
+    switch (c) {
+    case u'"':
+        result += QLatin1String("\\\"");
+        break;
+    case u'\\':
+        result += QLatin1String("\\\\");
+        break;
+    case u'\b':
+        result += QLatin1String("\\b");
+        break;
+    case u'\f':
+        result += QLatin1String("\\f");
+        break;
+    case u'\n':
+        result += QLatin1String("\\n");
+        break;
+    case u'\r':
+        result += QLatin1String("\\r");
+        break;
+    case u'\t':
+        result += QLatin1String("\\t");
+        break;
+    default:
+        Q_ASSERT(c <= LastControlCharacter);
+        result += QLatin1String("\\u00");
+        result += (c > 0xf ? u'1' : u'0');
+        result += QLatin1Char("0123456789abcdef"[c & 0xf]);
+    }
+}
+
+void Stringify::quote(QStringView str)
+{
+    const QChar *ch = str.begin();
+    const QChar *end = str.end();
+    result += u'"';
+    while (ch != end) {
+        // Only quotes, backslashes and control characters need to be escaped.
+        const QChar *run = ch;
+        ch = findStringSpecial(ch, end);
+        if (ch != run)
+            result.append(run, ch - run);
+        if (ch == end)
             break;
-        case u'\t':
-            product += QLatin1String("\\t");
+        appendEscaped((ch++)->unicode());
+    }
+    result += u'"';
+}
+
+void Stringify::quote(QLatin1StringView str)
+{
+    const char *ch = str.begin();
+    const char *end = str.end();
+    result += u'"';
+    while (ch != end) {
+        const char *run = ch;
+        while (ch != end && !isStringSpecial(uchar(*ch)))
+            ++ch;
+        if (ch != run)
+            result += QLatin1StringView(run, ch - run);
+        if (ch == end)
             break;
-        default:
-            if (c.unicode() <= 0x1f) {
-                product += QLatin1String("\\u00");
-                product += (c.unicode() > 0xf ? u'1' : u'0') +
-                        QLatin1Char("0123456789abcdef"[c.unicode() & 0xf]);
-            } else {
-                product += c;
-            }
-        }
+        appendEscaped(uchar(*ch++));
     }
-    product += u'"';
-    return product;
+    result += u'"';
+}
+
+QString Stringify::memberPrefix(QStringView key)
+{
+    // Quote the key into the output buffer, and take it out again.
+    const qsizetype position = result.size();
+    quote(key);
+    result += u':';
+    if (!gap.isEmpty())
+        result += u' ';
+    QString prefix = result.sliced(position);
+    result.truncate(position);
+    return prefix;
 }
 
-QString Stringify::Str(const QString &key, const Value &v)
+bool Stringify::Str(const Value &key, const Value &v)
 {
     Scope scope(v4);
 
     ScopedValue value(scope, v);
     ScopedObject o(scope, value);
     if (o) {
-        ScopedString s(scope, v4->newString(QStringLiteral("toJSON")));
-        ScopedFunctionObject toJSON(scope, o->get(s));
-        if (!!toJSON) {
+        ScopedFunctionObject toJSONFunction(scope, o->get(toJSON));
+        if (!!toJSONFunction) {
             JSCallArguments jsCallData(scope, 1);
             *jsCallData.thisObject = value;
-            jsCallData.args[0] = v4->newString(key);
-            value = toJSON->call(jsCallData);
+            jsCallData.args[0] = key.toString(v4);
+            value = toJSONFunction->call(jsCallData);
             if (v4->hasException)
-                return QString();
+                return false;
         }
     }
 
     if (replacerFunction) {
         JSCallArguments jsCallData(scope, 2);
-        jsCallData.args[0] = v4->newString(key);
+        jsCallData.args[0] = key.toString(v4);
         jsCallData.args[1] = value;
 
         if (stack.isEmpty()) {
@@ -709,7 +974,7 @@ QString Stringify::Str(const QString &key, const Value &v)
 
         value = replacerFunction->call(jsCallData);
         if (v4->hasException)
-            return QString();
+            return false;
     }
 
     o = value->asReturnedValue();
@@ -722,64 +987,175 @@ QString Stringify::Str(const QString &key, const Value &v)
             value = Encode(b->value());
     }
 
-    if (value->isNull())
-        return QStringLiteral("null");
-    if (value->isBoolean())
-        return value->booleanValue() ? QStringLiteral("true") : QStringLiteral("false");
-    if (value->isString())
-        return quote(value->stringValue()->toQString());
+    if (value->isNull()) {
+        result += QLatin1String("null");
+        return true;
+    }
+    if (value->isBoolean()) {
+        result += value->booleanValue() ? QLatin1String("true") : QLatin1String("false");
+        return true;
+    }
+    if (value->isString()) {
+        // Don't convert Latin-1 strings to UTF-16 just to copy them.
+        const Heap::String *string = value->stringValue()->d();
+        if (string->subtype < Heap::String::StringType_AddedString && string->isLatin1()) {
+            const QByteArrayData &text = string->latin1Text();
+            quote(QLatin1StringView(text.data(), text.size));
+        } else {
+            quote(string->toQString());
+        }
+        return true;
+    }
+
+    if (value->isInteger()) {
+        char buffer[16];
+        const auto converted = std::to_chars(buffer, buffer + sizeof buffer,
+                                             value->integerValue());
+        result += QLatin1String(buffer, converted.ptr - buffer);
+        return true;
+    }
 
     if (value->isNumber()) {
         double d = value->toNumber();
-        return std::isfinite(d) ? value->toQString() : QStringLiteral("null");
+        if (std::isfinite(d))
+            result += value->toQString();
+        else
+            result += QLatin1String("null");
+        return true;
     }
 
     if (const QV4::VariantObject *v = value->as<QV4::VariantObject>()) {
-        return quote(v->d()->data().toString());
+        quote(v->d()->data().toString());
+        return true;
     }
 
     o = value->asReturnedValue();
     if (o) {
         if (!o->as<FunctionObject>()) {
             if (o->isArrayLike()) {
-                return JA(o.getPointer());
+                JA(o.getPointer());
             } else {
-                return JO(o);
+                JO(o);
             }
+            return true;
         }
     }
 
-    return QString();
+    return false;
 }
 
-QString Stringify::makeMember(const QString &key, const Value &v)
+void Stringify::appendMember(bool *empty, QStringView prefix, const Value &key, const Value &v)
 {
-    QString strP = Str(key, v);
-    if (!strP.isEmpty()) {
-        QString member = quote(key) + u':';
-        if (!gap.isEmpty())
-            member += u' ';
-        member += strP;
-        return member;
+    const qsizetype position = result.size();
+    if (!*empty)
+        result += u',';
+    if (!gap.isEmpty()) {
+        result += u'\n';
+        result += indent;
     }
-    return QString();
+    result += prefix;
+
+    // Members that don't have a JSON representation are left out.
+    if (Str(key, v))
+        *empty = false;
+    else
+        result.truncate(position);
 }
 
-QString Stringify::JO(Object *o)
+/*
+    Plain objects list their own properties in the order of their internal class. Retrieve
+    the enumerable ones from the cache, or add them to it. Objects with accessors are not
+    cached, as the getters might change the object while it is serialized.
+*/
+bool Stringify::plainMembers(Object *o, QList<Member> *members)
+{
+    if (o->vtable()->ownPropertyKeys != Object::staticVTable()->ownPropertyKeys || o->arrayData())
+        return false;
+
+    Heap::InternalClass *ic = o->internalClass();
+    for (int i = 0; i < shapeCacheSize; ++i) {
+        if (shapes[i].heapObject() == ic) {
+            *members = shapeMembers[i];
+            return true;
+        }
+    }
+
+    QList<Member> list;
+    for (uint i = 0; i < ic->size; ++i) {
+        PropertyKey key = ic->nameMap.at(i);
+        // accessor properties have a dummy entry, and symbols are never serialized
+        if (!key.isString())
+            continue;
+        InternalClassEntry e = ic->find(key);
+        if (!e.isValid())
+            continue;
+        if (e.attributes.isAccessor())
+            return false;
+        if (e.attributes.isEnumerable())
+            list.append({ key, e.index, memberPrefix(key.toQString()) });
+    }
+
+    shapes[nextShape] = Value::fromHeapObject(ic);
+    shapeMembers[nextShape] = list;
+    nextShape = (nextShape + 1) % shapeCacheSize;
+    *members = std::move(list);
+    return true;
+}
+
+void Stringify::flush(bool force)
+{
+    if (!utf8Output && !deviceOutput)
+        return;
+    if (!force && result.size() < flushThreshold)
+        return;
+
+    QByteArray *out = utf8Output ? utf8Output : &chunk;
+    const qsizetype size = utf8Output ? out->size() : 0;
+    out->resize(size + encoder.requiredSpace(result.size()));
+    char *end = encoder.appendToBuffer(out->data() + size, result);
+    out->resize(end - out->constData());
+    result.resize(0);
+
+    if (deviceOutput && deviceOutput->write(chunk) != chunk.size())
+        outputFailed = true;
+}
+
+void Stringify::JO(Object *o)
 {
     CallDepthAndCycleChecker check(this, o);
     if (check.foundProblem())
-        return QString();
+        return;
 
     Scope scope(v4);
 
-    QString result;
     stack.push(o);
     QString stepback = indent;
     indent += gap;
 
-    QStringList partial;
-    if (!propertyListSize) {
+    result += u'{';
+    bool empty = true;
+    QList<Member> members;
+    if (!propertyListSize && plainMembers(o, &members)) {
+        Scoped<InternalClass> ic(scope, o->internalClass());
+        ScopedValue key(scope);
+        ScopedValue val(scope);
+        for (const Member &member : std::as_const(members)) {
+            key = member.key.asStringOrSymbol();
+            if (o->internalClass() == ic->d()) {
+                val = *o->propertyData(member.index);
+            } else {
+                // A toJSON method or the replacer function has changed the object.
+                bool exists;
+                val = o->get(member.key, nullptr, &exists);
+                if (!exists)
+                    continue;
+            }
+            appendMember(&empty, member.prefix, key, val);
+            if (v4->hasException)
+                break;
+            flush();
+        }
+    } else if (!propertyListSize) {
         ObjectIterator it(scope, o, ObjectIterator::EnumerableOnly);
         ScopedValue name(scope);
 
@@ -788,10 +1164,10 @@ QString Stringify::JO(Object *o)
             name = it.nextPropertyNameAsString(val);
             if (name->isNull())
                 break;
-            QString key = name->toQString();
-            QString member = makeMember(key, val);
-            if (!member.isEmpty())
-                partial += member;
+            appendMember(&empty, memberPrefix(name->toQString()), name, val);
+            if (v4->hasException)
+                break;
+            flush();
         }
     } else {
         ScopedValue v(scope);
@@ -803,69 +1179,62 @@ QString Stringify::JO(Object *o)
             v = o->get(s, &exists);
             if (!exists)
                 continue;
-            QString member = makeMember(s->toQString(), v);
-            if (!member.isEmpty())
-                partial += member;
+            appendMember(&empty, memberPrefix(s->toQString()), *s, v);
+            if (v4->hasException)
+                break;
+            flush();
         }
     }
 
-    if (partial.isEmpty()) {
-        result = QStringLiteral("{}");
-    } else if (gap.isEmpty()) {
-        result = u'{' + partial.join(u',') + u'}';
-    } else {
-        QString separator = QLatin1String(",\n") + indent;
-        result = QLatin1String("{\n") + indent + partial.join(separator) + u'\n'
-                 + stepback + u'}';
+    if (!empty && !gap.isEmpty()) {
+        result += u'\n';
+        result += stepback;
     }
+    result += u'}';
 
     indent = stepback;
     stack.pop();
-    return result;
 }
 
-QString Stringify::JA(Object *a)
+void Stringify::JA(Object *a)
 {
     CallDepthAndCycleChecker check(this, a);
     if (check.foundProblem())
-        return QString();
+        return;
 
     Scope scope(a->engine());
 
-    QString result;
     stack.push(a);
     QString stepback = indent;
     indent += gap;
 
-    QStringList partial;
+    result += u'[';
     uint len = a->getLength();
     ScopedValue v(scope);
     for (uint i = 0; i < len; ++i) {
+        if (i)
+            result += u',';
+        if (!gap.isEmpty()) {
+            result += u'\n';
+            result += indent;
+        }
         bool exists;
         v = a->get(i, &exists);
-        if (!exists) {
-            partial += QStringLiteral("null");
-            continue;
-        }
-        QString strP = Str(QString::number(i), v);
-        if (!strP.isEmpty())
-            partial += strP;
-        else
-            partial += QStringLiteral("null");
+        if (!exists || !Str(Value::fromUInt32(i), v))
+            result += QLatin1String("null");
+        if (v4->hasException)
+            break;
+        flush();
     }
 
-    if (partial.isEmpty()) {
-        result = QStringLiteral("[]");
-    } else if (gap.isEmpty()) {
-        result = u'[' + partial.join(u',') + u']';
-    } else {
-        QString separator = QLatin1String(",\n") + indent;
-        result = QLatin1String("[\n") + indent + partial.join(separator) + u'\n' + stepback + u']';
+    if (len && !gap.isEmpty()) {
+        result += u'\n';
+        result += stepback;
     }
+    result += u']';
 
     indent = stepback;
     stack.pop();
-    return result;
 }
 
 
@@ -904,7 +1273,7 @@ ReturnedValue JsonObject::method_parse(const FunctionObject *b, const Value *, c
 ReturnedValue JsonObject::method_stringify(const FunctionObject *b, const Value *, const Value *argv, int argc)
 {
     Scope scope(b);
-    Stringify stringify(scope.engine);
+    Stringify stringify(scope);
 
     ScopedObject o(scope, argc > 1 ? argv[1] : Value::undefinedValue());
     if (o) {
@@ -946,10 +1315,49 @@ ReturnedValue JsonObject::method_stringify(const FunctionObject *b, const Value
 
 
     ScopedValue arg0(scope, argc ? argv[0] : Value::undefinedValue());
-    QString result = stringify.Str(QString(), arg0);
-    if (result.isEmpty() || scope.hasException())
+    if (!stringify.Str(*scope.engine->id_empty(), arg0) || scope.hasException())
         RETURN_UNDEFINED();
-    return Encode(scope.engine->newString(result));
+    return Encode(scope.engine->newString(stringify.result));
+}
+
+/*
+    Writes the JSON text for value to output as UTF-8, the same way as JSON.stringify(value,
+    null, gap) would produce it. The text is converted in chunks while it is generated, so
+    that large object graphs don't need a complete UTF-16 copy of it. Returns false if value
+    has no JSON representation, or if an exception was thrown, or if writing failed.
+    In that case, output may already contain part of the text.
+*/
+bool JsonObject::stringify(ExecutionEngine *engine, const Value &value, QIODevice *output,
+                           const QString &gap)
+{
+    Scope scope(engine);
+    Stringify stringify(scope);
+    stringify.gap = gap.left(10);
+    stringify.deviceOutput = output;
+
+    ScopedValue v(scope, value);
+    if (!stringify.Str(*engine->id_empty(), v) || engine->hasException)
+        return false;
+    stringify.flush(true);
+    return !stringify.outputFailed;
+}
+
+/*
+    Appends the JSON text for value to output as UTF-8. See above.
+*/
+bool JsonObject::stringify(ExecutionEngine *engine, const Value &value, QByteArray *output,
+                           const QString &gap)
+{
+    Scope scope(engine);
+    Stringify stringify(scope);
+    stringify.gap = gap.left(10);
+    stringify.utf8Output = output;
+
+    ScopedValue v(scope, value);
+    if (!stringify.Str(*engine->id_empty(), v) || engine->hasException)
+        return false;
+    stringify.flush(true);
+    return true;
 }
 
 
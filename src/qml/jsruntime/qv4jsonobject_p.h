@@ -23,6 +23,8 @@
 
 QT_BEGIN_NAMESPACE
 
+class QIODevice;
+
 namespace QV4 {
 
 namespace Heap {
@@ -55,6 +57,13 @@ public:
     static ReturnedValue method_parse(const FunctionObject *, const Value *thisObject, const Value *argv, int argc);
     static ReturnedValue method_stringify(const FunctionObject *, const Value *thisObject, const Value *argv, int argc);
 
+    Q_QML_PRIVATE_EXPORT static bool stringify(
+            ExecutionEngine *engine, const Value &value, QIODevice *output,
+            const QString &gap = QString());
+    Q_QML_PRIVATE_EXPORT static bool stringify(
+            ExecutionEngine *engine, const Value &value, QByteArray *output,
+            const QString &gap = QString());
+
     static ReturnedValue fromJsonValue(ExecutionEngine *engine, const QJsonValue &value);
     static ReturnedValue fromJsonObject(ExecutionEngine *engine, const QJsonObject &object);
     static ReturnedValue fromJsonArray(ExecutionEngine *engine, const QJsonArray &array);
@@ -86,16 +95,22 @@ private:
 
     ReturnedValue parseObject();
     ReturnedValue parseArray();
-    bool parseMember(Object *o);
+    bool parseMember(Value *key, Value *val);
     bool parseString(QString *string);
     bool parseValue(Value *val);
     bool parseNumber(Value *val);
 
+    ReturnedValue createObject(Value *members, int count);
+
     ExecutionEngine *engine;
     const QChar *head;
     const QChar *json;
     const QChar *end;
 
+    // Internal classes of recently parsed objects, kept on the JS stack.
+    Value *shapes;
+    int nextShape;
+
     int nestingLevel;
     QJsonParseError::ParseError lastError;
 };
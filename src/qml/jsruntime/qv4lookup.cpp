@@ -10,6 +10,17 @@ QT_BEGIN_NAMESPACE
 
 using namespace QV4;
 
+#if QT_CONFIG(qml_lookup_counters)
+// Lookups can also be made from native code, without a JavaScript function on the stack.
+#  define COUNT_LOOKUP(engine, counter) \
+    do { \
+        const CppStackFrame *frame = (engine)->currentStackFrame; \
+        if (Function *function = frame ? frame->v4Function : nullptr) \
+            ++function->counter; \
+    } while (false)
+#else
+#  define COUNT_LOOKUP(engine, counter)
+#endif
 
 void Lookup::resolveProtoGetter(PropertyKey name, const Heap::Object *proto)
 {
@@ -109,6 +120,7 @@ ReturnedValue Lookup::resolveGlobalGetter(ExecutionEngine *engine)
 
 ReturnedValue Lookup::getterGeneric(Lookup *l, ExecutionEngine *engine, const Value &object)
 {
+    COUNT_LOOKUP(engine, lookupResolutions);
     if (const Object *o = object.as<Object>())
         return l->resolveGetter(engine, o);
     return l->resolvePrimitiveGetter(engine, object);
@@ -140,9 +152,148 @@ static inline void setupProtoLookupTwoClasses(Lookup *l, const Lookup &first, co
     l->protoLookupTwoClasses.data2 = data2;
 }
 
+static inline void addPolymorphicEntry(
+        PolymorphicLookupCache *cache, PolymorphicLookupCache::Kind kind,
+        Heap::InternalClass *ic, uint offset)
+{
+    Q_ASSERT(cache->size < PolymorphicLookupCache::Size);
+    PolymorphicLookupCache::Entry &entry = cache->entries[cache->size++];
+    entry.ic = ic;
+    entry.offset = offset;
+    entry.kind = kind;
+}
+
+static inline void addPolymorphicEntry(
+        PolymorphicLookupCache *cache, PolymorphicLookupCache::Kind kind,
+        quintptr protoId, const Value *data)
+{
+    Q_ASSERT(cache->size < PolymorphicLookupCache::Size);
+    PolymorphicLookupCache::Entry &entry = cache->entries[cache->size++];
+    entry.protoId = protoId;
+    entry.data = data;
+    entry.kind = kind;
+}
+
+// Adds the result of resolving a getter for a single internal class to the cache. Returns false
+// if the cache is full or cannot represent the result.
+static bool addPolymorphicEntry(PolymorphicLookupCache *cache, const Lookup &l)
+{
+    if (cache->size == PolymorphicLookupCache::Size)
+        return false;
+
+    if (l.getter == Lookup::getter0Inline) {
+        addPolymorphicEntry(cache, PolymorphicLookupCache::Inline,
+                            l.objectLookup.ic, l.objectLookup.offset);
+    } else if (l.getter == Lookup::getter0MemberData) {
+        addPolymorphicEntry(cache, PolymorphicLookupCache::MemberData,
+                            l.objectLookup.ic, l.objectLookup.offset);
+    } else if (l.getter == Lookup::getterAccessor) {
+        addPolymorphicEntry(cache, PolymorphicLookupCache::Accessor,
+                            l.objectLookup.ic, l.objectLookup.offset);
+    } else if (l.getter == Lookup::getterProto) {
+        addPolymorphicEntry(cache, PolymorphicLookupCache::Proto,
+                            l.protoLookup.protoId, l.protoLookup.data);
+    } else if (l.getter == Lookup::getterProtoAccessor) {
+        addPolymorphicEntry(cache, PolymorphicLookupCache::ProtoAccessor,
+                            l.protoLookup.protoId, l.protoLookup.data);
+    } else {
+        return false;
+    }
+    return true;
+}
+
+static inline void setupPolymorphicLookup(Lookup *l, PolymorphicLookupCache *cache)
+{
+    l->clear();
+    l->polymorphicLookup.cache = cache;
+}
+
+// Gives up on caching. From now on the lookup always takes the generic path.
+static inline void setupMegamorphicLookup(Lookup *l, ExecutionEngine *engine)
+{
+    Q_UNUSED(engine);
+    COUNT_LOOKUP(engine, megamorphicLookups);
+    l->releasePropertyCache();
+    l->clear();
+}
+
+static ReturnedValue getterPolymorphicMiss(Lookup *l, ExecutionEngine *engine, const Value &object)
+{
+    const Object *o = object.as<Object>();
+    if (!o) {
+        // Primitives can't be cached here, but they don't spoil the cache either.
+        return Lookup::getterFallback(l, engine, object);
+    }
+
+    COUNT_LOOKUP(engine, lookupResolutions);
+
+    // Do the resolution on a second lookup, then merge.
+    Lookup second;
+    memset(&second, 0, sizeof(Lookup));
+    second.nameIndex = l->nameIndex;
+    second.forCall = l->forCall;
+    second.getter = Lookup::getterGeneric;
+    const ReturnedValue result = second.resolveGetter(engine, o);
+
+    // Resolving may call into JavaScript, which may have changed the lookup in the meantime.
+    if (l->getter == Lookup::getterPolymorphic
+            && !addPolymorphicEntry(l->polymorphicLookup.cache, second)) {
+        setupMegamorphicLookup(l, engine);
+        l->getter = Lookup::getterFallback;
+    }
+
+    // If the entry was added, the propertyCache was inactive.
+    second.releasePropertyCache();
+    return result;
+}
+
+// Moves the internal classes of a lookup that just missed into a polymorphic cache, and adds the
+// internal class of object to it.
+static ReturnedValue getterToPolymorphic(Lookup *l, ExecutionEngine *engine, const Value &object)
+{
+    PolymorphicLookupCache *cache = new PolymorphicLookupCache;
+    if (l->getter == Lookup::getter0Inlinegetter0Inline
+            || l->getter == Lookup::getter0Inlinegetter0MemberData
+            || l->getter == Lookup::getter0MemberDatagetter0MemberData) {
+        addPolymorphicEntry(cache, l->getter == Lookup::getter0MemberDatagetter0MemberData
+                                    ? PolymorphicLookupCache::MemberData
+                                    : PolymorphicLookupCache::Inline,
+                            l->objectLookupTwoClasses.ic, l->objectLookupTwoClasses.offset);
+        addPolymorphicEntry(cache, l->getter == Lookup::getter0Inlinegetter0Inline
+                                    ? PolymorphicLookupCache::Inline
+                                    : PolymorphicLookupCache::MemberData,
+                            l->objectLookupTwoClasses.ic2, l->objectLookupTwoClasses.offset2);
+    } else {
+        Q_ASSERT(l->getter == Lookup::getterProtoTwoClasses
+                 || l->getter == Lookup::getterProtoAccessorTwoClasses);
+        const auto kind = (l->getter == Lookup::getterProtoTwoClasses)
+                ? PolymorphicLookupCache::Proto
+                : PolymorphicLookupCache::ProtoAccessor;
+        addPolymorphicEntry(cache, kind,
+                            l->protoLookupTwoClasses.protoId, l->protoLookupTwoClasses.data);
+        addPolymorphicEntry(cache, kind,
+                            l->protoLookupTwoClasses.protoId2, l->protoLookupTwoClasses.data2);
+    }
+
+    setupPolymorphicLookup(l, cache);
+    l->getter = Lookup::getterPolymorphic;
+    return getterPolymorphicMiss(l, engine, object);
+}
+
+static inline ReturnedValue callAccessorGetter(
+        ExecutionEngine *engine, const Value *getter, const Value &object)
+{
+    if (!getter->isFunctionObject()) // ### catch at resolve time
+        return Encode::undefined();
+
+    return checkedResult(engine, static_cast<const FunctionObject *>(getter)->call(
+                             &object, nullptr, 0));
+}
+
 ReturnedValue Lookup::getterTwoClasses(Lookup *l, ExecutionEngine *engine, const Value &object)
 {
     if (const Object *o = object.as<Object>()) {
+        COUNT_LOOKUP(engine, lookupResolutions);
 
         // Do the resolution on a second lookup, then merge.
         Lookup second;
@@ -183,8 +334,18 @@ ReturnedValue Lookup::getterTwoClasses(Lookup *l, ExecutionEngine *engine, const
             return result;
         }
 
+        // The two internal classes need different kinds of lookups.
+        PolymorphicLookupCache *cache = new PolymorphicLookupCache;
+        if (addPolymorphicEntry(cache, *l) && addPolymorphicEntry(cache, second)) {
+            setupPolymorphicLookup(l, cache);
+            l->getter = getterPolymorphic;
+            return result;
+        }
+        delete cache;
+
         // If any of the above options were true, the propertyCache was inactive.
         second.releasePropertyCache();
+        setupMegamorphicLookup(l, engine);
     }
 
     l->getter = getterFallback;
@@ -193,6 +354,7 @@ ReturnedValue Lookup::getterTwoClasses(Lookup *l, ExecutionEngine *engine, const
 
 ReturnedValue Lookup::getterFallback(Lookup *l, ExecutionEngine *engine, const Value &object)
 {
+    COUNT_LOOKUP(engine, lookupFallbacks);
     QV4::Scope scope(engine);
     QV4::ScopedObject o(scope, object.toObject(scope.engine));
     if (!o)
@@ -207,8 +369,10 @@ ReturnedValue Lookup::getter0MemberData(Lookup *l, ExecutionEngine *engine, cons
     // the internal class won't match
     Heap::Object *o = static_cast<Heap::Object *>(object.heapObject());
     if (o) {
-        if (l->objectLookup.ic == o->internalClass)
+        if (l->objectLookup.ic == o->internalClass) {
+            COUNT_LOOKUP(engine, lookupHits);
             return o->memberData->values.data()[l->objectLookup.offset].asReturnedValue();
+        }
     }
     return getterTwoClasses(l, engine, object);
 }
@@ -219,8 +383,10 @@ ReturnedValue Lookup::getter0Inline(Lookup *l, ExecutionEngine *engine, const Va
     // the internal class won't match
     Heap::Object *o = static_cast<Heap::Object *>(object.heapObject());
     if (o) {
-        if (l->objectLookup.ic == o->internalClass)
+        if (l->objectLookup.ic == o->internalClass) {
+            COUNT_LOOKUP(engine, lookupHits);
             return o->inlinePropertyDataWithOffset(l->objectLookup.offset)->asReturnedValue();
+        }
     }
     return getterTwoClasses(l, engine, object);
 }
@@ -234,8 +400,10 @@ ReturnedValue Lookup::getterProto(Lookup *l, ExecutionEngine *engine, const Valu
     // the internal class won't match
     Heap::Object *o = static_cast<Heap::Object *>(object.heapObject());
     if (o) {
-        if (l->protoLookup.protoId == o->internalClass->protoId)
+        if (l->protoLookup.protoId == o->internalClass->protoId) {
+            COUNT_LOOKUP(engine, lookupHits);
             return l->protoLookup.data->asReturnedValue();
+        }
     }
     return getterTwoClasses(l, engine, object);
 }
@@ -246,13 +414,16 @@ ReturnedValue Lookup::getter0Inlinegetter0Inline(Lookup *l, ExecutionEngine *eng
     // the internal class won't match
     Heap::Object *o = static_cast<Heap::Object *>(object.heapObject());
     if (o) {
-        if (l->objectLookupTwoClasses.ic == o->internalClass)
+        if (l->objectLookupTwoClasses.ic == o->internalClass) {
+            COUNT_LOOKUP(engine, lookupHits);
             return o->inlinePropertyDataWithOffset(l->objectLookupTwoClasses.offset)->asReturnedValue();
-        if (l->objectLookupTwoClasses.ic2 == o->internalClass)
+        }
+        if (l->objectLookupTwoClasses.ic2 == o->internalClass) {
+            COUNT_LOOKUP(engine, lookupHits);
             return o->inlinePropertyDataWithOffset(l->objectLookupTwoClasses.offset2)->asReturnedValue();
+        }
     }
-    l->getter = getterFallback;
-    return getterFallback(l, engine, object);
+    return getterToPolymorphic(l, engine, object);
 }
 
 ReturnedValue Lookup::getter0Inlinegetter0MemberData(Lookup *l, ExecutionEngine *engine, const Value &object)
@@ -261,13 +432,16 @@ ReturnedValue Lookup::getter0Inlinegetter0MemberData(Lookup *l, ExecutionEngine
     // the internal class won't match
     Heap::Object *o = static_cast<Heap::Object *>(object.heapObject());
     if (o) {
-        if (l->objectLookupTwoClasses.ic == o->internalClass)
+        if (l->objectLookupTwoClasses.ic == o->internalClass) {
+            COUNT_LOOKUP(engine, lookupHits);
             return o->inlinePropertyDataWithOffset(l->objectLookupTwoClasses.offset)->asReturnedValue();
-        if (l->objectLookupTwoClasses.ic2 == o->internalClass)
+        }
+        if (l->objectLookupTwoClasses.ic2 == o->internalClass) {
+            COUNT_LOOKUP(engine, lookupHits);
             return o->memberData->values.data()[l->objectLookupTwoClasses.offset2].asReturnedValue();
+        }
     }
-    l->getter = getterFallback;
-    return getterFallback(l, engine, object);
+    return getterToPolymorphic(l, engine, object);
 }
 
 ReturnedValue Lookup::getter0MemberDatagetter0MemberData(Lookup *l, ExecutionEngine *engine, const Value &object)
@@ -276,13 +450,16 @@ ReturnedValue Lookup::getter0MemberDatagetter0MemberData(Lookup *l, ExecutionEng
     // the internal class won't match
     Heap::Object *o = static_cast<Heap::Object *>(object.heapObject());
     if (o) {
-        if (l->objectLookupTwoClasses.ic == o->internalClass)
+        if (l->objectLookupTwoClasses.ic == o->internalClass) {
+            COUNT_LOOKUP(engine, lookupHits);
             return o->memberData->values.data()[l->objectLookupTwoClasses.offset].asReturnedValue();
-        if (l->objectLookupTwoClasses.ic2 == o->internalClass)
+        }
+        if (l->objectLookupTwoClasses.ic2 == o->internalClass) {
+            COUNT_LOOKUP(engine, lookupHits);
             return o->memberData->values.data()[l->objectLookupTwoClasses.offset2].asReturnedValue();
+        }
     }
-    l->getter = getterFallback;
-    return getterFallback(l, engine, object);
+    return getterToPolymorphic(l, engine, object);
 }
 
 ReturnedValue Lookup::getterProtoTwoClasses(Lookup *l, ExecutionEngine *engine, const Value &object)
@@ -294,14 +471,16 @@ ReturnedValue Lookup::getterProtoTwoClasses(Lookup *l, ExecutionEngine *engine,
     // the internal class won't match
     Heap::Object *o = static_cast<Heap::Object *>(object.heapObject());
     if (o) {
-        if (l->protoLookupTwoClasses.protoId == o->internalClass->protoId)
+        if (l->protoLookupTwoClasses.protoId == o->internalClass->protoId) {
+            COUNT_LOOKUP(engine, lookupHits);
             return l->protoLookupTwoClasses.data->asReturnedValue();
-        if (l->protoLookupTwoClasses.protoId2 == o->internalClass->protoId)
+        }
+        if (l->protoLookupTwoClasses.protoId2 == o->internalClass->protoId) {
+            COUNT_LOOKUP(engine, lookupHits);
             return l->protoLookupTwoClasses.data2->asReturnedValue();
-        return getterFallback(l, engine, object);
+        }
     }
-    l->getter = getterFallback;
-    return getterFallback(l, engine, object);
+    return getterToPolymorphic(l, engine, object);
 }
 
 ReturnedValue Lookup::getterAccessor(Lookup *l, ExecutionEngine *engine, const Value &object)
@@ -311,16 +490,11 @@ ReturnedValue Lookup::getterAccessor(Lookup *l, ExecutionEngine *engine, const V
     Heap::Object *o = static_cast<Heap::Object *>(object.heapObject());
     if (o) {
         if (l->objectLookup.ic == o->internalClass) {
-            const Value *getter = o->propertyData(l->objectLookup.offset);
-            if (!getter->isFunctionObject()) // ### catch at resolve time
-                return Encode::undefined();
-
-            return checkedResult(engine, static_cast<const FunctionObject *>(getter)->call(
-                                     &object, nullptr, 0));
+            COUNT_LOOKUP(engine, lookupHits);
+            return callAccessorGetter(engine, o->propertyData(l->objectLookup.offset), object);
         }
     }
-    l->getter = getterFallback;
-    return getterFallback(l, engine, object);
+    return getterTwoClasses(l, engine, object);
 }
 
 ReturnedValue Lookup::getterProtoAccessor(Lookup *l, ExecutionEngine *engine, const Value &object)
@@ -332,12 +506,8 @@ ReturnedValue Lookup::getterProtoAccessor(Lookup *l, ExecutionEngine *engine, co
     // the internal class won't match
     Heap::Object *o = static_cast<Heap::Object *>(object.heapObject());
     if (o && l->protoLookup.protoId == o->internalClass->protoId) {
-        const Value *getter = l->protoLookup.data;
-        if (!getter->isFunctionObject()) // ### catch at resolve time
-            return Encode::undefined();
-
-        return checkedResult(engine, static_cast<const FunctionObject *>(getter)->call(
-                                 &object, nullptr, 0));
+        COUNT_LOOKUP(engine, lookupHits);
+        return callAccessorGetter(engine, l->protoLookup.data, object);
     }
     return getterTwoClasses(l, engine, object);
 }
@@ -357,15 +527,58 @@ ReturnedValue Lookup::getterProtoAccessorTwoClasses(Lookup *l, ExecutionEngine *
         else if (l->protoLookupTwoClasses.protoId2 == o->internalClass->protoId)
             getter = l->protoLookupTwoClasses.data2;
         if (getter) {
-            if (!getter->isFunctionObject()) // ### catch at resolve time
-                return Encode::undefined();
+            COUNT_LOOKUP(engine, lookupHits);
+            return callAccessorGetter(engine, getter, object);
+        }
+    }
+    return getterToPolymorphic(l, engine, object);
+}
 
-            return checkedResult(engine, static_cast<const FunctionObject *>(getter)->call(
-                                     &object, nullptr, 0));
+ReturnedValue Lookup::getterPolymorphic(Lookup *l, ExecutionEngine *engine, const Value &object)
+{
+    // Otherwise we cannot trust the protoIds
+    Q_ASSERT(engine->isInitialized);
+
+    // we can safely cast to a QV4::Object here. If object is actually a string,
+    // the internal class won't match
+    Heap::Object *o = static_cast<Heap::Object *>(object.heapObject());
+    if (o) {
+        const Heap::InternalClass *ic = o->internalClass;
+        const PolymorphicLookupCache *cache = l->polymorphicLookup.cache;
+        for (uint i = 0; i < cache->size; ++i) {
+            const PolymorphicLookupCache::Entry &entry = cache->entries[i];
+            switch (entry.kind) {
+            case PolymorphicLookupCache::Inline:
+                if (entry.ic != ic)
+                    continue;
+                COUNT_LOOKUP(engine, lookupHits);
+                return o->inlinePropertyDataWithOffset(entry.offset)->asReturnedValue();
+            case PolymorphicLookupCache::MemberData:
+                if (entry.ic != ic)
+                    continue;
+                COUNT_LOOKUP(engine, lookupHits);
+                return o->memberData->values.data()[entry.offset].asReturnedValue();
+            case PolymorphicLookupCache::Accessor:
+                if (entry.ic != ic)
+                    continue;
+                COUNT_LOOKUP(engine, lookupHits);
+                return callAccessorGetter(engine, o->propertyData(entry.offset), object);
+            case PolymorphicLookupCache::Proto:
+                if (entry.protoId != ic->protoId)
+                    continue;
+                COUNT_LOOKUP(engine, lookupHits);
+                return entry.data->asReturnedValue();
+            case PolymorphicLookupCache::ProtoAccessor:
+                if (entry.protoId != ic->protoId)
+                    continue;
+                COUNT_LOOKUP(engine, lookupHits);
+                return callAccessorGetter(engine, entry.data, object);
+            case PolymorphicLookupCache::Property:
+                Q_UNREACHABLE();
+            }
         }
     }
-    l->getter = getterFallback;
-    return getterFallback(l, engine, object);
+    return getterPolymorphicMiss(l, engine, object);
 }
 
 ReturnedValue Lookup::getterIndexed(Lookup *l, ExecutionEngine *engine, const Value &object)
@@ -500,8 +713,42 @@ bool Lookup::resolveSetter(ExecutionEngine *engine, Object *object, const Value
     return object->resolveLookupSetter(engine, this, value);
 }
 
+static bool setterPolymorphicMiss(Lookup *l, ExecutionEngine *engine, Value &object, const Value &value)
+{
+    if (!object.isObject())
+        return Lookup::setterFallback(l, engine, object, value);
+
+    COUNT_LOOKUP(engine, lookupResolutions);
+
+    // Do the resolution on a second lookup, then merge. This also stores the value.
+    Lookup second;
+    memset(&second, 0, sizeof(Lookup));
+    second.nameIndex = l->nameIndex;
+    second.forCall = l->forCall;
+    second.setter = Lookup::setterGeneric;
+    const bool result = second.resolveSetter(engine, static_cast<Object *>(&object), value);
+
+    // Resolving may call into JavaScript, which may have changed the lookup in the meantime.
+    if (l->setter == Lookup::setterPolymorphic) {
+        PolymorphicLookupCache *cache = l->polymorphicLookup.cache;
+        if (result && cache->size < PolymorphicLookupCache::Size
+                && (second.setter == Lookup::setter0MemberData
+                    || second.setter == Lookup::setter0Inline)) {
+            addPolymorphicEntry(cache, PolymorphicLookupCache::Property,
+                                second.objectLookup.ic, second.objectLookup.index);
+            return true;
+        }
+        setupMegamorphicLookup(l, engine);
+        l->setter = Lookup::setterFallback;
+    }
+
+    second.releasePropertyCache();
+    return result;
+}
+
 bool Lookup::setterGeneric(Lookup *l, ExecutionEngine *engine, Value &object, const Value &value)
 {
+    COUNT_LOOKUP(engine, lookupResolutions);
     if (object.isObject())
         return l->resolveSetter(engine, static_cast<Object *>(&object), value);
 
@@ -522,6 +769,7 @@ bool Lookup::setterTwoClasses(Lookup *l, ExecutionEngine *engine, Value &object,
     Q_ASSERT(l->setter == setter0MemberData || l->setter == setter0Inline);
 
     if (object.isObject()) {
+        COUNT_LOOKUP(engine, lookupResolutions);
 
         // As l->objectLookup is active, we can stash some members here, before resolving.
         Heap::InternalClass *ic = l->objectLookup.ic;
@@ -533,15 +781,19 @@ bool Lookup::setterTwoClasses(Lookup *l, ExecutionEngine *engine, Value &object,
         }
 
         if (l->setter == Lookup::setter0MemberData || l->setter == Lookup::setter0Inline) {
+            // objectLookup and objectLookupTwoClasses overlap. Read the new class first.
+            Heap::InternalClass *ic2 = l->objectLookup.ic;
+            const uint index2 = l->objectLookup.index;
             l->objectLookupTwoClasses.ic = ic;
-            l->objectLookupTwoClasses.ic2 = ic;
+            l->objectLookupTwoClasses.ic2 = ic2;
             l->objectLookupTwoClasses.offset = index;
-            l->objectLookupTwoClasses.offset2 = index;
+            l->objectLookupTwoClasses.offset2 = index2;
             l->setter = setter0setter0;
             return true;
         }
 
         l->releasePropertyCache();
+        COUNT_LOOKUP(engine, megamorphicLookups);
     }
 
     l->setter = setterFallback;
@@ -550,6 +802,7 @@ bool Lookup::setterTwoClasses(Lookup *l, ExecutionEngine *engine, Value &object,
 
 bool Lookup::setterFallback(Lookup *l, ExecutionEngine *engine, Value &object, const Value &value)
 {
+    COUNT_LOOKUP(engine, lookupFallbacks);
     QV4::Scope scope(engine);
     QV4::ScopedObject o(scope, object.toObject(scope.engine));
     if (!o)
@@ -563,6 +816,7 @@ bool Lookup::setter0MemberData(Lookup *l, ExecutionEngine *engine, Value &object
 {
     Heap::Object *o = static_cast<Heap::Object *>(object.heapObject());
     if (o && o->internalClass == l->objectLookup.ic) {
+        COUNT_LOOKUP(engine, lookupHits);
         o->memberData->values.set(engine, l->objectLookup.offset, value);
         return true;
     }
@@ -574,6 +828,7 @@ bool Lookup::setter0Inline(Lookup *l, ExecutionEngine *engine, Value &object, co
 {
     Heap::Object *o = static_cast<Heap::Object *>(object.heapObject());
     if (o && o->internalClass == l->objectLookup.ic) {
+        COUNT_LOOKUP(engine, lookupHits);
         o->setInlinePropertyWithOffset(engine, l->objectLookup.offset, value);
         return true;
     }
@@ -586,17 +841,44 @@ bool Lookup::setter0setter0(Lookup *l, ExecutionEngine *engine, Value &object, c
     Heap::Object *o = static_cast<Heap::Object *>(object.heapObject());
     if (o) {
         if (o->internalClass == l->objectLookupTwoClasses.ic) {
+            COUNT_LOOKUP(engine, lookupHits);
             o->setProperty(engine, l->objectLookupTwoClasses.offset, value);
             return true;
         }
         if (o->internalClass == l->objectLookupTwoClasses.ic2) {
+            COUNT_LOOKUP(engine, lookupHits);
             o->setProperty(engine, l->objectLookupTwoClasses.offset2, value);
             return true;
         }
     }
 
-    l->setter = setterFallback;
-    return setterFallback(l, engine, object, value);
+    PolymorphicLookupCache *cache = new PolymorphicLookupCache;
+    addPolymorphicEntry(cache, PolymorphicLookupCache::Property,
+                        l->objectLookupTwoClasses.ic, l->objectLookupTwoClasses.offset);
+    addPolymorphicEntry(cache, PolymorphicLookupCache::Property,
+                        l->objectLookupTwoClasses.ic2, l->objectLookupTwoClasses.offset2);
+    setupPolymorphicLookup(l, cache);
+    l->setter = setterPolymorphic;
+    return setterPolymorphicMiss(l, engine, object, value);
+}
+
+bool Lookup::setterPolymorphic(Lookup *l, ExecutionEngine *engine, Value &object, const Value &value)
+{
+    Heap::Object *o = static_cast<Heap::Object *>(object.heapObject());
+    if (o) {
+        const PolymorphicLookupCache *cache = l->polymorphicLookup.cache;
+        for (uint i = 0; i < cache->size; ++i) {
+            const PolymorphicLookupCache::Entry &entry = cache->entries[i];
+            Q_ASSERT(entry.kind == PolymorphicLookupCache::Property);
+            if (entry.ic == o->internalClass) {
+                COUNT_LOOKUP(engine, lookupHits);
+                o->setProperty(engine, entry.offset, value);
+                return true;
+            }
+        }
+    }
+
+    return setterPolymorphicMiss(l, engine, object, value);
 }
 
 bool Lookup::setterInsert(Lookup *l, ExecutionEngine *engine, Value &object, const Value &value)
@@ -606,6 +888,7 @@ bool Lookup::setterInsert(Lookup *l, ExecutionEngine *engine, Value &object, con
 
     Object *o = static_cast<Object *>(object.managed());
     if (o && o->internalClass()->protoId == l->insertionLookup.protoId) {
+        COUNT_LOOKUP(engine, lookupHits);
         o->setInternalClass(l->insertionLookup.newClass);
         o->d()->setProperty(engine, l->insertionLookup.offset, value);
         return true;
@@ -28,6 +28,46 @@ namespace Heap {
     struct QObjectMethod;
 }
 
+// Used by lookups that have seen more than two internal classes for plain JavaScript objects. Once
+// more than Size different internal classes have been seen, or one of them needs a kind of lookup
+// that cannot be cached here, the lookup becomes megamorphic and always takes the generic path.
+struct PolymorphicLookupCache
+{
+    enum { Size = 8 };
+
+    enum Kind : quint8 {
+        Inline,         // offset is the offset of the inline property
+        MemberData,     // offset is the index into the member data
+        Accessor,       // offset is the index of the property
+        Proto,          // data points to the value found in the prototype chain
+        ProtoAccessor,  // data points to the getter found in the prototype chain
+        Property        // setter only, offset is the index of the property
+    };
+
+    struct Entry {
+        union {
+            Heap::InternalClass *ic; // Inline, MemberData, Accessor, Property
+            quintptr protoId;        // Proto, ProtoAccessor
+        };
+        union {
+            uint offset;
+            const Value *data;
+        };
+        Kind kind;
+    };
+
+    Entry entries[Size];
+    uint size = 0;
+
+    void markObjects(MarkStack *stack)
+    {
+        for (uint i = 0; i < size; ++i) {
+            if (entries[i].kind != Proto && entries[i].kind != ProtoAccessor)
+                entries[i].ic->mark(stack);
+        }
+    }
+};
+
 // Note: We cannot hide the copy ctor and assignment operator of this class because it needs to
 //       be trivially copyable. But you should never ever copy it. There are refcounted members
 //       in there.
@@ -77,6 +117,11 @@ struct Q_QML_PRIVATE_EXPORT Lookup {
             const Value *data;
             quintptr type;
         } primitiveLookup;
+        struct {
+            quintptr unused;  // always 0, the internal classes are marked through the cache
+            quintptr unused2;
+            PolymorphicLookupCache *cache;
+        } polymorphicLookup;
         struct {
             Heap::InternalClass *newClass;
             quintptr protoId;
@@ -175,6 +220,7 @@ struct Q_QML_PRIVATE_EXPORT Lookup {
     static ReturnedValue getterAccessor(Lookup *l, ExecutionEngine *engine, const Value &object);
     static ReturnedValue getterProtoAccessor(Lookup *l, ExecutionEngine *engine, const Value &object);
     static ReturnedValue getterProtoAccessorTwoClasses(Lookup *l, ExecutionEngine *engine, const Value &object);
+    static ReturnedValue getterPolymorphic(Lookup *l, ExecutionEngine *engine, const Value &object);
     static ReturnedValue getterIndexed(Lookup *l, ExecutionEngine *engine, const Value &object);
     static ReturnedValue getterQObject(Lookup *l, ExecutionEngine *engine, const Value &object);
     static ReturnedValue getterQObjectMethod(Lookup *l, ExecutionEngine *engine, const Value &object);
@@ -194,6 +240,7 @@ struct Q_QML_PRIVATE_EXPORT Lookup {
     static bool setter0MemberData(Lookup *l, ExecutionEngine *engine, Value &object, const Value &value);
     static bool setter0Inline(Lookup *l, ExecutionEngine *engine, Value &object, const Value &value);
     static bool setter0setter0(Lookup *l, ExecutionEngine *engine, Value &object, const Value &value);
+    static bool setterPolymorphic(Lookup *l, ExecutionEngine *engine, Value &object, const Value &value);
     static bool setterInsert(Lookup *l, ExecutionEngine *engine, Value &object, const Value &value);
     static bool setterQObject(Lookup *l, ExecutionEngine *engine, Value &object, const Value &value);
     static bool arrayLengthSetter(Lookup *l, ExecutionEngine *engine, Value &object, const Value &value);
@@ -203,6 +250,8 @@ struct Q_QML_PRIVATE_EXPORT Lookup {
             markDef.h1->mark(stack);
         if (markDef.h2 && !(reinterpret_cast<quintptr>(markDef.h2) & 1))
             markDef.h2->mark(stack);
+        if ((getter == getterPolymorphic || setter == setterPolymorphic) && polymorphicLookup.cache)
+            polymorphicLookup.cache->markObjects(stack);
     }
 
     void clear() {
@@ -224,6 +273,9 @@ struct Q_QML_PRIVATE_EXPORT Lookup {
                    || qmlContextPropertyGetter == QQmlContextWrapper::lookupContextObjectMethod) {
             if (const QQmlPropertyCache *pc = qobjectMethodLookup.propertyCache)
                 pc->release();
+        } else if (getter == getterPolymorphic || setter == setterPolymorphic) {
+            delete polymorphicLookup.cache;
+            polymorphicLookup.cache = nullptr;
         }
     }
 };
@@ -38,9 +38,8 @@ ReturnedValue MapIteratorPrototype::method_next(const FunctionObject *b, const V
 
     Value *arguments = scope.alloc(2);
 
-    while (index < s->d()->esTable->size()) {
-        s->d()->esTable->iterate(index, &arguments[0], &arguments[1]);
-        thisObject->d()->mapNextIndex = index + 1;
+    while (s->d()->esTable->iterate(&index, &arguments[0], &arguments[1])) {
+        thisObject->d()->mapNextIndex = index;
 
         ScopedValue result(scope);
 
@@ -215,7 +215,14 @@ ReturnedValue WeakMapPrototype::method_set(const FunctionObject *b, const Value
         (!argc || !argv[0].isObject()))
         return scope.engine->throwTypeError();
 
-    that->d()->esTable->set(argv[0], argc > 1 ? argv[1] : Value::undefinedValue());
+    Value key = argv[0];
+    Value value = argc > 1 ? argv[1] : Value::undefinedValue();
+    // The table's storage isn't covered by the regular write barrier.
+    WriteBarrier::markCustom(scope.engine, that->d(), [&](MarkStack *ms) {
+        key.mark(ms);
+        value.mark(ms);
+    });
+    that->d()->esTable->set(key, value);
     return that.asReturnedValue();
 }
 
@@ -270,9 +277,8 @@ ReturnedValue MapPrototype::method_forEach(const FunctionObject *b, const Value
 
     Value *arguments = scope.alloc(3);
     arguments[2] = that;
-    for (uint i = 0; i < that->d()->esTable->size(); ++i) {
-        that->d()->esTable->iterate(i, &arguments[1], &arguments[0]); // fill in key (0), value (1)
-
+    uint i = 0;
+    while (that->d()->esTable->iterate(&i, &arguments[1], &arguments[0])) { // fill in key (0), value (1)
         callbackfn->call(thisArg, arguments, 3);
         CHECK_EXCEPTION();
     }
@@ -318,7 +324,14 @@ ReturnedValue MapPrototype::method_set(const FunctionObject *b, const Value *thi
     if (!that || that->d()->isWeakMap)
         return scope.engine->throwTypeError();
 
-    that->d()->esTable->set(argc ? argv[0] : Value::undefinedValue(), argc > 1 ? argv[1] : Value::undefinedValue());
+    Value key = argc ? argv[0] : Value::undefinedValue();
+    Value value = argc > 1 ? argv[1] : Value::undefinedValue();
+    // The table's storage isn't covered by the regular write barrier.
+    WriteBarrier::markCustom(scope.engine, that->d(), [&](MarkStack *ms) {
+        key.mark(ms);
+        value.mark(ms);
+    });
+    that->d()->esTable->set(key, value);
     return that.asReturnedValue();
 }
 
@@ -2,20 +2,29 @@
 // SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
 
 #include "qv4profiling_p.h"
+#include <private/qv4executableallocator_p.h>
 #include <private/qv4mm_p.h>
 #include <private/qv4string_p.h>
 
+#include <QtCore/qrandom.h>
+#include <QtCore/qvarlengtharray.h>
+
 QT_BEGIN_NAMESPACE
 
 namespace QV4 {
 namespace Profiling {
 
+static FunctionLocation functionLocation(const Function *function)
+{
+    return FunctionLocation(function->name()->toQString(),
+                            function->executableCompilationUnit()->fileName(),
+                            function->compiledFunction->location.line(),
+                            function->compiledFunction->location.column());
+}
+
 FunctionLocation FunctionCall::resolveLocation() const
 {
-    return FunctionLocation(m_function->name()->toQString(),
-                            m_function->executableCompilationUnit()->fileName(),
-                            m_function->compiledFunction->location.line(),
-                            m_function->compiledFunction->location.column());
+    return functionLocation(m_function);
 }
 
 FunctionCallProperties FunctionCall::properties() const
@@ -33,10 +42,16 @@ Profiler::Profiler(QV4::ExecutionEngine *engine) : featuresEnabled(0), m_engine(
     static const int metatypes[] = {
         qRegisterMetaType<QVector<QV4::Profiling::FunctionCallProperties> >(),
         qRegisterMetaType<QVector<QV4::Profiling::MemoryAllocationProperties> >(),
-        qRegisterMetaType<FunctionLocationHash>()
+        qRegisterMetaType<FunctionLocationHash>(),
+        qRegisterMetaType<AllocationSiteHash>()
     };
     Q_UNUSED(metatypes);
     m_timer.start();
+
+    bool ok = false;
+    const int interval = qEnvironmentVariableIntValue("QV4_PROFILE_ALLOCATION_SAMPLE_INTERVAL", &ok);
+    if (ok && interval > 0)
+        m_allocationSampleInterval = interval;
 }
 
 void Profiler::stopProfiling()
@@ -44,6 +59,8 @@ void Profiler::stopProfiling()
     featuresEnabled = 0;
     reportData();
     m_sentLocations.clear();
+    m_allocationTree.clear();
+    m_allocationTreeIndices.clear();
 }
 
 bool operator<(const FunctionCall &call1, const FunctionCall &call2)
@@ -73,11 +90,86 @@ void Profiler::reportData()
         }
     }
 
-    emit dataReady(locations, properties, m_memory_data);
+    AllocationSiteHash allocationSites;
+    for (const MemoryAllocationProperties &allocation : std::as_const(m_memory_data)) {
+        if (allocation.type == AllocationSample && !allocationSites.contains(allocation.allocationSite))
+            allocationSites.insert(allocation.allocationSite, allocationSite(allocation.allocationSite));
+    }
+
+    emit dataReady(locations, properties, m_memory_data, allocationSites);
     m_data.clear();
     m_memory_data.clear();
 }
 
+// The interval is varied randomly around the configured one. Otherwise, a program that
+// allocates in a fixed pattern could always be sampled at the same allocation.
+qint64 Profiler::nextAllocationSampleInterval() const
+{
+    return m_allocationSampleInterval / 2
+            + QRandomGenerator::global()->bounded(m_allocationSampleInterval);
+}
+
+// Records the JavaScript stack of the current allocation. The sample stands for all bytes
+// allocated since the previous one.
+void Profiler::sampleAllocation(qint64 timestamp)
+{
+    // Deeply recursive code would otherwise create a separate branch of the tree for each level.
+    enum { MaxSampledFrames = 32 };
+
+    const qint64 size = m_currentAllocationSampleInterval - m_bytesUntilAllocationSample;
+    m_currentAllocationSampleInterval = nextAllocationSampleInterval();
+    m_bytesUntilAllocationSample = m_currentAllocationSampleInterval;
+
+    QVarLengthArray<Function *, MaxSampledFrames> functions;
+    for (CppStackFrame *frame = m_engine->currentStackFrame;
+         frame && functions.size() < MaxSampledFrames; frame = frame->parentFrame()) {
+        if (frame->v4Function)
+            functions.append(frame->v4Function);
+    }
+
+    int node = allocationTreeNode(-1, nullptr);
+    for (auto it = functions.crbegin(), end = functions.crend(); it != end; ++it)
+        node = allocationTreeNode(node, *it);
+
+    MemoryAllocationProperties sample = {timestamp, size, AllocationSample, node};
+    m_memory_data.append(sample);
+}
+
+int Profiler::allocationTreeNode(int parent, Function *function)
+{
+    const QPair<int, Function *> key(parent, function);
+    auto it = m_allocationTreeIndices.constFind(key);
+    if (it != m_allocationTreeIndices.constEnd())
+        return *it;
+
+    const int node = int(m_allocationTree.size());
+    m_allocationTree.push_back({
+        parent, function,
+        QQmlRefPointer<ExecutableCompilationUnit>(
+                function ? function->executableCompilationUnit() : nullptr)
+    });
+    m_allocationTreeIndices.insert(key, node);
+    return node;
+}
+
+AllocationSite Profiler::allocationSite(int node) const
+{
+    AllocationSite site;
+    const Function *innermost = m_allocationTree[node].function;
+    if (!innermost)
+        return site;
+
+    site.location = functionLocation(innermost);
+    QStringList stack;
+    for (; node >= 0 && m_allocationTree[node].function; node = m_allocationTree[node].parent) {
+        const FunctionLocation location = functionLocation(m_allocationTree[node].function);
+        stack.append(QStringLiteral("%1 (%2:%3)").arg(location.name, location.file,
+                                                      QString::number(location.line)));
+    }
+    site.stack = stack.join(QLatin1Char('\n'));
+    return site;
+}
+
 void Profiler::startProfiling(quint64 features)
 {
     if (featuresEnabled == 0) {
@@ -86,16 +178,25 @@ void Profiler::startProfiling(quint64 features)
             MemoryAllocationProperties heap = {timestamp,
                                                (qint64)m_engine->memoryManager->getAllocatedMem() -
                                                (qint64)m_engine->memoryManager->getLargeItemsMem(),
-                                               HeapPage};
+                                               HeapPage, -1};
             m_memory_data.append(heap);
             MemoryAllocationProperties smallP = {timestamp,
                                                 (qint64)m_engine->memoryManager->getUsedMem(),
-                                                SmallItem};
+                                                SmallItem, -1};
             m_memory_data.append(smallP);
             MemoryAllocationProperties large = {timestamp,
                                                 (qint64)m_engine->memoryManager->getLargeItemsMem(),
-                                                LargeItem};
+                                                LargeItem, -1};
             m_memory_data.append(large);
+            MemoryAllocationProperties jit = {
+                timestamp, (qint64)m_engine->executableAllocator->statistics().mappedBytes,
+                JitCodePage, -1};
+            m_memory_data.append(jit);
+        }
+
+        if (m_allocationSampleInterval) {
+            m_currentAllocationSampleInterval = nextAllocationSampleInterval();
+            m_bytesUntilAllocationSample = m_currentAllocationSampleInterval;
         }
 
         featuresEnabled = features;
@@ -21,6 +21,8 @@
 
 #include <QElapsedTimer>
 
+#include <vector>
+
 #if !QT_CONFIG(qml_debug)
 
 #define Q_V4_PROFILE_ALLOC(engine, size, type) (!engine)
@@ -66,7 +68,9 @@ enum Features {
 enum MemoryType {
     HeapPage,
     LargeItem,
-    SmallItem
+    SmallItem,
+    JitCodePage,
+    AllocationSample
 };
 
 struct FunctionCallProperties {
@@ -98,8 +102,19 @@ struct MemoryAllocationProperties {
     qint64 timestamp;
     qint64 size;
     MemoryType type;
+    int allocationSite; // for AllocationSample, the key into the AllocationSiteHash
+};
+
+// Where a sampled allocation happened: The function that allocated, and the JavaScript stack
+// leading to it, as one line per function, innermost first. Both are empty for allocations
+// that happened while no JavaScript was running.
+struct AllocationSite {
+    FunctionLocation location;
+    QString stack;
 };
 
+typedef QHash<int, QV4::Profiling::AllocationSite> AllocationSiteHash;
+
 class FunctionCall {
 public:
     FunctionCall() : m_function(nullptr), m_start(0), m_end(0) {}
@@ -210,8 +225,13 @@ public:
     bool trackAlloc(size_t size, MemoryType type)
     {
         if (size) {
-            MemoryAllocationProperties allocation = {m_timer.nsecsElapsed(), (qint64)size, type};
+            MemoryAllocationProperties allocation = {m_timer.nsecsElapsed(), (qint64)size, type, -1};
             m_memory_data.append(allocation);
+            if (m_allocationSampleInterval && (type == SmallItem || type == LargeItem)) {
+                m_bytesUntilAllocationSample -= qint64(size);
+                if (m_bytesUntilAllocationSample <= 0)
+                    sampleAllocation(allocation.timestamp);
+            }
             return true;
         } else {
             return false;
@@ -221,7 +241,7 @@ public:
     bool trackDealloc(size_t size, MemoryType type)
     {
         if (size) {
-            MemoryAllocationProperties allocation = {m_timer.nsecsElapsed(), -(qint64)size, type};
+            MemoryAllocationProperties allocation = {m_timer.nsecsElapsed(), -(qint64)size, type, -1};
             m_memory_data.append(allocation);
             return true;
         } else {
@@ -239,15 +259,37 @@ public:
 Q_SIGNALS:
     void dataReady(const QV4::Profiling::FunctionLocationHash &,
                    const QVector<QV4::Profiling::FunctionCallProperties> &,
-                   const QVector<QV4::Profiling::MemoryAllocationProperties> &);
+                   const QVector<QV4::Profiling::MemoryAllocationProperties> &,
+                   const QV4::Profiling::AllocationSiteHash &);
 
 private:
+    // A node in the call tree of the sampled allocations. Node 0 is the root, standing for
+    // allocations without JavaScript on the stack.
+    struct AllocationTreeNode {
+        int parent;
+        Function *function;
+        QQmlRefPointer<ExecutableCompilationUnit> unit; // keeps the function alive
+    };
+
+    void sampleAllocation(qint64 timestamp);
+    int allocationTreeNode(int parent, Function *function);
+    AllocationSite allocationSite(int node) const;
+    qint64 nextAllocationSampleInterval() const;
+
     QV4::ExecutionEngine *m_engine;
     QElapsedTimer m_timer;
     QVector<FunctionCall> m_data;
     QVector<MemoryAllocationProperties> m_memory_data;
     QHash<quintptr, SentMarker> m_sentLocations;
 
+    // Every m_allocationSampleInterval bytes on average, the JavaScript stack of an allocation
+    // is recorded. 0 means that allocations aren't sampled.
+    qint64 m_allocationSampleInterval = 0;
+    qint64 m_currentAllocationSampleInterval = 0;
+    qint64 m_bytesUntilAllocationSample = 0;
+    std::vector<AllocationTreeNode> m_allocationTree;
+    QHash<QPair<int, Function *>, int> m_allocationTreeIndices;
+
     friend class FunctionCallProfiler;
 };
 
@@ -286,12 +328,14 @@ Q_DECLARE_TYPEINFO(QV4::Profiling::MemoryAllocationProperties, Q_RELOCATABLE_TYP
 Q_DECLARE_TYPEINFO(QV4::Profiling::FunctionCallProperties, Q_RELOCATABLE_TYPE);
 Q_DECLARE_TYPEINFO(QV4::Profiling::FunctionCall, Q_RELOCATABLE_TYPE);
 Q_DECLARE_TYPEINFO(QV4::Profiling::FunctionLocation, Q_RELOCATABLE_TYPE);
+Q_DECLARE_TYPEINFO(QV4::Profiling::AllocationSite, Q_RELOCATABLE_TYPE);
 Q_DECLARE_TYPEINFO(QV4::Profiling::Profiler::SentMarker, Q_RELOCATABLE_TYPE);
 
 QT_END_NAMESPACE
 Q_DECLARE_METATYPE(QV4::Profiling::FunctionLocationHash)
 Q_DECLARE_METATYPE(QVector<QV4::Profiling::FunctionCallProperties>)
 Q_DECLARE_METATYPE(QVector<QV4::Profiling::MemoryAllocationProperties>)
+Q_DECLARE_METATYPE(QV4::Profiling::AllocationSiteHash)
 
 #endif // QT_CONFIG(qml_debug)
 
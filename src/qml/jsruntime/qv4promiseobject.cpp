@@ -50,38 +50,13 @@ void dropException(QV4::ExecutionEngine* e)
 namespace QV4 {
 namespace Promise {
 
-const int PROMISE_REACTION_EVENT = QEvent::registerEventType();
-const int PROMISE_RESOLVE_THENABLE_EVENT = QEvent::registerEventType();
-
-struct ReactionEvent : public QEvent
-{
-    ReactionEvent(ExecutionEngine *e, const Value *reaction_, const Value *resolution_)
-            : QEvent(QEvent::Type(PROMISE_REACTION_EVENT)),
-              reaction{e, *reaction_},
-              resolution{e, *resolution_}
-    {}
-
-    QV4::PersistentValue reaction;
-    QV4::PersistentValue resolution;
-};
-
-struct ResolveThenableEvent : public QEvent
-{
-    ResolveThenableEvent(ExecutionEngine *e, const PromiseObject *promise_, const Object *thenable_, const FunctionObject *then_)
-        : QEvent(QEvent::Type(PROMISE_RESOLVE_THENABLE_EVENT)), promise(e, *promise_), thenable(e, *thenable_), then(e, *then_)
-    {}
-
-    QV4::PersistentValue promise;
-    QV4::PersistentValue thenable;
-    QV4::PersistentValue then;
-};
-
+const int PROMISE_MICROTASKS_EVENT = QEvent::registerEventType();
 
 } // namespace Promise
 } // namespace QV4
 
-ReactionHandler::ReactionHandler(QObject *parent)
-    : QObject(parent)
+ReactionHandler::ReactionHandler(ExecutionEngine *engine, QObject *parent)
+    : QObject(parent), m_engine(engine)
 {}
 
 ReactionHandler::~ReactionHandler()
@@ -89,35 +64,84 @@ ReactionHandler::~ReactionHandler()
 
 void ReactionHandler::addReaction(ExecutionEngine *e, const Value *reaction, const Value *value)
 {
-    QCoreApplication::postEvent(this, new ReactionEvent(e, reaction, value));
+    Q_ASSERT(e == m_engine);
+    Q_UNUSED(e);
+    enqueue({ Job::Reaction, { *reaction, *value, Value::undefinedValue() } });
 }
 
 void ReactionHandler::addResolveThenable(ExecutionEngine *e, const PromiseObject *promise, const Object *thenable, const FunctionObject *then)
 {
-    QCoreApplication::postEvent(this, new ResolveThenableEvent(e, promise, thenable, then));
+    Q_ASSERT(e == m_engine);
+    Q_UNUSED(e);
+    enqueue({ Job::ResolveThenable, { *promise, *thenable, *then } });
+}
+
+void ReactionHandler::markObjects(MarkStack *markStack)
+{
+    const size_t mask = m_jobs.size() - 1;
+    for (size_t i = 0; i < m_size; ++i) {
+        Job &job = m_jobs[(m_head + i) & mask];
+        for (Value &value : job.values)
+            value.mark(markStack);
+    }
+}
+
+void ReactionHandler::enqueue(const Job &job)
+{
+    if (m_size == m_jobs.size()) {
+        std::vector<Job> jobs(std::max<size_t>(64, m_jobs.size() * 2));
+        for (size_t i = 0; i < m_size; ++i)
+            jobs[i] = m_jobs[(m_head + i) & (m_jobs.size() - 1)];
+        m_jobs.swap(jobs);
+        m_head = 0;
+    }
+
+    m_jobs[(m_head + m_size) & (m_jobs.size() - 1)] = job;
+    ++m_size;
+
+    if (!m_drainPending) {
+        m_drainPending = true;
+        QCoreApplication::postEvent(this, new QEvent(QEvent::Type(PROMISE_MICROTASKS_EVENT)));
+    }
 }
 
 void ReactionHandler::customEvent(QEvent *event)
 {
-    if (event)
-    {
-        const int type = event->type();
-        if (type == PROMISE_REACTION_EVENT)
-            executeReaction(static_cast<ReactionEvent*>(event));
+    if (event && event->type() == PROMISE_MICROTASKS_EVENT)
+        drain();
+}
 
-        if (type == PROMISE_RESOLVE_THENABLE_EVENT)
-            executeResolveThenable(static_cast<ResolveThenableEvent*>(event));
+void ReactionHandler::drain()
+{
+    Scope scope(m_engine);
+    Value *values = scope.alloc(3);
+
+    while (m_size) {
+        // The job may add further jobs, so take it out of the buffer first.
+        Job &job = m_jobs[m_head];
+        const Job::Kind kind = job.kind;
+        std::copy(std::begin(job.values), std::end(job.values), values);
+        m_head = (m_head + 1) & (m_jobs.size() - 1);
+        --m_size;
+
+        if (kind == Job::Reaction)
+            executeReaction(values[0], values[1]);
+        else
+            executeResolveThenable(values[0], values[1], values[2]);
     }
+
+    m_head = 0;
+    m_drainPending = false;
 }
 
-void ReactionHandler::executeReaction(ReactionEvent *event)
+void ReactionHandler::executeReaction(const Value &reaction, const Value &resolutionValue)
 {
-    Scope scope(event->reaction.engine());
+    Scope scope(m_engine);
 
-    Scoped<QV4::PromiseReaction> ro(scope, event->reaction.as<QV4::PromiseReaction>());
+    Scoped<QV4::PromiseReaction> ro(scope, reaction.as<QV4::PromiseReaction>());
     Scoped<QV4::PromiseCapability> capability(scope, ro->d()->capability);
 
-    ScopedValue resolution(scope, event->resolution.value());
+    ScopedValue resolution(scope, resolutionValue);
     ScopedValue promise(scope, capability->d()->promise);
 
     if (ro->d()->type == Heap::PromiseReaction::Function) {
@@ -188,17 +212,17 @@ public:
 }
 
 
-void ReactionHandler::executeResolveThenable(ResolveThenableEvent *event)
+void ReactionHandler::executeResolveThenable(const Value &promiseValue, const Value &thenable, const Value &then)
 {
-    Scope scope(event->then.engine());
+    Scope scope(m_engine);
     JSCallArguments jsCallData(scope, 2);
-    PromiseObject *promise = event->promise.as<PromiseObject>();
+    const PromiseObject *promise = promiseValue.as<PromiseObject>();
     ScopedFunctionObject resolve {scope, FunctionBuilder::makeResolveFunction(scope.engine, promise->d())};
     ScopedFunctionObject reject {scope, FunctionBuilder::makeRejectFunction(scope.engine, promise->d())};
     jsCallData.args[0] = resolve;
     jsCallData.args[1] = reject;
-    jsCallData.thisObject = event->thenable.as<QV4::Object>();
-    event->then.as<const FunctionObject>()->call(jsCallData);
+    *jsCallData.thisObject = thenable;
+    then.as<FunctionObject>()->call(jsCallData);
     if (scope.hasException()) {
         JSCallArguments rejectCallData(scope, 1);
         rejectCallData.args[0] = scope.engine->catchException();
@@ -17,6 +17,8 @@
 #include "qv4object_p.h"
 #include "qv4functionobject_p.h"
 
+#include <vector>
+
 QT_BEGIN_NAMESPACE
 
 namespace QV4 {
@@ -25,24 +27,46 @@ struct PromiseCapability;
 
 namespace Promise {
 
-struct ReactionEvent;
-struct ResolveThenableEvent;
-
+// Queues the jobs that run the reactions to settled promises. As the spec describes for its
+// microtasks, the queue is drained in one go once control returns to the event loop. Only
+// one event is posted for that, no matter how many jobs are added in the meantime, and jobs
+// added while draining the queue are run in the same batch.
 class ReactionHandler : public QObject
 {
     Q_OBJECT
 
 public:
-    ReactionHandler(QObject *parent = nullptr);
+    ReactionHandler(ExecutionEngine *engine, QObject *parent = nullptr);
     ~ReactionHandler() override;
 
     void addReaction(ExecutionEngine *e, const Value *reaction, const Value *value);
     void addResolveThenable(ExecutionEngine *e, const PromiseObject *promise, const Object *thenable, const FunctionObject *then);
 
+    void markObjects(MarkStack *markStack);
+
 protected:
+    struct Job
+    {
+        enum Kind { Reaction, ResolveThenable };
+
+        Kind kind;
+        // reaction and resolution, or promise, thenable and then
+        Value values[3];
+    };
+
     void customEvent(QEvent *event) override;
-    void executeReaction(ReactionEvent *event);
-    void executeResolveThenable(ResolveThenableEvent *event);
+    void enqueue(const Job &job);
+    void drain();
+    void executeReaction(const Value &reaction, const Value &resolution);
+    void executeResolveThenable(const Value &promise, const Value &thenable, const Value &then);
+
+    ExecutionEngine *m_engine;
+
+    // Ring buffer with a capacity that is a power of two.
+    std::vector<Job> m_jobs;
+    size_t m_head = 0;
+    size_t m_size = 0;
+    bool m_drainPending = false;
 };
 
 } // Promise
@@ -7,8 +7,71 @@
 #include <private/qv4mm_p.h>
 #include <runtime/VM.h>
 
+#include <QtCore/qatomic.h>
+#include <QtCore/qmutex.h>
+
+#include <memory>
+
 using namespace QV4;
 
+namespace QV4 {
+
+// Parsing a pattern and compiling it to byte code only depends on the pattern and the flags, so
+// all regular expressions with the same pattern and flags share the results, in all engines. The
+// JIT code stays with each regular expression, as it lives in the executable memory of its
+// engine.
+struct RegExpPattern
+{
+    RegExpPattern(const QString &pattern, uint flags);
+
+    static RegExpPattern *get(const QString &pattern, uint flags);
+
+    void ref() { refCount.ref(); }
+    void deref()
+    {
+        if (!refCount.deref())
+            delete this;
+    }
+
+    bool ensureByteCode();
+
+    QAtomicInt refCount;
+
+    // Compiling modifies the Yarr pattern, and the interpreter uses the allocator while it runs
+    // the byte code. Engines on different threads need to take turns.
+    QMutex mutex;
+    std::unique_ptr<JSC::Yarr::YarrPattern> yarrPattern;
+    WTF::BumpPointerAllocator allocator;
+    std::unique_ptr<JSC::Yarr::BytecodePattern> byteCode;
+    bool byteCodeFailed = false;
+
+    int subPatternCount = 0;
+    bool valid = false;
+    bool containsBackreferences = false;
+};
+
+}
+
+namespace {
+
+struct RegExpPatternCache
+{
+    enum { MaxSize = 2048 };
+
+    ~RegExpPatternCache()
+    {
+        for (RegExpPattern *pattern : std::as_const(patterns))
+            pattern->deref();
+    }
+
+    QMutex mutex;
+    QHash<RegExpCacheKey, RegExpPattern *> patterns; // each holds a reference
+};
+
+}
+
+Q_GLOBAL_STATIC(RegExpPatternCache, regExpPatternCache)
+
 static JSC::RegExpFlags jscFlags(uint flags)
 {
     JSC::RegExpFlags jscFlags = JSC::NoFlags;
@@ -25,6 +88,69 @@ static JSC::RegExpFlags jscFlags(uint flags)
     return jscFlags;
 }
 
+RegExpPattern::RegExpPattern(const QString &pattern, uint flags)
+    : refCount(1)
+{
+    JSC::Yarr::ErrorCode error = JSC::Yarr::ErrorCode::NoError;
+    auto parsed = std::make_unique<JSC::Yarr::YarrPattern>(WTF::String(pattern), jscFlags(flags),
+                                                           error);
+    if (error != JSC::Yarr::ErrorCode::NoError)
+        return;
+
+    subPatternCount = parsed->m_numSubpatterns;
+    valid = true;
+    containsBackreferences = parsed->m_containsBackreferences;
+    yarrPattern = std::move(parsed);
+}
+
+// Returns the shared pattern with an added reference.
+RegExpPattern *RegExpPattern::get(const QString &pattern, uint flags)
+{
+    const RegExpCacheKey key(pattern, flags);
+    RegExpPatternCache *cache = regExpPatternCache();
+    {
+        QMutexLocker locker(&cache->mutex);
+        if (RegExpPattern *shared = cache->patterns.value(key)) {
+            shared->ref();
+            return shared;
+        }
+    }
+
+    // Parse without holding the lock. If another thread was faster, use its result.
+    RegExpPattern *parsed = new RegExpPattern(pattern, flags);
+    QMutexLocker locker(&cache->mutex);
+    if (RegExpPattern *shared = cache->patterns.value(key)) {
+        shared->ref();
+        locker.unlock();
+        parsed->deref();
+        return shared;
+    }
+
+    // Regular expressions that are still alive keep their patterns.
+    if (cache->patterns.size() >= RegExpPatternCache::MaxSize) {
+        for (RegExpPattern *shared : std::as_const(cache->patterns))
+            shared->deref();
+        cache->patterns.clear();
+    }
+    parsed->ref();
+    cache->patterns.insert(key, parsed);
+    return parsed;
+}
+
+// Has to be called with the mutex locked.
+bool RegExpPattern::ensureByteCode()
+{
+    Q_ASSERT(valid);
+    if (!byteCode && !byteCodeFailed) {
+        // This moves the character classes from the Yarr pattern to the byte code. The terms of
+        // the Yarr pattern still point to them, so it stays usable for the JIT as long as the
+        // byte code is alive.
+        byteCode = JSC::Yarr::byteCompile(*yarrPattern, &allocator);
+        byteCodeFailed = !byteCode;
+    }
+    return byteCode != nullptr;
+}
+
 RegExpCache::~RegExpCache()
 {
     for (RegExpCache::Iterator it = begin(), e = end(); it != e; ++it) {
@@ -40,11 +166,14 @@ uint RegExp::match(const QString &string, int start, uint *matchOffsets)
     if (!isValid())
         return JSC::Yarr::offsetNoMatch;
 
+    auto *priv = d();
+    if (!priv->compiled)
+        priv->compile();
+
     WTF::String s(string);
 
 #if ENABLE(YARR_JIT)
     static const uint offsetJITFail = std::numeric_limits<unsigned>::max() - 1;
-    auto *priv = d();
     if (priv->hasValidJITCode()) {
         uint ret = JSC::Yarr::offsetNoMatch;
 #if ENABLE(YARR_JIT_ALL_PARENS_EXPRESSIONS)
@@ -59,22 +188,19 @@ uint RegExp::match(const QString &string, int start, uint *matchOffsets)
             return ret;
 
         // JIT failed. We need byteCode to run the interpreter.
-        if (!priv->byteCode) {
-            JSC::Yarr::ErrorCode error = JSC::Yarr::ErrorCode::NoError;
-            JSC::Yarr::YarrPattern yarrPattern(WTF::String(*priv->pattern), jscFlags(priv->flags),
-                                               error);
-
-            // As we successfully parsed the pattern before, we should still be able to.
-            Q_ASSERT(error == JSC::Yarr::ErrorCode::NoError);
-
-            priv->byteCode = JSC::Yarr::byteCompile(
-                                     yarrPattern,
-                                     priv->internalClass->engine->bumperPointerAllocator).release();
-        }
     }
 #endif // ENABLE(YARR_JIT)
 
-    return JSC::Yarr::interpret(byteCode(), s.characters16(), string.size(), start, matchOffsets);
+    RegExpPattern *shared = priv->sharedPattern;
+    QMutexLocker locker(&shared->mutex);
+    if (!shared->ensureByteCode()) {
+        locker.unlock();
+        engine()->throwSyntaxError(QStringLiteral("Cannot compile regular expression /%1/%2")
+                                           .arg(*priv->pattern, priv->flagsAsString()));
+        return JSC::Yarr::offsetNoMatch;
+    }
+    return JSC::Yarr::interpret(shared->byteCode.get(), s.characters16(), string.size(), start,
+                                matchOffsets);
 }
 
 QString RegExp::getSubstitution(const QString &matched, const QString &str, int position, const Value *captures, int nCaptures, const QString &replacement)
@@ -170,33 +296,38 @@ Heap::RegExp *RegExp::create(ExecutionEngine* engine, const QString& pattern, ui
 
 void Heap::RegExp::init(ExecutionEngine *engine, const QString &pattern, uint flags)
 {
+    Q_UNUSED(engine);
     Base::init();
     this->pattern = new QString(pattern);
     this->flags = flags;
 
-    valid = false;
+    // Only parse the pattern here, so that syntax errors are reported on creation. Many regular
+    // expressions, especially the literals of a compilation unit, are created long before they
+    // are used, if at all. They are compiled when they are first matched.
+    compiled = false;
+
+    sharedPattern = RegExpPattern::get(pattern, flags);
+    subPatternCount = sharedPattern->subPatternCount;
+    valid = sharedPattern->valid;
+    containsBackreferences = sharedPattern->containsBackreferences;
+}
+
+// Compiles the JIT code if possible. Otherwise match() uses the shared byte code, which is
+// compiled on demand.
+void Heap::RegExp::compile()
+{
+    Q_ASSERT(valid && !compiled);
+    compiled = true;
 
-    JSC::Yarr::ErrorCode error = JSC::Yarr::ErrorCode::NoError;
-    JSC::Yarr::YarrPattern yarrPattern(WTF::String(pattern), jscFlags(flags), error);
-    if (error != JSC::Yarr::ErrorCode::NoError)
-        return;
-    subPatternCount = yarrPattern.m_numSubpatterns;
 #if ENABLE(YARR_JIT)
-    if (!yarrPattern.m_containsBackreferences && engine->canJIT()) {
+    ExecutionEngine *engine = internalClass->engine;
+    if (!containsBackreferences && engine->canJIT()) {
         jitCode = new JSC::Yarr::YarrCodeBlock;
         JSC::VM *vm = static_cast<JSC::VM *>(engine);
-        JSC::Yarr::jitCompile(yarrPattern, JSC::Yarr::Char16, vm, *jitCode);
+        QMutexLocker locker(&sharedPattern->mutex);
+        JSC::Yarr::jitCompile(*sharedPattern->yarrPattern, JSC::Yarr::Char16, vm, *jitCode);
     }
-#else
-    Q_UNUSED(engine);
 #endif
-    if (hasValidJITCode()) {
-        valid = true;
-        return;
-    }
-    byteCode = JSC::Yarr::byteCompile(yarrPattern, internalClass->engine->bumperPointerAllocator).release();
-    if (byteCode)
-        valid = true;
 }
 
 void Heap::RegExp::destroy()
@@ -208,7 +339,8 @@ void Heap::RegExp::destroy()
 #if ENABLE(YARR_JIT)
     delete jitCode;
 #endif
-    delete byteCode;
+    if (sharedPattern)
+        sharedPattern->deref();
     delete pattern;
     Base::destroy();
 }
@@ -36,15 +36,17 @@ namespace QV4 {
 
 struct ExecutionEngine;
 struct RegExpCacheKey;
+struct RegExpPattern;
 
 namespace Heap {
 
 struct RegExp : Base {
     void init(ExecutionEngine *engine, const QString& pattern, uint flags);
     void destroy();
+    void compile();
 
     QString *pattern;
-    JSC::Yarr::BytecodePattern *byteCode;
+    RegExpPattern *sharedPattern;
 #if ENABLE(YARR_JIT)
     JSC::Yarr::YarrCodeBlock *jitCode;
 #endif
@@ -66,6 +68,8 @@ struct RegExp : Base {
     int subPatternCount;
     uint flags;
     bool valid;
+    bool compiled;
+    bool containsBackreferences;
 
     QString flagsAsString() const;
     int captureCount() const { return subPatternCount + 1; }
@@ -82,7 +86,6 @@ struct RegExp : public Managed
     V4_INTERNALCLASS(RegExp)
 
     QString pattern() const { return *d()->pattern; }
-    JSC::Yarr::BytecodePattern *byteCode() { return d()->byteCode; }
 #if ENABLE(YARR_JIT)
     JSC::Yarr::YarrCodeBlock *jitCode() const { return d()->jitCode; }
 #endif
@@ -151,6 +151,7 @@ ReturnedValue RegExpObject::builtinExec(ExecutionEngine *engine, const String *s
 
     Q_ALLOCA_VAR(uint, matchOffsets, value()->captureCount() * 2 * sizeof(uint));
     const uint result = Scoped<RegExp>(scope, value())->match(s, offset, matchOffsets);
+    CHECK_EXCEPTION();
 
     RegExpCtor *regExpCtor = static_cast<RegExpCtor *>(scope.engine->regExpCtor());
     regExpCtor->d()->clearLastMatch();
@@ -387,6 +388,7 @@ ReturnedValue RegExpPrototype::execFirstMatch(const FunctionObject *b, const Val
 
     Q_ALLOCA_VAR(uint, matchOffsets, r->value()->captureCount() * 2 * sizeof(uint));
     const int result = Scoped<RegExp>(scope, r->value())->match(s, offset, matchOffsets);
+    CHECK_EXCEPTION();
 
     RegExpCtor *regExpCtor = static_cast<RegExpCtor *>(scope.engine->regExpCtor());
     regExpCtor->d()->clearLastMatch();
@@ -38,9 +38,8 @@ ReturnedValue SetIteratorPrototype::method_next(const FunctionObject *b, const V
 
     Value *arguments = scope.alloc(2);
 
-    while (index < s->d()->esTable->size()) {
-        s->d()->esTable->iterate(index, &arguments[0], &arguments[1]);
-        thisObject->d()->setNextIndex = index + 1;
+    while (s->d()->esTable->iterate(&index, &arguments[0], &arguments[1])) {
+        thisObject->d()->setNextIndex = index;
 
         if (itemKind == KeyValueIteratorKind) {
             ScopedArrayObject resultArray(scope, scope.engine->newArrayObject());
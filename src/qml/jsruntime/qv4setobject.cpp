@@ -105,7 +105,12 @@ ReturnedValue WeakSetPrototype::method_add(const FunctionObject *b, const Value
         (!argc || !argv[0].isObject()))
         return scope.engine->throwTypeError();
 
-    that->d()->esTable->set(argv[0], Value::undefinedValue());
+    Value key = argv[0];
+    // The table's storage isn't covered by the regular write barrier.
+    WriteBarrier::markCustom(scope.engine, that->d(), [&](MarkStack *ms) {
+        key.mark(ms);
+    });
+    that->d()->esTable->set(key, Value::undefinedValue());
     return that.asReturnedValue();
 }
 
@@ -193,7 +198,12 @@ ReturnedValue SetPrototype::method_add(const FunctionObject *b, const Value *thi
     if (!that || that->d()->isWeakSet)
         return scope.engine->throwTypeError();
 
-    that->d()->esTable->set(argv[0], Value::undefinedValue());
+    Value key = argv[0];
+    // The table's storage isn't covered by the regular write barrier.
+    WriteBarrier::markCustom(scope.engine, that->d(), [&](MarkStack *ms) {
+        key.mark(ms);
+    });
+    that->d()->esTable->set(key, Value::undefinedValue());
     return that.asReturnedValue();
 }
 
@@ -246,8 +256,8 @@ ReturnedValue SetPrototype::method_forEach(const FunctionObject *b, const Value
         thisArg = ScopedValue(scope, argv[1]);
 
     Value *arguments = scope.alloc(3);
-    for (uint i = 0; i < that->d()->esTable->size(); ++i) {
-        that->d()->esTable->iterate(i, &arguments[0], &arguments[1]); // fill in key (0), value (1)
+    uint i = 0;
+    while (that->d()->esTable->iterate(&i, &arguments[0], &arguments[1])) { // fill in key (0), value (1)
         arguments[1] = arguments[0]; // but for set, we want to return the key twice; value is always undefined.
 
         arguments[2] = that;
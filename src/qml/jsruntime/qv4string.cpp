@@ -59,6 +59,13 @@ void Heap::String::init(const QString &t)
     subtype = String::StringType_Unknown;
 }
 
+void Heap::String::init(const QByteArray &latin1Text)
+{
+    QByteArray mutableText(latin1Text);
+    StringOrSymbol::init(mutableText.data_ptr());
+    subtype = String::StringType_Unknown;
+}
+
 void Heap::ComplexString::init(String *l, String *r)
 {
     StringOrSymbol::init();
@@ -67,6 +74,7 @@ void Heap::ComplexString::init(String *l, String *r)
     left = l;
     right = r;
     len = left->length() + right->length();
+    latin1Parts = left->hasOnlyLatin1() && right->hasOnlyLatin1();
     if (left->subtype >= StringType_Complex)
         largestSubLength = static_cast<ComplexString *>(left)->largestSubLength;
     else
@@ -91,10 +99,19 @@ void Heap::ComplexString::init(Heap::String *ref, int from, int len)
     left = ref;
     this->from = from;
     this->len = len;
+    latin1Parts = ref->hasOnlyLatin1();
 }
 
 void Heap::StringOrSymbol::destroy()
 {
+    if (latin1) {
+        internalClass->engine->memoryManager->changeUnmanagedHeapSizeUsage(
+                    -qptrdiff(latin1Text().size));
+        latin1Text().~QByteArrayData();
+        Base::destroy();
+        return;
+    }
+
     if (subtype < Heap::String::StringType_AddedString) {
         internalClass->engine->memoryManager->changeUnmanagedHeapSizeUsage(
                     qptrdiff(-text()->size) * qptrdiff(sizeof(QChar)));
@@ -103,6 +120,19 @@ void Heap::StringOrSymbol::destroy()
     Base::destroy();
 }
 
+void Heap::StringOrSymbol::convertToUtf16() const
+{
+    Q_ASSERT(latin1);
+    QByteArrayData &bytes = latin1Text();
+    QString utf16 = QString::fromLatin1(QByteArrayView(bytes.data(), bytes.size));
+    bytes.~QByteArrayData();
+    new (&textStorage) QStringPrivate(std::move(utf16.data_ptr()));
+    latin1 = false;
+
+    // The UTF-16 text takes twice the space.
+    internalClass->engine->memoryManager->changeUnmanagedHeapSizeUsage(qptrdiff(text().size));
+}
+
 uint String::toUInt(bool *ok) const
 {
     *ok = true;
@@ -134,16 +164,24 @@ void Heap::String::simplifyString() const
     Q_ASSERT(subtype >= StringType_AddedString);
 
     int l = length();
-    QString result(l, Qt::Uninitialized);
-    QChar *ch = const_cast<QChar *>(result.constData());
-    append(this, ch);
-    text() = result.data_ptr();
     const ComplexString *cs = static_cast<const ComplexString *>(this);
+    if (cs->latin1Parts) {
+        QByteArray result(l, Qt::Uninitialized);
+        append(this, result.data());
+        text().~QStringPrivate();
+        new (&textStorage) QByteArrayData(std::move(result.data_ptr()));
+        latin1 = true;
+        internalClass->engine->memoryManager->changeUnmanagedHeapSizeUsage(qptrdiff(l));
+    } else {
+        QString result(l, Qt::Uninitialized);
+        QChar *ch = const_cast<QChar *>(result.constData());
+        append(this, ch);
+        text() = result.data_ptr();
+        internalClass->engine->memoryManager->changeUnmanagedHeapSizeUsage(
+                    qptrdiff(text().size) * qptrdiff(sizeof(QChar)));
+    }
     identifier = PropertyKey::invalid();
     cs->left = cs->right = nullptr;
-
-    internalClass->engine->memoryManager->changeUnmanagedHeapSizeUsage(
-                qptrdiff(text().size) * qptrdiff(sizeof(QChar)));
     subtype = StringType_Unknown;
 }
 
@@ -165,10 +203,43 @@ bool Heap::String::startsWithUpper() const
         offset = cs->from;
     }
     Q_ASSERT(str->subtype < Heap::String::StringType_Complex);
-    return str->text().size > offset && QChar::isUpper(str->text().data()[offset]);
+    if (str->textSize() <= offset)
+        return false;
+    if (str->latin1)
+        return QChar::isUpper(QChar::fromLatin1(str->latin1Text().data()[offset]));
+    return QChar::isUpper(str->text().data()[offset]);
+}
+
+// Copies size characters of the simple string str, starting at from, to ch. UTF-16 text is only
+// copied into a Latin-1 buffer if it was converted from Latin-1 before, see hasOnlyLatin1().
+template<typename Char>
+static Char *copyText(const Heap::String *str, qsizetype from, qsizetype size, Char *ch)
+{
+    Q_ASSERT(str->subtype < Heap::String::StringType_Complex);
+    if (str->isLatin1()) {
+        const char *text = str->latin1Text().data() + from;
+        if constexpr (std::is_same_v<Char, char>) {
+            memcpy(ch, text, size);
+        } else {
+            for (qsizetype i = 0; i < size; ++i)
+                ch[i] = QChar::fromLatin1(text[i]);
+        }
+    } else {
+        const char16_t *text = str->text().data() + from;
+        if constexpr (std::is_same_v<Char, char>) {
+            for (qsizetype i = 0; i < size; ++i) {
+                Q_ASSERT(text[i] < 0x100);
+                ch[i] = char(text[i]);
+            }
+        } else {
+            memcpy(static_cast<void *>(ch), text, size * sizeof(QChar));
+        }
+    }
+    return ch + size;
 }
 
-void Heap::String::append(const String *data, QChar *ch)
+template<typename Char>
+void Heap::String::append(const String *data, Char *ch)
 {
     std::vector<const String *> worklist;
     worklist.reserve(32);
@@ -184,11 +255,11 @@ void Heap::String::append(const String *data, QChar *ch)
             worklist.push_back(cs->left);
         } else if (item->subtype == StringType_SubString) {
             const ComplexString *cs = static_cast<const ComplexString *>(item);
-            memcpy(ch, cs->left->toQString().constData() + cs->from, cs->len*sizeof(QChar));
-            ch += cs->len;
+            if (cs->left->subtype >= StringType_Complex)
+                cs->left->simplifyString();
+            ch = copyText(cs->left, cs->from, cs->len, ch);
         } else {
-            memcpy(static_cast<void *>(ch), item->text().data(), item->text().size * sizeof(QChar));
-            ch += item->text().size;
+            ch = copyText(item, 0, item->textSize(), ch);
         }
     }
 }
@@ -200,6 +271,12 @@ void Heap::StringOrSymbol::createHashValue() const
         static_cast<const Heap::String *>(this)->simplifyString();
     }
     Q_ASSERT(subtype < StringType_AddedString);
+    if (latin1) {
+        const char *ch = latin1Text().data();
+        const char *end = ch + latin1Text().size;
+        stringHash = QV4::String::calculateHashValue(ch, end, &subtype);
+        return;
+    }
     const QChar *ch = reinterpret_cast<const QChar *>(text().data());
     const QChar *end = ch + text().size;
     stringHash = QV4::String::calculateHashValue(ch, end, &subtype);
@@ -44,25 +44,67 @@ struct Q_QML_PRIVATE_EXPORT StringOrSymbol : Base
     void init() {
         Base::init();
         new (&textStorage) QStringPrivate;
+        latin1 = false;
     }
 
     void init(QStringPrivate text)
     {
         Base::init();
         new (&textStorage) QStringPrivate(std::move(text));
+        latin1 = false;
     }
 
+    void init(QByteArrayData latin1Text)
+    {
+        Base::init();
+        new (&textStorage) QByteArrayData(std::move(latin1Text));
+        latin1 = true;
+    }
+
+    // Holds a QStringPrivate, or a QByteArrayData with Latin-1 text if latin1 is set.
     mutable struct { alignas(QStringPrivate) unsigned char data[sizeof(QStringPrivate)]; } textStorage;
     mutable PropertyKey identifier;
     mutable uint subtype;
     mutable uint stringHash;
+    mutable bool latin1;
 
     static void markObjects(Heap::Base *that, MarkStack *markStack);
     void destroy();
 
-    QStringPrivate &text() const { return *reinterpret_cast<QStringPrivate *>(&textStorage); }
+    bool isLatin1() const { return latin1; }
+    QStringPrivate &text() const
+    {
+        Q_ASSERT(!latin1);
+        return *reinterpret_cast<QStringPrivate *>(&textStorage);
+    }
+    QByteArrayData &latin1Text() const
+    {
+        Q_ASSERT(latin1);
+        return *reinterpret_cast<QByteArrayData *>(&textStorage);
+    }
+    qsizetype textSize() const { return latin1 ? latin1Text().size : text().size; }
+
+    // Only valid for simple strings, see String::simplifyString().
+    template<typename StringView>
+    bool textEquals(StringView other) const
+    {
+        if (latin1)
+            return QLatin1StringView(latin1Text().data(), latin1Text().size) == other;
+        return QStringView(text().data(), text().size) == other;
+    }
+    bool hasEqualText(const StringOrSymbol *other) const
+    {
+        if (other->latin1)
+            return textEquals(QLatin1StringView(other->latin1Text().data(), other->latin1Text().size));
+        return textEquals(QStringView(other->text().data(), other->text().size));
+    }
+
+    // Replaces Latin-1 text with UTF-16 text, for the places that need to refer to QChars.
+    Q_NEVER_INLINE void convertToUtf16() const;
 
     inline QString toQString() const {
+        if (latin1)
+            convertToUtf16();
         QStringPrivate dd = text();
         return QString(std::move(dd));
     }
@@ -84,10 +126,14 @@ struct Q_QML_PRIVATE_EXPORT String : StringOrSymbol {
     }
 
     void init(const QString &text);
+    void init(const QByteArray &latin1Text);
     void simplifyString() const;
     int length() const;
+    bool hasOnlyLatin1() const;
     std::size_t retainedTextSize() const {
-        return subtype >= StringType_Complex ? 0 : (std::size_t(text().size) * sizeof(QChar));
+        if (subtype >= StringType_Complex)
+            return 0;
+        return latin1 ? std::size_t(latin1Text().size) : std::size_t(text().size) * sizeof(QChar);
     }
     inline QString toQString() const {
         if (subtype >= StringType_Complex)
@@ -105,13 +151,14 @@ struct Q_QML_PRIVATE_EXPORT String : StringOrSymbol {
         if (subtype == Heap::String::StringType_ArrayIndex && other->subtype == Heap::String::StringType_ArrayIndex)
             return true;
 
-        return toQString() == other->toQString();
+        return hasEqualText(other);
     }
 
     bool startsWithUpper() const;
 
 private:
-    static void append(const String *data, QChar *ch);
+    template<typename Char>
+    static void append(const String *data, Char *ch);
 };
 Q_STATIC_ASSERT(std::is_trivial_v<String>);
 
@@ -125,13 +172,19 @@ struct ComplexString : String {
         int from;
     };
     int len;
+    bool latin1Parts; // whether simplifying the string results in Latin-1 text
 };
 Q_STATIC_ASSERT(std::is_trivial_v<ComplexString>);
 
 inline
 int String::length() const {
     // TODO: ensure that our strings never actually grow larger than INT_MAX
-    return subtype < StringType_AddedString ? int(text().size) : static_cast<const ComplexString *>(this)->len;
+    return subtype < StringType_AddedString ? int(textSize()) : static_cast<const ComplexString *>(this)->len;
+}
+
+inline
+bool String::hasOnlyLatin1() const {
+    return subtype < StringType_AddedString ? latin1 : static_cast<const ComplexString *>(this)->latin1Parts;
 }
 
 }
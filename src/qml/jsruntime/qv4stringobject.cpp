@@ -779,6 +779,11 @@ ReturnedValue StringPrototype::method_replace(const FunctionObject *b, const Val
                 break;
             offset = qMax(offset + 1, matchOffsets[oldSize + 1]);
         }
+        if (scope.hasException()) {
+            if (matchOffsets != _matchOffsets)
+                free(matchOffsets);
+            return Encode::undefined();
+        }
         if (regExp->global()) {
             regExp->setLastIndex(0);
             if (scope.hasException())
@@ -873,6 +878,7 @@ ReturnedValue StringPrototype::method_search(const FunctionObject *b, const Valu
     Scoped<RegExp> re(scope, regExp->value());
     Q_ALLOCA_VAR(uint, matchOffsets, regExp->value()->captureCount() * 2 * sizeof(uint));
     uint result = re->match(string, /*offset*/0, matchOffsets);
+    CHECK_EXCEPTION();
     if (result == JSC::Yarr::offsetNoMatch)
         return Encode(-1);
     else
@@ -953,6 +959,7 @@ ReturnedValue StringPrototype::method_split(const FunctionObject *b, const Value
         while (true) {
             Scoped<RegExp> regexp(scope, re->value());
             uint result = regexp->match(text, offset, matchOffsets);
+            CHECK_EXCEPTION();
             if (result == JSC::Yarr::offsetNoMatch)
                 break;
 
@@ -7,7 +7,9 @@
 #include "qv4symbol_p.h"
 #include "qv4runtime_p.h"
 #include <QtCore/qatomic.h>
+#include <private/qsimd_p.h>
 
+#include <algorithm>
 #include <cmath>
 
 using namespace QV4;
@@ -58,14 +60,8 @@ T valueToType(Value value)
     return static_cast<T>(n);
 }
 
-template <>
-ClampedUInt8 valueToType(Value value)
+static inline ClampedUInt8 clampToUInt8(double d)
 {
-    Q_ASSERT(value.isNumber());
-    if (value.isInteger())
-        return { static_cast<quint8>(qBound(0, value.integerValue(), 255)) };
-    Q_ASSERT(value.isDouble());
-    double d = value.doubleValue();
     // ### is there a way to optimise this?
     if (d <= 0 || std::isnan(d))
         return { 0 };
@@ -82,6 +78,16 @@ ClampedUInt8 valueToType(Value value)
     return { (quint8)(f) };
 }
 
+template <>
+ClampedUInt8 valueToType(Value value)
+{
+    Q_ASSERT(value.isNumber());
+    if (value.isInteger())
+        return { static_cast<quint8>(qBound(0, value.integerValue(), 255)) };
+    Q_ASSERT(value.isDouble());
+    return clampToUInt8(value.doubleValue());
+}
+
 template <>
 float valueToType(Value value)
 {
@@ -189,6 +195,146 @@ ReturnedValue atomicStore(char *data, Value v)
     return typeToValue(value);
 }
 
+// The bulk operations below work on whole ranges of elements, without going through a Value
+// for each of them. Simple loops over the native types are vectorized by the compiler.
+
+template <typename T>
+struct NativeType { using Type = T; };
+
+template <>
+struct NativeType<ClampedUInt8> { using Type = quint8; };
+
+template <typename T>
+void fillElements(char *data, uint count, Value value)
+{
+    std::fill_n(reinterpret_cast<T *>(data), count, valueToType<T>(value));
+}
+
+template <typename T>
+uint indexOfElement(const char *data, uint from, uint count, Value value)
+{
+    using Native = typename NativeType<T>::Type;
+
+    // Only numbers can be strictly equal to an element, and only if the element type can
+    // represent them exactly.
+    if (!value.isNumber())
+        return UINT_MAX;
+    const double d = value.asDouble();
+    if constexpr (std::is_floating_point_v<Native>) {
+        if (std::isnan(d) || (std::isfinite(d) && std::abs(d) > std::numeric_limits<Native>::max()))
+            return UINT_MAX;
+    } else {
+        if (!(d >= std::numeric_limits<Native>::min() && d <= std::numeric_limits<Native>::max()))
+            return UINT_MAX;
+    }
+    const Native needle = static_cast<Native>(d);
+    if (needle != d)
+        return UINT_MAX;
+
+    const Native *begin = reinterpret_cast<const Native *>(data);
+    const Native *it = std::find(begin + from, begin + count, needle);
+    return it == begin + count ? UINT_MAX : uint(it - begin);
+}
+
+template <typename T>
+void reverseElements(char *data, uint count)
+{
+    T *begin = reinterpret_cast<T *>(data);
+    std::reverse(begin, begin + count);
+}
+
+// Same conversion as reading the source element into a Value and writing that to the
+// destination, i.e. ToInt32 and friends for integer targets.
+template <typename To, typename From>
+static inline To convertElement(From from)
+{
+    if constexpr (std::is_same_v<To, ClampedUInt8>) {
+        if constexpr (std::is_floating_point_v<From>)
+            return clampToUInt8(from);
+        else
+            return { static_cast<quint8>(qBound<qint64>(0, from, 255)) };
+    } else if constexpr (std::is_floating_point_v<To> || std::is_integral_v<From>) {
+        return static_cast<To>(from);
+    } else {
+        return static_cast<To>(QJSNumberCoercion::toInteger(from));
+    }
+}
+
+#ifdef __SSE2__
+// Truncates four floating point numbers to int32. Returns false if any of them is NaN or out of
+// range, in which case the result is not the one of ToInt32.
+static inline bool truncateToInt32(const float *s, __m128i *result)
+{
+    *result = _mm_cvttps_epi32(_mm_loadu_ps(s));
+    const __m128i invalid = _mm_set1_epi32(std::numeric_limits<int>::min());
+    return !_mm_movemask_epi8(_mm_cmpeq_epi32(*result, invalid));
+}
+
+static inline bool truncateToInt32(const double *s, __m128i *result)
+{
+    const __m128i lo = _mm_cvttpd_epi32(_mm_loadu_pd(s));
+    const __m128i hi = _mm_cvttpd_epi32(_mm_loadu_pd(s + 2));
+    *result = _mm_unpacklo_epi64(lo, hi);
+    const __m128i invalid = _mm_set1_epi32(std::numeric_limits<int>::min());
+    return !_mm_movemask_epi8(_mm_cmpeq_epi32(*result, invalid));
+}
+
+// The compiler can't vectorize the conversion of floating point numbers to 32bit and 16bit
+// integers with JavaScript semantics. Returns the number of elements converted.
+template <typename To, typename From>
+static uint convertToIntegers(To *d, const From *s, uint count)
+{
+    uint i = 0;
+    if constexpr (sizeof(To) == 4) {
+        for (; i + 4 <= count; i += 4) {
+            __m128i v;
+            if (truncateToInt32(s + i, &v)) {
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(d + i), v);
+            } else {
+                for (uint j = i; j < i + 4; ++j)
+                    d[j] = convertElement<To>(s[j]);
+            }
+        }
+    } else if constexpr (sizeof(To) == 2) {
+        for (; i + 8 <= count; i += 8) {
+            __m128i lo;
+            __m128i hi;
+            if (truncateToInt32(s + i, &lo) && truncateToInt32(s + i + 4, &hi)) {
+                // Keep the low 16 bits, sign extended so that packing doesn't saturate.
+                lo = _mm_srai_epi32(_mm_slli_epi32(lo, 16), 16);
+                hi = _mm_srai_epi32(_mm_slli_epi32(hi, 16), 16);
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(d + i), _mm_packs_epi32(lo, hi));
+            } else {
+                for (uint j = i; j < i + 8; ++j)
+                    d[j] = convertElement<To>(s[j]);
+            }
+        }
+    }
+    return i;
+}
+#endif
+
+template <typename To, typename From>
+void convertElements(char *dest, const char *src, uint count)
+{
+    using Source = typename NativeType<From>::Type;
+    To *d = reinterpret_cast<To *>(dest);
+    const Source *s = reinterpret_cast<const Source *>(src);
+    uint i = 0;
+#ifdef __SSE2__
+    if constexpr (std::is_floating_point_v<Source> && std::is_integral_v<To>)
+        i = convertToIntegers(d, s, count);
+#endif
+    for (; i < count; ++i)
+        d[i] = convertElement<To>(s[i]);
+}
+
+#define TYPED_ARRAY_CONVERSIONS(T) \
+    { ::convertElements<T, qint8>, ::convertElements<T, quint8>, \
+      ::convertElements<T, qint16>, ::convertElements<T, quint16>, \
+      ::convertElements<T, qint32>, ::convertElements<T, quint32>, \
+      ::convertElements<T, ClampedUInt8>, ::convertElements<T, float>, \
+      ::convertElements<T, double> }
 
 template<typename T>
 constexpr TypedArrayOperations TypedArrayOperations::create(const char *name)
@@ -200,7 +346,11 @@ constexpr TypedArrayOperations TypedArrayOperations::create(const char *name)
              { nullptr, nullptr, nullptr, nullptr, nullptr, nullptr },
              nullptr,
              nullptr,
-             nullptr
+             nullptr,
+             ::fillElements<T>,
+             ::indexOfElement<T>,
+             ::reverseElements<T>,
+             TYPED_ARRAY_CONVERSIONS(T)
     };
 }
 
@@ -214,10 +364,16 @@ constexpr TypedArrayOperations TypedArrayOperations::createWithAtomics(const cha
              { ::atomicAdd<T>, ::atomicAnd<T>, ::atomicExchange<T>, ::atomicOr<T>, ::atomicSub<T>, ::atomicXor<T> },
              ::atomicCompareExchange<T>,
              ::atomicLoad<T>,
-             ::atomicStore<T>
+             ::atomicStore<T>,
+             ::fillElements<T>,
+             ::indexOfElement<T>,
+             ::reverseElements<T>,
+             TYPED_ARRAY_CONVERSIONS(T)
     };
 }
 
+#undef TYPED_ARRAY_CONVERSIONS
+
 const TypedArrayOperations operations[NTypedArrayTypes] = {
 #ifdef Q_ATOMIC_INT8_IS_SUPPORTED
     TypedArrayOperations::createWithAtomics<qint8>("Int8Array"),
@@ -306,20 +462,11 @@ ReturnedValue TypedArrayCtor::virtualCallAsConstructor(const FunctionObject *f,
         const char *src = buffer->constArrayData() + typedArray->byteOffset();
         char *dest = newBuffer->arrayData();
 
-        // check if src and new type have the same size. In that case we can simply memcpy the data
-        if (srcElementSize == destElementSize) {
+        // check if src and new type are the same. In that case we can simply memcpy the data
+        if (typedArray->d()->type == array->d()->type)
             memcpy(dest, src, byteLength);
-        } else {
-            // not same size, we need to loop
-            uint l = typedArray->length();
-            TypedArrayOperations::Read read = typedArray->d()->type->read;
-            TypedArrayOperations::Write write =array->d()->type->write;
-            for (uint i = 0; i < l; ++i) {
-                Value val;
-                val.setRawValue(read(src + i*srcElementSize));
-                write(dest + i*destElementSize, val);
-            }
-        }
+        else
+            array->d()->type->convertFrom[typedArray->arrayType()](dest, src, typedArray->length());
 
         updateProto(scope, array);
         return array.asReturnedValue();
@@ -767,14 +914,8 @@ ReturnedValue IntrinsicTypedArrayPrototype::method_fill(const FunctionObject *b,
     if (scope.hasException() || v->hasDetachedArrayData())
         return scope.engine->throwTypeError();
 
-    char *data = v->arrayData();
-    uint bytesPerElement = v->bytesPerElement();
-    uint byteOffset = v->byteOffset();
-
-    while (k < fin) {
-        v->d()->type->write(data + byteOffset + k * bytesPerElement, value);
-        k++;
-    }
+    if (k < fin)
+        v->d()->type->fill(v->arrayData() + v->byteOffset() + k * v->bytesPerElement(), fin - k, value);
 
     return v.asReturnedValue();
 }
@@ -1011,27 +1152,15 @@ ReturnedValue IntrinsicTypedArrayPrototype::method_indexOf(const FunctionObject
         fromIndex = (uint) f;
     }
 
-    if (v->isStringObject()) {
-        ScopedValue value(scope);
-        for (uint k = fromIndex; k < len; ++k) {
-            bool exists;
-            value = v->get(k, &exists);
-            if (exists && RuntimeHelpers::strictEqual(value, searchValue))
-                return Encode(k);
-        }
+    // Converting the start index may have detached the buffer, in which case no elements exist.
+    if (v->hasDetachedArrayData())
         return Encode(-1);
-    }
 
-    ScopedValue value(scope);
-
-    for (uint i = fromIndex; i < len; ++i) {
-        bool exists;
-        value = v->get(i, &exists);
-        CHECK_EXCEPTION();
-        if (exists && RuntimeHelpers::strictEqual(value, searchValue))
-            return Encode(i);
-    }
-    return Encode(-1);
+    const uint index = v->d()->type->indexOf(v->constArrayData() + v->byteOffset(), fromIndex, len,
+                                             searchValue);
+    if (index == UINT_MAX)
+        return Encode(-1);
+    return Encode(index);
 }
 
 ReturnedValue IntrinsicTypedArrayPrototype::method_join(
@@ -1280,23 +1409,7 @@ ReturnedValue IntrinsicTypedArrayPrototype::method_reverse(const FunctionObject
     if (!instance || instance->hasDetachedArrayData())
         return scope.engine->throwTypeError();
 
-    uint length = instance->length();
-
-    int lo = 0, hi = length - 1;
-
-    ScopedValue lval(scope);
-    ScopedValue hval(scope);
-    for (; lo < hi; ++lo, --hi) {
-        bool loExists, hiExists;
-        lval = instance->get(lo, &loExists);
-        hval = instance->get(hi, &hiExists);
-        Q_ASSERT(hiExists && loExists);
-        bool ok;
-        ok = instance->put(lo, hval);
-        Q_ASSERT(ok);
-        ok = instance->put(hi, lval);
-        Q_ASSERT(ok);
-    }
+    instance->d()->type->reverse(instance->arrayData() + instance->byteOffset(), instance->length());
     return instance->asReturnedValue();
 }
 
@@ -1387,6 +1500,19 @@ ReturnedValue IntrinsicTypedArrayPrototype::method_set(const FunctionObject *b,
         if (buffer->hasDetachedArrayData())
             return scope.engine->throwTypeError();
         char *b = buffer->arrayData() + a->byteOffset() + offset*elementSize;
+
+        // The elements of a packed array are numbers already, and converting them can't have
+        // side effects.
+        const Heap::ArrayData *arrayData = o->isArrayObject() ? o->d()->arrayData.get() : nullptr;
+        if (arrayData && arrayData->type == Heap::ArrayData::Simple && arrayData->isPacked()
+                && l <= arrayData->values.size) {
+            const Heap::SimpleArrayData *sa = static_cast<const Heap::SimpleArrayData *>(arrayData);
+            TypedArrayOperations::Write write = a->d()->type->write;
+            for (; idx < l; ++idx, b += elementSize)
+                write(b, sa->data(idx));
+            RETURN_UNDEFINED();
+        }
+
         ScopedValue val(scope);
         while (idx < l) {
             val = o->get(idx);
@@ -1418,8 +1544,11 @@ ReturnedValue IntrinsicTypedArrayPrototype::method_set(const FunctionObject *b,
     char *dest = buffer->arrayData() + a->byteOffset() + offset*elementSize;
     const char *src = srcBuffer->d()->constArrayData() + srcTypedArray->byteOffset();
     if (srcTypedArray->d()->type == a->d()->type) {
-        // same type of typed arrays, use memmove (as srcbuffer and buffer could be the same)
-        memmove(dest, src, srcTypedArray->byteLength());
+        // same type of typed arrays, use memmove if srcbuffer and buffer are the same
+        if (buffer->d() == srcBuffer->d())
+            memmove(dest, src, srcTypedArray->byteLength());
+        else
+            memcpy(dest, src, srcTypedArray->byteLength());
         RETURN_UNDEFINED();
     }
 
@@ -1431,15 +1560,8 @@ ReturnedValue IntrinsicTypedArrayPrototype::method_set(const FunctionObject *b,
         src = srcCopy;
     }
 
-    // typed arrays of different kind, need to manually loop
-    uint srcElementSize = srcTypedArray->bytesPerElement();
-    TypedArrayOperations::Read read = srcTypedArray->d()->type->read;
-    TypedArrayOperations::Write write = a->d()->type->write;
-    for (uint i = 0; i < l; ++i) {
-        Value val;
-        val.setRawValue(read(src + i*srcElementSize));
-        write(dest + i*elementSize, val);
-    }
+    // typed arrays of different kind, need to convert
+    a->d()->type->convertFrom[srcTypedArray->arrayType()](dest, src, l);
 
     if (srcCopy)
         delete [] srcCopy;
@@ -1480,6 +1602,18 @@ ReturnedValue IntrinsicTypedArrayPrototype::method_slice(const FunctionObject *b
     if (!a)
         return Encode::undefined();
 
+    const Heap::ArrayBuffer *srcBuffer = instance->d()->buffer;
+    if (count && !instance->hasDetachedArrayData() && a->d()->buffer != srcBuffer) {
+        const char *src = instance->constArrayData() + instance->byteOffset()
+                + start * instance->bytesPerElement();
+        char *dest = a->arrayData() + a->byteOffset();
+        if (a->d()->type == instance->d()->type)
+            memcpy(dest, src, count * instance->bytesPerElement());
+        else
+            a->d()->type->convertFrom[instance->arrayType()](dest, src, count);
+        return a->asReturnedValue();
+    }
+
     ScopedValue v(scope);
     uint n = 0;
     for (uint i = start; i < end; ++i) {
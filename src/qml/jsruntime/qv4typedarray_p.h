@@ -54,6 +54,10 @@ struct TypedArrayOperations {
     typedef ReturnedValue (*AtomicCompareExchange)(char *data, Value expected, Value v);
     typedef ReturnedValue (*AtomicLoad)(char *data);
     typedef ReturnedValue (*AtomicStore)(char *data, Value value);
+    typedef void (*Fill)(char *data, uint count, Value value);
+    typedef uint (*IndexOf)(const char *data, uint from, uint count, Value value);
+    typedef void (*Reverse)(char *data, uint count);
+    typedef void (*Convert)(char *dest, const char *src, uint count);
 
     template<typename T>
     static constexpr TypedArrayOperations create(const char *name);
@@ -68,6 +72,11 @@ struct TypedArrayOperations {
     AtomicCompareExchange atomicCompareExchange;
     AtomicLoad atomicLoad;
     AtomicStore atomicStore;
+    Fill fill;
+    IndexOf indexOf;
+    Reverse reverse;
+    // Converts elements of the given source type to this type, indexed by TypedArrayType.
+    Convert convertFrom[NTypedArrayTypes];
 };
 
 namespace Heap {
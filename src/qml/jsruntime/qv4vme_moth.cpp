@@ -29,6 +29,7 @@
 
 #if QT_CONFIG(qml_jit)
 #include <private/qv4baselinejit_p.h>
+#include <private/qv4optimizingjit_p.h>
 #endif
 
 #include <qtqml_tracepoints_p.h>
@@ -524,6 +525,13 @@ ReturnedValue VME::exec(JSTypesStackFrame *frame, ExecutionEngine *engine)
                 QV4::JIT::BaselineJIT(function).generate();
             else
                 ++function->interpreterCallCount;
+        } else if (function->optimizedCodeRef == nullptr && function->jittedCode != nullptr
+                   && engine->canOptimize()) {
+            // Functions that deoptimize stay in the baseline tier from then on.
+            if (engine->canOptimize(function))
+                QV4::JIT::OptimizingJIT(function).generate();
+            else if (!function->optimizationDisabled)
+                ++function->jittedCallCount;
         }
     }
 #endif // QT_CONFIG(qml_jit)
@@ -534,7 +542,9 @@ ReturnedValue VME::exec(JSTypesStackFrame *frame, ExecutionEngine *engine)
 
     ReturnedValue result;
     Q_ASSERT(function->kind != Function::AotCompiled);
-    if (function->jittedCode != nullptr && debugger == nullptr) {
+    if (function->optimizedCode != nullptr && debugger == nullptr) {
+        result = function->optimizedCode(frame, engine);
+    } else if (function->jittedCode != nullptr && debugger == nullptr) {
         result = function->jittedCode(frame, engine);
     } else {
         // interpreter
@@ -729,6 +739,45 @@ QV4::ReturnedValue VME::interpret(JSTypesStackFrame *frame, ExecutionEngine *eng
         CHECK_EXCEPTION;
     MOTH_END_INSTR(GetLookup)
 
+    MOTH_BEGIN_INSTR(GetLookupFromReg)
+        STORE_IP();
+        acc = STACK_VALUE(base).asReturnedValue();
+        STORE_ACC();
+
+        QV4::Lookup *l = function->executableCompilationUnit()->runtimeLookups + index;
+
+        if (accumulator.isNullOrUndefined()) {
+            QString message = QStringLiteral("Cannot read property '%1' of %2")
+                    .arg(engine->currentStackFrame->v4Function->compilationUnit->runtimeStrings[l->nameIndex]->toQString())
+                    .arg(accumulator.toQStringNoThrow());
+            acc = engine->throwTypeError(message);
+            goto handleUnwind;
+        }
+
+        acc = l->getter(l, engine, accumulator);
+        CHECK_EXCEPTION;
+    MOTH_END_INSTR(GetLookupFromReg)
+
+    MOTH_BEGIN_INSTR(GetLookupFromRegToReg)
+        STORE_IP();
+        acc = STACK_VALUE(base).asReturnedValue();
+        STORE_ACC();
+
+        QV4::Lookup *l = function->executableCompilationUnit()->runtimeLookups + index;
+
+        if (accumulator.isNullOrUndefined()) {
+            QString message = QStringLiteral("Cannot read property '%1' of %2")
+                    .arg(engine->currentStackFrame->v4Function->compilationUnit->runtimeStrings[l->nameIndex]->toQString())
+                    .arg(accumulator.toQStringNoThrow());
+            acc = engine->throwTypeError(message);
+            goto handleUnwind;
+        }
+
+        acc = l->getter(l, engine, accumulator);
+        CHECK_EXCEPTION;
+        STACK_VALUE(destReg) = acc;
+    MOTH_END_INSTR(GetLookupFromRegToReg)
+
     MOTH_BEGIN_INSTR(GetOptionalLookup)
         STORE_IP();
         STORE_ACC();
@@ -1258,6 +1307,174 @@ QV4::ReturnedValue VME::interpret(JSTypesStackFrame *frame, ExecutionEngine *eng
         }
     MOTH_END_INSTR(CmpStrictNotEqual)
 
+    MOTH_BEGIN_INSTR(CmpGtJumpTrue)
+        const Value left = STACK_VALUE(lhs);
+        if (Q_LIKELY(left.isInteger() && ACC.isInteger())) {
+            acc = Encode(left.int_32() > ACC.int_32());
+        } else if (left.isNumber() && ACC.isNumber()) {
+            acc = Encode(left.asDouble() > ACC.asDouble());
+        } else {
+            STORE_ACC();
+            acc = Encode(bool(Runtime::CompareGreaterThan::call(left, accumulator)));
+            CHECK_EXCEPTION;
+        }
+        if (ACC.booleanValue())
+            code += offset;
+    MOTH_END_INSTR(CmpGtJumpTrue)
+
+    MOTH_BEGIN_INSTR(CmpGtJumpFalse)
+        const Value left = STACK_VALUE(lhs);
+        if (Q_LIKELY(left.isInteger() && ACC.isInteger())) {
+            acc = Encode(left.int_32() > ACC.int_32());
+        } else if (left.isNumber() && ACC.isNumber()) {
+            acc = Encode(left.asDouble() > ACC.asDouble());
+        } else {
+            STORE_ACC();
+            acc = Encode(bool(Runtime::CompareGreaterThan::call(left, accumulator)));
+            CHECK_EXCEPTION;
+        }
+        if (!ACC.booleanValue())
+            code += offset;
+    MOTH_END_INSTR(CmpGtJumpFalse)
+
+    MOTH_BEGIN_INSTR(CmpGeJumpTrue)
+        const Value left = STACK_VALUE(lhs);
+        if (Q_LIKELY(left.isInteger() && ACC.isInteger())) {
+            acc = Encode(left.int_32() >= ACC.int_32());
+        } else if (left.isNumber() && ACC.isNumber()) {
+            acc = Encode(left.asDouble() >= ACC.asDouble());
+        } else {
+            STORE_ACC();
+            acc = Encode(bool(Runtime::CompareGreaterEqual::call(left, accumulator)));
+            CHECK_EXCEPTION;
+        }
+        if (ACC.booleanValue())
+            code += offset;
+    MOTH_END_INSTR(CmpGeJumpTrue)
+
+    MOTH_BEGIN_INSTR(CmpGeJumpFalse)
+        const Value left = STACK_VALUE(lhs);
+        if (Q_LIKELY(left.isInteger() && ACC.isInteger())) {
+            acc = Encode(left.int_32() >= ACC.int_32());
+        } else if (left.isNumber() && ACC.isNumber()) {
+            acc = Encode(left.asDouble() >= ACC.asDouble());
+        } else {
+            STORE_ACC();
+            acc = Encode(bool(Runtime::CompareGreaterEqual::call(left, accumulator)));
+            CHECK_EXCEPTION;
+        }
+        if (!ACC.booleanValue())
+            code += offset;
+    MOTH_END_INSTR(CmpGeJumpFalse)
+
+    MOTH_BEGIN_INSTR(CmpLtJumpTrue)
+        const Value left = STACK_VALUE(lhs);
+        if (Q_LIKELY(left.isInteger() && ACC.isInteger())) {
+            acc = Encode(left.int_32() < ACC.int_32());
+        } else if (left.isNumber() && ACC.isNumber()) {
+            acc = Encode(left.asDouble() < ACC.asDouble());
+        } else {
+            STORE_ACC();
+            acc = Encode(bool(Runtime::CompareLessThan::call(left, accumulator)));
+            CHECK_EXCEPTION;
+        }
+        if (ACC.booleanValue())
+            code += offset;
+    MOTH_END_INSTR(CmpLtJumpTrue)
+
+    MOTH_BEGIN_INSTR(CmpLtJumpFalse)
+        const Value left = STACK_VALUE(lhs);
+        if (Q_LIKELY(left.isInteger() && ACC.isInteger())) {
+            acc = Encode(left.int_32() < ACC.int_32());
+        } else if (left.isNumber() && ACC.isNumber()) {
+            acc = Encode(left.asDouble() < ACC.asDouble());
+        } else {
+            STORE_ACC();
+            acc = Encode(bool(Runtime::CompareLessThan::call(left, accumulator)));
+            CHECK_EXCEPTION;
+        }
+        if (!ACC.booleanValue())
+            code += offset;
+    MOTH_END_INSTR(CmpLtJumpFalse)
+
+    MOTH_BEGIN_INSTR(CmpLeJumpTrue)
+        const Value left = STACK_VALUE(lhs);
+        if (Q_LIKELY(left.isInteger() && ACC.isInteger())) {
+            acc = Encode(left.int_32() <= ACC.int_32());
+        } else if (left.isNumber() && ACC.isNumber()) {
+            acc = Encode(left.asDouble() <= ACC.asDouble());
+        } else {
+            STORE_ACC();
+            acc = Encode(bool(Runtime::CompareLessEqual::call(left, accumulator)));
+            CHECK_EXCEPTION;
+        }
+        if (ACC.booleanValue())
+            code += offset;
+    MOTH_END_INSTR(CmpLeJumpTrue)
+
+    MOTH_BEGIN_INSTR(CmpLeJumpFalse)
+        const Value left = STACK_VALUE(lhs);
+        if (Q_LIKELY(left.isInteger() && ACC.isInteger())) {
+            acc = Encode(left.int_32() <= ACC.int_32());
+        } else if (left.isNumber() && ACC.isNumber()) {
+            acc = Encode(left.asDouble() <= ACC.asDouble());
+        } else {
+            STORE_ACC();
+            acc = Encode(bool(Runtime::CompareLessEqual::call(left, accumulator)));
+            CHECK_EXCEPTION;
+        }
+        if (!ACC.booleanValue())
+            code += offset;
+    MOTH_END_INSTR(CmpLeJumpFalse)
+
+    MOTH_BEGIN_INSTR(CmpStrictEqualJumpTrue)
+        if (STACK_VALUE(lhs).rawValue() == ACC.rawValue() && !ACC.isNaN()) {
+            acc = Encode(true);
+        } else {
+            STORE_ACC();
+            acc = Runtime::StrictEqual::call(STACK_VALUE(lhs), accumulator);
+            CHECK_EXCEPTION;
+        }
+        if (ACC.booleanValue())
+            code += offset;
+    MOTH_END_INSTR(CmpStrictEqualJumpTrue)
+
+    MOTH_BEGIN_INSTR(CmpStrictEqualJumpFalse)
+        if (STACK_VALUE(lhs).rawValue() == ACC.rawValue() && !ACC.isNaN()) {
+            acc = Encode(true);
+        } else {
+            STORE_ACC();
+            acc = Runtime::StrictEqual::call(STACK_VALUE(lhs), accumulator);
+            CHECK_EXCEPTION;
+        }
+        if (!ACC.booleanValue())
+            code += offset;
+    MOTH_END_INSTR(CmpStrictEqualJumpFalse)
+
+    MOTH_BEGIN_INSTR(CmpStrictNotEqualJumpTrue)
+        if (STACK_VALUE(lhs).rawValue() != ACC.rawValue() || ACC.isNaN()) {
+            STORE_ACC();
+            acc = Runtime::StrictNotEqual::call(STACK_VALUE(lhs), accumulator);
+            CHECK_EXCEPTION;
+        } else {
+            acc = Encode(false);
+        }
+        if (ACC.booleanValue())
+            code += offset;
+    MOTH_END_INSTR(CmpStrictNotEqualJumpTrue)
+
+    MOTH_BEGIN_INSTR(CmpStrictNotEqualJumpFalse)
+        if (STACK_VALUE(lhs).rawValue() != ACC.rawValue() || ACC.isNaN()) {
+            STORE_ACC();
+            acc = Runtime::StrictNotEqual::call(STACK_VALUE(lhs), accumulator);
+            CHECK_EXCEPTION;
+        } else {
+            acc = Encode(false);
+        }
+        if (!ACC.booleanValue())
+            code += offset;
+    MOTH_END_INSTR(CmpStrictNotEqualJumpFalse)
+
     MOTH_BEGIN_INSTR(CmpIn)
         STORE_IP();
         STORE_ACC();
@@ -1342,6 +1559,34 @@ QV4::ReturnedValue VME::interpret(JSTypesStackFrame *frame, ExecutionEngine *eng
         }
     MOTH_END_INSTR(Add)
 
+    MOTH_BEGIN_INSTR(AddInt)
+        const Value left = STACK_VALUE(lhs);
+        if (Q_LIKELY(left.integerCompatible())) {
+            acc = add_int32(left.int_32(), value);
+        } else if (left.isDouble()) {
+            acc = Encode(left.doubleValue() + value);
+        } else {
+            acc = Encode(value);
+            STORE_ACC();
+            acc = Runtime::Add::call(engine, left, accumulator);
+            CHECK_EXCEPTION;
+        }
+    MOTH_END_INSTR(AddInt)
+
+    MOTH_BEGIN_INSTR(AddConst)
+        const Value left = STACK_VALUE(lhs);
+        acc = constant(function, index).asReturnedValue();
+        if (Q_LIKELY(Value::integerCompatible(left, ACC))) {
+            acc = add_int32(left.int_32(), ACC.int_32());
+        } else if (left.isNumber() && ACC.isNumber()) {
+            acc = Encode(left.asDouble() + ACC.asDouble());
+        } else {
+            STORE_ACC();
+            acc = Runtime::Add::call(engine, left, accumulator);
+            CHECK_EXCEPTION;
+        }
+    MOTH_END_INSTR(AddConst)
+
     MOTH_BEGIN_INSTR(Sub)
         const Value left = STACK_VALUE(lhs);
         if (Q_LIKELY(Value::integerCompatible(left, ACC))) {
@@ -0,0 +1,609 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qv4heapsnapshot_p.h"
+#include "qv4engine_p.h"
+#include "qv4mm_p.h"
+#include "qv4object_p.h"
+#include "qv4arraydata_p.h"
+#include "qv4context_p.h"
+#include "qv4functionobject_p.h"
+#include "qv4function_p.h"
+#include "qv4qobjectwrapper_p.h"
+#include "qv4string_p.h"
+
+#include <QtCore/qhash.h>
+#include <QtCore/qiodevice.h>
+#include <QtCore/qmetaobject.h>
+#include <QtCore/qscopedvaluerollback.h>
+#include <QtCore/qset.h>
+
+#include <array>
+#include <vector>
+
+QT_BEGIN_NAMESPACE
+
+using namespace QV4;
+
+namespace {
+
+// The types of nodes and edges, as indices into the lists in the meta data of the snapshot.
+enum NodeType {
+    NodeHidden, NodeArray, NodeString, NodeObject, NodeCode, NodeClosure, NodeRegExp,
+    NodeNumber, NodeNative, NodeSynthetic, NodeConcatenatedString, NodeSlicedString,
+    NodeSymbol, NodeBigInt, NodeObjectShape
+};
+
+enum EdgeType {
+    EdgeContext, EdgeElement, EdgeProperty, EdgeInternal, EdgeHidden, EdgeShortcut, EdgeWeak
+};
+
+enum Detachedness { DetachednessUnknown, Attached, Detached };
+
+enum { NodeFieldCount = 7 };
+
+// Longer strings are truncated in the names of the string nodes.
+enum { MaxStringLength = 1024 };
+
+static const char snapshotMeta[] =
+    "{\"snapshot\":{\"meta\":{"
+    "\"node_fields\":[\"type\",\"name\",\"id\",\"self_size\",\"edge_count\",\"trace_node_id\","
+        "\"detachedness\"],"
+    "\"node_types\":[[\"hidden\",\"array\",\"string\",\"object\",\"code\",\"closure\",\"regexp\","
+        "\"number\",\"native\",\"synthetic\",\"concatenated string\",\"sliced string\","
+        "\"symbol\",\"bigint\",\"object shape\"],"
+        "\"string\",\"number\",\"number\",\"number\",\"number\",\"number\"],"
+    "\"edge_fields\":[\"type\",\"name_or_index\",\"to_node\"],"
+    "\"edge_types\":[[\"context\",\"element\",\"property\",\"internal\",\"hidden\",\"shortcut\","
+        "\"weak\"],\"string_or_number\",\"node\"],"
+    "\"trace_function_info_fields\":[\"function_id\",\"name\",\"script_name\",\"script_id\","
+        "\"line\",\"column\"],"
+    "\"trace_node_fields\":[\"id\",\"function_info_index\",\"count\",\"size\",\"children\"],"
+    "\"sample_fields\":[\"timestamp_us\",\"last_assigned_id\"],"
+    "\"location_fields\":[\"object_index\",\"script_id\",\"line\",\"column\"]},";
+
+// Reads the text without converting Latin-1 strings, so that the heap stays untouched.
+static QString stringText(const Heap::StringOrSymbol *s)
+{
+    if (s->isLatin1())
+        return QString::fromLatin1(s->latin1Text().data(), s->latin1Text().size);
+    return QStringView(s->text().data(), s->text().size).toString();
+}
+
+static void clearMarkBit(Heap::Base *b)
+{
+    HeapItem *h = reinterpret_cast<HeapItem *>(b);
+    Chunk *c = h->chunk();
+    Chunk::clearBit(c->blackBitmap, h - c->realBase());
+}
+
+static const Value *dataProperty(Heap::Object *o, PropertyKey key)
+{
+    const InternalClassEntry entry = o->internalClass->find(key);
+    if (!entry.isValid() || entry.attributes.isAccessor())
+        return nullptr;
+    return o->propertyData(entry.index);
+}
+
+class HeapGraph
+{
+public:
+    HeapGraph(ExecutionEngine *engine, MemoryManager *mm);
+
+    void build(MarkStack *markStack, const std::vector<Heap::Base *> &roots);
+    bool write(QIODevice *device) const;
+
+private:
+    struct Node
+    {
+        Heap::Base *heapObject = nullptr;
+        QObject *qobject = nullptr; // for the nodes of the QObjects behind QObjectWrappers
+        NodeType type = NodeHidden;
+        int name = 0;
+        size_t selfSize = 0;
+        uint edgeCount = 0;
+        Detachedness detachedness = DetachednessUnknown;
+    };
+
+    struct Edge
+    {
+        EdgeType type;
+        int nameOrIndex;
+        int toNode;
+    };
+
+    int string(const QString &s);
+    int nodeFor(Heap::Base *b);
+    int nodeFor(QObject *o);
+    size_t itemSize(Heap::Base *b) const;
+    void describe(Node *node);
+    QString functionName(Heap::FunctionObject *f) const;
+    QString constructorName(Heap::Object *o) const;
+
+    void collectChildren(Heap::Base *b, MarkStack *markStack,
+                         std::vector<Heap::Base *> *children) const;
+    void addEdge(int from, EdgeType type, int nameOrIndex, int to);
+    void addValueEdge(int from, EdgeType type, int nameOrIndex, const Value &v,
+                      QSet<Heap::Base *> *linked);
+    void addObjectEdges(int node, MarkStack *markStack);
+    void addQObjectEdges(int node, MarkStack *markStack);
+
+    ExecutionEngine *m_engine;
+    std::vector<Node> m_nodes;
+    std::vector<Edge> m_edges;
+    QHash<Heap::Base *, int> m_heapNodes;
+    QHash<QObject *, int> m_qobjectNodes;
+    QHash<QString, int> m_stringIndices;
+    QStringList m_strings;
+    QHash<const Chunk *, size_t> m_hugeItemSizes;
+};
+
+HeapGraph::HeapGraph(ExecutionEngine *engine, MemoryManager *mm)
+    : m_engine(engine)
+{
+    for (const auto &c : mm->hugeItemAllocator.chunks)
+        m_hugeItemSizes.insert(c.chunk, c.size);
+
+    Node root;
+    root.type = NodeSynthetic;
+    root.name = string(QStringLiteral("(GC roots)"));
+    m_nodes.push_back(root);
+}
+
+int HeapGraph::string(const QString &s)
+{
+    auto it = m_stringIndices.constFind(s);
+    if (it != m_stringIndices.constEnd())
+        return *it;
+    const int index = int(m_strings.size());
+    m_strings.append(s);
+    m_stringIndices.insert(s, index);
+    return index;
+}
+
+size_t HeapGraph::itemSize(Heap::Base *b) const
+{
+    HeapItem *h = reinterpret_cast<HeapItem *>(b);
+    Chunk *c = h->chunk();
+    if (h == c->first()) {
+        auto it = m_hugeItemSizes.constFind(c);
+        if (it != m_hugeItemSizes.constEnd())
+            return *it;
+    }
+    return h->size();
+}
+
+QString HeapGraph::functionName(Heap::FunctionObject *f) const
+{
+    if (f->function) {
+        if (Heap::String *name = f->function->name())
+            return stringText(name);
+    }
+    if (const Value *name = dataProperty(f, m_engine->id_name()->propertyKey())) {
+        if (const String *s = name->as<String>()) {
+            if (s->d()->subtype < Heap::String::StringType_Complex)
+                return stringText(s->d());
+        }
+    }
+    return QString();
+}
+
+// Names plain objects after their constructor, as the DevTools do for other engines.
+QString HeapGraph::constructorName(Heap::Object *o) const
+{
+    if (Heap::Object *prototype = o->internalClass->prototype) {
+        const Value *constructor = dataProperty(prototype,
+                                                m_engine->id_constructor()->propertyKey());
+        if (constructor) {
+            if (const FunctionObject *f = constructor->as<FunctionObject>()) {
+                const QString name = functionName(f->d());
+                if (!name.isEmpty())
+                    return name;
+            }
+        }
+    }
+    return QString::fromLatin1(o->internalClass->vtable->className);
+}
+
+void HeapGraph::describe(Node *node)
+{
+    Heap::Base *b = node->heapObject;
+    const VTable *vtable = b->internalClass->vtable;
+    const Value value = Value::fromHeapObject(b);
+    QString name;
+
+    if (vtable->isString) {
+        Heap::String *s = static_cast<Heap::String *>(b);
+        if (s->subtype == Heap::String::StringType_AddedString) {
+            node->type = NodeConcatenatedString;
+        } else if (s->subtype == Heap::String::StringType_SubString) {
+            node->type = NodeSlicedString;
+        } else {
+            node->type = NodeString;
+            name = stringText(s).left(MaxStringLength);
+            node->selfSize += s->retainedTextSize();
+        }
+    } else if (vtable->isStringOrSymbol) {
+        node->type = NodeSymbol;
+        name = stringText(static_cast<Heap::StringOrSymbol *>(b));
+    } else if (vtable->type == Managed::Type_InternalClass) {
+        node->type = NodeObjectShape;
+    } else if (vtable->isFunctionObject) {
+        node->type = NodeClosure;
+        name = functionName(static_cast<Heap::FunctionObject *>(b));
+    } else if (vtable->type == Managed::Type_RegExpObject || vtable->type == Managed::Type_RegExp) {
+        node->type = NodeRegExp;
+    } else if (const QObjectWrapper *wrapper = value.as<QObjectWrapper>()) {
+        node->type = NodeObject;
+        if (QObject *o = wrapper->object()) {
+            name = QString::fromLatin1(o->metaObject()->className());
+            const QString objectName = o->objectName();
+            if (!objectName.isEmpty())
+                name += QLatin1Char(' ') + objectName;
+            node->detachedness = Attached;
+        } else {
+            // The QObject is gone, but something in JavaScript still holds on to the wrapper.
+            node->detachedness = Detached;
+        }
+    } else if (vtable->isObject) {
+        node->type = NodeObject;
+        if (vtable->type == Managed::Type_Object)
+            name = constructorName(static_cast<Heap::Object *>(b));
+    }
+
+    if (name.isEmpty())
+        name = QString::fromLatin1(vtable->className);
+    node->name = string(name);
+}
+
+int HeapGraph::nodeFor(Heap::Base *b)
+{
+    auto it = m_heapNodes.constFind(b);
+    if (it != m_heapNodes.constEnd())
+        return *it;
+
+    Node node;
+    node.heapObject = b;
+    node.selfSize = itemSize(b);
+    describe(&node);
+
+    const int index = int(m_nodes.size());
+    m_nodes.push_back(node);
+    m_heapNodes.insert(b, index);
+    return index;
+}
+
+int HeapGraph::nodeFor(QObject *o)
+{
+    auto it = m_qobjectNodes.constFind(o);
+    if (it != m_qobjectNodes.constEnd())
+        return *it;
+
+    Node node;
+    node.qobject = o;
+    node.type = NodeNative;
+    node.name = string(QString::fromLatin1(o->metaObject()->className()));
+    node.detachedness = Attached;
+
+    const int index = int(m_nodes.size());
+    m_nodes.push_back(node);
+    m_qobjectNodes.insert(o, index);
+    return index;
+}
+
+// Lets the object mark its children, and takes them back from the mark stack. The mark bits
+// are cleared again, so that other objects referencing the same children report them, too.
+void HeapGraph::collectChildren(Heap::Base *b, MarkStack *markStack,
+                                std::vector<Heap::Base *> *children) const
+{
+    const size_t first = children->size();
+    b->internalClass->vtable->markObjects(b, markStack);
+    markStack->takeCollected(children);
+    for (size_t i = first, end = children->size(); i < end; ++i)
+        clearMarkBit(children->at(i));
+}
+
+void HeapGraph::addEdge(int from, EdgeType type, int nameOrIndex, int to)
+{
+    m_edges.push_back({ type, nameOrIndex, to });
+    ++m_nodes[from].edgeCount;
+}
+
+void HeapGraph::addValueEdge(int from, EdgeType type, int nameOrIndex, const Value &v,
+                             QSet<Heap::Base *> *linked)
+{
+    Heap::Base *b = v.heapObject();
+    if (!b)
+        return;
+    addEdge(from, type, nameOrIndex, nodeFor(b));
+    linked->insert(b);
+}
+
+void HeapGraph::addObjectEdges(int node, MarkStack *markStack)
+{
+    Heap::Base *b = m_nodes[node].heapObject;
+    const VTable *vtable = b->internalClass->vtable;
+
+    std::vector<Heap::Base *> children;
+    collectChildren(b, markStack, &children);
+
+    QSet<Heap::Base *> linked;
+    Heap::InternalClass *ic = b->internalClass;
+    addEdge(node, EdgeInternal, string(QStringLiteral("map")), nodeFor(ic));
+    linked.insert(ic);
+
+    if (vtable->isObject) {
+        Heap::Object *o = static_cast<Heap::Object *>(b);
+
+        // The member data and the array data are part of the object, rather than nodes of
+        // their own. Their contents are reported as properties and elements below.
+        for (Heap::Base *part : { static_cast<Heap::Base *>(o->memberData),
+                                  static_cast<Heap::Base *>(o->arrayData) }) {
+            if (!part)
+                continue;
+            m_nodes[node].selfSize += itemSize(part);
+            linked.insert(part);
+            collectChildren(part, markStack, &children);
+        }
+
+        for (uint i = 0; i < ic->size; ++i) {
+            const PropertyKey key = ic->nameMap.at(i);
+            if (!key.isValid())
+                continue;
+            const PropertyAttributes attributes = ic->propertyData.at(i);
+            if (attributes.isEmpty())
+                continue;
+            const QString name = key.toQString();
+            if (attributes.isAccessor()) {
+                addValueEdge(node, EdgeInternal, string(QStringLiteral("get ") + name),
+                             *o->propertyData(i), &linked);
+                const uint setterIndex = ic->find(key).setterIndex;
+                if (setterIndex != UINT_MAX) {
+                    addValueEdge(node, EdgeInternal, string(QStringLiteral("set ") + name),
+                                 *o->propertyData(setterIndex), &linked);
+                }
+            } else {
+                addValueEdge(node, EdgeProperty, string(name), *o->propertyData(i), &linked);
+            }
+        }
+
+        if (Heap::ArrayData *arrayData = o->arrayData) {
+            if (arrayData->isSparse()) {
+                const Heap::SparseArrayData *sparse
+                        = static_cast<Heap::SparseArrayData *>(arrayData);
+                for (const SparseArrayNode *n = sparse->sparse->begin();
+                     n != sparse->sparse->end(); n = n->nextNode()) {
+                    addValueEdge(node, EdgeElement, int(n->key()), sparse->values[n->value],
+                                 &linked);
+                }
+            } else {
+                const Heap::SimpleArrayData *simple
+                        = static_cast<Heap::SimpleArrayData *>(arrayData);
+                for (uint i = 0; i < simple->values.size; ++i)
+                    addValueEdge(node, EdgeElement, int(i), simple->data(i), &linked);
+            }
+        }
+
+        const Value value = Value::fromHeapObject(b);
+        if (const QObjectWrapper *wrapper = value.as<QObjectWrapper>()) {
+            if (QObject *qobject = wrapper->object())
+                addEdge(node, EdgeInternal, string(QStringLiteral("qobject")), nodeFor(qobject));
+        }
+    } else if (vtable->isExecutionContext) {
+        Heap::ExecutionContext *context = static_cast<Heap::ExecutionContext *>(b);
+        if (context->type == Heap::ExecutionContext::Type_CallContext
+                || context->type == Heap::ExecutionContext::Type_BlockContext) {
+            // The internal class of a call or block context maps the names of its locals.
+            Heap::CallContext *callContext = static_cast<Heap::CallContext *>(context);
+            const uint nLocals = qMin(ic->size, callContext->locals.size);
+            for (uint i = 0; i < nLocals; ++i) {
+                const PropertyKey key = ic->nameMap.at(i);
+                if (key.isValid()) {
+                    addValueEdge(node, EdgeContext, string(key.toQString()),
+                                 callContext->locals[i], &linked);
+                }
+            }
+        }
+    }
+
+    int index = 0;
+    for (Heap::Base *child : children) {
+        if (linked.contains(child))
+            continue;
+        linked.insert(child);
+        addEdge(node, EdgeHidden, index++, nodeFor(child));
+    }
+}
+
+// Links the QObject to the wrappers of its children, so that the object tree shows up as
+// retainers of the wrappers.
+void HeapGraph::addQObjectEdges(int node, MarkStack *markStack)
+{
+    QObject *qobject = m_nodes[node].qobject;
+    std::vector<Heap::Base *> wrappers;
+    int index = 0;
+    for (QObject *child : qobject->children()) {
+        if (!child)
+            continue;
+        wrappers.clear();
+        QObjectWrapper::markWrapper(child, markStack);
+        markStack->takeCollected(&wrappers);
+        for (Heap::Base *wrapper : wrappers) {
+            clearMarkBit(wrapper);
+            addEdge(node, EdgeElement, index, nodeFor(wrapper));
+        }
+        ++index;
+    }
+}
+
+void HeapGraph::build(MarkStack *markStack, const std::vector<Heap::Base *> &roots)
+{
+    int index = 0;
+    for (Heap::Base *root : roots)
+        addEdge(0, EdgeElement, index++, nodeFor(root));
+
+    // New nodes are appended while walking the graph. Visiting them in order keeps the
+    // edges of each node together, as the format requires.
+    for (size_t i = 1; i < m_nodes.size(); ++i) {
+        if (m_nodes[i].qobject)
+            addQObjectEdges(int(i), markStack);
+        else
+            addObjectEdges(int(i), markStack);
+    }
+}
+
+static void appendJsonString(QByteArray *out, const QString &s)
+{
+    out->append('"');
+    for (const QChar c : s) {
+        const char16_t u = c.unicode();
+        switch (u) {
+        case '"':
+            out->append("\\\"");
+            break;
+        case '\\':
+            out->append("\\\\");
+            break;
+        case '\n':
+            out->append("\\n");
+            break;
+        case '\r':
+            out->append("\\r");
+            break;
+        case '\t':
+            out->append("\\t");
+            break;
+        default:
+            if (u < 0x20 || u >= 0x7f)
+                out->append("\\u").append(QByteArray::number(u, 16).rightJustified(4, '0'));
+            else
+                out->append(char(u));
+            break;
+        }
+    }
+    out->append('"');
+}
+
+bool HeapGraph::write(QIODevice *device) const
+{
+    enum { FlushThreshold = 64 * 1024 };
+
+    QByteArray buffer;
+    bool ok = true;
+    const auto flushIfNeeded = [&](bool force = false) {
+        if (ok && (force || buffer.size() >= FlushThreshold)) {
+            ok = device->write(buffer) == buffer.size();
+            buffer.clear();
+        }
+    };
+    const auto appendNumber = [&](qulonglong n) {
+        buffer.append(QByteArray::number(n));
+    };
+
+    buffer.append(snapshotMeta);
+    buffer.append("\"node_count\":");
+    appendNumber(m_nodes.size());
+    buffer.append(",\"edge_count\":");
+    appendNumber(m_edges.size());
+    buffer.append(",\"trace_function_count\":0},\n\"nodes\":[");
+
+    for (size_t i = 0; i < m_nodes.size(); ++i) {
+        const Node &node = m_nodes[i];
+        if (i)
+            buffer.append(",\n");
+        appendNumber(node.type);
+        buffer.append(',');
+        appendNumber(node.name);
+        buffer.append(',');
+        appendNumber(2 * i + 1);
+        buffer.append(',');
+        appendNumber(node.selfSize);
+        buffer.append(',');
+        appendNumber(node.edgeCount);
+        buffer.append(",0,");
+        appendNumber(node.detachedness);
+        flushIfNeeded();
+    }
+
+    buffer.append("],\n\"edges\":[");
+    for (size_t i = 0; i < m_edges.size(); ++i) {
+        const Edge &edge = m_edges[i];
+        if (i)
+            buffer.append(",\n");
+        appendNumber(edge.type);
+        buffer.append(',');
+        appendNumber(edge.nameOrIndex);
+        buffer.append(',');
+        appendNumber(qulonglong(edge.toNode) * NodeFieldCount);
+        flushIfNeeded();
+    }
+
+    buffer.append("],\n\"trace_function_infos\":[],\n\"trace_tree\":[],\n\"samples\":[],\n"
+                  "\"locations\":[],\n\"strings\":[");
+    for (qsizetype i = 0; i < m_strings.size(); ++i) {
+        if (i)
+            buffer.append(",\n");
+        appendJsonString(&buffer, m_strings.at(i));
+        flushIfNeeded();
+    }
+    buffer.append("]}\n");
+    flushIfNeeded(true);
+    return ok;
+}
+
+} // namespace
+
+namespace QV4 {
+
+bool HeapSnapshot::write(ExecutionEngine *engine, QIODevice *device)
+{
+    MemoryManager *mm = engine->memoryManager;
+    if (mm->gcBlocked)
+        return false;
+
+    // Only report what is reachable. This also completes any ongoing incremental collection,
+    // so that the mark bits can be used to walk the heap below.
+    mm->runGC();
+    Q_ASSERT(mm->gcState == MemoryManager::GCState::Idle);
+
+    QScopedValueRollback<bool> gcBlocker(mm->gcBlocked, true);
+
+    // With generational collection, the black bits denote the old generation. Restore them
+    // afterwards, so that the next minor collection still finds the old objects.
+    std::vector<std::pair<Chunk *, std::array<quintptr, Chunk::EntriesInBitmap>>> blackBits;
+    if (mm->generationalGC) {
+        const auto save = [&](Chunk *c) {
+            blackBits.emplace_back(c, std::array<quintptr, Chunk::EntriesInBitmap>());
+            std::copy(std::begin(c->blackBitmap), std::end(c->blackBitmap),
+                      blackBits.back().second.begin());
+        };
+        for (Chunk *c : mm->blockAllocator.chunks)
+            save(c);
+        for (Chunk *c : mm->icAllocator.chunks)
+            save(c);
+        for (const auto &c : mm->hugeItemAllocator.chunks)
+            save(c.chunk);
+        mm->resetBlackBits();
+    }
+
+    HeapGraph graph(engine, mm);
+    {
+        MarkStack markStack(engine, MarkStack::Mode::Collect);
+        std::vector<Heap::Base *> roots;
+        mm->collectRoots(&markStack);
+        markStack.takeCollected(&roots);
+        for (Heap::Base *root : roots)
+            clearMarkBit(root);
+        graph.build(&markStack, roots);
+    }
+
+    mm->resetBlackBits();
+    for (const auto &saved : blackBits)
+        std::copy(saved.second.begin(), saved.second.end(), std::begin(saved.first->blackBitmap));
+
+    return graph.write(device);
+}
+
+} // namespace QV4
+
+QT_END_NAMESPACE
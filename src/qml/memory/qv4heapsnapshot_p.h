@@ -0,0 +1,42 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QV4HEAPSNAPSHOT_P_H
+#define QV4HEAPSNAPSHOT_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <private/qv4global_p.h>
+
+QT_BEGIN_NAMESPACE
+
+class QIODevice;
+
+namespace QV4 {
+
+// Writes the JavaScript heap of an engine in the .heapsnapshot format of the Chrome DevTools.
+// The snapshot contains every object that survives a garbage collection, the references
+// between them, and a node for each QObject wrapped by a QObjectWrapper. It can be loaded into
+// the memory panel of the DevTools, which calculate the retained sizes and dominators from it.
+class Q_QML_PRIVATE_EXPORT HeapSnapshot
+{
+public:
+    // Returns false if the garbage collector is blocked, for example because this is called
+    // from within a garbage collection, or if writing to the device fails.
+    static bool write(ExecutionEngine *engine, QIODevice *device);
+};
+
+} // namespace QV4
+
+QT_END_NAMESPACE
+
+#endif // QV4HEAPSNAPSHOT_P_H
@@ -6,6 +6,7 @@
 #include "qv4mm_p.h"
 #include "qv4qobjectwrapper_p.h"
 #include "qv4identifiertable_p.h"
+#include "qv4executableallocator_p.h"
 #include <QtCore/qalgorithms.h>
 #include <QtCore/private/qnumeric_p.h>
 #include <QtCore/qloggingcategory.h>
@@ -14,9 +15,17 @@
 #include "PageReservation.h"
 #include "PageAllocation.h"
 
+#include <QAbstractEventDispatcher>
+#include <QBasicTimer>
 #include <QElapsedTimer>
 #include <QMap>
 #include <QScopedValueRollback>
+#include <QThread>
+#include <QTimerEvent>
+#if QT_CONFIG(thread)
+#include <QSemaphore>
+#include <QThreadPool>
+#endif
 
 #include <iostream>
 #include <cstdlib>
@@ -67,7 +76,46 @@ namespace QV4 {
 
 enum {
     MinSlotsGCLimit = QV4::Chunk::AvailableSlots*16,
-    GCOverallocation = 200 /* Max overallocation by the GC in % */
+    GCOverallocation = 200, /* Max overallocation by the GC in % */
+    DefaultGCSliceBudget = 2, /* in ms */
+    MaxRecordedGCPauses = 1024
+};
+
+// Continues an incremental collection from the event loop, so that it also
+// makes progress when the application isn't allocating, and so that most of
+// the slices run in between the frames of animations.
+struct IncrementalGCDriver : public QObject
+{
+    IncrementalGCDriver(MemoryManager *mm) : mm(mm) {}
+
+    void schedule(int msecs)
+    {
+        // The timer can only fire in the thread the driver lives in. If the
+        // engine has been moved to another thread, slices are only driven
+        // by allocations.
+        if (timer.isActive() || thread() != QThread::currentThread()
+                || !QAbstractEventDispatcher::instance()) {
+            return;
+        }
+        timer.start(msecs, this);
+    }
+
+    void stop() { timer.stop(); }
+
+protected:
+    void timerEvent(QTimerEvent *event) override
+    {
+        if (event->timerId() != timer.timerId()) {
+            QObject::timerEvent(event);
+            return;
+        }
+        timer.stop();
+        mm->continueIncrementalGC(/*force*/true);
+    }
+
+private:
+    MemoryManager *mm;
+    QBasicTimer timer;
 };
 
 struct MemorySegment {
@@ -263,21 +311,24 @@ static void increaseFreedCountForClass(const char *className)
     (*freedObjectStatsGlobal())[className]++;
 }
 
-//bool Chunk::sweep(ClassDestroyStatsCallback classCountPtr)
-bool Chunk::sweep(ExecutionEngine *engine)
+// Frees all objects in the chunk that haven't been marked. \a destroy is called
+// for each of them before its slots are released. Returns whether any objects are
+// left in the chunk.
+template <typename Destroy>
+static bool sweepChunk(Chunk *c, size_t *freedSlots, Destroy &&destroy)
 {
     bool hasUsedSlots = false;
-    SDUMP() << "sweeping chunk" << this;
-    HeapItem *o = realBase();
+    SDUMP() << "sweeping chunk" << c;
+    HeapItem *o = c->realBase();
     bool lastSlotFree = false;
     for (uint i = 0; i < Chunk::EntriesInBitmap; ++i) {
-        quintptr toFree = objectBitmap[i] ^ blackBitmap[i];
-        Q_ASSERT((toFree & objectBitmap[i]) == toFree); // check all black objects are marked as being used
-        quintptr e = extendsBitmap[i];
+        quintptr toFree = c->objectBitmap[i] ^ c->blackBitmap[i];
+        Q_ASSERT((toFree & c->objectBitmap[i]) == toFree); // check all black objects are marked as being used
+        quintptr e = c->extendsBitmap[i];
         SDUMP() << "   index=" << i;
         SDUMP() << "        toFree      =" << binary(toFree);
-        SDUMP() << "        black       =" << binary(blackBitmap[i]);
-        SDUMP() << "        object      =" << binary(objectBitmap[i]);
+        SDUMP() << "        black       =" << binary(c->blackBitmap[i]);
+        SDUMP() << "        object      =" << binary(c->objectBitmap[i]);
         SDUMP() << "        extends     =" << binary(e);
         if (lastSlotFree)
             e &= (e + 1); // clear all lowest extent bits
@@ -298,34 +349,64 @@ bool Chunk::sweep(ExecutionEngine *engine)
             e &= result;
 
             HeapItem *itemToFree = o + index;
-            Heap::Base *b = *itemToFree;
-            const VTable *v = b->internalClass->vtable;
-//            if (Q_UNLIKELY(classCountPtr))
-//                classCountPtr(v->className);
-            if (v->destroy) {
-                v->destroy(b);
-                b->_checkIsDestroyed();
-            }
+            destroy(static_cast<Heap::Base *>(*itemToFree));
 #ifdef V4_USE_HEAPTRACK
             heaptrack_report_free(itemToFree);
 #endif
         }
-        Q_V4_PROFILE_DEALLOC(engine, qPopulationCount((objectBitmap[i] | extendsBitmap[i])
-                                                      - (blackBitmap[i] | e)) * Chunk::SlotSize,
-                             Profiling::SmallItem);
-        objectBitmap[i] = blackBitmap[i];
-        hasUsedSlots |= (blackBitmap[i] != 0);
-        extendsBitmap[i] = e;
-        lastSlotFree = !((objectBitmap[i]|extendsBitmap[i]) >> (sizeof(quintptr)*8 - 1));
+        *freedSlots += qPopulationCount((c->objectBitmap[i] | c->extendsBitmap[i])
+                                        - (c->blackBitmap[i] | e));
+        c->objectBitmap[i] = c->blackBitmap[i];
+        hasUsedSlots |= (c->blackBitmap[i] != 0);
+        c->extendsBitmap[i] = e;
+        lastSlotFree = !((c->objectBitmap[i]|c->extendsBitmap[i]) >> (sizeof(quintptr)*8 - 1));
         SDUMP() << "        new extends =" << binary(e);
         SDUMP() << "        lastSlotFree" << lastSlotFree;
-        Q_ASSERT((objectBitmap[i] & extendsBitmap[i]) == 0);
+        Q_ASSERT((c->objectBitmap[i] & c->extendsBitmap[i]) == 0);
         o += Chunk::Bits;
     }
     //    DEBUG << "swept chunk" << this << "freed" << slotsFreed << "slots.";
     return hasUsedSlots;
 }
 
+//bool Chunk::sweep(ClassDestroyStatsCallback classCountPtr)
+bool Chunk::sweep(ExecutionEngine *engine)
+{
+    size_t freedSlots = 0;
+    const bool hasUsedSlots = sweepChunk(this, &freedSlots, [](Heap::Base *b) {
+        const VTable *v = b->internalClass->vtable;
+//        if (Q_UNLIKELY(classCountPtr))
+//            classCountPtr(v->className);
+        if (v->destroy) {
+            v->destroy(b);
+            b->_checkIsDestroyed();
+        }
+    });
+    Q_V4_PROFILE_DEALLOC(engine, freedSlots * Chunk::SlotSize, Profiling::SmallItem);
+    return hasUsedSlots;
+}
+
+void Chunk::collectObjectsToDestroy(std::vector<Heap::Base *> *objects)
+{
+    HeapItem *o = realBase();
+    for (uint i = 0; i < Chunk::EntriesInBitmap; ++i) {
+        quintptr toFree = objectBitmap[i] ^ blackBitmap[i];
+        while (toFree) {
+            uint index = qCountTrailingZeroBits(toFree);
+            toFree ^= (static_cast<quintptr>(1) << index);
+            Heap::Base *b = o[index];
+            if (b->internalClass->vtable->destroy)
+                objects->push_back(b);
+        }
+        o += Chunk::Bits;
+    }
+}
+
+bool Chunk::sweepDestroyed(size_t *freedSlots)
+{
+    return sweepChunk(this, freedSlots, [](Heap::Base *) {});
+}
+
 void Chunk::freeAll(ExecutionEngine *engine)
 {
     //    DEBUG << "sweeping chunk" << this << (*freeList);
@@ -578,6 +659,116 @@ void BlockAllocator::sweep()
     chunks.erase(firstEmptyChunk, chunks.end());
 }
 
+#if QT_CONFIG(thread)
+void BlockAllocator::sweep(QThreadPool *threadPool, qint64 *destroyTime)
+{
+    const size_t nBatches = qMin(size_t(threadPool->maxThreadCount()) + 1, chunks.size());
+    if (nBatches < 2) {
+        sweep();
+        return;
+    }
+
+    nextFree = nullptr;
+    nFree = 0;
+    memset(freeBins, 0, sizeof(freeBins));
+    usedSlotsAfterLastSweep = 0;
+
+    struct Batch {
+        Chunk **begin = nullptr;
+        Chunk **end = nullptr;
+        Chunk **firstEmptyChunk = nullptr;
+        std::vector<Heap::Base *> objectsToDestroy;
+        HeapItem *bins[NumBins] = {};
+        HeapItem *lastInBin[NumBins] = {};
+        size_t usedSlots = 0;
+        size_t freedSlots = 0;
+    };
+
+    std::vector<Batch> batches(nBatches);
+    Chunk **next = chunks.data();
+    Chunk **const end = next + chunks.size();
+    for (size_t i = 0; i < nBatches; ++i) {
+        batches[i].begin = next;
+        next += (end - next) / (nBatches - i);
+        batches[i].end = next;
+    }
+    Q_ASSERT(next == end);
+
+    // Runs work on all batches and waits for it to finish. This thread takes the first batch.
+    auto forAllBatches = [&](auto work) {
+        QSemaphore done;
+        for (size_t i = 1; i < nBatches; ++i) {
+            Batch *batch = &batches[i];
+            threadPool->start([&work, &done, batch]() {
+                work(batch);
+                done.release();
+            });
+        }
+        work(&batches[0]);
+        done.acquire(int(nBatches - 1));
+    };
+
+    forAllBatches([](Batch *batch) {
+        for (Chunk **c = batch->begin; c != batch->end; ++c)
+            (*c)->collectObjectsToDestroy(&batch->objectsToDestroy);
+    });
+
+    // Destructors may have thread affinity, for example if they delete QObjects.
+    // Run them all here, before their slots get reused for the free lists.
+    QElapsedTimer destroyTimer;
+    if (destroyTime)
+        destroyTimer.start();
+    for (const Batch &batch : batches) {
+        for (Heap::Base *b : batch.objectsToDestroy) {
+            b->internalClass->vtable->destroy(b);
+            b->_checkIsDestroyed();
+        }
+    }
+    if (destroyTime)
+        *destroyTime += destroyTimer.nsecsElapsed() / 1000;
+
+    forAllBatches([](Batch *batch) {
+        batch->firstEmptyChunk = std::partition(batch->begin, batch->end, [batch](Chunk *c) {
+            return c->sweepDestroyed(&batch->freedSlots);
+        });
+        std::for_each(batch->begin, batch->firstEmptyChunk, [batch](Chunk *c) {
+            c->sortIntoBins(batch->bins, NumBins);
+            batch->usedSlots += c->nUsedSlots();
+        });
+        // Find the ends of the free lists, so that they can be concatenated quickly.
+        for (uint i = 0; i < NumBins; ++i) {
+            for (HeapItem *h = batch->bins[i]; h; h = h->freeData.next)
+                batch->lastInBin[i] = h;
+        }
+    });
+
+    std::vector<Chunk *> usedChunks;
+    usedChunks.reserve(chunks.size());
+    size_t freedSlots = 0;
+    for (const Batch &batch : batches) {
+        for (uint i = 0; i < NumBins; ++i) {
+            if (!batch.bins[i])
+                continue;
+            batch.lastInBin[i]->freeData.next = freeBins[i];
+            freeBins[i] = batch.bins[i];
+        }
+        usedSlotsAfterLastSweep += batch.usedSlots;
+        freedSlots += batch.freedSlots;
+        usedChunks.insert(usedChunks.end(), batch.begin, batch.firstEmptyChunk);
+    }
+    Q_V4_PROFILE_DEALLOC(engine, freedSlots * Chunk::SlotSize, Profiling::SmallItem);
+
+    for (const Batch &batch : batches) {
+        std::for_each(batch.firstEmptyChunk, batch.end, [this](Chunk *c) {
+            Q_V4_PROFILE_DEALLOC(engine, Chunk::DataSize, Profiling::HeapPage);
+            chunkAllocator->free(c);
+        });
+    }
+
+    chunks = std::move(usedChunks);
+}
+#endif
+
 void BlockAllocator::freeAll()
 {
     for (auto c : chunks)
@@ -645,7 +836,6 @@ void HugeItemAllocator::sweep(ClassDestroyStatsCallback classCountPtr)
 {
     auto isBlack = [this, classCountPtr] (const HugeChunk &c) {
         bool b = c.chunk->first()->isBlack();
-        Chunk::clearBit(c.chunk->blackBitmap, c.chunk->first() - c.chunk->realBase());
         if (!b) {
             Q_V4_PROFILE_DEALLOC(engine, c.size, Profiling::LargeItem);
             freeHugeChunk(chunkAllocator, c, classCountPtr);
@@ -684,6 +874,9 @@ MemoryManager::MemoryManager(ExecutionEngine *engine)
     , aggressiveGC(!qEnvironmentVariableIsEmpty("QV4_MM_AGGRESSIVE_GC"))
     , gcStats(lcGcStats().isDebugEnabled())
     , gcCollectorStats(lcGcAllocatorStats().isDebugEnabled())
+    , incrementalGC(!qEnvironmentVariableIsEmpty("QV4_MM_INCREMENTAL_GC"))
+    , generationalGC(!qEnvironmentVariableIsEmpty("QV4_MM_GENERATIONAL_GC"))
+    , gcSliceBudget(qint64(DefaultGCSliceBudget) * 1000 * 1000)
 {
 #ifdef V4_USE_VALGRIND
     VALGRIND_CREATE_MEMPOOL(this, 0, true);
@@ -691,6 +884,26 @@ MemoryManager::MemoryManager(ExecutionEngine *engine)
     memset(statistics.allocations, 0, sizeof(statistics.allocations));
     if (gcStats)
         blockAllocator.allocationStats = statistics.allocations;
+
+    bool ok = false;
+    const int sliceBudget = qEnvironmentVariableIntValue("QV4_MM_GC_SLICE_BUDGET", &ok);
+    if (ok && sliceBudget > 0)
+        gcSliceBudget = qint64(sliceBudget) * 1000 * 1000;
+
+#if QT_CONFIG(thread)
+    if (!qEnvironmentVariableIsEmpty("QV4_MM_PARALLEL_SWEEP")) {
+        int sweepThreads = qEnvironmentVariableIntValue("QV4_MM_PARALLEL_SWEEP", &ok);
+        if (!ok || sweepThreads <= 0)
+            sweepThreads = QThread::idealThreadCount();
+        if (sweepThreads > 1) {
+            sweepThreadPool = std::make_unique<QThreadPool>();
+            // The engine's thread sweeps, too.
+            sweepThreadPool->setMaxThreadCount(sweepThreads - 1);
+        }
+    }
+#endif
+
+    engine->isGenerationalGC = generationalGC;
 }
 
 Heap::Base *MemoryManager::allocString(std::size_t unmanagedSize)
@@ -778,8 +991,8 @@ Heap::Object *MemoryManager::allocObjectWithMemberData(const QV4::VTable *vtable
 
 static uint markStackSize = 0;
 
-MarkStack::MarkStack(ExecutionEngine *engine)
-    : m_engine(engine)
+MarkStack::MarkStack(ExecutionEngine *engine, Mode mode)
+    : m_engine(engine), m_mode(mode)
 {
     m_base = (Heap::Base **)engine->gcStack->base();
     m_top = m_base;
@@ -798,6 +1011,113 @@ void MarkStack::drain()
     }
 }
 
+MarkStack::DrainState MarkStack::drain(QDeadlineTimer deadline)
+{
+    // Checking the time is not free, so only do it every couple of objects.
+    enum { DeadlineCheckInterval = 64 };
+
+    do {
+        for (int i = 0; i < DeadlineCheckInterval; ++i) {
+            if (m_top == m_base)
+                return DrainState::Complete;
+            Heap::Base *h = pop();
+            ++markStackSize;
+            Q_ASSERT(h);
+            h->internalClass->vtable->markObjects(h, this);
+        }
+    } while (!deadline.hasExpired());
+
+    return m_top == m_base ? DrainState::Complete : DrainState::Ongoing;
+}
+
+void MarkStack::spill()
+{
+    Q_ASSERT(m_mode == Mode::Collect);
+    m_spilled.insert(m_spilled.end(), m_base, m_top);
+    m_top = m_base;
+}
+
+void MarkStack::takeCollected(std::vector<Heap::Base *> *objects)
+{
+    Q_ASSERT(m_mode == Mode::Collect);
+    objects->insert(objects->end(), m_spilled.begin(), m_spilled.end());
+    objects->insert(objects->end(), m_base, m_top);
+    m_spilled.clear();
+    m_top = m_base;
+}
+
+void WriteBarrier::markValue(EngineBase *engine, ReturnedValue value)
+{
+    Q_ASSERT(engine->isGCOngoing);
+    if (Heap::Base *b = Value::fromReturnedValue(value).heapObject())
+        b->mark(engine->memoryManager->markStack());
+}
+
+void WriteBarrier::markHeapObject(EngineBase *engine, Heap::Base *value)
+{
+    Q_ASSERT(engine->isGCOngoing);
+    value->mark(engine->memoryManager->markStack());
+}
+
+MarkStack *WriteBarrier::markStack(EngineBase *engine)
+{
+    Q_ASSERT(engine->isGCOngoing);
+    return engine->memoryManager->markStack();
+}
+
+void WriteBarrier::rememberValue(EngineBase *engine, Heap::Base *base, ReturnedValue value)
+{
+    if (Heap::Base *b = Value::fromReturnedValue(value).heapObject())
+        rememberHeapObject(engine, base, b);
+}
+
+void WriteBarrier::rememberHeapObject(EngineBase *engine, Heap::Base *base, Heap::Base *value)
+{
+    Q_ASSERT(engine->isGenerationalGC);
+    // Only references from the old to the young generation are interesting.
+    if (base->isMarked() && !value->isMarked())
+        engine->memoryManager->remember(base);
+}
+
+void WriteBarrier::remember(EngineBase *engine, Heap::Base *base)
+{
+    Q_ASSERT(engine->isGenerationalGC);
+    if (base->isMarked())
+        engine->memoryManager->remember(base);
+}
+
+void WriteBarrier::tenure(EngineBase *engine, Heap::Base *value)
+{
+    Q_ASSERT(engine->isGenerationalGC);
+    value->setMarkBit();
+    engine->memoryManager->remember(value);
+}
+
+void MemoryManager::remember(Heap::Base *base)
+{
+    HeapItem *h = reinterpret_cast<HeapItem *>(base);
+    Chunk *c = h->chunk();
+    const size_t index = h - c->realBase();
+    RememberedBitmap &bitmap = rememberedBitmaps[c];
+    if (Chunk::testBit(bitmap.data(), index))
+        return;
+    Chunk::setBit(bitmap.data(), index);
+    rememberedSet.push_back(base);
+}
+
+void MemoryManager::clearRememberedSet()
+{
+    rememberedSet.clear();
+    rememberedBitmaps.clear();
+}
+
+void MemoryManager::resetBlackBits()
+{
+    blockAllocator.resetBlackBits();
+    hugeItemAllocator.resetBlackBits();
+    icAllocator.resetBlackBits();
+}
+
 void MemoryManager::collectRoots(MarkStack *markStack)
 {
     engine->markObjects(markStack);
@@ -850,6 +1170,18 @@ void MemoryManager::mark()
 
 void MemoryManager::sweep(bool lastSweep, ClassDestroyStatsCallback classCountPtr)
 {
+    QElapsedTimer phaseTimer;
+    if (gcCollectorStats) {
+        sweepTimes = {};
+        phaseTimer.start();
+    }
+    const auto endPhase = [&](qint64 *duration) {
+        if (!gcCollectorStats)
+            return;
+        *duration += phaseTimer.nsecsElapsed() / 1000;
+        phaseTimer.start();
+    };
+
     for (PersistentValueStorage::Iterator it = m_weakValues->begin(); it != m_weakValues->end(); ++it) {
         Managed *m = (*it).managed();
         if (!m || m->markBit())
@@ -918,11 +1250,27 @@ void MemoryManager::sweep(bool lastSweep, ClassDestroyStatsCallback classCountPt
 
 
     if (!lastSweep) {
+        endPhase(&sweepTimes.weakReferences);
         engine->identifierTable->sweep();
-        blockAllocator.sweep(/*classCountPtr*/);
+        endPhase(&sweepTimes.identifiers);
+        sweepChunks(&blockAllocator);
+        endPhase(&sweepTimes.chunks);
         hugeItemAllocator.sweep(classCountPtr);
-        icAllocator.sweep(/*classCountPtr*/);
+        endPhase(&sweepTimes.hugeItems);
+        sweepChunks(&icAllocator);
+        endPhase(&sweepTimes.chunks);
+    }
+}
+
+void MemoryManager::sweepChunks(BlockAllocator *allocator)
+{
+#if QT_CONFIG(thread)
+    if (sweepThreadPool) {
+        allocator->sweep(sweepThreadPool.get(), gcCollectorStats ? &sweepTimes.destroy : nullptr);
+        return;
     }
+#endif
+    allocator->sweep(/*classCountPtr*/);
 }
 
 bool MemoryManager::shouldRunGC() const
@@ -972,11 +1320,27 @@ void MemoryManager::runGC()
     QScopedValueRollback<bool> gcBlocker(gcBlocked, true);
 //    qDebug() << "runGC";
 
+    QElapsedTimer pauseTimer;
+    pauseTimer.start();
+
+    if (gcState == GCState::Marking) {
+        // Somebody explicitly asked for a collection. Complete the ongoing one right away.
+        finishIncrementalGC();
+        recordGCPause(pauseTimer.nsecsElapsed());
+        return;
+    }
+
     if (gcStats) {
         statistics.maxReservedMem = qMax(statistics.maxReservedMem, getAllocatedMem());
         statistics.maxAllocatedMem = qMax(statistics.maxAllocatedMem, getUsedMem() + getLargeItemsMem());
     }
 
+    if (generationalGC) {
+        // A major collection needs to find out about the old generation, too.
+        clearRememberedSet();
+        resetBlackBits();
+    }
+
     if (!gcCollectorStats) {
         mark();
         sweep();
@@ -1022,6 +1386,16 @@ void MemoryManager::runGC()
         qDebug(stats) << "Marked object in" << markTime << "us.";
         qDebug(stats) << "   " << markStackSize << "objects marked";
         qDebug(stats) << "Sweeped object in" << sweepTime << "us.";
+        qDebug(stats) << "    weak references:" << sweepTimes.weakReferences << "us";
+        qDebug(stats) << "    identifiers:" << sweepTimes.identifiers << "us";
+        qDebug(stats) << "    chunks:" << sweepTimes.chunks << "us";
+#if QT_CONFIG(thread)
+        if (sweepThreadPool) {
+            qDebug(stats) << "      on" << (sweepThreadPool->maxThreadCount() + 1) << "threads,"
+                          << sweepTimes.destroy << "us of it destroying objects on the engine's thread";
+        }
+#endif
+        qDebug(stats) << "    huge items:" << sweepTimes.hugeItems << "us";
 
         // sort our object types by number of freed instances
         MMStatsHash freedObjectStats;
@@ -1057,6 +1431,205 @@ void MemoryManager::runGC()
         qDebug(stats) << "======== End GC ========";
     }
 
+    finishGCCycle();
+    recordGCPause(pauseTimer.nsecsElapsed());
+}
+
+// Runs a minor collection if generational collection is enabled and the old
+// generation hasn't grown too much. Otherwise starts an incremental collection,
+// or advances the ongoing one, if incremental collection is enabled. Otherwise
+// runs a full collection.
+void MemoryManager::triggerGC()
+{
+    if (generationalGC && gcState == GCState::Idle && !shouldRunMajorGC()) {
+        runMinorGC();
+        return;
+    }
+
+    if (!incrementalGC) {
+        runGC();
+        return;
+    }
+
+    if (gcBlocked)
+        return;
+
+    if (gcState == GCState::Marking) {
+        continueIncrementalGC();
+        return;
+    }
+
+    QScopedValueRollback<bool> gcBlocker(gcBlocked, true);
+    QElapsedTimer pauseTimer;
+    pauseTimer.start();
+
+    startIncrementalGC();
+    if (runIncrementalMarkSlice())
+        finishIncrementalGC();
+    else
+        m_incrementalGCDriver->schedule(int(gcSliceBudget / (1000 * 1000)));
+
+    recordGCPause(pauseTimer.nsecsElapsed());
+}
+
+// Collects the young generation only. The old generation is black already, so
+// marking stops as soon as it reaches an old object. Young objects only referenced
+// from old ones are found through the remembered set. Surviving young objects
+// keep their black bit and thereby become old.
+void MemoryManager::runMinorGC()
+{
+    Q_ASSERT(generationalGC);
+    Q_ASSERT(gcState == GCState::Idle);
+    if (gcBlocked)
+        return;
+
+    QScopedValueRollback<bool> gcBlocker(gcBlocked, true);
+    QElapsedTimer pauseTimer;
+    pauseTimer.start();
+
+    if (gcStats) {
+        statistics.maxReservedMem = qMax(statistics.maxReservedMem, getAllocatedMem());
+        statistics.maxAllocatedMem = qMax(statistics.maxAllocatedMem, getUsedMem() + getLargeItemsMem());
+    }
+
+    const size_t usedBefore = gcCollectorStats ? getUsedMem() : 0;
+    const size_t rememberedObjects = rememberedSet.size();
+
+    markStackSize = 0;
+    {
+        MarkStack markStack(engine);
+        collectRoots(&markStack);
+        for (Heap::Base *b : std::as_const(rememberedSet))
+            b->internalClass->vtable->markObjects(b, &markStack);
+        // dtor of MarkStack drains
+    }
+
+    // All young objects referenced from the old generation have been promoted.
+    clearRememberedSet();
+    sweep();
+
+    usedSlotsAfterLastFullSweep = blockAllocator.usedSlotsAfterLastSweep + icAllocator.usedSlotsAfterLastSweep;
+    ++statistics.minorCollections;
+    if (gcStats)
+        statistics.maxUsedMem = qMax(statistics.maxUsedMem, getUsedMem() + getLargeItemsMem());
+
+    if (gcCollectorStats) {
+        qDebug(lcGcAllocatorStats) << "Minor GC:" << rememberedObjects << "remembered objects,"
+                                   << markStackSize << "objects marked,"
+                                   << (usedBefore - getUsedMem()) << "bytes freed";
+    }
+
+    recordGCPause(pauseTimer.nsecsElapsed());
+}
+
+// Survivors of minor collections are only freed by major ones. Run one once the
+// old generation has outgrown the memory that was in use after the last major one.
+bool MemoryManager::shouldRunMajorGC() const
+{
+    return oldGenerationSize() * 100 > oldGenerationSizeAfterLastMajorGC * GCOverallocation;
+}
+
+// Huge items and the unmanaged memory held by old objects are only freed by major
+// collections as well.
+size_t MemoryManager::oldGenerationSize() const
+{
+    return usedSlotsAfterLastFullSweep * Chunk::SlotSize + getLargeItemsMem() + unmanagedHeapSize;
+}
+
+void MemoryManager::continueIncrementalGC(bool force)
+{
+    if (gcState != GCState::Marking || gcBlocked)
+        return;
+
+    // Leave the mutator at least as much time as a slice may take.
+    if (!force && lastGCSliceEnd.isValid() && lastGCSliceEnd.nsecsElapsed() < gcSliceBudget)
+        return;
+
+    QScopedValueRollback<bool> gcBlocker(gcBlocked, true);
+    QElapsedTimer pauseTimer;
+    pauseTimer.start();
+
+    // If the mutator allocates much faster than we mark, the heap would grow
+    // without bounds. Give up on incrementality then.
+    if (runIncrementalMarkSlice() || getAllocatedMem() > 2 * allocatedMemAtGCStart)
+        finishIncrementalGC();
+    else
+        m_incrementalGCDriver->schedule(int(gcSliceBudget / (1000 * 1000)));
+
+    recordGCPause(pauseTimer.nsecsElapsed());
+}
+
+void MemoryManager::startIncrementalGC()
+{
+    Q_ASSERT(gcBlocked);
+    Q_ASSERT(gcState == GCState::Idle);
+
+    if (gcStats) {
+        statistics.maxReservedMem = qMax(statistics.maxReservedMem, getAllocatedMem());
+        statistics.maxAllocatedMem = qMax(statistics.maxAllocatedMem, getUsedMem() + getLargeItemsMem());
+        ++statistics.incrementalCycles;
+    }
+
+    if (!m_incrementalGCDriver)
+        m_incrementalGCDriver = std::make_unique<IncrementalGCDriver>(this);
+
+    if (generationalGC) {
+        clearRememberedSet();
+        resetBlackBits();
+    }
+
+    markStackSize = 0;
+    allocatedMemAtGCStart = getAllocatedMem();
+    m_markStack = std::make_unique<MarkStack>(engine);
+    collectRoots(m_markStack.get());
+
+    // From now on, the write barrier shades all values stored into the heap.
+    // New objects are allocated white. They survive if they get stored into
+    // a marked object or are found when rescanning the roots at the end.
+    gcState = GCState::Marking;
+    engine->isGCOngoing = true;
+}
+
+// Marks objects until the slice budget is used up. Returns true if marking is done.
+bool MemoryManager::runIncrementalMarkSlice()
+{
+    Q_ASSERT(gcBlocked);
+    Q_ASSERT(gcState == GCState::Marking);
+
+    const QDeadlineTimer deadline(std::chrono::nanoseconds(gcSliceBudget));
+    const bool done = m_markStack->drain(deadline) == MarkStack::DrainState::Complete;
+    lastGCSliceEnd.start();
+    return done;
+}
+
+void MemoryManager::finishIncrementalGC()
+{
+    Q_ASSERT(gcBlocked);
+    Q_ASSERT(gcState == GCState::Marking);
+
+    // The JS stack and the persistent values aren't covered by the write barrier,
+    // so they need to be scanned again before we can sweep.
+    collectRoots(m_markStack.get());
+    m_markStack->drain(QDeadlineTimer(QDeadlineTimer::Forever));
+    Q_ASSERT(m_markStack->isEmpty());
+
+    engine->isGCOngoing = false;
+    gcState = GCState::Idle;
+    m_markStack.reset();
+    m_incrementalGCDriver->stop();
+    lastGCSliceEnd.invalidate();
+
+    if (gcCollectorStats) {
+        qDebug(lcGcAllocatorStats) << "Incremental GC finished marking," << markStackSize
+                                   << "objects marked";
+    }
+
+    sweep();
+    finishGCCycle();
+}
+
+void MemoryManager::finishGCCycle()
+{
     if (gcStats)
         statistics.maxUsedMem = qMax(statistics.maxUsedMem, getUsedMem() + getLargeItemsMem());
 
@@ -1069,11 +1642,26 @@ void MemoryManager::runGC()
     }
 
     usedSlotsAfterLastFullSweep = blockAllocator.usedSlotsAfterLastSweep + icAllocator.usedSlotsAfterLastSweep;
+    oldGenerationSizeAfterLastMajorGC = oldGenerationSize();
 
-    // reset all black bits
-    blockAllocator.resetBlackBits();
-    hugeItemAllocator.resetBlackBits();
-    icAllocator.resetBlackBits();
+    // With generational collection the survivors keep their black bits, they are
+    // the old generation now.
+    if (!generationalGC)
+        resetBlackBits();
+}
+
+void MemoryManager::recordGCPause(qint64 nsecs)
+{
+    if (!gcStats)
+        return;
+
+    ++statistics.totalPauses;
+    if (statistics.pauses.size() < MaxRecordedGCPauses) {
+        statistics.pauses.push_back(nsecs);
+    } else {
+        statistics.pauses[statistics.nextPause] = nsecs;
+        statistics.nextPause = (statistics.nextPause + 1) % MaxRecordedGCPauses;
+    }
 }
 
 size_t MemoryManager::getUsedMem() const
@@ -1105,6 +1693,23 @@ void MemoryManager::registerWeakSet(Heap::SetObject *set)
 
 MemoryManager::~MemoryManager()
 {
+    if (gcState == GCState::Marking) {
+        // Everything is going to be destroyed below anyway.
+        m_markStack->discard();
+        m_markStack.reset();
+        m_incrementalGCDriver.reset();
+        engine->isGCOngoing = false;
+        gcState = GCState::Idle;
+        resetBlackBits();
+    }
+
+    if (generationalGC) {
+        // The final sweep expects all objects to be unmarked.
+        engine->isGenerationalGC = false;
+        clearRememberedSet();
+        resetBlackBits();
+    }
+
     delete m_persistentValues;
 
     dumpStats();
@@ -1136,6 +1741,28 @@ void MemoryManager::dumpStats() const
     for (int i = 1; i < BlockAllocator::NumBins - 1; ++i)
         qDebug(stats) << "     <" << (i << Chunk::SlotSizeShift) << " bytes: " << statistics.allocations[i];
     qDebug(stats) << "     >=" << ((BlockAllocator::NumBins - 1) << Chunk::SlotSizeShift) << " bytes: " << statistics.allocations[BlockAllocator::NumBins - 1];
+
+    const ExecutableAllocator::Statistics jit = engine->executableAllocator->statistics();
+    qDebug(stats) << "JIT code memory:" << jit.mappedBytes << "bytes in" << jit.chunkCount
+                  << "chunks," << jit.liveBytes << "bytes in use," << jit.wastedBytes << "bytes unused";
+
+    if (statistics.pauses.empty())
+        return;
+
+    std::vector<qint64> pauses = statistics.pauses;
+    std::sort(pauses.begin(), pauses.end());
+    const size_t p99Index = (pauses.size() * 99 + 99) / 100 - 1;
+    const qint64 budget = gcSliceBudget / 1000;
+    const qint64 p99 = pauses[p99Index] / 1000;
+    qDebug(stats) << "GC pauses:" << statistics.totalPauses << "(last" << pauses.size() << "recorded)";
+    if (incrementalGC)
+        qDebug(stats) << "Incremental GC cycles:" << statistics.incrementalCycles << ", slice budget:" << budget << "us";
+    if (generationalGC)
+        qDebug(stats) << "Minor GC cycles:" << statistics.minorCollections;
+    qDebug(stats) << "Median GC pause:" << pauses[pauses.size() / 2] / 1000 << "us";
+    qDebug(stats) << "99th percentile GC pause:" << p99 << "us"
+                  << (incrementalGC ? (p99 <= budget ? "(within budget)" : "(exceeds budget)") : "");
+    qDebug(stats) << "Max GC pause:" << pauses.back() / 1000 << "us";
 }
 
 void MemoryManager::collectFromJSStack(MarkStack *markStack) const
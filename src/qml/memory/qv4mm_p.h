@@ -21,15 +21,23 @@
 #include <private/qv4object_p.h>
 #include <private/qv4mmdefs_p.h>
 #include <QVector>
+#include <QElapsedTimer>
+#include <QHash>
+
+#include <array>
+#include <memory>
 
 #define MM_DEBUG 0
 
 QT_BEGIN_NAMESPACE
 
+class QThreadPool;
+
 namespace QV4 {
 
 struct ChunkAllocator;
 struct MemorySegment;
+struct IncrementalGCDriver;
 
 struct BlockAllocator {
     BlockAllocator(ChunkAllocator *chunkAllocator, ExecutionEngine *engine)
@@ -61,6 +69,12 @@ struct BlockAllocator {
     }
 
     void sweep();
+#if QT_CONFIG(thread)
+    // Sweeps the chunks on \a threadPool, with the calling thread taking part.
+    // The destructors of the dead objects run on the calling thread only. The time
+    // spent in them is added to \a destroyTime, if given.
+    void sweep(QThreadPool *threadPool, qint64 *destroyTime);
+#endif
     void freeAll();
     void resetBlackBits();
 
@@ -107,6 +121,7 @@ struct HugeItemAllocator {
 class Q_QML_EXPORT MemoryManager
 {
     Q_DISABLE_COPY(MemoryManager);
+    friend class HeapSnapshot;
 
 public:
     MemoryManager(ExecutionEngine *engine);
@@ -215,6 +230,18 @@ public:
 
     void runGC();
 
+    // Runs one slice of an ongoing incremental collection, if the previous
+    // slice is long enough ago. With \a force, the slice is run unconditionally.
+    void continueIncrementalGC(bool force = false);
+    bool isIncrementalGCEnabled() const { return incrementalGC; }
+    bool isIncrementalGCOngoing() const { return gcState == GCState::Marking; }
+    MarkStack *markStack() const { return m_markStack.get(); }
+
+    bool isGenerationalGCEnabled() const { return generationalGC; }
+    // Adds the old object \a base to the remembered set, so that the next minor
+    // collection scans it for references to young objects.
+    void remember(Heap::Base *base);
+
     void dumpStats() const;
 
     size_t getUsedMem() const;
@@ -246,11 +273,41 @@ private:
         MinUnmanagedHeapSizeGCLimit = 128 * 1024
     };
 
+    enum class GCState {
+        Idle,
+        Marking
+    };
+
     void collectFromJSStack(MarkStack *markStack) const;
     void mark();
     void sweep(bool lastSweep = false, ClassDestroyStatsCallback classCountPtr = nullptr);
     bool shouldRunGC() const;
     void collectRoots(MarkStack *markStack);
+    void triggerGC();
+    void runMinorGC();
+    bool shouldRunMajorGC() const;
+    size_t oldGenerationSize() const;
+    void clearRememberedSet();
+    void resetBlackBits();
+    void sweepChunks(BlockAllocator *allocator);
+    void startIncrementalGC();
+    bool runIncrementalMarkSlice();
+    void finishIncrementalGC();
+    void finishGCCycle();
+    void recordGCPause(qint64 nsecs);
+
+    void updateUnmanagedHeapSizeGCLimit()
+    {
+        if (3*unmanagedHeapSizeGCLimit <= 4 * unmanagedHeapSize) {
+            // more than 75% full, raise limit
+            unmanagedHeapSizeGCLimit = std::max(unmanagedHeapSizeGCLimit,
+                                                unmanagedHeapSize) * 2;
+        } else if (unmanagedHeapSize * 4 <= unmanagedHeapSizeGCLimit) {
+            // less than 25% full, lower limit
+            unmanagedHeapSizeGCLimit = qMax(std::size_t(MinUnmanagedHeapSizeGCLimit),
+                                            unmanagedHeapSizeGCLimit/2);
+        }
+    }
 
     HeapItem *allocate(BlockAllocator *allocator, std::size_t size)
     {
@@ -258,21 +315,18 @@ private:
         if (aggressiveGC) {
             runGC();
             didGCRun = true;
+        } else if (gcState == GCState::Marking) {
+            continueIncrementalGC();
+            didGCRun = true;
         }
 
         if (unmanagedHeapSize > unmanagedHeapSizeGCLimit) {
             if (!didGCRun)
-                runGC();
-
-            if (3*unmanagedHeapSizeGCLimit <= 4 * unmanagedHeapSize) {
-                // more than 75% full, raise limit
-                unmanagedHeapSizeGCLimit = std::max(unmanagedHeapSizeGCLimit,
-                                                    unmanagedHeapSize) * 2;
-            } else if (unmanagedHeapSize * 4 <= unmanagedHeapSizeGCLimit) {
-                // less than 25% full, lower limit
-                unmanagedHeapSizeGCLimit = qMax(std::size_t(MinUnmanagedHeapSizeGCLimit),
-                                                unmanagedHeapSizeGCLimit/2);
-            }
+                triggerGC();
+
+            // Only adjust the limit once we know how much the collection freed.
+            if (gcState == GCState::Idle)
+                updateUnmanagedHeapSizeGCLimit();
             didGCRun = true;
         }
 
@@ -283,7 +337,7 @@ private:
             return m;
 
         if (!didGCRun && shouldRunGC())
-            runGC();
+            triggerGC();
 
         return allocator->allocate(size, true);
     }
@@ -308,6 +362,38 @@ public:
     bool aggressiveGC = false;
     bool gcStats = false;
     bool gcCollectorStats = false;
+    bool incrementalGC = false;
+    bool generationalGC = false;
+
+    GCState gcState = GCState::Idle;
+    std::unique_ptr<MarkStack> m_markStack;
+    std::unique_ptr<IncrementalGCDriver> m_incrementalGCDriver;
+    qint64 gcSliceBudget; // in nanoseconds
+    QElapsedTimer lastGCSliceEnd;
+    size_t allocatedMemAtGCStart = 0;
+
+    // With generational collection, the black bits aren't reset after a collection.
+    // Black objects form the old generation, all others are young.
+    // The bitmaps deduplicate the remembered set. They are kept out of the chunks, so that
+    // the chunks don't lose capacity if generational collection is off.
+    using RememberedBitmap = std::array<quintptr, Chunk::EntriesInBitmap>;
+    std::vector<Heap::Base *> rememberedSet;
+    QHash<const Chunk *, RememberedBitmap> rememberedBitmaps;
+    std::size_t oldGenerationSizeAfterLastMajorGC = 0;
+
+#if QT_CONFIG(thread)
+    std::unique_ptr<QThreadPool> sweepThreadPool;
+#endif
+
+    // Durations of the phases of the last sweep, in microseconds. Only measured
+    // if gcCollectorStats is set.
+    struct {
+        qint64 weakReferences = 0;
+        qint64 identifiers = 0;
+        qint64 chunks = 0;
+        qint64 destroy = 0; // part of chunks, only measured separately when sweeping in parallel
+        qint64 hugeItems = 0;
+    } sweepTimes;
 
     int allocationCount = 0;
     size_t lastAllocRequestedSlots = 0;
@@ -317,6 +403,12 @@ public:
         size_t maxAllocatedMem = 0;
         size_t maxUsedMem = 0;
         uint allocations[BlockAllocator::NumBins];
+        // ring buffer of the most recent pauses caused by the GC, in nanoseconds
+        std::vector<qint64> pauses;
+        size_t nextPause = 0;
+        size_t totalPauses = 0;
+        size_t incrementalCycles = 0;
+        size_t minorCollections = 0;
     } statistics;
 };
 
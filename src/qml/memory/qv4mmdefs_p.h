@@ -17,8 +17,11 @@
 #include <private/qv4global_p.h>
 #include <private/qv4runtimeapi_p.h>
 #include <QtCore/qalgorithms.h>
+#include <QtCore/qdeadlinetimer.h>
 #include <QtCore/qmath.h>
 
+#include <vector>
+
 QT_BEGIN_NAMESPACE
 
 namespace QV4 {
@@ -34,7 +37,7 @@ typedef void(*ClassDestroyStatsCallback)(const char *);
  * is a simple masking operation. Each Chunk has 4 bitmaps for managing purposes,
  * and 32byte wide slots for the objects following afterwards.
  *
- * The gray and black bitmaps are used for mark/sweep.
+ * The black bitmap is used for mark/sweep.
  * The object bitmap has a bit set if this location represents the start of a Heap object.
  * The extends bitmap denotes the extend of an object. It has a cleared bit at the start of the object
  * and a set bit for all following slots used by the object.
@@ -152,6 +155,13 @@ struct Chunk {
     bool sweep(ClassDestroyStatsCallback classCountPtr);
     void resetBlackBits();
     bool sweep(ExecutionEngine *engine);
+
+    // The two halves of sweep(), for sweeping on other threads than the engine's:
+    // The objects returned by the first need to be destroyed on the engine's
+    // thread before the second can release their slots. Neither is reporting
+    // to the profiler.
+    void collectObjectsToDestroy(std::vector<Heap::Base *> *objects);
+    bool sweepDestroyed(size_t *freedSlots);
     void freeAll(ExecutionEngine *engine);
 
     void sortIntoBins(HeapItem **bins, uint nBins);
@@ -228,8 +238,12 @@ Q_STATIC_ASSERT(QT_POINTER_SIZE*8 == Chunk::Bits);
 Q_STATIC_ASSERT((1 << Chunk::BitShift) == Chunk::Bits);
 
 struct Q_QML_PRIVATE_EXPORT MarkStack {
-    MarkStack(ExecutionEngine *engine);
-    ~MarkStack() { drain(); }
+    // In Collect mode, pushed objects are only collected, not marked. They can be
+    // retrieved with takeCollected(). This is used to walk the heap one object at a time.
+    enum class Mode { Mark, Collect };
+
+    MarkStack(ExecutionEngine *engine, Mode mode = Mode::Mark);
+    ~MarkStack() { if (m_mode == Mode::Mark) drain(); }
 
     void push(Heap::Base *m) {
         *(m_top++) = m;
@@ -237,6 +251,11 @@ struct Q_QML_PRIVATE_EXPORT MarkStack {
         if (m_top < m_softLimit)
             return;
 
+        if (m_mode == Mode::Collect) {
+            spill();
+            return;
+        }
+
         // If at or above soft limit, partition the remaining space into at most 64 segments and
         // allow one C++ recursion of drain() per segment, plus one for the fence post.
         const quintptr segmentSize = qNextPowerOfTwo(quintptr(m_hardLimit - m_softLimit) / 64u);
@@ -252,9 +271,21 @@ struct Q_QML_PRIVATE_EXPORT MarkStack {
 
     ExecutionEngine *engine() const { return m_engine; }
 
+    enum class DrainState { Ongoing, Complete };
+
+    // Marks objects until the stack is empty or the deadline has expired.
+    DrainState drain(QDeadlineTimer deadline);
+    bool isEmpty() const { return m_top == m_base; }
+    // Drops all objects still waiting to be marked.
+    void discard() { m_top = m_base; }
+
+    // Appends the objects pushed since the last call to \a objects, in the order they were pushed.
+    void takeCollected(std::vector<Heap::Base *> *objects);
+
 private:
     Heap::Base *pop() { return *(--m_top); }
     void drain();
+    void spill();
 
     Heap::Base **m_top = nullptr;
     Heap::Base **m_base = nullptr;
@@ -262,6 +293,8 @@ private:
     Heap::Base **m_hardLimit = nullptr;
     ExecutionEngine *m_engine = nullptr;
     quintptr m_drainRecursion = 0;
+    std::vector<Heap::Base *> m_spilled;
+    Mode m_mode = Mode::Mark;
 };
 
 // Some helper to automate the generation of our
@@ -15,15 +15,11 @@
 //
 
 #include <private/qv4global_p.h>
+#include <private/qv4enginebase_p.h>
 
 QT_BEGIN_NAMESPACE
 
-#define WRITEBARRIER_none 1
-
-#define WRITEBARRIER(x) (1/WRITEBARRIER_##x == 1)
-
 namespace QV4 {
-struct EngineBase;
 
 namespace WriteBarrier {
 
@@ -41,28 +37,67 @@ enum NewValueType {
 // ### this needs to be filled with a real memory fence once marking is concurrent
 Q_ALWAYS_INLINE void fence() {}
 
-#if WRITEBARRIER(none)
-
+// The barrier is only needed while the memory manager is marking incrementally,
+// or if it collects generationally. In the first case the new value gets shaded,
+// so that a black object never points to a white one. In the second case old
+// objects that get a young object stored into them are remembered, so that minor
+// collections can find the young object without scanning the old generation.
+// Primitives never need either.
 template <NewValueType type>
 static constexpr inline bool isRequired() {
-    return false;
+    return type != Primitive;
 }
 
+Q_QML_PRIVATE_EXPORT void markValue(EngineBase *engine, ReturnedValue value);
+Q_QML_PRIVATE_EXPORT void markHeapObject(EngineBase *engine, Heap::Base *value);
+Q_QML_PRIVATE_EXPORT MarkStack *markStack(EngineBase *engine);
+Q_QML_PRIVATE_EXPORT void rememberValue(EngineBase *engine, Heap::Base *base, ReturnedValue value);
+Q_QML_PRIVATE_EXPORT void rememberHeapObject(EngineBase *engine, Heap::Base *base, Heap::Base *value);
+Q_QML_PRIVATE_EXPORT void remember(EngineBase *engine, Heap::Base *base);
+Q_QML_PRIVATE_EXPORT void tenure(EngineBase *engine, Heap::Base *value);
+
 inline void write(EngineBase *engine, Heap::Base *base, ReturnedValue *slot, ReturnedValue value)
 {
-    Q_UNUSED(engine);
-    Q_UNUSED(base);
+    if (Q_UNLIKELY(engine->isGCOngoing))
+        markValue(engine, value);
+    else if (Q_UNLIKELY(engine->isGenerationalGC))
+        rememberValue(engine, base, value);
     *slot = value;
 }
 
 inline void write(EngineBase *engine, Heap::Base *base, Heap::Base **slot, Heap::Base *value)
 {
-    Q_UNUSED(engine);
-    Q_UNUSED(base);
+    if (Q_UNLIKELY(engine->isGCOngoing) && value)
+        markHeapObject(engine, value);
+    else if (Q_UNLIKELY(engine->isGenerationalGC) && value)
+        rememberHeapObject(engine, base, value);
     *slot = value;
 }
 
-#endif
+// For stores into memory that isn't covered by write() above, for example
+// the malloc'ed storage of Map and Set, owned by \a base.  markFunction gets
+// passed the mark stack of the ongoing collection and is expected to mark the
+// new values. For generational collection, \a base gets remembered as a whole.
+template <typename MarkFunction>
+inline void markCustom(EngineBase *engine, Heap::Base *base, MarkFunction &&markFunction)
+{
+    if (Q_UNLIKELY(engine->isGCOngoing))
+        markFunction(markStack(engine));
+    else if (Q_UNLIKELY(engine->isGenerationalGC))
+        remember(engine, base);
+}
+
+// For heap objects that get stored into memory that isn't owned by any heap
+// object, but that is only marked through one, for example the member data
+// holding the keys of an internal class.  As the owner can't be remembered,
+// \a value itself is moved to the old generation and remembered.
+inline void writeExternal(EngineBase *engine, Heap::Base *value)
+{
+    if (Q_UNLIKELY(engine->isGCOngoing))
+        markHeapObject(engine, value);
+    else if (Q_UNLIKELY(engine->isGenerationalGC))
+        tenure(engine, value);
+}
 
 }
 
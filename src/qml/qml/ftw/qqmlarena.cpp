@@ -0,0 +1,116 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qqmlarena_p.h"
+
+#include <cstdlib>
+#include <new>
+
+QT_BEGIN_NAMESPACE
+
+/*!
+\class QQmlArena
+\brief The QQmlArena class provides memory for the bookkeeping objects of a QML component instance.
+\internal
+
+While QQmlObjectCreator creates an object tree, the bindings, bound signals, signal handler
+expressions and context data it creates are allocated from an arena, by bumping a pointer
+in chunks of memory, rather than with one heap allocation each. Classes opt into this with
+the Q_QML_ARENA_ALLOCATED macro, and are allocated from the arena of the innermost
+QQmlArena::Scope on the current thread, or from the heap if there is none.
+
+Deleting an object does not free its memory. Instead, each object holds a reference to its
+arena, like the creator does while it runs. When the last reference is gone, usually when the
+object tree is destroyed, all chunks are freed at once. Objects that outlive the tree keep
+the whole arena alive.
+*/
+
+namespace {
+
+// Precedes every allocation, with the arena it belongs to or nullptr if it is on the heap.
+struct alignas(alignof(std::max_align_t)) AllocationHeader
+{
+    QQmlArena *arena;
+};
+
+}
+
+struct alignas(alignof(std::max_align_t)) QQmlArena::Chunk
+{
+    Chunk *next;
+};
+
+static constexpr size_t minimumChunkSize = 2048;
+static constexpr size_t maximumChunkSize = 32768;
+
+Q_CONSTINIT static thread_local QQmlArena *currentArena = nullptr;
+
+QQmlArena::Scope::Scope(QQmlArena *arena)
+    : m_previous(currentArena)
+{
+    currentArena = arena;
+}
+
+QQmlArena::Scope::~Scope()
+{
+    currentArena = m_previous;
+}
+
+QQmlArena::~QQmlArena()
+{
+    while (Chunk *chunk = m_chunks) {
+        m_chunks = chunk->next;
+        free(chunk);
+    }
+}
+
+void *QQmlArena::allocateInChunk(size_t size)
+{
+    constexpr size_t alignment = alignof(std::max_align_t);
+    size = (size + alignment - 1) & ~(alignment - 1);
+
+    if (size_t(m_end - m_next) < size) {
+        m_chunkSize = qBound(minimumChunkSize, m_chunkSize * 2, maximumChunkSize);
+        const size_t dataSize = qMax(m_chunkSize, size);
+        Chunk *chunk = static_cast<Chunk *>(malloc(sizeof(Chunk) + dataSize));
+        if (!chunk)
+            qBadAlloc();
+        chunk->next = m_chunks;
+        m_chunks = chunk;
+        m_next = reinterpret_cast<char *>(chunk + 1);
+        m_end = m_next + dataSize;
+    }
+
+    void *result = m_next;
+    m_next += size;
+    return result;
+}
+
+void *QQmlArena::allocate(size_t size)
+{
+    QQmlArena *arena = currentArena;
+    AllocationHeader *header;
+    if (arena) {
+        header = static_cast<AllocationHeader *>(
+                arena->allocateInChunk(sizeof(AllocationHeader) + size));
+        arena->addref();
+    } else {
+        header = static_cast<AllocationHeader *>(::operator new(sizeof(AllocationHeader) + size));
+    }
+    header->arena = arena;
+    return header + 1;
+}
+
+void QQmlArena::deallocate(void *ptr)
+{
+    if (!ptr)
+        return;
+
+    AllocationHeader *header = static_cast<AllocationHeader *>(ptr) - 1;
+    if (QQmlArena *arena = header->arena)
+        arena->release();
+    else
+        ::operator delete(header);
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,74 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QQMLARENA_P_H
+#define QQMLARENA_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/qglobal.h>
+#include <QtCore/qatomic.h>
+#include <private/qtqmlglobal_p.h>
+
+#include <cstddef>
+
+QT_BEGIN_NAMESPACE
+
+class Q_QML_PRIVATE_EXPORT QQmlArena
+{
+    Q_DISABLE_COPY_MOVE(QQmlArena)
+public:
+    QQmlArena() = default;
+
+    void addref() const { m_refCount.ref(); }
+    void release() const
+    {
+        if (!m_refCount.deref())
+            delete this;
+    }
+
+    class Q_QML_PRIVATE_EXPORT Scope
+    {
+        Q_DISABLE_COPY_MOVE(Scope)
+    public:
+        Scope(QQmlArena *arena);
+        ~Scope();
+
+    private:
+        QQmlArena *m_previous;
+    };
+
+    static void *allocate(size_t size);
+    static void deallocate(void *ptr);
+
+private:
+    struct Chunk;
+
+    ~QQmlArena();
+    void *allocateInChunk(size_t size);
+
+    mutable QAtomicInt m_refCount = 1;
+    Chunk *m_chunks = nullptr;
+    char *m_next = nullptr;
+    char *m_end = nullptr;
+    size_t m_chunkSize = 0;
+};
+
+#define Q_QML_ARENA_ALLOCATED \
+public: \
+    static void *operator new(size_t size) { return QQmlArena::allocate(size); } \
+    static void operator delete(void *ptr) { QQmlArena::deallocate(ptr); } \
+private:
+
+QT_END_NAMESPACE
+
+#endif // QQMLARENA_P_H
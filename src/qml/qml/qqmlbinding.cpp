@@ -9,6 +9,7 @@
 #include <private/qqmldebugserviceinterfaces_p.h>
 #include <private/qqmldebugconnector_p.h>
 
+#include <private/qqmlbindingscheduler_p.h>
 #include <private/qqmlprofiler_p.h>
 #include <private/qqmlexpression_p.h>
 #include <private/qqmlscriptstring_p.h>
@@ -137,12 +138,7 @@ void QQmlBinding::update(QQmlPropertyData::WriteFlags flags)
 
     // Check for a binding update loop
     if (Q_UNLIKELY(updatingFlag())) {
-        const QQmlPropertyData *d = nullptr;
-        QQmlPropertyData vtd;
-        getPropertyData(&d, &vtd);
-        Q_ASSERT(d);
-        QQmlProperty p = QQmlPropertyPrivate::restore(targetObject(), *d, &vtd, nullptr);
-        QQmlAbstractBinding::printBindingLoopError(p);
+        reportBindingLoop();
         return;
     }
     setUpdatingFlag(true);
@@ -595,8 +591,24 @@ QVariant QQmlBinding::evaluate()
     return QV4::ExecutionEngine::toVariant(result, QMetaType::fromType<QList<QObject*> >());
 }
 
+void QQmlBinding::reportBindingLoop()
+{
+    const QQmlPropertyData *d = nullptr;
+    QQmlPropertyData vtd;
+    getPropertyData(&d, &vtd);
+    Q_ASSERT(d);
+    QQmlProperty p = QQmlPropertyPrivate::restore(targetObject(), *d, &vtd, nullptr);
+    QQmlAbstractBinding::printBindingLoopError(p);
+}
+
 void QQmlBinding::expressionChanged()
 {
+    if (QQmlEngine *qmlEngine = engine()) {
+        if (QQmlBindingScheduler *scheduler = QQmlEnginePrivate::get(qmlEngine)->bindingScheduler) {
+            scheduler->schedule(this);
+            return;
+        }
+    }
     update();
 }
 
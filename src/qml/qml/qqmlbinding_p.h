@@ -22,6 +22,7 @@
 #include <QtCore/QMetaProperty>
 
 #include <private/qqmlabstractbinding_p.h>
+#include <private/qqmlarena_p.h>
 #include <private/qqmljavascriptexpression_p.h>
 #include <private/qv4functionobject_p.h>
 #include <private/qqmltranslation_p.h>
@@ -32,7 +33,9 @@ class QQmlContext;
 class Q_QML_PRIVATE_EXPORT QQmlBinding : public QQmlJavaScriptExpression,
                                          public QQmlAbstractBinding
 {
+    Q_QML_ARENA_ALLOCATED
     friend class QQmlAbstractBinding;
+    friend class QQmlBindingScheduler;
 public:
     typedef QExplicitlySharedDataPointer<QQmlBinding> Ptr;
 
@@ -127,7 +130,9 @@ private:
 
     QQmlSourceLocation *m_sourceLocation = nullptr; // used for Qt.binding() created functions
     QV4::PersistentValue m_boundFunction; // used for Qt.binding() that are created from a bound function object
+    quint32 m_scheduledDepth = 0; // depth in the dependency graph, as learned by QQmlBindingScheduler
     void handleWriteError(const void *result, QMetaType resultType, QMetaType metaType);
+    void reportBindingLoop();
 };
 
 QT_END_NAMESPACE
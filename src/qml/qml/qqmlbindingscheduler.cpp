@@ -0,0 +1,128 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qqmlbindingscheduler_p.h"
+
+#include <private/qqmlengine_p.h>
+
+#include <QtCore/qloggingcategory.h>
+#include <QtCore/qscopedvaluerollback.h>
+
+#include <algorithm>
+#include <limits>
+
+QT_BEGIN_NAMESPACE
+
+Q_LOGGING_CATEGORY(lcBindingScheduler, "qt.qml.binding.scheduler")
+
+static thread_local QList<QQmlBindingScheduler *> threadSchedulers;
+
+QQmlBindingScheduler::QQmlBindingScheduler(QQmlEngine *engine)
+    : m_engine(engine)
+{
+    threadSchedulers.append(this);
+}
+
+QQmlBindingScheduler::~QQmlBindingScheduler()
+{
+    threadSchedulers.removeOne(this);
+
+    qCDebug(lcBindingScheduler).nospace()
+            << "Binding notifications: " << m_statistics.notifications
+            << ", evaluations: " << m_statistics.evaluations
+            << ", evaluations saved: " << m_statistics.evaluationsSaved();
+}
+
+// Orders the heap so that the shallowest binding scheduled first is on top.
+bool QQmlBindingScheduler::isLater(const Entry &a, const Entry &b)
+{
+    return a.depth != b.depth ? a.depth > b.depth : a.sequence > b.sequence;
+}
+
+void QQmlBindingScheduler::schedule(QQmlBinding *binding)
+{
+    ++m_statistics.notifications;
+
+    // A binding triggered by another one is deeper in the dependency graph.
+    quint32 depth = binding->m_scheduledDepth;
+    quint32 chainLength = 0;
+    if (m_current) {
+        if (m_current->m_scheduledDepth < std::numeric_limits<quint32>::max())
+            depth = qMax(depth, m_current->m_scheduledDepth + 1);
+        chainLength = m_currentChainLength + 1;
+    }
+
+    auto it = m_pending.find(binding);
+    if (it != m_pending.end()) {
+        it->chainLength = qMax(it->chainLength, chainLength);
+        if (depth <= it->depth)
+            return;
+        // The entry already in the queue is skipped when it comes up.
+        it->depth = depth;
+    } else {
+        m_pending.insert(binding, { depth, chainLength });
+    }
+
+    binding->m_scheduledDepth = depth;
+    m_queue.push_back({ depth, m_sequence++, QQmlBinding::Ptr(binding) });
+    std::push_heap(m_queue.begin(), m_queue.end(), isLater);
+
+    if (!m_flushPosted && !m_flushing) {
+        m_flushPosted = true;
+        QMetaObject::invokeMethod(m_engine, [engine = m_engine]() {
+            if (QQmlBindingScheduler *scheduler = QQmlEnginePrivate::get(engine)->bindingScheduler)
+                scheduler->flush();
+        }, Qt::QueuedConnection);
+    }
+}
+
+void QQmlBindingScheduler::flush()
+{
+    m_flushPosted = false;
+    if (m_flushing || m_queue.empty())
+        return;
+
+    QScopedValueRollback<bool> flushing(m_flushing, true);
+
+    while (!m_queue.empty()) {
+        std::pop_heap(m_queue.begin(), m_queue.end(), isLater);
+        const Entry entry = std::move(m_queue.back());
+        m_queue.pop_back();
+
+        QQmlBinding *binding = entry.binding.data();
+        const auto it = m_pending.constFind(binding);
+        if (it == m_pending.constEnd() || it->depth != entry.depth)
+            continue;
+        const quint32 chainLength = it->chainLength;
+        m_pending.erase(it);
+
+        if (!binding->isAddedToObject())
+            continue;
+
+        // Without a loop, a binding cannot be triggered through more bindings than there are.
+        if (chainLength > quint32(m_evaluated.size() + m_pending.size())) {
+            binding->reportBindingLoop();
+            continue;
+        }
+
+        m_evaluated.insert(binding);
+        m_current = binding;
+        m_currentChainLength = chainLength;
+        ++m_statistics.evaluations;
+        binding->update();
+        m_current = nullptr;
+    }
+
+    m_evaluated.clear();
+}
+
+void QQmlBindingScheduler::flushAll()
+{
+    const QList<QQmlBindingScheduler *> schedulers = threadSchedulers;
+    for (QQmlBindingScheduler *scheduler : schedulers) {
+        if (threadSchedulers.contains(scheduler))
+            scheduler->flush();
+    }
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,91 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QQMLBINDINGSCHEDULER_P_H
+#define QQMLBINDINGSCHEDULER_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <private/qqmlbinding_p.h>
+
+#include <QtCore/qhash.h>
+#include <QtCore/qset.h>
+
+#include <vector>
+
+QT_BEGIN_NAMESPACE
+
+class QQmlEngine;
+
+// Collects the bindings of an engine whose dependencies have changed, instead of re-evaluating
+// each of them right away, and evaluates each of them once when flushed. A binding depending on
+// several properties that change together, as in diamond shaped dependency graphs, is then only
+// evaluated once, after all its dependencies. The scheduler learns the depth of each binding in
+// the dependency graph from which bindings trigger which, and evaluates them in that order.
+// Pending bindings are flushed from the event loop, and by QQuickWindow before it synchronizes
+// the scene graph.
+class Q_QML_PRIVATE_EXPORT QQmlBindingScheduler
+{
+    Q_DISABLE_COPY_MOVE(QQmlBindingScheduler)
+public:
+    struct Statistics
+    {
+        quint64 notifications = 0; // Bindings whose dependencies changed
+        quint64 evaluations = 0; // Bindings evaluated when flushing
+
+        // The evaluations that would have happened without batching, but did not
+        quint64 evaluationsSaved() const { return notifications - evaluations; }
+    };
+
+    explicit QQmlBindingScheduler(QQmlEngine *engine);
+    ~QQmlBindingScheduler();
+
+    void schedule(QQmlBinding *binding);
+    void flush();
+    bool hasPendingBindings() const { return !m_pending.isEmpty(); }
+
+    const Statistics &statistics() const { return m_statistics; }
+
+    // Flushes the schedulers of all engines living in the current thread.
+    static void flushAll();
+
+private:
+    struct Entry
+    {
+        quint32 depth;
+        quint64 sequence;
+        QQmlBinding::Ptr binding;
+    };
+
+    struct Pending
+    {
+        quint32 depth;
+        quint32 chainLength;
+    };
+
+    static bool isLater(const Entry &a, const Entry &b);
+
+    QQmlEngine *m_engine;
+    std::vector<Entry> m_queue; // A heap, ordered by depth and sequence
+    QHash<const QQmlBinding *, Pending> m_pending;
+    QSet<const QQmlBinding *> m_evaluated; // During a flush
+    QQmlBinding *m_current = nullptr;
+    quint32 m_currentChainLength = 0;
+    quint64 m_sequence = 0;
+    bool m_flushPosted = false;
+    bool m_flushing = false;
+    Statistics m_statistics;
+};
+
+QT_END_NAMESPACE
+
+#endif // QQMLBINDINGSCHEDULER_P_H
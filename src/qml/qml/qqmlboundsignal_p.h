@@ -17,6 +17,7 @@
 
 #include <QtCore/qmetaobject.h>
 
+#include <private/qqmlarena_p.h>
 #include <private/qqmljavascriptexpression_p.h>
 #include <private/qqmlnotifier_p.h>
 #include <private/qqmlrefcount_p.h>
@@ -26,6 +27,7 @@ QT_BEGIN_NAMESPACE
 
 class Q_QML_PRIVATE_EXPORT QQmlBoundSignalExpression : public QQmlJavaScriptExpression, public QQmlRefCount
 {
+    Q_QML_ARENA_ALLOCATED
 public:
     QQmlBoundSignalExpression(
             const QObject *target, int index, const QQmlRefPointer<QQmlContextData> &ctxt, QObject *scope,
@@ -61,6 +63,7 @@ private:
 
 class Q_QML_PRIVATE_EXPORT QQmlBoundSignal : public QQmlNotifierEndpoint
 {
+    Q_QML_ARENA_ALLOCATED
 public:
     QQmlBoundSignal(QObject *target, int signal, QObject *owner, QQmlEngine *engine);
     ~QQmlBoundSignal();
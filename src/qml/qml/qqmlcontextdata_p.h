@@ -16,6 +16,7 @@
 //
 
 #include <QtQml/private/qtqmlglobal_p.h>
+#include <QtQml/private/qqmlarena_p.h>
 #include <QtQml/private/qqmlcontext_p.h>
 #include <QtQml/private/qqmlguard_p.h>
 #include <QtQml/private/qqmltypenamecache_p.h>
@@ -32,6 +33,7 @@ class QQmlIncubatorPrivate;
 
 class Q_QML_PRIVATE_EXPORT QQmlContextData
 {
+    Q_QML_ARENA_ALLOCATED
 public:
     static QQmlRefPointer<QQmlContextData> createRefCounted(
             const QQmlRefPointer<QQmlContextData> &parent)
@@ -32,9 +32,12 @@
 #include <QtCore/qfileinfo.h>
 #include <QtCore/qurl.h>
 
+#include <memory>
+
 QT_BEGIN_NAMESPACE
 
 class QQmlTypeLoader;
+class QQmlPreparedSource;
 class Q_QML_PRIVATE_EXPORT QQmlDataBlob : public QQmlRefCount
 {
 public:
@@ -92,11 +95,15 @@ public:
             return hasInlineSourceCode || !fileInfo.filePath().isEmpty();
         }
 
+        // Set if the file has already been read and parsed on a worker thread of the loader.
+        QQmlPreparedSource *preparedSource() const { return prepared.get(); }
+
     private:
         friend class QQmlDataBlob;
         friend class QQmlTypeLoader;
         QString inlineSourceCode;
         QFileInfo fileInfo;
+        std::shared_ptr<QQmlPreparedSource> prepared;
         bool hasInlineSourceCode = false;
     };
 
@@ -14,6 +14,7 @@
 #include "qqmlabstracturlinterceptor.h"
 
 #include <private/qqmldirparser_p.h>
+#include <private/qqmlbindingscheduler_p.h>
 #include <private/qqmlboundsignal_p.h>
 #include <private/qqmljsdiagnosticmessage_p.h>
 #include <private/qqmltype_p_p.h>
@@ -476,6 +477,23 @@ void QQmlEnginePrivate::init()
     q->handle()->setQmlEngine(q);
 
     rootContext = new QQmlContext(q,true);
+
+    if (qEnvironmentVariableIsSet("QML_BATCHED_BINDING_UPDATES"))
+        setBatchedBindingUpdates(true);
+}
+
+void QQmlEnginePrivate::setBatchedBindingUpdates(bool batched)
+{
+    if (batched == (bindingScheduler != nullptr))
+        return;
+
+    if (batched) {
+        bindingScheduler = new QQmlBindingScheduler(q_func());
+    } else {
+        // Evaluate the pending bindings before falling back to immediate updates.
+        bindingScheduler->flush();
+        delete std::exchange(bindingScheduler, nullptr);
+    }
 }
 
 /*!
@@ -555,6 +573,9 @@ QQmlEngine::~QQmlEngine()
     // XXX TODO: performance -- store list of singleton types separately?
     d->singletonInstances.clear();
 
+    // Bindings triggered from now on are evaluated right away.
+    delete std::exchange(d->bindingScheduler, nullptr);
+
     delete d->rootContext;
     d->rootContext = nullptr;
 
@@ -49,6 +49,7 @@
 QT_BEGIN_NAMESPACE
 
 class QNetworkAccessManager;
+class QQmlBindingScheduler;
 class QQmlDelayedError;
 class QQmlIncubator;
 class QQmlMetaObject;
@@ -129,6 +130,10 @@ public:
     QQmlDelayedError *erroredBindings = nullptr;
     int inProgressCreations = 0;
 
+    // Set if bindings are re-evaluated in batches rather than immediately
+    QQmlBindingScheduler *bindingScheduler = nullptr;
+    void setBatchedBindingUpdates(bool batched);
+
     QV4::ExecutionEngine *v4engine() const { return q_func()->handle(); }
 
 #if QT_CONFIG(qml_worker_script)
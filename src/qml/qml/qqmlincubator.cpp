@@ -57,6 +57,8 @@ void QQmlEnginePrivate::incubate(
         incubatorCount++;
 
         p->vmeGuard.guard(p->creator.data());
+        if (mode == QQmlIncubator::AsynchronousParallel && p->creator)
+            p->creator->prebuildObjects(p->subComponentToCreate);
         p->changeStatus(QQmlIncubator::Loading);
 
         if (incubationController)
@@ -477,7 +479,7 @@ incubating objects should be processed.  If an incubation controller is not set
 QQmlEngine, QQmlIncubator creates objects synchronously regardless of the
 specified IncubationMode.
 
-QQmlIncubator supports three incubation modes:
+QQmlIncubator supports four incubation modes:
 \list
 \li Synchronous The creation occurs synchronously.  That is, once the
 QQmlComponent::create() call returns, the incubator will already be in either the
@@ -525,7 +527,40 @@ items like ListView have already completed loading their initial delegates.
 It is almost always incorrect to use the Synchronous incubation mode - elements or components that
 want the appearance of synchronous instantiation, but without the downsides of introducing freezes
 or stutters into the application, should use the AsynchronousIfNested incubation mode.
+
+\li AsynchronousParallel The creation occurs asynchronously, like with the Asynchronous mode, but
+part of the work is moved off the thread of the engine, as described below.
 \endlist
+
+\section1 Constructing objects on a worker thread
+
+With the AsynchronousParallel mode, the objects of C++ types that opt in are constructed on a
+worker thread as soon as the incubation is started, while the engine is still busy with other
+work. A type opts in by declaring the class info \c{QML.ThreadSafeConstruction}:
+
+\code
+class Gauge : public QObject
+{
+    Q_OBJECT
+    QML_ELEMENT
+    Q_CLASSINFO("QML.ThreadSafeConstruction", "true")
+    Q_PROPERTY(double value READ value WRITE setValue NOTIFY valueChanged)
+    ...
+};
+\endcode
+
+By declaring it, the class promises that its constructor and the setters of its \c bool, \c int,
+\c float, \c double and \c QString properties can run on any thread, as long as no other
+thread uses the object at the same time. In particular, they must not access the engine, other
+objects, or anything else that is not thread-safe. The class info is not inherited.
+
+The worker also sets the properties that are initialized with plain literals of these types,
+such as \c{value: 42}, unless the type implements QQmlParserStatus or the object declares
+properties, signals or functions of its own in QML. The objects are then moved to the thread of
+the engine. Everything else, from bindings and signal handlers to the
+\l{Component::completed()}{completed} signal, is still done on the thread of the engine, in the
+same order as with the Asynchronous mode. If the engine gets to an object before the worker is
+done, it waits for the worker.
 */
 
 /*!
@@ -561,6 +596,11 @@ of an asynchronous creation, this incubator will join that existing incubation a
 asynchronously.  The existing incubation will not become Ready until both it and this
 incubation have completed.  Otherwise, the incubation will execute synchronously.
 \value Synchronous The object will be created synchronously.
+\value [since 6.6] AsynchronousParallel The object will be created asynchronously, like with
+Asynchronous. Additionally, while the incubation waits to be processed, objects of C++ types that
+declare \c{Q_CLASSINFO("QML.ThreadSafeConstruction", "true")} are constructed on a worker
+thread, and the boolean, number and string literals assigned to their properties are set there.
+See \l{Constructing objects on a worker thread}.
 */
 
 /*!
@@ -23,7 +23,8 @@ public:
     enum IncubationMode {
         Asynchronous,
         AsynchronousIfNested,
-        Synchronous
+        Synchronous,
+        AsynchronousParallel
     };
     enum Status {
         Null,
@@ -9,6 +9,7 @@
 #include <private/qv4functionobject_p.h>
 #include <private/qv4qobjectwrapper_p.h>
 #include <private/qqmlbinding_p.h>
+#include <private/qqmlbindingscheduler_p.h>
 #include <private/qqmlstringconverters_p.h>
 #include <private/qqmlboundsignal_p.h>
 #include <private/qqmlcomponentattached_p.h>
@@ -60,6 +61,7 @@ QQmlObjectCreator::QQmlObjectCreator(
     sharedState->allJavaScriptObjects = nullptr;
     sharedState->creationContext = creationContext;
     sharedState->rootContext.reset();
+    sharedState->arena.adopt(new QQmlArena);
     sharedState->hadTopLevelRequiredProperties = false;
 
     if (auto profiler = QQmlEnginePrivate::get(engine)->profiler) {
@@ -120,7 +122,32 @@ QQmlObjectCreator::~QQmlObjectCreator()
             QQmlComponentAttached *a = sharedState->componentAttached;
             a->removeFromList();
         }
+        if (sharedState->prebuiltObjects) {
+            sharedState->prebuiltObjects->discard();
+            sharedState->prebuiltObjects.reset();
+        }
+    }
+}
+
+/*!
+    \internal
+    Starts constructing the objects create() will create for \a subComponentIndex on a worker
+    thread, as far as their types allow. See QQmlPrebuiltObjects.
+*/
+void QQmlObjectCreator::prebuildObjects(int subComponentIndex)
+{
+    Q_ASSERT(topLevelCreator && phase == Startup);
+
+    int objectToCreate = /*root object*/0;
+    if (subComponentIndex != -1) {
+        const QV4::CompiledData::Object *compObj = compilationUnit->objectAt(subComponentIndex);
+        if (!compObj->hasFlag(QV4::CompiledData::Object::IsComponent))
+            return;
+        objectToCreate = compObj->bindingTable()->value.objectIndex;
     }
+
+    sharedState->prebuiltObjects = QQmlPrebuiltObjects::start(
+            compilationUnit, objectToCreate, engine->thread());
 }
 
 QObject *QQmlObjectCreator::create(int subComponentIndex, QObject *parent, QQmlInstantiationInterrupt *interrupt, int flags)
@@ -132,6 +159,8 @@ QObject *QQmlObjectCreator::create(int subComponentIndex, QObject *parent, QQmlI
     Q_ASSERT(phase == Startup);
     phase = CreatingObjects;
 
+    QQmlArena::Scope arenaScope(sharedState->arena.data());
+
     int objectToCreate;
     bool isComponentRoot = false; // either a "real" component of or an inline component
 
@@ -190,8 +219,13 @@ QObject *QQmlObjectCreator::create(int subComponentIndex, QObject *parent, QQmlI
         ddata->compilationUnit = compilationUnit;
     }
 
-    if (topLevelCreator)
+    if (topLevelCreator) {
         sharedState->allJavaScriptObjects = nullptr;
+        if (sharedState->prebuiltObjects) {
+            sharedState->prebuiltObjects->discard();
+            sharedState->prebuiltObjects.reset();
+        }
+    }
 
     phase = CreatingObjectsPhase2;
 
@@ -634,6 +668,11 @@ void QQmlObjectCreator::setupBindings(BindingSetupFlags mode)
 
     const QV4::BindingPropertyData &propertyData = compilationUnit->bindingPropertyDataPerObject.at(_compiledObjectIndex);
 
+    // The literals that were already assigned when the object was built on a worker thread
+    const QBitArray *prebuiltBindings = sharedState->prebuiltObjects && !_valueTypeProperty
+            ? sharedState->prebuiltObjects->assignedBindings(_qobject, _compiledObject)
+            : nullptr;
+
     if (_compiledObject->idNameIndex) {
         const QQmlPropertyData *idProperty = propertyData.last();
         Q_ASSERT(!idProperty || !idProperty->isValid() || idProperty->name(_qobject) == QLatin1String("id"));
@@ -748,6 +787,9 @@ void QQmlObjectCreator::setupBindings(BindingSetupFlags mode)
             currentListPropertyIndex = -1;
         }
 
+        if (prebuiltBindings && prebuiltBindings->testBit(i))
+            continue;
+
         if (!setPropertyBinding(property, binding))
             return;
     }
@@ -1222,7 +1264,10 @@ QObject *QQmlObjectCreator::createInstance(int index, QObject *parent, bool isCo
         if (type.isValid() && !type.isInlineComponentType()) {
             typeName = type.qmlTypeName();
 
-            instance = type.createWithQQmlData();
+            if (sharedState->prebuiltObjects)
+                instance = sharedState->prebuiltObjects->take(compilationUnit.data(), index);
+            if (!instance)
+                instance = type.createWithQQmlData();
             if (!instance) {
                 recordError(obj->location, tr("Unable to create object of type %1").arg(stringAt(obj->inheritedTypeNameIndex)));
                 return nullptr;
@@ -1461,6 +1506,13 @@ bool QQmlObjectCreator::finalize(QQmlInstantiationInterrupt &interrupt)
             return false;
     }
 
+    // Bindings re-evaluated in batches have to settle before the objects are completed.
+    if (QQmlBindingScheduler *scheduler = QQmlEnginePrivate::get(engine)->bindingScheduler) {
+        scheduler->flush();
+        if (watcher.hasRecursed())
+            return false;
+    }
+
     if (QQmlVME::componentCompleteEnabled()) { // the qml designer does the component complete later
         while (!sharedState->allParserStatusCallbacks.isEmpty()) {
             QQmlObjectCompletionProfiler profiler(&sharedState->profiler);
@@ -24,6 +24,8 @@
 #include <private/qqmlguardedcontextdata_p.h>
 #include <private/qqmlfinalizer_p.h>
 #include <private/qqmlvmemetaobject_p.h>
+#include <private/qqmlarena_p.h>
+#include <private/qqmlprebuiltobjects_p.h>
 
 #include <qpointer.h>
 
@@ -98,6 +100,8 @@ struct QQmlObjectCreatorSharedState : QQmlRefCount
     QRecursionNode recursionNode;
     RequiredProperties requiredProperties;
     QList<DeferredQPropertyBinding> allQPropertyBindings;
+    QQmlRefPointer<QQmlArena> arena;
+    QQmlRefPointer<QQmlPrebuiltObjects> prebuiltObjects;
     bool hadTopLevelRequiredProperties;
 };
 
@@ -114,6 +118,7 @@ public:
     enum CreationFlags { NormalObject = 1, InlineComponent = 2 };
     QObject *create(int subComponentIndex = -1, QObject *parent = nullptr,
                     QQmlInstantiationInterrupt *interrupt = nullptr, int flags = NormalObject);
+    void prebuildObjects(int subComponentIndex = -1);
 
     bool populateDeferredProperties(QObject *instance, const QQmlData::DeferredData *deferredData);
 
@@ -230,6 +235,8 @@ private:
     template<typename Functor>
     void doPopulateDeferred(QObject *instance, int deferredIndex, Functor f)
     {
+        QQmlArena::Scope arenaScope(sharedState->arena.data());
+
         QQmlData *declarativeData = QQmlData::get(instance);
         QObject *bindingTarget = instance;
 
@@ -0,0 +1,243 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qqmlprebuiltobjects_p.h"
+
+#include <private/qqmlpropertydata_p.h>
+#include <private/qv4resolvedtypereference_p.h>
+
+#include <QtCore/qthread.h>
+#include <QtCore/qthreadpool.h>
+
+#include <utility>
+
+QT_BEGIN_NAMESPACE
+
+// Only the class that declares it is opted in, not the classes derived from it.
+static bool hasThreadSafeConstruction(const QMetaObject *metaObject)
+{
+    const int index = metaObject->indexOfClassInfo("QML.ThreadSafeConstruction");
+    return index >= metaObject->classInfoOffset()
+            && qstrcmp(metaObject->classInfo(index).value(), "true") == 0;
+}
+
+QQmlPrebuiltObjects::QQmlPrebuiltObjects(
+        const QQmlRefPointer<QV4::ExecutableCompilationUnit> &compilationUnit,
+        QThread *targetThread)
+    : m_compilationUnit(compilationUnit), m_targetThread(targetThread)
+{
+}
+
+QQmlRefPointer<QQmlPrebuiltObjects> QQmlPrebuiltObjects::start(
+        const QQmlRefPointer<QV4::ExecutableCompilationUnit> &compilationUnit,
+        int objectIndex, QThread *targetThread)
+{
+    QQmlRefPointer<QQmlPrebuiltObjects> prebuilt(
+            new QQmlPrebuiltObjects(compilationUnit, targetThread),
+            QQmlRefPointer<QQmlPrebuiltObjects>::Adopt);
+    prebuilt->collect(objectIndex, /*isInstance*/true);
+    if (prebuilt->m_entries.empty())
+        return {};
+
+    QThreadPool::globalInstance()->start([prebuilt]() {
+        prebuilt->run();
+    });
+    return prebuilt;
+}
+
+// Follows the same bindings as QQmlObjectCreator does when creating the object tree, but stops
+// at components and deferred properties, whose objects are created later, if ever.
+void QQmlPrebuiltObjects::collect(int objectIndex, bool isInstance)
+{
+    const QV4::CompiledData::Object *object = m_compilationUnit->objectAt(objectIndex);
+    if (object->hasFlag(QV4::CompiledData::Object::IsComponent))
+        return;
+
+    if (isInstance)
+        addEntry(objectIndex, object);
+
+    const QV4::CompiledData::Binding *binding = object->bindingTable();
+    for (quint32 i = 0; i < object->nBindings; ++i, ++binding) {
+        if (binding->hasFlag(QV4::CompiledData::Binding::IsDeferredBinding)
+                || binding->hasFlag(QV4::CompiledData::Binding::IsCustomParserBinding)
+                || binding->hasFlag(QV4::CompiledData::Binding::IsSignalHandlerObject)) {
+            continue;
+        }
+
+        switch (binding->type()) {
+        case QV4::CompiledData::Binding::Type_Object:
+            collect(binding->value.objectIndex, /*isInstance*/true);
+            break;
+        case QV4::CompiledData::Binding::Type_AttachedProperty:
+        case QV4::CompiledData::Binding::Type_GroupProperty:
+            collect(binding->value.objectIndex, /*isInstance*/false);
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+void QQmlPrebuiltObjects::addEntry(int objectIndex, const QV4::CompiledData::Object *object)
+{
+    const QV4::ResolvedTypeReference *typeRef
+            = m_compilationUnit->resolvedType(object->inheritedTypeNameIndex);
+    if (!typeRef)
+        return;
+
+    const QQmlType type = typeRef->type();
+    if (!type.isValid() || type.isComposite() || type.isInlineComponentType()
+            || type.isExtendedType() || type.customParser()) {
+        return;
+    }
+
+    const QMetaObject *metaObject = type.metaObject();
+    if (!metaObject || !hasThreadSafeConstruction(metaObject))
+        return;
+
+    Entry entry;
+    entry.object = object;
+    entry.type = type;
+    entry.assignedBindings.resize(object->nBindings);
+
+    // QQmlParserStatus::classBegin() has to be called before any property is set, and a
+    // QQmlVMEMetaObject may intercept the writes. Both are only available on the engine thread.
+    const bool canAssignLiterals = type.parserStatusCast() == -1
+            && !m_compilationUnit->propertyCaches.needsVMEMetaObject(objectIndex)
+            && objectIndex < m_compilationUnit->bindingPropertyDataPerObject.size();
+    const QV4::BindingPropertyData *propertyData = canAssignLiterals
+            ? &m_compilationUnit->bindingPropertyDataPerObject.at(objectIndex)
+            : nullptr;
+
+    const QV4::CompiledData::Binding *binding = object->bindingTable();
+    for (quint32 i = 0; propertyData && i < object->nBindings; ++i, ++binding) {
+        if (binding->flags() || qsizetype(i) >= propertyData->size())
+            continue;
+
+        const QQmlPropertyData *property = propertyData->at(i);
+        if (!property || !property->isWritable() || property->isAlias() || property->isEnum()
+                || property->coreIndex() >= metaObject->propertyCount()) {
+            continue;
+        }
+
+        QVariant value;
+        const QV4::CompiledData::Binding::Type bindingType = binding->type();
+        switch (property->propType().id()) {
+        case QMetaType::Bool:
+            if (bindingType == QV4::CompiledData::Binding::Type_Boolean)
+                value = binding->valueAsBoolean();
+            break;
+        case QMetaType::Int:
+            if (bindingType == QV4::CompiledData::Binding::Type_Number)
+                value = int(m_compilationUnit->bindingValueAsNumber(binding));
+            break;
+        case QMetaType::Float:
+            if (bindingType == QV4::CompiledData::Binding::Type_Number)
+                value = float(m_compilationUnit->bindingValueAsNumber(binding));
+            break;
+        case QMetaType::Double:
+            if (bindingType == QV4::CompiledData::Binding::Type_Number)
+                value = m_compilationUnit->bindingValueAsNumber(binding);
+            break;
+        case QMetaType::QString:
+            if (bindingType == QV4::CompiledData::Binding::Type_String)
+                value = m_compilationUnit->bindingValueAsString(binding);
+            break;
+        default:
+            break;
+        }
+
+        if (!value.isValid())
+            continue;
+
+        entry.literals.push_back({ property, std::move(value) });
+        entry.assignedBindings.setBit(i);
+    }
+
+    m_entryForObject.insert(objectIndex, qsizetype(m_entries.size()));
+    m_entries.push_back(std::move(entry));
+}
+
+// Builds the objects on the calling thread, unless another thread has already started to.
+bool QQmlPrebuiltObjects::run()
+{
+    if (m_started.exchange(true))
+        return false;
+
+    const QQmlPropertyData::WriteFlags writeFlags = QQmlPropertyData::BypassInterceptor
+            | QQmlPropertyData::RemoveBindingOnAliasWrite;
+
+    for (Entry &entry : m_entries) {
+        QObject *instance = entry.type.createWithQQmlData();
+        if (!instance)
+            continue;
+
+        for (const Literal &literal : entry.literals)
+            literal.property->writeProperty(instance, const_cast<void *>(literal.value.constData()),
+                                            writeFlags);
+
+        if (instance->thread() != m_targetThread)
+            instance->moveToThread(m_targetThread);
+        entry.instance = instance;
+    }
+
+    m_finished.release();
+    return true;
+}
+
+void QQmlPrebuiltObjects::waitForFinished()
+{
+    if (m_waited)
+        return;
+    if (!run())
+        m_finished.acquire();
+    m_waited = true;
+}
+
+QObject *QQmlPrebuiltObjects::take(const QV4::ExecutableCompilationUnit *compilationUnit,
+                                   int objectIndex)
+{
+    if (compilationUnit != m_compilationUnit.data())
+        return nullptr;
+
+    const auto it = m_entryForObject.constFind(objectIndex);
+    if (it == m_entryForObject.constEnd())
+        return nullptr;
+
+    waitForFinished();
+
+    Entry &entry = m_entries[*it];
+    QObject *instance = std::exchange(entry.instance, nullptr);
+    if (instance)
+        m_entryForInstance.insert(instance, *it);
+    return instance;
+}
+
+const QBitArray *QQmlPrebuiltObjects::assignedBindings(
+        const QObject *instance, const QV4::CompiledData::Object *object) const
+{
+    const auto it = m_entryForInstance.constFind(instance);
+    if (it == m_entryForInstance.constEnd())
+        return nullptr;
+
+    const Entry &entry = m_entries[*it];
+    return entry.object == object ? &entry.assignedBindings : nullptr;
+}
+
+void QQmlPrebuiltObjects::discard()
+{
+    // Claim the work if no worker has started on it yet, so that it's skipped. Otherwise the
+    // worker is still using the compilation unit, and has to finish first.
+    if (!m_waited && m_started.exchange(true))
+        m_finished.acquire();
+    m_waited = true;
+
+    for (Entry &entry : m_entries)
+        delete std::exchange(entry.instance, nullptr);
+    m_entries.clear();
+    m_entryForObject.clear();
+    m_entryForInstance.clear();
+    m_compilationUnit.reset();
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,105 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QQMLPREBUILTOBJECTS_P_H
+#define QQMLPREBUILTOBJECTS_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <private/qqmlrefcount_p.h>
+#include <private/qqmltype_p.h>
+#include <private/qv4executablecompilationunit_p.h>
+
+#include <QtCore/qbitarray.h>
+#include <QtCore/qhash.h>
+#include <QtCore/qsemaphore.h>
+#include <QtCore/qvariant.h>
+
+#include <atomic>
+#include <vector>
+
+QT_BEGIN_NAMESPACE
+
+class QQmlPropertyData;
+class QThread;
+
+// The objects of a component that are constructed on a worker thread while an incubation with
+// QQmlIncubator::AsynchronousParallel waits for its turn on the engine thread. Only instances of
+// C++ types that declare Q_CLASSINFO("QML.ThreadSafeConstruction", "true") are built this way,
+// together with the plain bool, number and string literals assigned to their properties. The
+// worker never touches the engine or the context. QQmlObjectCreator picks the objects up when it
+// gets to them, and sets up everything else on the engine thread as usual.
+class QQmlPrebuiltObjects final : public QQmlRefCount
+{
+    Q_DISABLE_COPY_MOVE(QQmlPrebuiltObjects)
+public:
+    // Returns nullptr if none of the objects created for objectIndex can be built off the
+    // engine thread. Otherwise the objects are built on the global thread pool, and moved to
+    // targetThread when done.
+    static QQmlRefPointer<QQmlPrebuiltObjects> start(
+            const QQmlRefPointer<QV4::ExecutableCompilationUnit> &compilationUnit,
+            int objectIndex, QThread *targetThread);
+
+    // Returns the object built for the given object of the unit, or nullptr. The caller takes
+    // ownership. Waits for the worker, or builds the objects on the calling thread if no
+    // worker has picked them up yet.
+    QObject *take(const QV4::ExecutableCompilationUnit *compilationUnit, int objectIndex);
+
+    // The bindings of object that were already assigned to instance, if it was taken before.
+    const QBitArray *assignedBindings(
+            const QObject *instance, const QV4::CompiledData::Object *object) const;
+
+    // Deletes the objects nobody has taken, and releases the compilation unit. Objects that no
+    // worker has started to build yet are not built anymore. Has to be called on the target
+    // thread.
+    void discard();
+
+private:
+    struct Literal
+    {
+        const QQmlPropertyData *property;
+        QVariant value;
+    };
+
+    struct Entry
+    {
+        const QV4::CompiledData::Object *object;
+        QQmlType type;
+        std::vector<Literal> literals;
+        QBitArray assignedBindings;
+        QObject *instance = nullptr;
+    };
+
+    QQmlPrebuiltObjects(const QQmlRefPointer<QV4::ExecutableCompilationUnit> &compilationUnit,
+                        QThread *targetThread);
+    // The worker may drop the last reference. Therefore the objects, the types and the
+    // compilation unit are all released in discard(), on the target thread.
+    ~QQmlPrebuiltObjects() override = default;
+
+    void collect(int objectIndex, bool isInstance);
+    void addEntry(int objectIndex, const QV4::CompiledData::Object *object);
+    bool run();
+    void waitForFinished();
+
+    QQmlRefPointer<QV4::ExecutableCompilationUnit> m_compilationUnit;
+    QThread *m_targetThread;
+    std::vector<Entry> m_entries;
+    QHash<int, qsizetype> m_entryForObject;
+    QHash<const QObject *, qsizetype> m_entryForInstance;
+    std::atomic<bool> m_started = false;
+    QSemaphore m_finished;
+    bool m_waited = false;
+};
+
+QT_END_NAMESPACE
+
+#endif // QQMLPREBUILTOBJECTS_P_H
@@ -0,0 +1,87 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QQMLPREPAREDSOURCE_P_H
+#define QQMLPREPAREDSOURCE_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <private/qqmldatablob_p.h>
+#include <private/qqmlirbuilder_p.h>
+#include <private/qv4executablecompilationunit_p.h>
+
+#include <QtQml/qqmlerror.h>
+
+#include <QtCore/qsemaphore.h>
+#include <QtCore/qset.h>
+
+#include <atomic>
+#include <memory>
+
+QT_BEGIN_NAMESPACE
+
+// A QML or JavaScript file that is read and parsed on one of the worker threads of the type
+// loader, while the type loader thread is still busy with the files loaded before it. The
+// preparation only touches the members of this class, never the blob or the engine. The type
+// loader thread picks up the result when it gets to load the file, in the same order as it
+// would without the workers.
+class QQmlPreparedSource
+{
+    Q_DISABLE_COPY_MOVE(QQmlPreparedSource)
+public:
+    using Prepare = void (*)(QQmlPreparedSource *);
+
+    QQmlPreparedSource(Prepare prepare) : m_prepare(prepare) {}
+
+    // Runs the preparation on the calling thread, unless another thread has already started it.
+    bool run()
+    {
+        if (m_started.exchange(true))
+            return false;
+        m_prepare(this);
+        m_finished.release();
+        return true;
+    }
+
+    // Returns once the preparation is finished, running it on the calling thread if no worker
+    // has picked it up yet.
+    void waitForFinished()
+    {
+        if (!run())
+            m_finished.acquire();
+    }
+
+    // Input, set up on the type loader thread
+    QUrl url;
+    QQmlDataBlob::SourceCodeData source;
+    QSet<QString> illegalNames;
+    bool readCacheFile = false;
+    bool isDebugging = false;
+
+    // Output. If the file could be loaded from the disk cache, cachedUnit is set. Otherwise, if
+    // parsed is set, the file was read and parsed into document (for QML files) or compiled into
+    // scriptUnit (for JavaScript files), or errors were found.
+    QQmlRefPointer<QV4::ExecutableCompilationUnit> cachedUnit;
+    std::unique_ptr<QmlIR::Document> document;
+    QV4::CompiledData::CompilationUnit scriptUnit;
+    QList<QQmlError> errors;
+    bool parsed = false;
+
+private:
+    Prepare m_prepare;
+    std::atomic<bool> m_started = false;
+    QSemaphore m_finished;
+};
+
+QT_END_NAMESPACE
+
+#endif // QQMLPREPAREDSOURCE_P_H
@@ -3,6 +3,7 @@
 
 #include <private/qqmlengine_p.h>
 #include <private/qqmlirbuilder_p.h>
+#include <private/qqmlpreparedsource_p.h>
 #include <private/qqmlscriptblob_p.h>
 #include <private/qqmlscriptdata_p.h>
 #include <private/qqmlsourcecoordinate_p.h>
@@ -32,9 +33,85 @@ QQmlRefPointer<QQmlScriptData> QQmlScriptBlob::scriptData() const
     return m_scriptData;
 }
 
+// Doesn't touch any state of the blob or the engine, so that it can run on the worker threads
+// of the type loader.
+static QV4::CompiledData::CompilationUnit compileSource(
+        const QQmlDataBlob::SourceCodeData &data, const QString &urlString,
+        const QString &finalUrlString, bool isModule, bool isDebugging, QList<QQmlError> *errors)
+{
+    QString error;
+    QString source = data.readAll(&error);
+    if (!error.isEmpty()) {
+        QQmlError e;
+        e.setDescription(error);
+        errors->append(e);
+        return QV4::CompiledData::CompilationUnit();
+    }
+
+    if (isModule) {
+        QList<QQmlJS::DiagnosticMessage> diagnostics;
+        QV4::CompiledData::CompilationUnit unit = QV4::Compiler::Codegen::compileModule(
+                isDebugging, urlString, source, data.sourceTimeStamp(), &diagnostics);
+        *errors = QQmlEnginePrivate::qmlErrorFromDiagnostics(urlString, diagnostics);
+        return unit;
+    }
+
+    QmlIR::Document irUnit(isDebugging);
+
+    irUnit.jsModule.sourceTimeStamp = data.sourceTimeStamp();
+
+    QmlIR::ScriptDirectivesCollector collector(&irUnit);
+    irUnit.jsParserEngine.setDirectives(&collector);
+
+    irUnit.javaScriptCompilationUnit = QV4::Script::precompile(
+                 &irUnit.jsModule, &irUnit.jsParserEngine, &irUnit.jsGenerator, urlString, finalUrlString,
+                 source, errors, QV4::Compiler::ContextType::ScriptImportedByQML);
+
+    source.clear();
+    if (!errors->isEmpty())
+        return QV4::CompiledData::CompilationUnit();
+
+    QmlIR::QmlUnitGenerator qmlGenerator;
+    qmlGenerator.generate(irUnit);
+    return std::move(irUnit.javaScriptCompilationUnit);
+}
+
+void QQmlScriptBlob::prepareSource(QQmlPreparedSource *prepared)
+{
+    if (prepared->readCacheFile) {
+        QQmlRefPointer<QV4::ExecutableCompilationUnit> unit
+                = QV4::ExecutableCompilationUnit::create();
+        QString error;
+        if (unit->loadFromDisk(prepared->url, prepared->source.sourceTimeStamp(), &error)) {
+            prepared->cachedUnit = std::move(unit);
+            return;
+        }
+        qCDebug(DBG_DISK_CACHE()) << "Error loading" << prepared->url.toString()
+                                  << "from disk cache:" << error;
+    }
+
+    // dataReceived() reports missing files.
+    if (!prepared->source.exists())
+        return;
+
+    const QString urlString = prepared->url.toString();
+    prepared->scriptUnit = compileSource(
+                prepared->source, urlString, urlString,
+                prepared->url.path().endsWith(QLatin1String(".mjs")), prepared->isDebugging,
+                &prepared->errors);
+    prepared->parsed = true;
+}
+
 void QQmlScriptBlob::dataReceived(const SourceCodeData &data)
 {
-    if (readCacheFile()) {
+    QQmlPreparedSource *prepared = data.preparedSource();
+    if (prepared) {
+        // A worker thread has already tried the disk cache, and logged the error if it failed.
+        if (prepared->cachedUnit) {
+            initializeFromCompilationUnit(prepared->cachedUnit);
+            return;
+        }
+    } else if (readCacheFile()) {
         QQmlRefPointer<QV4::ExecutableCompilationUnit> unit
                 = QV4::ExecutableCompilationUnit::create();
         QString error;
@@ -54,46 +131,19 @@ void QQmlScriptBlob::dataReceived(const SourceCodeData &data)
         return;
     }
 
-    QString error;
-    QString source = data.readAll(&error);
-    if (!error.isEmpty()) {
-        setError(error);
-        return;
-    }
-
     QV4::CompiledData::CompilationUnit unit;
-
-    if (m_isModule) {
-        QList<QQmlJS::DiagnosticMessage> diagnostics;
-        unit = QV4::Compiler::Codegen::compileModule(isDebugging(), urlString(), source,
-                                                     data.sourceTimeStamp(), &diagnostics);
-        QList<QQmlError> errors = QQmlEnginePrivate::qmlErrorFromDiagnostics(urlString(), diagnostics);
-        if (!errors.isEmpty()) {
-            setError(errors);
-            return;
-        }
+    QList<QQmlError> errors;
+    if (prepared && prepared->parsed) {
+        unit = std::move(prepared->scriptUnit);
+        errors = std::move(prepared->errors);
     } else {
-        QmlIR::Document irUnit(isDebugging());
-
-        irUnit.jsModule.sourceTimeStamp = data.sourceTimeStamp();
-
-        QmlIR::ScriptDirectivesCollector collector(&irUnit);
-        irUnit.jsParserEngine.setDirectives(&collector);
-
-        QList<QQmlError> errors;
-        irUnit.javaScriptCompilationUnit = QV4::Script::precompile(
-                     &irUnit.jsModule, &irUnit.jsParserEngine, &irUnit.jsGenerator, urlString(), finalUrlString(),
-                     source, &errors, QV4::Compiler::ContextType::ScriptImportedByQML);
-
-        source.clear();
-        if (!errors.isEmpty()) {
-            setError(errors);
-            return;
-        }
+        unit = compileSource(data, urlString(), finalUrlString(), m_isModule, isDebugging(),
+                             &errors);
+    }
 
-        QmlIR::QmlUnitGenerator qmlGenerator;
-        qmlGenerator.generate(irUnit);
-        unit = std::move(irUnit.javaScriptCompilationUnit);
+    if (!errors.isEmpty()) {
+        setError(errors);
+        return;
     }
 
     auto executableUnit = QV4::ExecutableCompilationUnit::create(std::move(unit));
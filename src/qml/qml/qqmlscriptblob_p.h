@@ -40,6 +40,8 @@ public:
 
     QQmlRefPointer<QQmlScriptData> scriptData() const;
 
+    static void prepareSource(QQmlPreparedSource *prepared);
+
 protected:
     void dataReceived(const SourceCodeData &) override;
     void initializeFromCachedUnit(const QQmlPrivate::CachedQmlUnit *unit) override;
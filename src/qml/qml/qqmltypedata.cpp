@@ -5,6 +5,7 @@
 #include <private/qqmlengine_p.h>
 #include <private/qqmlirbuilder_p.h>
 #include <private/qqmlirloader_p.h>
+#include <private/qqmlpreparedsource_p.h>
 #include <private/qqmlpropertycachecreator_p.h>
 #include <private/qqmlpropertyvalidator_p.h>
 #include <private/qqmlscriptblob_p.h>
@@ -90,8 +91,14 @@ bool QQmlTypeData::tryLoadFromDiskCache()
     if (!v4)
         return false;
 
-    QQmlRefPointer<QV4::ExecutableCompilationUnit> unit = QV4::ExecutableCompilationUnit::create();
-    {
+    QQmlRefPointer<QV4::ExecutableCompilationUnit> unit;
+    if (QQmlPreparedSource *prepared = m_backupSourceCode.preparedSource()) {
+        // A worker thread has already tried, and logged the error if it failed.
+        if (!prepared->cachedUnit)
+            return false;
+        unit = std::move(prepared->cachedUnit);
+    } else {
+        unit = QV4::ExecutableCompilationUnit::create();
         QString error;
         if (!unit->loadFromDisk(url(), m_backupSourceCode.sourceTimeStamp(), &error)) {
             qCDebug(DBG_DISK_CACHE) << "Error loading" << urlString() << "from disk cache:" << error;
@@ -645,31 +652,79 @@ void QQmlTypeData::initializeFromCachedUnit(const QQmlPrivate::CachedQmlUnit *un
     continueLoadFromIR();
 }
 
-bool QQmlTypeData::loadFromSource()
+// Doesn't touch any state of the type data or the engine, so that it can run on the worker
+// threads of the type loader.
+static QList<QQmlError> parseSource(
+        QmlIR::Document *document, const QQmlDataBlob::SourceCodeData &data, const QUrl &url,
+        const QString &finalUrlString, const QSet<QString> &illegalNames)
 {
-    m_document.reset(new QmlIR::Document(isDebugging()));
-    m_document->jsModule.sourceTimeStamp = m_backupSourceCode.sourceTimeStamp();
-    QQmlEngine *qmlEngine = typeLoader()->engine();
-    QmlIR::IRBuilder compiler(qmlEngine->handle()->illegalNames());
+    document->jsModule.sourceTimeStamp = data.sourceTimeStamp();
+    QmlIR::IRBuilder compiler(illegalNames);
 
+    QList<QQmlError> errors;
     QString sourceError;
-    const QString source = m_backupSourceCode.readAll(&sourceError);
+    const QString source = data.readAll(&sourceError);
     if (!sourceError.isEmpty()) {
-        setError(sourceError);
-        return false;
+        QQmlError e;
+        e.setUrl(url);
+        e.setDescription(sourceError);
+        errors << e;
+        return errors;
     }
 
-    if (!compiler.generateFromQml(source, finalUrlString(), m_document.data())) {
-        QList<QQmlError> errors;
+    if (!compiler.generateFromQml(source, finalUrlString, document)) {
         errors.reserve(compiler.errors.size());
         for (const QQmlJS::DiagnosticMessage &msg : std::as_const(compiler.errors)) {
             QQmlError e;
-            e.setUrl(url());
+            e.setUrl(url);
             e.setLine(qmlConvertSourceCoordinate<quint32, int>(msg.loc.startLine));
             e.setColumn(qmlConvertSourceCoordinate<quint32, int>(msg.loc.startColumn));
             e.setDescription(msg.message);
             errors << e;
         }
+    }
+    return errors;
+}
+
+void QQmlTypeData::prepareSource(QQmlPreparedSource *prepared)
+{
+    if (prepared->readCacheFile) {
+        QQmlRefPointer<QV4::ExecutableCompilationUnit> unit = QV4::ExecutableCompilationUnit::create();
+        QString error;
+        if (unit->loadFromDisk(prepared->url, prepared->source.sourceTimeStamp(), &error)) {
+            prepared->cachedUnit = std::move(unit);
+            return;
+        }
+        qCDebug(DBG_DISK_CACHE) << "Error loading" << prepared->url.toString()
+                                << "from disk cache:" << error;
+    }
+
+    // dataReceived() reports missing and empty files.
+    if (!prepared->source.exists() || prepared->source.isEmpty())
+        return;
+
+    prepared->document = std::make_unique<QmlIR::Document>(prepared->isDebugging);
+    prepared->errors = parseSource(prepared->document.get(), prepared->source, prepared->url,
+                                   prepared->url.toString(), prepared->illegalNames);
+    prepared->parsed = true;
+}
+
+bool QQmlTypeData::loadFromSource()
+{
+    QList<QQmlError> errors;
+    QQmlPreparedSource *prepared = m_backupSourceCode.preparedSource();
+    if (prepared && prepared->parsed) {
+        // Only use it once. If the type is loaded from source again, the file may have changed.
+        prepared->parsed = false;
+        m_document.reset(prepared->document.release());
+        errors = std::move(prepared->errors);
+    } else {
+        m_document.reset(new QmlIR::Document(isDebugging()));
+        errors = parseSource(m_document.data(), m_backupSourceCode, url(), finalUrlString(),
+                             typeLoader()->engine()->handle()->illegalNames());
+    }
+
+    if (!errors.isEmpty()) {
         setError(errors);
         return false;
     }
@@ -835,6 +890,8 @@ void QQmlTypeData::resolveTypes()
 {
     // Add any imported scripts to our resolved set
     const auto resolvedScripts = m_importCache->resolvedScripts();
+    for (const QQmlImports::ScriptReference &script : resolvedScripts)
+        prepareDependency(script.location, JavaScriptFile);
     for (const QQmlImports::ScriptReference &script : resolvedScripts) {
         QQmlRefPointer<QQmlScriptBlob> blob = typeLoader()->getScript(script.location);
         addDependency(blob.data());
@@ -903,6 +960,20 @@ void QQmlTypeData::resolveTypes()
                          QQmlType::AnyRegistrationType, selfReferenceDetection) && reportErrors)
             return;
 
+        ref.version = version;
+        ref.location = unresolvedRef->location;
+        ref.needsCreation = unresolvedRef->needsCreation;
+        m_resolvedTypes.insert(unresolvedRef.key(), ref);
+    }
+
+    // Only load the composite types once all of them are resolved, so that the worker threads
+    // can already parse the later ones while the loader thread is busy with the first ones.
+    for (const TypeReference &ref : std::as_const(m_resolvedTypes)) {
+        if (ref.type.isComposite() && !ref.selfReference)
+            prepareDependency(ref.type.sourceUrl(), QmlFile);
+    }
+
+    for (TypeReference &ref : m_resolvedTypes) {
         if (ref.type.isComposite() && !ref.selfReference) {
             ref.typeData = typeLoader()->getType(ref.type.sourceUrl());
             addDependency(ref.typeData.data());
@@ -918,11 +989,6 @@ void QQmlTypeData::resolveTypes()
                 }
             }
         }
-
-        ref.version = version;
-        ref.location = unresolvedRef->location;
-        ref.needsCreation = unresolvedRef->needsCreation;
-        m_resolvedTypes.insert(unresolvedRef.key(), ref);
     }
 
     // ### this allows enums to work without explicit import or instantiation of the type
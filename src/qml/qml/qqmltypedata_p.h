@@ -72,6 +72,8 @@ public:
     QByteArray typeClassName() const { return m_typeClassName; }
     SourceCodeData backupSourceCode() const { return m_backupSourceCode; }
 
+    static void prepareSource(QQmlPreparedSource *prepared);
+
 protected:
     void done() override;
     void completed() override;
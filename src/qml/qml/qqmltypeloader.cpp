@@ -4,6 +4,7 @@
 #include <private/qqmltypeloader_p.h>
 
 #include <private/qqmldirdata_p.h>
+#include <private/qqmlpreparedsource_p.h>
 #include <private/qqmlprofiler_p.h>
 #include <private/qqmlscriptblob_p.h>
 #include <private/qqmltypedata_p.h>
@@ -22,6 +23,7 @@
 #include <QtCore/qdiriterator.h>
 #include <QtCore/qfile.h>
 #include <QtCore/qthread.h>
+#include <QtCore/qthreadpool.h>
 
 #include <functional>
 
@@ -228,6 +230,9 @@ void QQmlTypeLoader::loadThread(const QQmlDataBlob::Ptr &blob)
 {
     ASSERT_LOADTHREAD();
 
+    // Whether the blob gets loaded or fails early, a parse prepared for it isn't needed anymore.
+    std::shared_ptr<QQmlPreparedSource> prepared = takePreparedSource(blob->m_url);
+
     // Don't continue loading if we've been shutdown
     if (m_thread->isShutdown()) {
         QQmlError error;
@@ -254,7 +259,7 @@ void QQmlTypeLoader::loadThread(const QQmlDataBlob::Ptr &blob)
         if (blob->m_data.isAsync())
             m_thread->callDownloadProgressChanged(blob, 1.);
 
-        setData(blob, fileName);
+        setData(blob, fileName, std::move(prepared));
 
     } else {
 #if QT_CONFIG(qml_network)
@@ -385,10 +390,14 @@ void QQmlTypeLoader::setData(const QQmlDataBlob::Ptr &blob, const QByteArray &da
     setData(blob, d);
 }
 
-void QQmlTypeLoader::setData(const QQmlDataBlob::Ptr &blob, const QString &fileName)
+void QQmlTypeLoader::setData(const QQmlDataBlob::Ptr &blob, const QString &fileName,
+                             std::shared_ptr<QQmlPreparedSource> prepared)
 {
     QQmlDataBlob::SourceCodeData d;
     d.fileInfo = QFileInfo(fileName);
+    d.prepared = std::move(prepared);
+    if (d.prepared)
+        d.prepared->waitForFinished();
     setData(blob, d);
 }
 
@@ -432,6 +441,37 @@ void QQmlTypeLoader::setCachedUnit(const QQmlDataBlob::Ptr &blob, const QQmlPriv
     blob->tryDone();
 }
 
+/*!
+\internal
+Starts reading and parsing the local file at \a url on one of the worker threads, using the
+\a prepare function. When the file is loaded later on, the result is handed to the blob's
+dataReceived() as part of the source code data.
+*/
+void QQmlTypeLoader::prepareSource(const QUrl &url, void (*prepare)(QQmlPreparedSource *))
+{
+    ASSERT_LOADTHREAD();
+
+    QV4::ExecutionEngine *v4 = m_engine->handle();
+    auto prepared = std::make_shared<QQmlPreparedSource>(prepare);
+    prepared->url = url;
+    prepared->source.fileInfo = QFileInfo(QQmlFile::urlToLocalFileOrQrc(url));
+    prepared->illegalNames = v4->illegalNames();
+    prepared->readCacheFile = v4->diskCacheOptions() & QV4::ExecutionEngine::DiskCache::QmlcRead;
+    prepared->isDebugging = v4->debugger() != nullptr;
+
+    {
+        LockHolder<QQmlTypeLoader> holder(this);
+        m_preparedSources.insert(url, prepared);
+    }
+    m_workerPool->start([prepared]() { prepared->run(); });
+}
+
+std::shared_ptr<QQmlPreparedSource> QQmlTypeLoader::takePreparedSource(const QUrl &url)
+{
+    LockHolder<QQmlTypeLoader> holder(this);
+    return m_preparedSources.take(url);
+}
+
 void QQmlTypeLoader::shutdownThread()
 {
     if (m_thread && !m_thread->isShutdown())
@@ -460,6 +500,47 @@ QQmlTypeLoader::Blob::~Blob()
 {
 }
 
+/*!
+\internal
+Hints that the QML or JavaScript file at \a url is going to be loaded as a dependency of this
+blob soon. If it is a local file that isn't loaded yet, it is read and parsed on one of the worker
+threads in the meantime. The loading itself, including the resolution of its dependencies,
+still happens on the loader thread, in the same order as without this hint.
+*/
+void QQmlTypeLoader::Blob::prepareDependency(const QUrl &unNormalizedUrl, QQmlDataBlob::Type type)
+{
+    Q_ASSERT(type == QQmlDataBlob::QmlFile || type == QQmlDataBlob::JavaScriptFile);
+
+    QQmlTypeLoader *loader = typeLoader();
+    if (!loader->m_workerPool)
+        return;
+
+    const QUrl url = normalize(unNormalizedUrl);
+    if (!QQmlFile::isSynchronous(url))
+        return;
+
+    {
+        LockHolder<QQmlTypeLoader> holder(loader);
+        if (loader->m_preparedSources.contains(url))
+            return;
+        if (type == QQmlDataBlob::QmlFile ? loader->m_typeCache.contains(url)
+                                          : loader->m_scriptCache.contains(url)) {
+            return;
+        }
+    }
+
+    // Files compiled ahead of time are not read at all.
+    const QQmlMetaType::CacheMode cacheMode = aotCacheMode();
+    QQmlMetaType::CachedUnitLookupError error = QQmlMetaType::CachedUnitLookupError::NoError;
+    if (cacheMode != QQmlMetaType::RejectAll
+            && QQmlMetaType::findCachedCompilationUnit(url, cacheMode, &error)) {
+        return;
+    }
+
+    loader->prepareSource(url, type == QQmlDataBlob::QmlFile ? &QQmlTypeData::prepareSource
+                                                             : &QQmlScriptBlob::prepareSource);
+}
+
 bool QQmlTypeLoader::Blob::fetchQmldir(const QUrl &url, PendingImportPtr import, int priority, QList<QQmlError> *errors)
 {
     QQmlRefPointer<QQmlQmldirData> data = typeLoader()->getQmldir(url);
@@ -901,6 +982,18 @@ QQmlTypeLoader::QQmlTypeLoader(QQmlEngine *engine)
     , m_mutex(m_thread->mutex())
     , m_typeCacheTrimThreshold(TYPELOADER_MINIMUM_TRIM_THRESHOLD)
 {
+#if QT_CONFIG(thread)
+    // By default, use all cores but the one the loader thread runs on.
+    bool ok = false;
+    int workerThreads = qEnvironmentVariableIntValue("QML_TYPE_LOADER_WORKER_THREADS", &ok);
+    if (!ok)
+        workerThreads = QThread::idealThreadCount() - 1;
+    if (workerThreads > 0) {
+        m_workerPool = std::make_unique<QThreadPool>();
+        m_workerPool->setObjectName(QStringLiteral("QQmlTypeLoader worker"));
+        m_workerPool->setMaxThreadCount(workerThreads);
+    }
+#endif
 }
 
 /*!
@@ -1313,6 +1406,7 @@ void QQmlTypeLoader::clearCache()
     m_importDirCache.clear();
     m_importQmlDirCache.clear();
     m_checksumCache.clear();
+    m_preparedSources.clear();
     QQmlMetaType::freeUnusedTypesAndCaches();
 }
 
@@ -37,6 +37,7 @@ class QQmlExtensionInterface;
 class QQmlProfiler;
 class QQmlTypeLoaderThread;
 class QQmlEngine;
+class QThreadPool;
 
 class Q_QML_PRIVATE_EXPORT QQmlTypeLoader
 {
@@ -86,6 +87,8 @@ public:
         bool fetchQmldir(const QUrl &url, PendingImportPtr import, int priority, QList<QQmlError> *errors);
         bool updateQmldir(const QQmlRefPointer<QQmlQmldirData> &data, const PendingImportPtr &import, QList<QQmlError> *errors);
 
+        void prepareDependency(const QUrl &url, QQmlDataBlob::Type type);
+
     private:
         bool addScriptImport(const PendingImportPtr &import);
         bool addFileImport(const PendingImportPtr &import, QList<QQmlError> *errors);
@@ -188,10 +191,14 @@ private:
 #endif
 
     void setData(const QQmlDataBlob::Ptr &, const QByteArray &);
-    void setData(const QQmlDataBlob::Ptr &, const QString &fileName);
+    void setData(const QQmlDataBlob::Ptr &, const QString &fileName,
+                 std::shared_ptr<QQmlPreparedSource> prepared);
     void setData(const QQmlDataBlob::Ptr &, const QQmlDataBlob::SourceCodeData &);
     void setCachedUnit(const QQmlDataBlob::Ptr &blob, const QQmlPrivate::CachedQmlUnit *unit);
 
+    void prepareSource(const QUrl &url, void (*prepare)(QQmlPreparedSource *));
+    std::shared_ptr<QQmlPreparedSource> takePreparedSource(const QUrl &url);
+
     typedef QHash<QUrl, QQmlTypeData *> TypeCache;
     typedef QHash<QUrl, QQmlScriptBlob *> ScriptCache;
     typedef QHash<QUrl, QQmlQmldirData *> QmldirCache;
@@ -217,6 +224,12 @@ private:
     ImportQmlDirCache m_importQmlDirCache;
     ChecksumCache m_checksumCache;
 
+    // Reads and parses the files a blob depends on in parallel, while the loader thread is busy
+    // loading the ones before them. The prepared sources are guarded by the loader's mutex, as
+    // clearCache() is called from the engine thread.
+    std::unique_ptr<QThreadPool> m_workerPool;
+    QHash<QUrl, std::shared_ptr<QQmlPreparedSource>> m_preparedSources;
+
     template<typename Loader>
     void doLoad(const Loader &loader, QQmlDataBlob *blob, Mode mode);
     void updateTypeCacheTrimThreshold();
@@ -110,6 +110,8 @@ private:
         // non-simplified pieces.
         if (heapString->subtype >= QV4::Heap::String::StringType_Complex)
             heapString->simplifyString();
+        if (heapString->isLatin1())
+            heapString->convertToUtf16();
 
         // This is safe because the string data is backed by the QV4::String we got as
         // parameter. The contract about passing V4 values as parameters is that you have to
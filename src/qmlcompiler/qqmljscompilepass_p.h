@@ -304,6 +304,8 @@ protected:
 
     // Stub out all the methods so that passes can choose to only implement part of them.
     void generate_Add(int) override {}
+    void generate_AddConst(int, int) override {}
+    void generate_AddInt(int, int) override {}
     void generate_As(int) override {}
     void generate_BitAnd(int) override {}
     void generate_BitAndConst(int) override {}
@@ -326,16 +328,28 @@ protected:
     void generate_CmpEqInt(int) override {}
     void generate_CmpEqNull() override {}
     void generate_CmpGe(int) override {}
+    void generate_CmpGeJumpFalse(int, int) override {}
+    void generate_CmpGeJumpTrue(int, int) override {}
     void generate_CmpGt(int) override {}
+    void generate_CmpGtJumpFalse(int, int) override {}
+    void generate_CmpGtJumpTrue(int, int) override {}
     void generate_CmpIn(int) override {}
     void generate_CmpInstanceOf(int) override {}
     void generate_CmpLe(int) override {}
+    void generate_CmpLeJumpFalse(int, int) override {}
+    void generate_CmpLeJumpTrue(int, int) override {}
     void generate_CmpLt(int) override {}
+    void generate_CmpLtJumpFalse(int, int) override {}
+    void generate_CmpLtJumpTrue(int, int) override {}
     void generate_CmpNe(int) override {}
     void generate_CmpNeInt(int) override {}
     void generate_CmpNeNull() override {}
     void generate_CmpStrictEqual(int) override {}
+    void generate_CmpStrictEqualJumpFalse(int, int) override {}
+    void generate_CmpStrictEqualJumpTrue(int, int) override {}
     void generate_CmpStrictNotEqual(int) override {}
+    void generate_CmpStrictNotEqualJumpFalse(int, int) override {}
+    void generate_CmpStrictNotEqualJumpTrue(int, int) override {}
     void generate_Construct(int, int, int) override {}
     void generate_ConstructWithSpread(int, int, int) override {}
     void generate_ConvertThisToObject() override {}
@@ -358,6 +372,8 @@ protected:
     void generate_GetException() override {}
     void generate_GetIterator(int) override {}
     void generate_GetLookup(int) override {}
+    void generate_GetLookupFromReg(int, int) override {}
+    void generate_GetLookupFromRegToReg(int, int, int) override {}
     void generate_GetOptionalLookup(int, int) override {}
     void generate_GetTemplateObject(int) override {}
     void generate_Increment() override {}
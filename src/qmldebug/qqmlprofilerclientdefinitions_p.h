@@ -87,7 +87,9 @@ enum SceneGraphFrameType {
 enum MemoryType {
     HeapPage,
     LargeItem,
-    SmallItem
+    SmallItem,
+    JitCodePage,
+    AllocationSample
 };
 
 enum ProfileFeature {
@@ -122,9 +122,21 @@ QDataStream &operator>>(QDataStream &stream, QQmlProfilerTypedEvent &event)
         qint64 delta;
         stream >> delta;
 
-        event.type = QQmlProfilerEventType(
-                    static_cast<Message>(messageType),
-                    MaximumRangeType, subtype);
+        if (subtype == AllocationSample && !stream.atEnd()) {
+            // Sampled allocations carry the JavaScript function and stack they happened in.
+            QString filename;
+            int line = 0;
+            int column = 0;
+            QString stack;
+            stream >> filename >> line >> column >> stack;
+            event.type = QQmlProfilerEventType(
+                        static_cast<Message>(messageType), MaximumRangeType, subtype,
+                        QQmlProfilerEventLocation(filename, line, column), stack);
+        } else {
+            event.type = QQmlProfilerEventType(
+                        static_cast<Message>(messageType),
+                        MaximumRangeType, subtype);
+        }
         event.event.setNumbers<qint64>({delta});
         break;
     }
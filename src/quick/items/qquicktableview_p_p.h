@@ -180,6 +180,9 @@ public:
             case QQmlIncubator::Synchronous:
                 dbg << "Synchronous";
                 break;
+            case QQmlIncubator::AsynchronousParallel:
+                dbg << "AsynchronousParallel";
+                break;
             }
 
             return str;
@@ -34,6 +34,7 @@
 #include <QtCore/QRunnable>
 #include <QtQml/qqmlincubator.h>
 #include <QtQml/qqmlinfo.h>
+#include <QtQml/private/qqmlbindingscheduler_p.h>
 #include <QtQml/private/qqmlmetatype_p.h>
 
 #include <QtQuick/private/qquickpixmapcache_p.h>
@@ -334,6 +335,9 @@ void QQuickWindowPrivate::polishItems()
     // or indirectly, we use a PolishLoopDetector to determine if a warning should
     // be printed to the user.
 
+    // Bindings that are re-evaluated in batches may still change the geometry of items.
+    QQmlBindingScheduler::flushAll();
+
     PolishLoopDetector polishLoopDetector(itemsToPolish);
     while (!itemsToPolish.isEmpty()) {
         QQuickItem *item = itemsToPolish.takeLast();
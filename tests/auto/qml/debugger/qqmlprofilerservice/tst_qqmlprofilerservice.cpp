@@ -193,6 +193,7 @@ private:
                 const QVector<qint64> &expectedNumbers);
 
     QList<QQmlDebugClient *> createClients() override;
+    QQmlDebugProcess *createProcess(const QString &executable) override;
     QScopedPointer<QQmlProfilerTestClient> m_client;
 
 private slots:
@@ -209,6 +210,7 @@ private slots:
     void flushInterval();
     void translationBinding();
     void memory();
+    void allocationSamples();
     void compile();
     void multiEngine();
     void batchOverflow();
@@ -217,6 +219,7 @@ private:
     bool m_recordFromStart = true;
     bool m_flushInterval = false;
     bool m_isComplete = false;
+    int m_allocationSampleInterval = 0;
 
     // Don't use ({...}) here as MSVC will interpret that as the "QVector(int size)" ctor.
     const QVector<qint64> m_rangeStart = (QVector<qint64>() << RangeStart);
@@ -458,6 +461,16 @@ QList<QQmlDebugClient *> tst_QQmlProfilerService::createClients()
     return QList<QQmlDebugClient *>({m_client->client});
 }
 
+QQmlDebugProcess *tst_QQmlProfilerService::createProcess(const QString &executable)
+{
+    QQmlDebugProcess *process = QQmlDebugTest::createProcess(executable);
+    if (m_allocationSampleInterval > 0) {
+        process->addEnvironment(QLatin1String("QV4_PROFILE_ALLOCATION_SAMPLE_INTERVAL=")
+                                + QString::number(m_allocationSampleInterval));
+    }
+    return process;
+}
+
 void tst_QQmlProfilerService::cleanup()
 {
     auto log = [this](const QQmlProfilerEvent &data, int i) {
@@ -503,6 +516,7 @@ void tst_QQmlProfilerService::cleanup()
     }
 
     m_client.reset();
+    m_allocationSampleInterval = 0;
     QQmlDebugTest::cleanup();
 }
 
@@ -723,6 +737,43 @@ void tst_QQmlProfilerService::memory()
     QVERIFY(smallItems > 5);
 }
 
+void tst_QQmlProfilerService::allocationSamples()
+{
+    m_allocationSampleInterval = 64;
+    QCOMPARE(connectTo(true, "memory.qml"), ConnectSuccess);
+    checkProcessTerminated();
+
+    checkTraceReceived();
+    checkJsHeap();
+
+    QVERIFY(m_client);
+    int samples = 0;
+    bool seenRecurse = false;
+    for (const auto& message : m_client->jsHeapMessages) {
+        const QQmlProfilerEventType &type = m_client->types[message.typeIndex()];
+        if (type.detailType() != AllocationSample)
+            continue;
+
+        ++samples;
+        QVERIFY(message.number<qint64>(0) > 0);
+
+        // Allocations outside of JavaScript functions have no location.
+        const QQmlProfilerEventLocation location = type.location();
+        if (location.filename().isEmpty())
+            continue;
+
+        QVERIFY(location.filename().endsWith(QLatin1String("memory.qml")));
+        QVERIFY(!type.data().isEmpty());
+        if (type.data().startsWith(QLatin1String("recurse ("))) {
+            seenRecurse = true;
+            QVERIFY(location.line() > 0);
+        }
+    }
+
+    QVERIFY(samples > 0);
+    QVERIFY(seenRecurse);
+}
+
 static bool hasCompileEvents(const QVector<QQmlProfilerEventType> &types)
 {
     for (const QQmlProfilerEventType &type : types) {
@@ -14,6 +14,8 @@
 #include <stdlib.h>
 #include <private/qv4alloca_p.h>
 #include <private/qjsvalue_p.h>
+#include <private/qv4mm_p.h>
+#include <private/qv4identifiertable_p.h>
 #include <QScopeGuard>
 #include <QUrl>
 #include <QModelIndex>
@@ -106,6 +108,7 @@ private slots:
     void collectGarbage();
     void collectGarbageNestedWrappersTwoEngines();
     void gcWithNestedDataStructure();
+    void writeHeapSnapshot();
     void stacktrace();
     void numberParsing_data();
     void numberParsing();
@@ -262,6 +265,9 @@ private slots:
 
     void equality();
     void aggressiveGc();
+    void incrementalGc();
+    void generationalGc();
+    void parallelSweep();
     void noAccumulatorInTemplateLiteral();
 
     void interrupt_data();
@@ -280,8 +286,14 @@ private slots:
 
     void tostringRecursionCheck();
     void arrayIncludesWithLargeArray();
+    void packedArrays_data();
+    void packedArrays();
     void printCircularArray();
     void typedArraySet();
+    void typedArrayBulkOperations_data();
+    void typedArrayBulkOperations();
+    void fusedInstructions_data();
+    void fusedInstructions();
     void dataViewCtor();
 
     void uiLanguage();
@@ -304,6 +316,11 @@ private slots:
     void callWithSpreadOnElement();
     void spreadNoOverflow();
 
+    void mapAndSetWithManyEntries();
+    void mapWithQObjectKeys();
+    void polymorphicLookups();
+    void latin1Strings();
+
 public:
     Q_INVOKABLE QJSValue throwingCppMethod1();
     Q_INVOKABLE void throwingCppMethod2();
@@ -1966,6 +1983,104 @@ void tst_QJSEngine::gcWithNestedDataStructure()
     }
 }
 
+void tst_QJSEngine::writeHeapSnapshot()
+{
+    QJSEngine eng;
+    QObject object;
+    object.setObjectName(QStringLiteral("snapshotObject"));
+    eng.globalObject().setProperty(QStringLiteral("wrapped"), eng.newQObject(&object));
+    QJSValue ret = eng.evaluate(
+        "function Leaky() {"
+        "  this.payload = 'a string only the snapshot test uses';"
+        "  this.items = [ { }, { } ];"
+        "}"
+        "var leak = new Leaky();");
+    QVERIFY(!ret.isError());
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString fileName = dir.filePath(QStringLiteral("test.heapsnapshot"));
+    QVERIFY(eng.writeHeapSnapshot(fileName));
+
+    QFile file(fileName);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QJsonParseError error;
+    const QJsonObject snapshot = QJsonDocument::fromJson(file.readAll(), &error).object();
+    QCOMPARE(error.error, QJsonParseError::NoError);
+
+    const QJsonObject header = snapshot.value(QLatin1String("snapshot")).toObject();
+    const QJsonObject meta = header.value(QLatin1String("meta")).toObject();
+    const int nodeFieldCount = meta.value(QLatin1String("node_fields")).toArray().size();
+    const int edgeFieldCount = meta.value(QLatin1String("edge_fields")).toArray().size();
+    QCOMPARE(nodeFieldCount, 7);
+    QCOMPARE(edgeFieldCount, 3);
+
+    const QJsonArray nodes = snapshot.value(QLatin1String("nodes")).toArray();
+    const QJsonArray edges = snapshot.value(QLatin1String("edges")).toArray();
+    const QJsonArray strings = snapshot.value(QLatin1String("strings")).toArray();
+    const int nodeCount = header.value(QLatin1String("node_count")).toInt();
+    const int edgeCount = header.value(QLatin1String("edge_count")).toInt();
+    QCOMPARE(nodes.size(), nodeCount * nodeFieldCount);
+    QCOMPARE(edges.size(), edgeCount * edgeFieldCount);
+
+    const QStringList nodeTypes = meta.value(QLatin1String("node_types")).toArray().at(0)
+            .toVariant().toStringList();
+    const QStringList edgeTypes = meta.value(QLatin1String("edge_types")).toArray().at(0)
+            .toVariant().toStringList();
+    const auto nodeName = [&](int node) {
+        return strings.at(nodes.at(node * nodeFieldCount + 1).toInt()).toString();
+    };
+    const auto nodeType = [&](int node) {
+        return nodeTypes.at(nodes.at(node * nodeFieldCount).toInt());
+    };
+
+    // Every edge points to a node, and the edges of all nodes add up to the edge count.
+    int totalEdges = 0;
+    int leakyNode = -1;
+    int firstLeakyEdge = 0;
+    bool hasQObject = false;
+    for (int node = 0; node < nodeCount; ++node) {
+        if (nodeName(node) == QLatin1String("Leaky") && nodeType(node) == QLatin1String("object")) {
+            QCOMPARE(leakyNode, -1);
+            leakyNode = node;
+            firstLeakyEdge = totalEdges;
+        }
+        if (nodeName(node) == QLatin1String("QObject") && nodeType(node) == QLatin1String("native"))
+            hasQObject = true;
+        totalEdges += nodes.at(node * nodeFieldCount + 4).toInt();
+    }
+    QCOMPARE(totalEdges, edgeCount);
+    for (int edge = 0; edge < edgeCount; ++edge) {
+        const int toNode = edges.at(edge * edgeFieldCount + 2).toInt();
+        QCOMPARE(toNode % nodeFieldCount, 0);
+        QVERIFY(toNode / nodeFieldCount < nodeCount);
+    }
+    QVERIFY(hasQObject);
+
+    // The object created by the constructor references the string through a named property.
+    QVERIFY(leakyNode > 0);
+    bool foundPayload = false;
+    const int leakyEdgeCount = nodes.at(leakyNode * nodeFieldCount + 4).toInt();
+    for (int edge = firstLeakyEdge; edge < firstLeakyEdge + leakyEdgeCount; ++edge) {
+        const QString type = edgeTypes.at(edges.at(edge * edgeFieldCount).toInt());
+        if (type != QLatin1String("property"))
+            continue;
+        const QString name = strings.at(edges.at(edge * edgeFieldCount + 1).toInt()).toString();
+        if (name != QLatin1String("payload"))
+            continue;
+        const int toNode = edges.at(edge * edgeFieldCount + 2).toInt() / nodeFieldCount;
+        QCOMPARE(nodeType(toNode), QLatin1String("string"));
+        QCOMPARE(nodeName(toNode), QLatin1String("a string only the snapshot test uses"));
+        foundPayload = true;
+    }
+    QVERIFY(foundPayload);
+
+    // Writing the snapshot must leave the heap intact.
+    eng.collectGarbage();
+    QCOMPARE(eng.evaluate("leak.items.length").toInt(), 2);
+    QCOMPARE(eng.evaluate("wrapped.objectName").toString(), QStringLiteral("snapshotObject"));
+}
+
 void tst_QJSEngine::stacktrace()
 {
     QString script = QString::fromLatin1(
@@ -5187,6 +5302,177 @@ void tst_QJSEngine::aggressiveGc()
     qputenv("QV4_MM_AGGRESSIVE_GC", origAggressiveGc);
 }
 
+void tst_QJSEngine::incrementalGc()
+{
+    const QByteArray origIncrementalGc = qgetenv("QV4_MM_INCREMENTAL_GC");
+    const QByteArray origSliceBudget = qgetenv("QV4_MM_GC_SLICE_BUDGET");
+    const auto guard = qScopeGuard([&]() {
+        qputenv("QV4_MM_INCREMENTAL_GC", origIncrementalGc);
+        qputenv("QV4_MM_GC_SLICE_BUDGET", origSliceBudget);
+    });
+    qputenv("QV4_MM_INCREMENTAL_GC", "1");
+    qputenv("QV4_MM_GC_SLICE_BUDGET", "1");
+
+    QJSEngine engine;
+    QV4::MemoryManager *mm = engine.handle()->memoryManager;
+    QVERIFY(mm->isIncrementalGCEnabled());
+
+    // Keep mutating live objects, locals of closures, and maps while the
+    // collector is marking incrementally, and verify that nothing got lost.
+    const QJSValue result = engine.evaluate(uR"(
+        (function() {
+            let kept = [];
+            let map = new Map;
+            let captured = null;
+            let capture = function(o) { captured = o; };
+            for (let round = 0; round < 200; ++round) {
+                let head = null;
+                for (let i = 0; i < 1000; ++i)
+                    head = { index: i, name: 'item' + i, next: head };
+                kept[round % 10] = head;
+                map.set(round % 50, { round: round, list: head.next });
+                capture(head.next.next);
+            }
+            for (let list of kept) {
+                let expected = 999;
+                for (let o = list; o; o = o.next) {
+                    if (o.index !== expected || o.name !== 'item' + expected)
+                        return false;
+                    --expected;
+                }
+                if (expected !== -1)
+                    return false;
+            }
+            for (let [key, value] of map) {
+                if (value.round % 50 !== key || value.list.index !== 998)
+                    return false;
+            }
+            return captured.index === 997 && captured.name === 'item997';
+        })()
+    )"_s);
+
+    QVERIFY2(!result.isError(), qPrintable(result.toString()));
+    QVERIFY(result.toBool());
+
+    // Completes any ongoing incremental collection.
+    engine.collectGarbage();
+    QVERIFY(!mm->isIncrementalGCOngoing());
+}
+
+void tst_QJSEngine::generationalGc()
+{
+    const QByteArray origGenerationalGc = qgetenv("QV4_MM_GENERATIONAL_GC");
+    const auto guard = qScopeGuard([&]() {
+        qputenv("QV4_MM_GENERATIONAL_GC", origGenerationalGc);
+    });
+    qputenv("QV4_MM_GENERATIONAL_GC", "1");
+
+    QJSEngine engine;
+    QV4::MemoryManager *mm = engine.handle()->memoryManager;
+    QVERIFY(mm->isGenerationalGCEnabled());
+
+    // Create some objects and move them to the old generation.
+    engine.evaluate(uR"(
+        var oldObject = { young: null };
+        var oldArray = [];
+        var oldMap = new Map;
+        var oldCaptured = null;
+        var oldCapture = function(o) { oldCaptured = o; };
+    )"_s);
+    engine.collectGarbage();
+
+    // Store young objects into the old ones while minor collections happen,
+    // and verify that none of them got lost.
+    const QJSValue result = engine.evaluate(uR"(
+        (function() {
+            for (let round = 0; round < 200; ++round) {
+                let head = null;
+                for (let i = 0; i < 1000; ++i)
+                    head = { index: i, name: 'item' + i, next: head };
+                oldObject.young = head;
+                oldArray[round % 10] = head.next;
+                oldMap.set(round % 50, { round: round, list: head.next.next });
+                oldCapture(head.next.next.next);
+            }
+            let expected = 999;
+            for (let o = oldObject.young; o; o = o.next) {
+                if (o.index !== expected || o.name !== 'item' + expected)
+                    return false;
+                --expected;
+            }
+            if (expected !== -1)
+                return false;
+            for (let list of oldArray) {
+                if (list.index !== 998 || list.name !== 'item998')
+                    return false;
+            }
+            for (let [key, value] of oldMap) {
+                if (value.round % 50 !== key || value.list.index !== 997)
+                    return false;
+            }
+            return oldCaptured.index === 996 && oldCaptured.name === 'item996';
+        })()
+    )"_s);
+
+    QVERIFY2(!result.isError(), qPrintable(result.toString()));
+    QVERIFY(result.toBool());
+    QVERIFY(mm->statistics.minorCollections > 0);
+
+    engine.collectGarbage();
+    QVERIFY(mm->rememberedSet.empty());
+}
+
+void tst_QJSEngine::parallelSweep()
+{
+    const QByteArray origParallelSweep = qgetenv("QV4_MM_PARALLEL_SWEEP");
+    const auto guard = qScopeGuard([&]() {
+        qputenv("QV4_MM_PARALLEL_SWEEP", origParallelSweep);
+    });
+    qputenv("QV4_MM_PARALLEL_SWEEP", "4");
+
+    QJSEngine engine;
+    QV4::MemoryManager *mm = engine.handle()->memoryManager;
+    QVERIFY(mm->sweepThreadPool);
+
+    // QObjects owned by JavaScript have to be deleted on the engine's thread.
+    QPointer<QObject> collected = new QObject;
+    QPointer<QObject> kept = new QObject;
+    engine.globalObject().setProperty("kept", engine.newQObject(kept));
+    engine.newQObject(collected);
+
+    const QJSValue result = engine.evaluate(uR"(
+        (function() {
+            let kept = [];
+            for (let round = 0; round < 100; ++round) {
+                let head = null;
+                for (let i = 0; i < 1000; ++i)
+                    head = { index: i, name: 'item' + i, next: head };
+                kept[round % 10] = head;
+            }
+            for (let list of kept) {
+                let expected = 999;
+                for (let o = list; o; o = o.next) {
+                    if (o.index !== expected || o.name !== 'item' + expected)
+                        return false;
+                    --expected;
+                }
+                if (expected !== -1)
+                    return false;
+            }
+            return true;
+        })()
+    )"_s);
+
+    QVERIFY2(!result.isError(), qPrintable(result.toString()));
+    QVERIFY(result.toBool());
+
+    engine.collectGarbage();
+    if (collected)
+        QGuiApplication::sendPostedEvents(collected, QEvent::DeferredDelete);
+    QVERIFY(collected.isNull());
+    QVERIFY(!kept.isNull());
+}
+
 void tst_QJSEngine::noAccumulatorInTemplateLiteral()
 {
     // Use aggressive GC to increase our chances of triggering the problem.
@@ -5412,6 +5698,70 @@ void tst_QJSEngine::arrayIncludesWithLargeArray()
     QCOMPARE(value.toBool(), false);
 }
 
+void tst_QJSEngine::packedArrays_data()
+{
+    QTest::addColumn<QString>("program");
+    QTest::addColumn<QString>("expected");
+
+    QTest::newRow("indexOf int") << "[3, 1, 2].indexOf(2)" << "2";
+    QTest::newRow("indexOf int as double") << "[3, 1, 2].indexOf(2.0)" << "2";
+    QTest::newRow("indexOf fraction in ints") << "[3, 1, 2].indexOf(1.5)" << "-1";
+    QTest::newRow("indexOf string in ints") << "[3, 1, 2].indexOf('1')" << "-1";
+    QTest::newRow("indexOf double") << "[3, 1.5, 2].indexOf(1.5)" << "1";
+    QTest::newRow("indexOf zero") << "[3, -0, 2].indexOf(0)" << "1";
+    QTest::newRow("indexOf NaN") << "[NaN, 1.5].indexOf(NaN)" << "-1";
+    QTest::newRow("indexOf fromIndex") << "[2, 1, 2].indexOf(2, 1)" << "2";
+    QTest::newRow("indexOf after store")
+            << "var a = [1, 2, 3]; a[1] = 'x'; a.indexOf('x')" << "1";
+    QTest::newRow("indexOf after hole")
+            << "var a = [1, 2]; a[4] = 5; a.indexOf(5)" << "4";
+    QTest::newRow("indexOf after delete")
+            << "var a = [1, 2, 3]; delete a[1]; a[1] = 'w'; a.indexOf('w')" << "1";
+    QTest::newRow("indexOf after defineProperty")
+            << "var a = [1, 2, 3]; Object.defineProperty(a, 1, { value: 'y' }); a.indexOf('y')"
+            << "1";
+    QTest::newRow("indexOf after push")
+            << "var a = [1, 2]; a.push(2.5); a.push(null); a.indexOf(null)" << "3";
+    QTest::newRow("indexOf after unshift")
+            << "var a = [1, 2]; a.unshift({}); a.indexOf(1)" << "1";
+    QTest::newRow("indexOf of copy")
+            << "var a = [1, 2]; a[0] = 'z'; var b = a.slice(); b.indexOf('z')" << "0";
+    QTest::newRow("sort ints") << "[10, 9, 1, -3, 100, 0].sort().join()" << "-3,0,1,10,100,9";
+    QTest::newRow("sort ints with compare")
+            << "[10, 9, 1, -3, 100, 0].sort((a, b) => a - b).join()" << "-3,0,1,9,10,100";
+    QTest::newRow("sort doubles") << "[10, 9.5, 1, -3].sort().join()" << "-3,1,10,9.5";
+    QTest::newRow("sort with hole")
+            << "var a = [3, 1]; a[3] = 2; a.sort(); [a.length, a.join()].join(':')" << "4:1,2,3,";
+    QTest::newRow("map")
+            << "[1, 2.5, 3].map(x => x * 2).join()" << "2,5,6";
+    QTest::newRow("map modifying array")
+            << "var a = [1, 2, 3]; a.map((x, i) => { a[2] = 'c'; return x; }).join()" << "1,2,c";
+    QTest::newRow("map shrinking array")
+            << "var a = [1, 2, 3]; a.map((x, i) => { a.length = 1; return x; }).length" << "3";
+    QTest::newRow("map with hole")
+            << "var a = [1, 2]; a[3] = 4; Object.keys(a.map(x => x)).join()" << "0,1,3";
+    QTest::newRow("reduce") << "[1, 2, 3.5].reduce((a, b) => a + b)" << "6.5";
+    QTest::newRow("reduce with initial") << "[1, 2, 3].reduce((a, b) => a + b, 10)" << "16";
+    QTest::newRow("reduce modifying array")
+            << "var a = [1, 2, 3]; a.reduce((acc, x) => { a[2] = 10; return acc + x; }, 0)"
+            << "13";
+    QTest::newRow("reduce with prototype element")
+            << "var a = [1, 2]; a[3] = 4; Array.prototype[2] = 3;"
+               "var r = a.reduce((acc, x) => acc + x); delete Array.prototype[2]; r"
+            << "10";
+}
+
+void tst_QJSEngine::packedArrays()
+{
+    QFETCH(QString, program);
+    QFETCH(QString, expected);
+
+    QJSEngine engine;
+    const QJSValue result = engine.evaluate(program);
+    QVERIFY2(!result.isError(), qPrintable(result.toString()));
+    QCOMPARE(result.toString(), expected);
+}
+
 void tst_QJSEngine::printCircularArray()
 {
     QJSEngine engine;
@@ -5526,6 +5876,159 @@ void tst_QJSEngine::typedArraySet()
     }
 }
 
+void tst_QJSEngine::typedArrayBulkOperations_data()
+{
+    QTest::addColumn<QString>("program");
+    QTest::addColumn<QString>("expected");
+
+    const QString floats = QStringLiteral(
+                "var f = new Float32Array([1.5, -1.5, 32767.9, 32768, -32769, 65537.5, NaN,"
+                "                          Infinity, -Infinity, 3e9, -0, 0.49, 7, -7, 100000, 1]);");
+
+    QTest::newRow("Float32 to Int16")
+            << floats + "Array.from(new Int16Array(f)).join()"
+            << "1,-1,32767,-32768,32767,1,0,0,0,24064,0,0,7,-7,-31072,1";
+    QTest::newRow("Float32 to Uint16")
+            << floats + "Array.from(new Uint16Array(f)).join()"
+            << "1,65535,32767,32768,32767,1,0,0,0,24064,0,0,7,65529,34464,1";
+    QTest::newRow("Float32 to Int32")
+            << floats + "Array.from(new Int32Array(f)).join()"
+            << "1,-1,32767,32768,-32769,65537,0,0,0,-1294967296,0,0,7,-7,100000,1";
+    QTest::newRow("Float32 to Uint32")
+            << floats + "Array.from(new Uint32Array(f)).join()"
+            << "1,4294967295,32767,32768,4294934527,65537,0,0,0,3000000000,0,0,7,4294967289,"
+               "100000,1";
+    QTest::newRow("Float32 to Int8")
+            << floats + "Array.from(new Int8Array(f)).join()"
+            << "1,-1,-1,0,-1,1,0,0,0,0,0,0,7,-7,-96,1";
+    QTest::newRow("Float32 to Uint8Clamped")
+            << floats + "Array.from(new Uint8ClampedArray(f)).join()"
+            << "2,0,255,255,0,255,0,255,0,255,0,0,7,0,255,1";
+    QTest::newRow("Float64 to Int16")
+            << "Array.from(new Int16Array(new Float64Array([1.5, -70000.5, 4294967296.5, NaN,"
+               "2, 3, 4, 5, 6, 7]))).join()"
+            << "1,-4464,0,0,2,3,4,5,6,7";
+    QTest::newRow("Int16 to Float32")
+            << "Array.from(new Float32Array(new Int16Array([-32768, -1, 0, 1, 32767]))).join()"
+            << "-32768,-1,0,1,32767";
+    QTest::newRow("Int32 to Float32")
+            << "Array.from(new Float32Array(new Int32Array([16777217, -5]))).join()"
+            << "16777216,-5";
+    QTest::newRow("Float32 to Int32 same size")
+            << "Array.from(new Int32Array(new Float32Array([2.5, -3.5]))).join()" << "2,-3";
+    QTest::newRow("Uint32 to Uint8Clamped")
+            << "Array.from(new Uint8ClampedArray(new Uint32Array([4294967295, 12]))).join()"
+            << "255,12";
+    QTest::newRow("set Float32 on Int16")
+            << floats + "var i = new Int16Array(18); i.set(f, 1); Array.from(i).join()"
+            << "0,1,-1,32767,-32768,32767,1,0,0,0,24064,0,0,7,-7,-31072,1,0";
+    QTest::newRow("set overlapping")
+            << "var b = new ArrayBuffer(8); var i8 = new Int8Array(b, 0, 3);"
+               "i8.set([1, 2, 3]); var i16 = new Int16Array(b, 2, 3);"
+               "i16.set(i8); Array.from(new Int8Array(b)).join()"
+            << "1,2,1,0,2,0,3,0";
+    QTest::newRow("set same type overlapping")
+            << "var i = new Int16Array([1, 2, 3, 4]); i.set(i.subarray(0, 3), 1);"
+               "Array.from(i).join()"
+            << "1,1,2,3";
+    QTest::newRow("set packed array")
+            << "var i = new Int16Array(4); i.set([1, 2.5, -70000], 1); Array.from(i).join()"
+            << "0,1,2,-4464";
+    QTest::newRow("set array with holes")
+            << "var a = [1, , 3]; var i = new Float32Array(3); i.set(a); Array.from(i).join()"
+            << "1,NaN,3";
+    QTest::newRow("fill") << "Array.from(new Int16Array(5).fill(70000, 1, 4)).join()"
+                          << "0,4464,4464,4464,0";
+    QTest::newRow("fill clamped") << "Array.from(new Uint8ClampedArray(3).fill(2.5)).join()"
+                                  << "2,2,2";
+    QTest::newRow("indexOf") << "new Int16Array([5, 6, 7, 6]).indexOf(6)" << "1";
+    QTest::newRow("indexOf fromIndex") << "new Int16Array([5, 6, 7, 6]).indexOf(6, 2)" << "3";
+    QTest::newRow("indexOf negative fromIndex")
+            << "new Int16Array([5, 6, 7, 6]).indexOf(5, -3)" << "-1";
+    QTest::newRow("indexOf out of range") << "new Int8Array([1, -128]).indexOf(384)" << "-1";
+    QTest::newRow("indexOf fraction") << "new Int32Array([1, 2]).indexOf(1.5)" << "-1";
+    QTest::newRow("indexOf string") << "new Int32Array([1, 2]).indexOf('2')" << "-1";
+    QTest::newRow("indexOf float") << "new Float32Array([0.5, 0.1]).indexOf(0.5)" << "0";
+    QTest::newRow("indexOf inexact float") << "new Float32Array([0.5, 0.1]).indexOf(0.1)" << "-1";
+    QTest::newRow("indexOf NaN") << "new Float64Array([NaN]).indexOf(NaN)" << "-1";
+    QTest::newRow("indexOf zero") << "new Float64Array([1, -0]).indexOf(0)" << "1";
+    QTest::newRow("reverse") << "Array.from(new Float64Array([1, 2, 3.5]).reverse()).join()"
+                             << "3.5,2,1";
+    QTest::newRow("reverse subarray")
+            << "var i = new Int16Array([1, 2, 3, 4, 5]); i.subarray(1, 4).reverse();"
+               "Array.from(i).join()"
+            << "1,4,3,2,5";
+    QTest::newRow("slice") << "Array.from(new Int16Array([1, 2, 3, 4]).slice(1, 3)).join()"
+                           << "2,3";
+    QTest::newRow("slice species")
+            << "class F extends Float32Array { static get [Symbol.species]() { return Int8Array; } }"
+               "Array.from(new F([1.5, 300, -2]).slice(0)).join()"
+            << "1,44,-2";
+}
+
+void tst_QJSEngine::typedArrayBulkOperations()
+{
+    QFETCH(QString, program);
+    QFETCH(QString, expected);
+
+    QJSEngine engine;
+    const QJSValue result = engine.evaluate(program);
+    QVERIFY2(!result.isError(), qPrintable(result.toString()));
+    QCOMPARE(result.toString(), expected);
+}
+
+void tst_QJSEngine::fusedInstructions_data()
+{
+    QTest::addColumn<QString>("body");
+    QTest::addColumn<QString>("expected");
+
+    QTest::newRow("lookup from register")
+            << "var o = {a: {b: 3}}; var x = o.a; var y = x.b; return y + x.b;" << "6";
+    QTest::newRow("lookup on null")
+            << "var o = null; try { return o.x; } catch (e) { return e.message; }"
+            << "Cannot read property 'x' of null";
+    QTest::newRow("compare NaN and jump")
+            << "var n = NaN; var r = []; if (n < 1) r.push('lt'); if (!(n >= 1)) r.push('notge');"
+               "while (n <= 1) { r.push('le'); break; } return r.join();"
+            << "notge";
+    QTest::newRow("loop") << "var s = 0; for (var i = 0; i < 10; ++i) s += i; return s;" << "45";
+    QTest::newRow("comparison result in accumulator")
+            << "var a = 1, b = 2; var c = a < b || 'no'; var d = a > b && 'yes';"
+               "return c + ',' + d;"
+            << "true,false";
+    QTest::newRow("strict equality and jump")
+            << "var a = 1, b = '1'; return (a === b ? 'eq' : 'ne') + (a !== b ? 'ne' : 'eq');"
+            << "nene";
+    QTest::newRow("strict equality NaN") << "var n = NaN; return n === n ? 'eq' : 'ne';" << "ne";
+    QTest::newRow("add int")
+            << "var a = 2147483647, s = 'x', b = true, u, d = 0.5, n = null;"
+               "return [a + 1, s + 1, b + 1, u + 1, d + 1, n + 1].join();"
+            << "2147483648,x1,2,NaN,1.5,1";
+    QTest::newRow("add constant")
+            << "var v = 2, w = 1.5; return (v + ' px') + ',' + (w + 0.25);" << "2 px,1.75";
+    QTest::newRow("compare objects and jump")
+            << "var o = { valueOf: function() { return 5; } }; var k = 4;"
+               "return (k < o ? 'y' : 'n') + (k >= o ? 'y' : 'n');"
+            << "yn";
+}
+
+void tst_QJSEngine::fusedInstructions()
+{
+    QFETCH(QString, body);
+    QFETCH(QString, expected);
+
+    QJSEngine engine;
+    QJSValue function = engine.evaluate(QStringLiteral("(function() { %1 })").arg(body));
+    QVERIFY(function.isCallable());
+
+    // Call it often enough to also run the JIT-compiled code, where available.
+    for (int i = 0; i < 5; ++i) {
+        const QJSValue result = function.call();
+        QVERIFY2(!result.isError(), qPrintable(result.toString()));
+        QCOMPARE(result.toString(), expected);
+    }
+}
+
 void tst_QJSEngine::dataViewCtor()
 {
     QJSEngine engine;
@@ -6083,6 +6586,213 @@ void tst_QJSEngine::spreadNoOverflow()
     QCOMPARE(result.errorType(), QJSValue::RangeError);
 }
 
+void tst_QJSEngine::mapAndSetWithManyEntries()
+{
+    QJSEngine engine;
+
+    const QString program = uR"(
+        const m = new Map;
+        for (let i = 0; i < 1000; ++i)
+            m.set(i, 'v' + i);
+        m.set(-0, 'zero');
+        m.set(1.0, 'one');
+        m.set('1', 'string one');
+        m.set(NaN, 'nan');
+
+        let ok = m.size === 1002
+            && m.get(0) === 'zero'
+            && m.get(1) === 'one'
+            && m.get('1') === 'string one'
+            && m.get(NaN) === 'nan'
+            && m.get(999.0) === 'v999'
+            && !m.has(1000);
+
+        // Deleting entries while iterating must neither skip nor repeat the others.
+        let visited = 0;
+        for (const [k, v] of m) {
+            if (typeof k === 'number' && k < 1000 && k % 2 === 0)
+                m.delete(k + 1);
+            ++visited;
+        }
+        ok = ok && visited === 502 && m.size === 502 && !m.has(3) && m.has(4);
+
+        // Refill the holes, which compacts the table, and verify the order.
+        for (let i = 0; i < 2000; ++i)
+            m.set('k' + i, i);
+        let previous = -1;
+        for (const [k, v] of m) {
+            if (typeof k === 'string' && k.startsWith('k')) {
+                ok = ok && v === previous + 1;
+                previous = v;
+            }
+        }
+
+        const s = new Set([1, 2, 3, 2, 1]);
+        s.delete(2);
+        ok && previous === 1999 && s.size === 2 && [...s].join() === '1,3';
+    )"_s;
+
+    const QJSValue result = engine.evaluate(program);
+    QVERIFY2(!result.isError(), qPrintable(result.toString()));
+    QVERIFY(result.toBool());
+}
+
+void tst_QJSEngine::mapWithQObjectKeys()
+{
+    QJSEngine engine;
+
+    QObject parent;
+    QJSValue objects = engine.newArray(100);
+    for (int i = 0; i < 100; ++i) {
+        QObject *object = new QObject(&parent);
+        object->setObjectName(QString::number(i));
+        objects.setProperty(i, engine.newQObject(object));
+    }
+    engine.globalObject().setProperty("objects", objects);
+
+    const QJSValue result = engine.evaluate(uR"(
+        var m = new Map;
+        for (const o of objects)
+            m.set(o, o.objectName);
+        var s = new Set(objects);
+        s.delete(objects[1]);
+
+        let ok = m.size === 100 && s.size === 99 && !s.has(objects[1]);
+        for (let i = 0; i < objects.length; ++i)
+            ok = ok && m.get(objects[i]) === String(i) && (i === 1 || s.has(objects[i]));
+        ok;
+    )"_s);
+    QVERIFY2(!result.isError(), qPrintable(result.toString()));
+    QVERIFY(result.toBool());
+
+    // Entries stay reachable after the object is gone.
+    delete objects.property(5).toQObject();
+    const QJSValue afterDelete = engine.evaluate(uR"(
+        m.has(objects[5]) && s.has(objects[5]) && m.delete(objects[5]) && s.delete(objects[5])
+            && m.size === 99 && s.size === 98 && !m.has(objects[5]) && m.get(objects[6]) === "6";
+    )"_s);
+    QVERIFY2(!afterDelete.isError(), qPrintable(afterDelete.toString()));
+    QVERIFY(afterDelete.toBool());
+}
+
+void tst_QJSEngine::polymorphicLookups()
+{
+    QJSEngine engine;
+
+    const QString program = uR"(
+        // Objects with the property in different places, all going through the same lookups.
+        const proto = { x: 100 };
+        const accessorProto = { get x() { return 1000; } };
+        const shapes = [
+            () => ({ x: 1 }),
+            () => ({ a: 0, x: 2 }),
+            () => ({ a: 0, b: 0, x: 3 }),
+            () => { const o = { a: 0, b: 0, c: 0, d: 0, e: 0 }; o.x = 4; return o; },
+            () => { const o = Object.create(proto); o.a = 0; return o; },
+            () => ({ a: 0, get x() { return 6; } }),
+            () => { const o = Object.create(accessorProto); o.b = 0; return o; },
+            () => ({ b: 0, x: 8 }),
+            () => ({ c: 0, x: 9 }),
+            () => ({ d: 0, x: 10 }),
+        ];
+
+        function get(o) { return o.x; }
+        function set(o, v) { o.x = v; }
+
+        let ok = true;
+        for (let n = 1; n <= shapes.length; ++n) {
+            let sum = 0;
+            for (let round = 0; round < 3; ++round) {
+                for (let i = 0; i < n; ++i)
+                    sum += get(shapes[i]());
+            }
+            let expected = 0;
+            for (let i = 0; i < n; ++i)
+                expected += [1, 2, 3, 4, 100, 6, 1000, 8, 9, 10][i];
+            ok = ok && sum === 3 * expected;
+        }
+
+        // Primitives and missing properties don't confuse the cache.
+        ok = ok && get(5) === undefined && get({}) === undefined && get(shapes[1]()) === 2;
+
+        const writable = [0, 1, 2, 3, 7, 8, 9].map(i => shapes[i]());
+        for (let round = 0; round < 3; ++round) {
+            for (let i = 0; i < writable.length; ++i)
+                set(writable[i], round * 10 + i);
+        }
+        for (let i = 0; i < writable.length; ++i)
+            ok = ok && writable[i].x === 20 + i;
+
+        // Assigning to an inherited property creates an own one.
+        const inheriting = shapes[4]();
+        set(inheriting, 42);
+        ok && inheriting.x === 42 && proto.x === 100;
+    )"_s;
+
+    const QJSValue result = engine.evaluate(program);
+    QVERIFY2(!result.isError(), qPrintable(result.toString()));
+    QVERIFY(result.toBool());
+}
+
+void tst_QJSEngine::latin1Strings()
+{
+    QJSEngine engine;
+    QV4::ExecutionEngine *v4 = engine.handle();
+    QV4::Scope scope(v4);
+
+    const QString text = QStringLiteral("caf\u00e9 au lait");
+    QV4::ScopedString utf16(scope, v4->newString(text));
+    QV4::ScopedString latin1(scope, v4->newString(QLatin1StringView("caf\xe9 au lait")));
+    QVERIFY(!utf16->d()->isLatin1());
+    QVERIFY(latin1->d()->isLatin1());
+    QCOMPARE(latin1->d()->length(), text.size());
+    QCOMPARE(latin1->hashValue(), utf16->hashValue());
+    QVERIFY(latin1->isEqualTo(utf16));
+    QVERIFY(utf16->isEqualTo(latin1));
+    QVERIFY(latin1->d()->isLatin1());
+
+    // Only strings nobody else refers to are compacted.
+    QString detached = text;
+    detached.detach();
+    QVERIFY(v4->newCompactString(detached)->isLatin1());
+    QVERIFY(!v4->newCompactString(QStringLiteral("shared"))->isLatin1());
+    QVERIFY(!v4->newCompactString(QStringLiteral("\u0100 wide").toLower())->isLatin1());
+
+    // Identifiers are found no matter how they are stored.
+    QCOMPARE(v4->identifierTable->insertString(QLatin1StringView("caf\xe9 au lait")),
+             v4->identifierTable->insertString(text));
+    QCOMPARE(latin1->toPropertyKey(), utf16->toPropertyKey());
+
+    // Concatenating Latin-1 strings results in Latin-1 text.
+    QV4::ScopedString added(scope, v4->memoryManager->alloc<QV4::ComplexString>(
+                                           latin1->d(), latin1->d()));
+    QCOMPARE(added->d()->length(), 2 * text.size());
+    added->hashValue(); // simplifies the string
+    QVERIFY(added->d()->isLatin1());
+    QCOMPARE(added->toQString(), text + text);
+
+    // Converting to QString switches to UTF-16 for good.
+    QCOMPARE(latin1->toQString(), text);
+    QVERIFY(!latin1->d()->isLatin1());
+    QVERIFY(latin1->isEqualTo(utf16));
+
+    const QString program = uR"(
+        const parsed = JSON.parse('[{"name": "caf\u00e9", "n": 1}, {"name": "\u0100", "n": 2}]');
+        let ok = parsed[0].name === "caf\u00e9" && parsed[1].name === "\u0100"
+            && parsed[0].n + parsed[1].n === 3;
+        const joined = parsed[0].name + "-" + parsed[1].name;
+        ok = ok && joined.length === 6 && joined.substring(0, 4) === "caf\u00e9"
+            && ("x" + parsed[0].name).slice(1) === parsed[0].name;
+        const o = {};
+        o[parsed[0].name] = 5;
+        ok && o["caf\u00e9"] === 5 && Object.keys(parsed[1])[0] === "name";
+    )"_s;
+
+    const QJSValue result = engine.evaluate(program);
+    QVERIFY2(!result.isError(), qPrintable(result.toString()));
+    QVERIFY(result.toBool());
+}
+
 QTEST_MAIN(tst_QJSEngine)
 
 #include "tst_qjsengine.moc"
@@ -2,6 +2,8 @@
 // SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only WITH Qt-GPL-exception-1.0
 #include <QtTest/QtTest>
 #include <QtQml/QtQml>
+#include <QtQml/private/qjsvalue_p.h>
+#include <QtQml/private/qv4jsonobject_p.h>
 #include <QtQuickTestUtils/private/qmlutils_p.h>
 
 Q_DECLARE_METATYPE(QJsonValue::Type)
@@ -55,6 +57,14 @@ private slots:
     void cyclicStringify();
     void recursiveStringify();
 
+    void parse_data();
+    void parse();
+    void parseObjectsWithSameKeys();
+
+    void stringify_data();
+    void stringify();
+    void stringifyToUtf8();
+
 private:
     QByteArray readAsUtf8(const QString &fileName);
     static QJsonValue valueFromJson(const QByteArray &json);
@@ -529,6 +539,174 @@ void tst_qjsonbinding::recursiveStringify()
     QVERIFY(result.toString().contains(QLatin1String("Maximum call stack size exceeded")));
 }
 
+void tst_qjsonbinding::parse_data()
+{
+    QTest::addColumn<QString>("json");
+    QTest::addColumn<QString>("expected");
+
+    // Longer than a vector, so that both the vectorized and the scalar scanning are used.
+    const QString text = QStringLiteral("abcdefghijklmnopqrstuvwxyz0123456789");
+
+    QTest::newRow("long string") << (u'"' + text + u'"') << (u'"' + text + u'"');
+    QTest::newRow("escape after long run")
+            << QStringLiteral("\"%1\\n%1\\u00e9\\\"\"").arg(text)
+            << QStringLiteral("\"%1\\n%1é\\\"\"").arg(text);
+    QTest::newRow("surrogate pair")
+            << QStringLiteral("\"%1\\ud83d\\ude00\"").arg(text)
+            << QStringLiteral("\"%1\U0001F600\"").arg(text);
+    QTest::newRow("whitespace")
+            << QStringLiteral("  \n\t\r  [\n                  1 ,\r\n\t\t\t\t\t\t\t\t\t2]    \n")
+            << QStringLiteral("[1,2]");
+    QTest::newRow("integers")
+            << QStringLiteral("[0,-0,7,-7,33554431,-33554431,33554432,99999999,123456789012]")
+            << QStringLiteral("[0,0,7,-7,33554431,-33554431,33554432,99999999,123456789012]");
+    QTest::newRow("fractions")
+            << QStringLiteral("[0.5,-1.25,1e3,2E-2,-3.5e+2]")
+            << QStringLiteral("[0.5,-1.25,1000,0.02,-350]");
+    QTest::newRow("duplicate keys")
+            << QStringLiteral("[{\"a\":1,\"b\":2,\"a\":3},{\"a\":1,\"b\":2,\"a\":3}]")
+            << QStringLiteral("[{\"a\":3,\"b\":2},{\"a\":3,\"b\":2}]");
+    QTest::newRow("index keys")
+            << QStringLiteral("[{\"1\":1,\"b\":2},{\"1\":3,\"b\":4}]")
+            << QStringLiteral("[{\"1\":1,\"b\":2},{\"1\":3,\"b\":4}]");
+    QTest::newRow("__proto__")
+            << QStringLiteral("{\"__proto__\":1}") << QStringLiteral("{\"__proto__\":1}");
+    QTest::newRow("empty objects")
+            << QStringLiteral("[{},{},{\"a\":{}}]") << QStringLiteral("[{},{},{\"a\":{}}]");
+
+    QString members;
+    for (int i = 0; i < 100; ++i)
+        members += QStringLiteral("%1\"k%2\":%2").arg(i ? QStringLiteral(",") : QString()).arg(i);
+    QTest::newRow("many members")
+            << QStringLiteral("[{%1},{%1}]").arg(members)
+            << QStringLiteral("[{%1},{%1}]").arg(members);
+
+    QTest::newRow("control character") << (u'"' + text + u'\t' + u'"') << QString();
+    QTest::newRow("invalid escape") << (u'"' + text + QStringLiteral("\\x\"")) << QString();
+    QTest::newRow("unterminated string") << (u'"' + text) << QString();
+    QTest::newRow("minus") << QStringLiteral("[-]") << QString();
+    QTest::newRow("incomplete exponent") << QStringLiteral("[1e]") << QString();
+    QTest::newRow("unterminated object") << QStringLiteral("{\"a\":1,\"b\":2") << QString();
+}
+
+void tst_qjsonbinding::parse()
+{
+    QFETCH(QString, json);
+    QFETCH(QString, expected);
+
+    QJSEngine e;
+    QJSValue parse = e.evaluate(QStringLiteral(
+            "(function(json) { return JSON.stringify(JSON.parse(json)); })"));
+    QJSValue result = parse.call(QJSValueList() << json);
+    if (expected.isEmpty()) {
+        QVERIFY(result.isError());
+        QCOMPARE(result.errorType(), QJSValue::SyntaxError);
+    } else {
+        QVERIFY(!result.isError());
+        QCOMPARE(result.toString(), expected);
+    }
+}
+
+void tst_qjsonbinding::parseObjectsWithSameKeys()
+{
+    QJSEngine e;
+    const QString program = QStringLiteral(R"(
+        var list = JSON.parse('[{"x":1,"y":"a"},{"y":"b","x":2},{"x":3,"y":"c"},{"x":4}]');
+        list[2].z = 5;
+        var result = [];
+        for (var i = 0; i < list.length; ++i)
+            result.push(Object.keys(list[i]).join(",") + ":" + list[i].x + list[i].y);
+        result.push(list[0].z);
+        result.join(" ");
+    )");
+
+    QJSValue result = e.evaluate(program);
+    QVERIFY(!result.isError());
+    QCOMPARE(result.toString(),
+             QStringLiteral("x,y:1a y,x:2b x,y,z:3c x:4undefined undefined"));
+}
+
+void tst_qjsonbinding::stringify_data()
+{
+    QTest::addColumn<QString>("program");
+    QTest::addColumn<QString>("expected");
+
+    QTest::newRow("same keys")
+            << QStringLiteral("JSON.stringify([{a: 1, b: 'x'}, {a: 2, b: 'y'}, {b: 'z', a: 3}])")
+            << QStringLiteral("[{\"a\":1,\"b\":\"x\"},{\"a\":2,\"b\":\"y\"},{\"b\":\"z\",\"a\":3}]");
+    QTest::newRow("same keys, indented")
+            << QStringLiteral("JSON.stringify([{a: 1, b: [true]}, {a: 2, b: []}, {}], null, 2)")
+            << QStringLiteral("[\n  {\n    \"a\": 1,\n    \"b\": [\n      true\n    ]\n  },\n"
+                              "  {\n    \"a\": 2,\n    \"b\": []\n  },\n  {}\n]");
+    QTest::newRow("skipped members")
+            << QStringLiteral("JSON.stringify([{a: undefined, b: 1, c: function() {}},"
+                              " {a: undefined, b: 2, c: function() {}}])")
+            << QStringLiteral("[{\"b\":1},{\"b\":2}]");
+    QTest::newRow("non-enumerable")
+            << QStringLiteral("var o = {a: 1, b: 2}; Object.defineProperty(o, 'b', {enumerable: false});"
+                              " JSON.stringify([o, {a: 1, b: 2}])")
+            << QStringLiteral("[{\"a\":1},{\"a\":1,\"b\":2}]");
+    QTest::newRow("accessor")
+            << QStringLiteral("JSON.stringify({a: 1, get b() { return this.a + 1; }})")
+            << QStringLiteral("{\"a\":1,\"b\":2}");
+    QTest::newRow("replacer changes holder")
+            << QStringLiteral("var o = {a: 1, b: 2, c: 3};"
+                              " JSON.stringify(o, function(k, v) { if (k === 'a') delete this.b; return v; })")
+            << QStringLiteral("{\"a\":1,\"c\":3}");
+    QTest::newRow("toJSON")
+            << QStringLiteral("JSON.stringify([{a: 1, toJSON: function(k) { return 'k' + k; }}, {a: 2}])")
+            << QStringLiteral("[\"k0\",{\"a\":2}]");
+    QTest::newRow("escapes")
+            << QStringLiteral("JSON.stringify(['abcdefghijklmnopqrstuvwxyz\"\\\\\\n\\u0001\u00e9\u0100'])")
+            << QStringLiteral("[\"abcdefghijklmnopqrstuvwxyz\\\"\\\\\\n\\u0001\u00e9\u0100\"]");
+    QTest::newRow("latin-1 escapes")
+            << QStringLiteral("JSON.stringify(['a\\tb\"c\\\\d\u00e9'])")
+            << QStringLiteral("[\"a\\tb\\\"c\\\\d\u00e9\"]");
+    QTest::newRow("numbers")
+            << QStringLiteral("JSON.stringify([0, -1, 2147483647, 0.5, NaN, Infinity])")
+            << QStringLiteral("[0,-1,2147483647,0.5,null,null]");
+}
+
+void tst_qjsonbinding::stringify()
+{
+    QFETCH(QString, program);
+    QFETCH(QString, expected);
+
+    QJSEngine e;
+    QJSValue result = e.evaluate(program);
+    QVERIFY(!result.isError());
+    QCOMPARE(result.toString(), expected);
+}
+
+void tst_qjsonbinding::stringifyToUtf8()
+{
+    QJSEngine e;
+    QJSValue value = e.evaluate(QStringLiteral(R"(
+        var list = [];
+        for (var i = 0; i < 10000; ++i)
+            list.push({ id: i, name: "caf\u00e9 \u263a " + i, tags: ["a", "b"] });
+        list;
+    )"));
+    QVERIFY(value.isArray());
+
+    QV4::ExecutionEngine *v4 = e.handle();
+    QV4::Scope scope(v4);
+    QV4::ScopedValue v(scope, QJSValuePrivate::convertToReturnedValue(v4, value));
+    const QString expected = e.evaluate(QStringLiteral("JSON.stringify(list, null, 1)")).toString();
+
+    QByteArray utf8("prefix");
+    QVERIFY(QV4::JsonObject::stringify(v4, v, &utf8, QStringLiteral(" ")));
+    QCOMPARE(utf8, "prefix" + expected.toUtf8());
+
+    QBuffer buffer;
+    QVERIFY(buffer.open(QIODevice::WriteOnly));
+    QVERIFY(QV4::JsonObject::stringify(v4, v, &buffer, QStringLiteral(" ")));
+    QCOMPARE(buffer.data(), expected.toUtf8());
+
+    v = QV4::Encode::undefined();
+    QVERIFY(!QV4::JsonObject::stringify(v4, v, &utf8));
+}
+
 QTEST_MAIN(tst_qjsonbinding)
 
 #include "tst_qjsonbinding.moc"
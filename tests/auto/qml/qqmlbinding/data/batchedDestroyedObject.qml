@@ -0,0 +1,9 @@
+import QtQml
+
+QtObject {
+    id: root
+    property int value: 0
+    property QtObject child: QtObject {
+        property int doubled: root.value * 2
+    }
+}
@@ -0,0 +1,13 @@
+import QtQml
+
+QtObject {
+    property int value: 0
+
+    property int a: value + 1
+    property int b: value + 2
+    property int c: value + 3
+    property int d: value + 4
+
+    property int sum: a + b + c + d
+    property int result: sum * 2 + a
+}
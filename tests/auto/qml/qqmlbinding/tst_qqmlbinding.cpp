@@ -4,7 +4,9 @@
 #include <QtQml/qqmlengine.h>
 #include <QtQml/qqmlcomponent.h>
 #include <QtQml/private/qqmlbind_p.h>
+#include <QtQml/private/qqmlbindingscheduler_p.h>
 #include <QtQml/private/qqmlcomponentattached_p.h>
+#include <QtQml/private/qqmlengine_p.h>
 #include <QtQuick/private/qquickrectangle_p.h>
 #include <QtQuickTestUtils/private/qmlutils_p.h>
 #include "WithBindableProperties.h"
@@ -38,6 +40,9 @@ private slots:
     void intOverflow();
     void generalizedGroupedProperties();
     void localSignalHandler();
+    void batchedDiamond();
+    void batchedBindingLoop();
+    void batchedDestroyedObject();
 
 private:
     QQmlEngine engine;
@@ -596,6 +601,75 @@ void tst_qqmlbinding::localSignalHandler()
     QCOMPARE(o->property("output").toString(), QStringLiteral("abc"));
 }
 
+void tst_qqmlbinding::batchedDiamond()
+{
+    QQmlEngine e;
+    QQmlEnginePrivate::get(&e)->setBatchedBindingUpdates(true);
+    QQmlBindingScheduler *scheduler = QQmlEnginePrivate::get(&e)->bindingScheduler;
+    QVERIFY(scheduler);
+
+    QQmlComponent c(&e, testFileUrl("batchedDiamond.qml"));
+    QVERIFY2(c.isReady(), qPrintable(c.errorString()));
+    QScopedPointer<QObject> o(c.create());
+    QVERIFY(!o.isNull());
+    QVERIFY(!scheduler->hasPendingBindings());
+    QCOMPARE(o->property("result").toInt(), 21);
+
+    for (int value = 1; value <= 2; ++value) {
+        const quint64 evaluations = scheduler->statistics().evaluations;
+
+        o->setProperty("value", value);
+        QVERIFY(scheduler->hasPendingBindings());
+        QCOMPARE(o->property("result").toInt(), value == 1 ? 21 : 30);
+
+        // a, b, c and d, then sum, then result, each of them once.
+        scheduler->flush();
+        QVERIFY(!scheduler->hasPendingBindings());
+        QCOMPARE(scheduler->statistics().evaluations - evaluations, quint64(6));
+        QCOMPARE(o->property("sum").toInt(), 10 + 4 * value);
+        QCOMPARE(o->property("result").toInt(), 2 * (10 + 4 * value) + value + 1);
+    }
+}
+
+void tst_qqmlbinding::batchedBindingLoop()
+{
+    QQmlEngine e;
+    QQmlEnginePrivate::get(&e)->setBatchedBindingUpdates(true);
+
+    QQmlComponent c(&e, testFileUrl("batchedBindingLoop.qml"));
+    QVERIFY2(c.isReady(), qPrintable(c.errorString()));
+    const QString warning = c.url().toString()
+            + QLatin1String(R"(:\d+:\d+: QML QtObject: Binding loop detected for property "[ab]")");
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression(warning));
+    QScopedPointer<QObject> o(c.create());
+    QVERIFY(!o.isNull());
+    QVERIFY(!QQmlEnginePrivate::get(&e)->bindingScheduler->hasPendingBindings());
+}
+
+void tst_qqmlbinding::batchedDestroyedObject()
+{
+    QQmlEngine e;
+    QQmlEnginePrivate::get(&e)->setBatchedBindingUpdates(true);
+    QQmlBindingScheduler *scheduler = QQmlEnginePrivate::get(&e)->bindingScheduler;
+
+    QQmlComponent c(&e, testFileUrl("batchedDestroyedObject.qml"));
+    QVERIFY2(c.isReady(), qPrintable(c.errorString()));
+    QScopedPointer<QObject> o(c.create());
+    QVERIFY(!o.isNull());
+    QObject *child = o->property("child").value<QObject *>();
+    QVERIFY(child);
+
+    const quint64 evaluations = scheduler->statistics().evaluations;
+    o->setProperty("value", 1);
+    QVERIFY(scheduler->hasPendingBindings());
+    delete child;
+
+    // The binding of the deleted object is still queued, but must not be evaluated.
+    scheduler->flush();
+    QVERIFY(!scheduler->hasPendingBindings());
+    QCOMPARE(scheduler->statistics().evaluations, evaluations);
+}
+
 QTEST_MAIN(tst_qqmlbinding)
 
 #include "tst_qqmlbinding.moc"
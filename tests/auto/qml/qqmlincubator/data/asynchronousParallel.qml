@@ -0,0 +1,17 @@
+import Qt.test 1.0
+
+ThreadSafe {
+    value: 42
+    text: "hello"
+    label: "value " + value
+
+    child: ThreadSafe {
+        objectName: "child"
+        value: 7
+        label: "child"
+
+        child: DerivedThreadSafe {
+            value: 11
+        }
+    }
+}
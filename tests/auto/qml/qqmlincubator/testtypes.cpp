@@ -109,6 +109,14 @@ void CompletionCallbackType::registerCallback(callback c, void *d)
     m_data = d;
 }
 
+std::atomic<int> ThreadSafeType::constructed = 0;
+
+ThreadSafeType::ThreadSafeType()
+    : m_constructionThread(QThread::currentThread())
+{
+    ++constructed;
+}
+
 void registerTypes()
 {
     qmlRegisterType<SelfRegisteringType>("Qt.test", 1,0, "SelfRegistering");
@@ -116,4 +124,6 @@ void registerTypes()
     qmlRegisterType<CompletionRegisteringType>("Qt.test", 1,0, "CompletionRegistering");
     qmlRegisterType<CallbackRegisteringType>("Qt.test", 1,0, "CallbackRegistering");
     qmlRegisterType<CompletionCallbackType>("Qt.test", 1,0, "CompletionCallback");
+    qmlRegisterType<ThreadSafeType>("Qt.test", 1,0, "ThreadSafe");
+    qmlRegisterType<DerivedThreadSafeType>("Qt.test", 1,0, "DerivedThreadSafe");
 }
@@ -4,8 +4,11 @@
 #define TESTTYPES_H
 
 #include <QtCore/qobject.h>
+#include <QtCore/qthread.h>
 #include <QQmlParserStatus>
 
+#include <atomic>
+
 class SelfRegisteringType : public QObject
 {
 Q_OBJECT
@@ -103,6 +106,51 @@ private:
     static void *m_data;
 };
 
+class ThreadSafeType : public QObject
+{
+    Q_OBJECT
+    Q_CLASSINFO("QML.ThreadSafeConstruction", "true")
+    Q_PROPERTY(int value READ value WRITE setValue)
+    Q_PROPERTY(QString text READ text WRITE setText)
+    Q_PROPERTY(QString label READ label WRITE setLabel)
+    Q_PROPERTY(QObject *child READ child WRITE setChild)
+public:
+    ThreadSafeType();
+
+    int value() const { return m_value; }
+    void setValue(int v) { m_value = v; m_valueThread = QThread::currentThread(); }
+
+    QString text() const { return m_text; }
+    void setText(const QString &t) { m_text = t; }
+
+    QString label() const { return m_label; }
+    void setLabel(const QString &l) { m_label = l; m_labelThread = QThread::currentThread(); }
+
+    QObject *child() const { return m_child; }
+    void setChild(QObject *c) { m_child = c; }
+
+    QThread *constructionThread() const { return m_constructionThread; }
+    QThread *valueThread() const { return m_valueThread; }
+    QThread *labelThread() const { return m_labelThread; }
+
+    static std::atomic<int> constructed;
+
+private:
+    QThread *m_constructionThread = nullptr;
+    QThread *m_valueThread = nullptr;
+    QThread *m_labelThread = nullptr;
+    int m_value = 0;
+    QString m_text;
+    QString m_label;
+    QObject *m_child = nullptr;
+};
+
+// Does not inherit the class info.
+class DerivedThreadSafeType : public ThreadSafeType
+{
+    Q_OBJECT
+};
+
 void registerTypes();
 
 #endif // TESTTYPES_H
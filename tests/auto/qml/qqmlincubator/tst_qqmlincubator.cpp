@@ -7,6 +7,7 @@
 #include <QDebug>
 #include <qtest.h>
 #include <QPointer>
+#include <QThread>
 #include <QFileInfo>
 #include <QQmlEngine>
 #include <QQmlContext>
@@ -47,6 +48,7 @@ private slots:
     void garbageCollection();
     void requiredProperties();
     void deleteInSetInitialState();
+    void asynchronousParallel();
 
 private:
     QQmlIncubationController controller;
@@ -1240,6 +1242,54 @@ void tst_qqmlincubator::deleteInSetInitialState()
     QCOMPARE(incubator.object(), nullptr); // object was deleted
 }
 
+void tst_qqmlincubator::asynchronousParallel()
+{
+    QQmlComponent component(&engine, testFileUrl("asynchronousParallel.qml"));
+    QVERIFY(component.isReady());
+
+    ThreadSafeType::constructed = 0;
+    QQmlIncubator incubator(QQmlIncubator::AsynchronousParallel);
+    QCOMPARE(incubator.incubationMode(), QQmlIncubator::AsynchronousParallel);
+    component.create(incubator);
+    QVERIFY(incubator.isLoading());
+
+    // The two ThreadSafe objects are built while the incubator waits for the controller.
+    QTRY_COMPARE(ThreadSafeType::constructed.load(), 2);
+    QVERIFY(incubator.isLoading());
+
+    incubator.forceCompletion();
+    QVERIFY(incubator.isReady());
+    QCOMPARE(ThreadSafeType::constructed.load(), 3);
+
+    QScopedPointer<QObject> object(incubator.object());
+    ThreadSafeType *root = qobject_cast<ThreadSafeType *>(object.data());
+    QVERIFY(root);
+    QThread *engineThread = QThread::currentThread();
+    QCOMPARE(root->thread(), engineThread);
+    QVERIFY(root->constructionThread() != engineThread);
+    QVERIFY(root->valueThread() != engineThread);
+    QCOMPARE(root->labelThread(), engineThread);
+    QCOMPARE(root->value(), 42);
+    QCOMPARE(root->text(), QStringLiteral("hello"));
+    QCOMPARE(root->label(), QStringLiteral("value 42"));
+
+    ThreadSafeType *child = qobject_cast<ThreadSafeType *>(root->child());
+    QVERIFY(child);
+    QCOMPARE(child->thread(), engineThread);
+    QCOMPARE(child->parent(), root);
+    QVERIFY(child->constructionThread() != engineThread);
+    QVERIFY(child->labelThread() != engineThread);
+    QCOMPARE(child->objectName(), QStringLiteral("child"));
+    QCOMPARE(child->value(), 7);
+    QCOMPARE(child->label(), QStringLiteral("child"));
+
+    DerivedThreadSafeType *derived = qobject_cast<DerivedThreadSafeType *>(child->child());
+    QVERIFY(derived);
+    QCOMPARE(derived->constructionThread(), engineThread);
+    QCOMPARE(derived->valueThread(), engineThread);
+    QCOMPARE(derived->value(), 11);
+}
+
 QTEST_MAIN(tst_qqmlincubator)
 
 #include "tst_qqmlincubator.moc"
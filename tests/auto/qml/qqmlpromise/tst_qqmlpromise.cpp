@@ -48,6 +48,8 @@ private slots:
     void then_resolve_multiple_then();
     void promiseChain();
     void promiseHandlerThrows();
+    void reactionOrder();
+    void reactionsRunInOneBatch();
 
 private:
     void execute_test(QString testName);
@@ -261,6 +263,44 @@ void tst_qqmlpromise::promiseHandlerThrows()
     QTRY_VERIFY(root->property("errorMessage") == QLatin1String("Some error"));
 }
 
+void tst_qqmlpromise::reactionOrder()
+{
+    QJSEngine engine;
+    QJSValue log = engine.evaluate(QStringLiteral(R"(
+        var log = [];
+        var p1 = Promise.resolve(1);
+        var p2 = Promise.resolve(2);
+        p1.then(function() { log.push("a"); }).then(function() { log.push("c"); });
+        p2.then(function() { log.push("b"); }).then(function() { log.push("d"); });
+        p1.then(function() { return p2; }).then(function() { log.push("e"); });
+        log.push("sync");
+        log;
+    )"));
+    QVERIFY(log.isArray());
+    QCOMPARE(log.property(0).toString(), QStringLiteral("sync"));
+    QTRY_COMPARE(log.property(QStringLiteral("length")).toInt(), 6);
+    QCOMPARE(engine.evaluate(QStringLiteral("log.join()")).toString(),
+             QStringLiteral("sync,a,b,c,d,e"));
+}
+
+void tst_qqmlpromise::reactionsRunInOneBatch()
+{
+    QJSEngine engine;
+    QJSValue result = engine.evaluate(QStringLiteral(R"(
+        var result = { value: 0 };
+        var p = Promise.resolve(0);
+        for (var i = 0; i < 10000; ++i)
+            p = p.then(function(v) { return v + 1; });
+        p.then(function(v) { result.value = v; });
+        result;
+    )"));
+    QCOMPARE(result.property(QStringLiteral("value")).toInt(), 0);
+
+    // All reactions, including the ones queued by other reactions, are run once the
+    // single pending event is delivered.
+    QCoreApplication::sendPostedEvents();
+    QCOMPARE(result.property(QStringLiteral("value")).toInt(), 10000);
+}
 
 QTEST_MAIN(tst_qqmlpromise)
 
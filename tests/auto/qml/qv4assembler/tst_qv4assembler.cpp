@@ -5,7 +5,9 @@
 #if QT_CONFIG(process)
 #include <QtCore/qprocess.h>
 #endif
+#include <QtCore/qtemporarydir.h>
 #include <QtCore/qtemporaryfile.h>
+#include <QtQml/qjsengine.h>
 #include <QtQml/qqml.h>
 #include <QtQml/qqmlapplicationengine.h>
 #include <QtQuickTestUtils/private/qmlutils_p.h>
@@ -28,6 +30,9 @@ private slots:
     void perfMapFile();
     void functionTable();
     void jitEnabled();
+    void optimizingJit();
+    void optimizedLookups();
+    void codeCache();
 };
 
 tst_QV4Assembler::tst_QV4Assembler()
@@ -38,6 +43,7 @@ tst_QV4Assembler::tst_QV4Assembler()
 void tst_QV4Assembler::initTestCase()
 {
     qputenv("QV4_JIT_CALL_THRESHOLD", "0");
+    qputenv("QV4_JIT_OPTIMIZE_THRESHOLD", "0");
     QQmlDataTest::initTestCase();
 }
 
@@ -143,6 +149,159 @@ void tst_QV4Assembler::jitEnabled()
 #endif
 }
 
+void tst_QV4Assembler::optimizingJit()
+{
+    // The function with the try/finally block is never optimized. The other one is, and has to
+    // deoptimize once it sees operands that are not numbers.
+    QJSEngine engine;
+    const QJSValue result = engine.evaluate(R"(
+        function optimized(a, b) {
+            var r = 0;
+            for (var i = 0; i < 8; ++i)
+                r = r + a * b - i / 2;
+            return r > a ? r : a - 1;
+        }
+        function reference(a, b) {
+            try {
+                var r = 0;
+                for (var i = 0; i < 8; ++i)
+                    r = r + a * b - i / 2;
+                return r > a ? r : a - 1;
+            } finally {}
+        }
+        var mismatches = [];
+        function check(args) {
+            for (var j = 0; j < args.length; ++j) {
+                var expected = reference(args[j][0], args[j][1]);
+                var actual = optimized(args[j][0], args[j][1]);
+                if (!Object.is(expected, actual))
+                    mismatches.push(j + ": " + actual + " != " + expected);
+            }
+        }
+        for (var i = 0; i < 20; ++i)
+            check([[1, 2], [3, 0.5], [2147483647, 2], [-0.25, NaN], [1e300, 1e300], [0, -1]]);
+        check([["3", 2], [{ valueOf: function() { return 4; } }, 1], [true, null], ["a", "b"]]);
+        check([[1, 2], [3, 0.5]]);
+        mismatches.join("; ");
+    )");
+    QVERIFY2(!result.isError(), qPrintable(result.toString()));
+    QCOMPARE(result.toString(), QString());
+}
+
+void tst_QV4Assembler::optimizedLookups()
+{
+    // Each eval() creates a function with its own lookups. The first one is optimized while
+    // reading inline properties, the second one while reading properties from the member data.
+    // Both have to keep working when the objects change.
+    QJSEngine engine;
+    const QJSValue result = engine.evaluate(R"(
+        function make(body) { return eval("(function(o) { " + body + " })"); }
+        var body = "var x = o.x; var y = o.y; return x + y;";
+        var reference = make("try { " + body + " } finally {}");
+        var mismatches = [];
+        function check(name, optimized, objects) {
+            for (var j = 0; j < objects.length; ++j) {
+                var expected;
+                var actual;
+                try { expected = reference(objects[j]); } catch (e) { expected = e.name; }
+                try { actual = optimized(objects[j]); } catch (e) { actual = e.name; }
+                if (!Object.is(expected, actual))
+                    mismatches.push(name + " " + j + ": " + actual + " != " + expected);
+            }
+        }
+        function big(x, y) {
+            var o = {};
+            for (var k = 0; k < 32; ++k)
+                o["p" + k] = k;
+            o.x = x;
+            o.y = y;
+            return o;
+        }
+        var deleted = { x: 1, y: 2 };
+        delete deleted.x;
+        var changed = [{ x: 1, y: 2 }, big(3, 4), { y: 1, x: 2 }, { x: 1 }, deleted,
+                       { get x() { return 7; }, y: 1 }, Object.create({ x: 3, y: 4 }),
+                       "xy", 5, true, null, undefined];
+
+        var inlineRead = make(body);
+        for (var i = 0; i < 20; ++i)
+            check("inline", inlineRead, [{ x: i, y: 2 }, { x: 0.5, y: i }]);
+        check("inline", inlineRead, changed);
+
+        var memberDataRead = make(body);
+        for (var i = 0; i < 20; ++i)
+            check("memberData", memberDataRead, [big(i, 2), big(0.5, i)]);
+        check("memberData", memberDataRead, changed);
+
+        mismatches.join("; ");
+    )");
+    QVERIFY2(!result.isError(), qPrintable(result.toString()));
+    QCOMPARE(result.toString(), QString());
+}
+
+void tst_QV4Assembler::codeCache()
+{
+#if !QT_CONFIG(process)
+    QSKIP("Depends on QProcess");
+#elif !defined(Q_PROCESSOR_X86_64)
+    QSKIP("The JIT code cache is only available on x86_64");
+#else
+    const QString qmljs = QLibraryInfo::path(QLibraryInfo::BinariesPath) + "/qmljs";
+
+    QTemporaryDir cacheDir;
+    QVERIFY(cacheDir.isValid());
+    const QString script = cacheDir.filePath("script.mjs");
+
+    const auto writeScript = [&](const QByteArray &result) {
+        QFile file(script);
+        QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+        file.write("function fib(n) { return n < 2 ? n : fib(n - 1) + fib(n - 2); }\n"
+                   "function safeFib(n) { try { return fib(n); } catch (e) { return -1; } }\n"
+                   "console.log(\"result: \" + " + result + ");\n");
+    };
+
+    const auto run = [&]() {
+        QProcessEnvironment environment = QProcessEnvironment::systemEnvironment();
+        environment.insert("QML_DISK_CACHE", "jit");
+        environment.insert("QML_DISK_CACHE_PATH", cacheDir.path());
+        environment.insert("QV4_JIT_CALL_THRESHOLD", "0");
+        environment.insert("QT_LOGGING_RULES", "qt.qml.diskcache.debug=true");
+
+        QProcess process;
+        process.setProcessEnvironment(environment);
+        process.start(qmljs, QStringList({ "--module", script }));
+        if (!process.waitForFinished() || process.exitCode() != 0)
+            return QByteArray();
+        return process.readAllStandardError();
+    };
+
+    const auto cacheFiles = [&]() {
+        return QDir(cacheDir.path()).entryList({ "*.jit" }, QDir::Files);
+    };
+
+    writeScript("fib(20) + safeFib(10)");
+
+    // Nothing to load in the first run, but the code is saved afterwards.
+    QByteArray output = run();
+    QVERIFY(output.contains("result: 6820"));
+    QVERIFY(!output.contains("from JIT code cache"));
+    QCOMPARE(cacheFiles().size(), 1);
+
+    // The second run uses the cached code, including the exception handler, and gets the same
+    // result.
+    output = run();
+    QVERIFY(output.contains("result: 6820"));
+    QVERIFY2(output.contains("functions from JIT code cache"), output.constData());
+    QVERIFY(!output.contains("Loaded 0 functions"));
+
+    // A changed script doesn't use the stale code.
+    writeScript("fib(15) + safeFib(5)");
+    output = run();
+    QVERIFY(output.contains("result: 615"));
+    QVERIFY(output.contains("Ignoring stale JIT code cache"));
+#endif
+}
+
 QTEST_MAIN(tst_QV4Assembler)
 
 #include "tst_qv4assembler.moc"
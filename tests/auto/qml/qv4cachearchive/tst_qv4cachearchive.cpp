@@ -0,0 +1,182 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only WITH Qt-GPL-exception-1.0
+
+#include <qtest.h>
+#include <QtCore/qdir.h>
+#include <QtCore/qlibraryinfo.h>
+#include <QtCore/qprocess.h>
+#include <QtCore/qtemporarydir.h>
+#include <QtQml/qqmlcomponent.h>
+#include <QtQml/qqmlengine.h>
+#include <private/qv4cachearchive_p.h>
+#include <private/qv4compileddata_p.h>
+
+class tst_qv4cachearchive : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void findUnit();
+    void loadFromArchive();
+    void archivedUnitLocation();
+    void rejectInvalidArchive();
+
+private:
+    bool writeFile(const QString &fileName, const QByteArray &contents);
+    QTemporaryDir tempDir;
+};
+
+bool tst_qv4cachearchive::writeFile(const QString &fileName, const QByteArray &contents)
+{
+    QFile file(fileName);
+    return file.open(QIODevice::WriteOnly | QIODevice::Truncate)
+            && file.write(contents) == contents.size();
+}
+
+void tst_qv4cachearchive::initTestCase()
+{
+    QVERIFY(tempDir.isValid());
+    QVERIFY(QDir(tempDir.path()).mkpath(QStringLiteral("app/Controls")));
+    QVERIFY(QDir(tempDir.path()).mkpath(QStringLiteral("cache")));
+
+    const QString appDir = tempDir.filePath(QStringLiteral("app"));
+    QVERIFY(writeFile(appDir + QLatin1String("/main.qml"),
+                      "import QtQml\n"
+                      "import \"Controls\"\n"
+                      "import \"helper.js\" as Helper\n"
+                      "Button {\n"
+                      "    property int answer: Helper.answer()\n"
+                      "}\n"));
+    QVERIFY(writeFile(appDir + QLatin1String("/helper.js"),
+                      "function answer() { return 42; }\n"));
+    QVERIFY(writeFile(appDir + QLatin1String("/Controls/Button.qml"),
+                      "import QtQml\n"
+                      "QtObject {\n"
+                      "    property string text: \"archived\"\n"
+                      "}\n"));
+    QVERIFY(writeFile(appDir + QLatin1String("/location.qml"),
+                      "import QtQml\n"
+                      "import \"lib.mjs\" as Lib\n"
+                      "import \"thrower.js\" as Thrower\n"
+                      "QtObject {\n"
+                      "    property int value: Lib.value()\n"
+                      "    property string errorFile\n"
+                      "    property int errorLine\n"
+                      "    Component.onCompleted: {\n"
+                      "        try {\n"
+                      "            Thrower.fail();\n"
+                      "        } catch (e) {\n"
+                      "            errorFile = e.fileName;\n"
+                      "            errorLine = e.lineNumber;\n"
+                      "        }\n"
+                      "    }\n"
+                      "}\n"));
+    QVERIFY(writeFile(appDir + QLatin1String("/lib.mjs"),
+                      "import { answer } from \"./dep.mjs\";\n"
+                      "export function value() { return answer; }\n"));
+    QVERIFY(writeFile(appDir + QLatin1String("/dep.mjs"), "export const answer = 7;\n"));
+    QVERIFY(writeFile(appDir + QLatin1String("/thrower.js"),
+                      "function fail() {\n"
+                      "    throw new Error(\"archived\");\n"
+                      "}\n"));
+
+    QProcess proc;
+    proc.setProcessChannelMode(QProcess::ForwardedChannels);
+    proc.setProgram(QLibraryInfo::path(QLibraryInfo::LibraryExecutablesPath)
+                    + QLatin1String("/qmlcachegen"));
+    proc.setArguments({ QStringLiteral("--cache-archive"),
+                        QStringLiteral("-o"), appDir + QLatin1String("/app.qmlcarchive"),
+                        appDir + QLatin1String("/main.qml"),
+                        appDir + QLatin1String("/helper.js"),
+                        appDir + QLatin1String("/Controls/Button.qml"),
+                        appDir + QLatin1String("/location.qml"),
+                        appDir + QLatin1String("/lib.mjs"),
+                        appDir + QLatin1String("/dep.mjs"),
+                        appDir + QLatin1String("/thrower.js") });
+    proc.start();
+    QVERIFY(proc.waitForFinished());
+    QCOMPARE(proc.exitStatus(), QProcess::NormalExit);
+    QCOMPARE(proc.exitCode(), 0);
+
+    // The archive does not record time stamps. Change the sources, so that we can tell whether
+    // the archived code is used.
+    QVERIFY(writeFile(appDir + QLatin1String("/helper.js"),
+                      "function answer() { return 1; }\n"));
+    QVERIFY(writeFile(appDir + QLatin1String("/Controls/Button.qml"),
+                      "import QtQml\n"
+                      "QtObject {\n"
+                      "    property string text: \"source\"\n"
+                      "}\n"));
+    QVERIFY(writeFile(appDir + QLatin1String("/other.qml"), "import QtQml\nQtObject {}\n"));
+
+    QVERIFY(writeFile(tempDir.filePath(QStringLiteral("invalid.qmlcarchive")), "not an archive"));
+
+    qputenv("QML_DISK_CACHE_PATH", tempDir.filePath(QStringLiteral("cache")).toLocal8Bit());
+    qputenv("QML_DISK_CACHE_ARCHIVE",
+            (tempDir.filePath(QStringLiteral("invalid.qmlcarchive")) + QDir::listSeparator()
+             + appDir + QLatin1String("/app.qmlcarchive")).toLocal8Bit());
+}
+
+void tst_qv4cachearchive::findUnit()
+{
+    const QString appDir = tempDir.filePath(QStringLiteral("app"));
+    for (const char *file : { "/main.qml", "/helper.js", "/Controls/Button.qml" }) {
+        const QV4::CompiledData::Unit *unit
+                = QV4::CacheArchive::findUnit(appDir + QLatin1String(file));
+        QVERIFY2(unit, file);
+        QVERIFY(unit->flags & QV4::CompiledData::Unit::StaticData);
+    }
+
+    QVERIFY(!QV4::CacheArchive::findUnit(appDir + QLatin1String("/other.qml")));
+    QVERIFY(!QV4::CacheArchive::findUnit(appDir + QLatin1String("/Button.qml")));
+    QVERIFY(!QV4::CacheArchive::findUnit(tempDir.filePath(QStringLiteral("main.qml"))));
+}
+
+void tst_qv4cachearchive::loadFromArchive()
+{
+    QQmlEngine engine;
+    QQmlComponent component(
+            &engine, QUrl::fromLocalFile(tempDir.filePath(QStringLiteral("app/main.qml"))));
+    QVERIFY2(component.isReady(), qPrintable(component.errorString()));
+    std::unique_ptr<QObject> object(component.create());
+    QVERIFY(object);
+    QCOMPARE(object->property("answer").toInt(), 42);
+    QCOMPARE(object->property("text").toString(), QStringLiteral("archived"));
+}
+
+void tst_qv4cachearchive::archivedUnitLocation()
+{
+    const QString appDir = tempDir.filePath(QStringLiteral("app"));
+    for (const char *file : { "/lib.mjs", "/dep.mjs", "/thrower.js" })
+        QVERIFY2(QV4::CacheArchive::findUnit(appDir + QLatin1String(file)), file);
+
+    QQmlEngine engine;
+    QQmlComponent component(&engine, QUrl::fromLocalFile(appDir + QLatin1String("/location.qml")));
+    QVERIFY2(component.isReady(), qPrintable(component.errorString()));
+    std::unique_ptr<QObject> object(component.create());
+    QVERIFY(object);
+
+    // The relative import in lib.mjs is resolved against the location of the archived unit.
+    QCOMPARE(object->property("value").toInt(), 7);
+
+    QCOMPARE(object->property("errorFile").toString(),
+             QUrl::fromLocalFile(appDir + QLatin1String("/thrower.js")).toString());
+    QCOMPARE(object->property("errorLine").toInt(), 2);
+}
+
+void tst_qv4cachearchive::rejectInvalidArchive()
+{
+    QString errorString;
+    const QString archive = tempDir.filePath(QStringLiteral("duplicate.qmlcarchive"));
+    QVERIFY(!QV4::CacheArchive::write(
+                    archive, { { QStringLiteral("a.qml"), QByteArray() },
+                               { QStringLiteral("a.qml"), QByteArray() } },
+                    &errorString));
+    QCOMPARE(errorString, QStringLiteral("Duplicate entry for a.qml"));
+    QVERIFY(!QFile::exists(archive));
+}
+
+QTEST_MAIN(tst_qv4cachearchive)
+
+#include "tst_qv4cachearchive.moc"
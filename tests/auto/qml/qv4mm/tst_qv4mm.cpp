@@ -7,6 +7,7 @@
 #include <QQmlComponent>
 
 #include <private/qv4mm_p.h>
+#include <private/qv4executableallocator_p.h>
 #include <private/qv4qobjectwrapper_p.h>
 #include <private/qjsvalue_p.h>
 
@@ -27,6 +28,8 @@ private slots:
     void accessParentOnDestruction();
     void cleanInternalClasses();
     void createObjectsOnDestruction();
+    void executableAllocatorStatistics_data();
+    void executableAllocatorStatistics();
 };
 
 tst_qv4mm::tst_qv4mm()
@@ -206,6 +209,52 @@ void tst_qv4mm::createObjectsOnDestruction()
     QCOMPARE(obj->property("ok").toBool(), true);
 }
 
+void tst_qv4mm::executableAllocatorStatistics_data()
+{
+    QTest::addColumn<int>("options");
+
+    QTest::newRow("default") << int(QV4::ExecutableAllocator::NoOptions);
+    QTest::newRow("huge pages") << int(QV4::ExecutableAllocator::HugePages);
+    QTest::newRow("dual mapping") << int(QV4::ExecutableAllocator::DualMapping);
+    QTest::newRow("huge pages, dual mapping")
+            << int(QV4::ExecutableAllocator::HugePages | QV4::ExecutableAllocator::DualMapping);
+}
+
+void tst_qv4mm::executableAllocatorStatistics()
+{
+    QFETCH(int, options);
+
+    QV4::ExecutableAllocator allocator(
+            nullptr, QV4::ExecutableAllocator::Options(QV4::ExecutableAllocator::Option(options)));
+    QCOMPARE(allocator.statistics().chunkCount, 0);
+    QCOMPARE(allocator.statistics().mappedBytes, size_t(0));
+
+    QV4::ExecutableAllocator::Allocation *first = allocator.allocate(100);
+    QV4::ExecutableAllocator::Allocation *second = allocator.allocate(1000);
+
+    // The second allocation fits into the rest of the first chunk.
+    QV4::ExecutableAllocator::Statistics stats = allocator.statistics();
+    QCOMPARE(stats.chunkCount, 1);
+    QCOMPARE(stats.liveBytes, size_t(first->memorySize() + second->memorySize()));
+    QCOMPARE(stats.liveBytes + stats.wastedBytes, stats.mappedBytes);
+    QVERIFY(stats.liveBytes >= 1100);
+
+    // Whatever we write is visible where the code is executed.
+    memset(second->writableMemoryStart(), 0x5a, second->memorySize());
+    QCOMPARE(*static_cast<const uchar *>(second->memoryStart()), uchar(0x5a));
+
+    allocator.free(first);
+    stats = allocator.statistics();
+    QCOMPARE(stats.liveBytes, size_t(second->memorySize()));
+    QCOMPARE(stats.liveBytes + stats.wastedBytes, stats.mappedBytes);
+
+    allocator.free(second);
+    stats = allocator.statistics();
+    QCOMPARE(stats.chunkCount, 0);
+    QCOMPARE(stats.liveBytes, size_t(0));
+    QCOMPARE(stats.mappedBytes, size_t(0));
+}
+
 QTEST_MAIN(tst_qv4mm)
 
 #include "tst_qv4mm.moc"
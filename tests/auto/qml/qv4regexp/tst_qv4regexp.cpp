@@ -3,6 +3,10 @@
 
 #include <qtest.h>
 #include <QtQml/qjsengine.h>
+#include <QtCore/qthread.h>
+
+#include <memory>
+#include <vector>
 
 class tst_qv4regexp : public QObject
 {
@@ -10,6 +14,9 @@ class tst_qv4regexp : public QObject
 
 private slots:
     void catchJitFail();
+    void invalidPattern();
+    void sharedBetweenEngines();
+    void sharedBetweenThreads();
 };
 
 void tst_qv4regexp::catchJitFail()
@@ -23,6 +30,57 @@ void tst_qv4regexp::catchJitFail()
     QVERIFY(result.toBool());
 }
 
+void tst_qv4regexp::invalidPattern()
+{
+    // Regular expressions are only compiled when they are first used, but syntax errors are
+    // still reported when they are created.
+    for (int i = 0; i < 2; ++i) {
+        QJSEngine engine;
+        QJSValue result = engine.evaluate(QLatin1String("new RegExp('a(b');"));
+        QVERIFY(result.isError());
+        QCOMPARE(result.errorType(), QJSValue::SyntaxError);
+    }
+}
+
+void tst_qv4regexp::sharedBetweenEngines()
+{
+    const QString program = QLatin1String(
+            "var unused = /^[a-z]+@[a-z]+\\.[a-z]{2,}$/;"
+            "var m = /(\\w+)-(\\d+)/.exec('abc-123');"
+            "var b = /(a+)b\\1/.test('aabaa');"
+            "[m.length, m[1], m[2], b, 'x-1'.replace(/(\\w)-(\\d)/g, '$2$1')].join();");
+
+    QScopedPointer<QJSEngine> first(new QJSEngine);
+    QJSEngine second;
+    QCOMPARE(first->evaluate(program).toString(), QLatin1String("3,abc,123,true,1x"));
+    first.reset();
+    QCOMPARE(second.evaluate(program).toString(), QLatin1String("3,abc,123,true,1x"));
+}
+
+void tst_qv4regexp::sharedBetweenThreads()
+{
+    // Back references are not JIT-compiled, so all engines run the same shared byte code.
+    const QString program = QLatin1String(
+            "var n = 0;"
+            "for (var i = 0; i < 1000; ++i)"
+            "    n += /(a+)b\\1/.test('aab' + 'a'.repeat(i % 3)) ? 1 : 0;"
+            "n;");
+
+    std::vector<std::unique_ptr<QThread>> threads;
+    QAtomicInt correct = 0;
+    for (int i = 0; i < 4; ++i) {
+        threads.emplace_back(QThread::create([&]() {
+            QJSEngine engine;
+            if (engine.evaluate(program).toInt() == 666)
+                correct.ref();
+        }));
+        threads.back()->start();
+    }
+    for (const auto &thread : threads)
+        QVERIFY(thread->wait());
+    QCOMPARE(correct.loadRelaxed(), 4);
+}
+
 QTEST_MAIN(tst_qv4regexp)
 
 #include "tst_qv4regexp.moc"
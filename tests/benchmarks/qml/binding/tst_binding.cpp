@@ -7,6 +7,8 @@
 #include <QQmlComponent>
 #include <QFile>
 #include <QDebug>
+#include <private/qqmlbindingscheduler_p.h>
+#include <private/qqmlengine_p.h>
 #include "testtypes.h"
 
 class tst_binding : public QObject
@@ -28,6 +30,8 @@ private slots:
     void basicproperty();
     void creation_data();
     void creation();
+    void diamond_data();
+    void diamond();
 
 private:
     QQmlEngine engine;
@@ -150,5 +154,53 @@ void tst_binding::creation()
     }
 }
 
+void tst_binding::diamond_data()
+{
+    QTest::addColumn<bool>("batched");
+
+    QTest::newRow("immediate") << false;
+    QTest::newRow("batched") << true;
+}
+
+// One property feeds four bindings, which all feed the same two bindings. Evaluated
+// immediately, those two are evaluated once per binding they depend on: 13 evaluations per
+// change. Batched, each binding is evaluated once.
+void tst_binding::diamond()
+{
+    QFETCH(bool, batched);
+
+    QQmlEngine engine;
+    QQmlEnginePrivate *enginePrivate = QQmlEnginePrivate::get(&engine);
+    enginePrivate->setBatchedBindingUpdates(batched);
+
+    QQmlComponent c(&engine, QUrl::fromLocalFile(SRCDIR "/data/diamond.qml"));
+    QScopedPointer<QObject> object(c.create());
+    QVERIFY(object);
+
+    QQmlBindingScheduler *scheduler = enginePrivate->bindingScheduler;
+    QCOMPARE(scheduler != nullptr, batched);
+    if (scheduler)
+        scheduler->flush();
+    const QQmlBindingScheduler::Statistics initial
+            = scheduler ? scheduler->statistics() : QQmlBindingScheduler::Statistics();
+
+    int value = 0;
+    QBENCHMARK {
+        object->setProperty("value", ++value);
+        if (scheduler)
+            scheduler->flush();
+    }
+    QCOMPARE(object->property("result").toInt(), 9 * value + 21);
+
+    if (scheduler) {
+        const QQmlBindingScheduler::Statistics &statistics = scheduler->statistics();
+        const quint64 notifications = statistics.notifications - initial.notifications;
+        const quint64 evaluations = statistics.evaluations - initial.evaluations;
+        QVERIFY(evaluations < notifications);
+        qDebug() << "Per change, binding notifications:" << double(notifications) / value
+                 << "evaluations:" << double(evaluations) / value;
+    }
+}
+
 QTEST_MAIN(tst_binding)
 #include "tst_binding.moc"
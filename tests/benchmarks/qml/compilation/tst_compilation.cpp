@@ -13,6 +13,9 @@
 #include <QFile>
 #include <QDebug>
 #include <QTextStream>
+#include <QScopeGuard>
+#include <QTemporaryDir>
+#include <QThread>
 
 class tst_compilation : public QObject
 {
@@ -29,6 +32,9 @@ private slots:
     void bigimport_data();
     void bigimport();
 
+    void startup_data();
+    void startup();
+
 private:
     QQmlEngine engine;
 };
@@ -161,6 +167,93 @@ void tst_compilation::bigimport()
     }
 }
 
+void tst_compilation::startup_data()
+{
+    QTest::addColumn<int>("workerThreads");
+
+    QTest::newRow("no workers") << 0;
+    for (int threads = 1; threads < QThread::idealThreadCount(); threads *= 2)
+        QTest::addRow("%d workers", threads) << threads;
+    QTest::addRow("%d workers (default)", QThread::idealThreadCount() - 1)
+            << QThread::idealThreadCount() - 1;
+}
+
+// Loads an application made of many QML and JavaScript files from source, with the files read
+// and parsed on the given number of worker threads of the type loader.
+void tst_compilation::startup()
+{
+    QFETCH(int, workerThreads);
+
+    const int groups = 20;
+    const int typesPerGroup = 25;
+
+    QTemporaryDir d;
+    QVERIFY(d.isValid());
+    const auto writeFile = [&](const QString &name, const QByteArray &contents) {
+        QFile f(d.filePath(name));
+        QVERIFY(f.open(QIODevice::WriteOnly));
+        f.write(contents);
+    };
+
+    QByteArray main = "import QtQml\n\nQtObject {\n    property list<QtObject> groups: [\n";
+    for (int group = 0; group < groups; ++group) {
+        QByteArray groupFile = "import QtQml\nimport \"helpers.js\" as Helpers\n\n"
+                               "QtObject {\n    property list<QtObject> types: [\n";
+        for (int type = 0; type < typesPerGroup; ++type) {
+            const QByteArray name = "Type" + QByteArray::number(group) + "_"
+                    + QByteArray::number(type);
+            groupFile += "        " + name + " { base: " + QByteArray::number(type) + " },\n";
+            QByteArray typeFile = "import QtQml\n\nQtObject {\n"
+                                  "    id: root\n"
+                                  "    property int base\n"
+                                  "    property string label: \"" + name + "\"\n";
+            for (int i = 0; i < 20; ++i) {
+                const QByteArray n = QByteArray::number(i);
+                typeFile += "    property int value" + n + ": base * " + n + " + label.length\n"
+                            "    function compute" + n + "(x, y) {\n"
+                            "        let result = [];\n"
+                            "        for (let i = 0; i < x; ++i)\n"
+                            "            result.push({ index: i, value: value" + n + " + y * i });\n"
+                            "        return result.filter(e => e.value % 2 === 0).length;\n"
+                            "    }\n";
+            }
+            typeFile += "}\n";
+            writeFile(QString::fromLatin1(name + ".qml"), typeFile);
+        }
+        groupFile += "    ]\n    property int sum: Helpers.sum(types.length, "
+                + QByteArray::number(group) + ")\n}\n";
+        writeFile(QStringLiteral("Group%1.qml").arg(group), groupFile);
+        main += "        Group" + QByteArray::number(group) + " {},\n";
+    }
+    main += "    ]\n}\n";
+    writeFile(QStringLiteral("main.qml"), main);
+    writeFile(QStringLiteral("helpers.js"),
+              ".pragma library\n\nfunction sum(a, b) {\n    return a + b;\n}\n");
+
+    // Measure reading and parsing the files, not loading them from the disk cache.
+    const QByteArray origDisableDiskCache = qgetenv("QML_DISABLE_DISK_CACHE");
+    const QByteArray origWorkerThreads = qgetenv("QML_TYPE_LOADER_WORKER_THREADS");
+    qputenv("QML_DISABLE_DISK_CACHE", "1");
+    qputenv("QML_TYPE_LOADER_WORKER_THREADS", QByteArray::number(workerThreads));
+    const auto restoreEnvironment = qScopeGuard([&]() {
+        if (origDisableDiskCache.isNull())
+            qunsetenv("QML_DISABLE_DISK_CACHE");
+        else
+            qputenv("QML_DISABLE_DISK_CACHE", origDisableDiskCache);
+        if (origWorkerThreads.isNull())
+            qunsetenv("QML_TYPE_LOADER_WORKER_THREADS");
+        else
+            qputenv("QML_TYPE_LOADER_WORKER_THREADS", origWorkerThreads);
+    });
+
+    const QUrl url = QUrl::fromLocalFile(d.filePath(QStringLiteral("main.qml")));
+    QBENCHMARK {
+        QQmlEngine e;
+        QQmlComponent c(&e, url);
+        QVERIFY2(c.isReady(), qPrintable(c.errorString()));
+    }
+}
+
 QTEST_MAIN(tst_compilation)
 
 #include "tst_compilation.moc"
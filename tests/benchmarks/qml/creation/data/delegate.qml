@@ -0,0 +1,52 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only WITH Qt-GPL-exception-1.0
+
+import QtQuick 2.0
+
+Item {
+    id: root
+
+    property int index: 7
+    property string label: "Item " + index
+    property bool current: index === 0
+    property real progress: index / 100
+
+    width: 240
+    height: current ? 60 : 40
+    opacity: index % 2 ? 1 : 0.8
+
+    onIndexChanged: progress = index / 100
+    onCurrentChanged: if (current) forceActiveFocus()
+
+    Rectangle {
+        anchors.fill: parent
+        color: root.index % 2 ? "white" : "lightgray"
+        border.width: root.current ? 2 : 0
+    }
+
+    Text {
+        x: 10
+        width: parent.width - icon.width - 30
+        anchors.verticalCenter: parent.verticalCenter
+        text: root.label
+        font.bold: root.current
+        elide: Text.ElideRight
+    }
+
+    Rectangle {
+        id: icon
+        anchors.right: parent.right
+        anchors.rightMargin: 10
+        anchors.verticalCenter: parent.verticalCenter
+        width: root.height / 2
+        height: width
+        radius: width / 2
+        color: root.progress > 0.5 ? "green" : "red"
+    }
+
+    MouseArea {
+        anchors.fill: parent
+        onClicked: root.index++
+        onPressAndHold: root.label = "Held"
+    }
+}
@@ -46,6 +46,8 @@ private slots:
     void anchors_creation();
     void anchors_heightChange();
 
+    void delegates_qml();
+
 private:
     QQmlEngine engine;
 };
@@ -419,6 +421,25 @@ void tst_creation::anchors_heightChange()
     delete obj;
 }
 
+// Creates and destroys a batch of objects with bindings and signal handlers, as a view does
+// with its delegates.
+void tst_creation::delegates_qml()
+{
+    QQmlComponent component(&engine, TEST_FILE(QStringLiteral("delegate.qml")));
+    QVERIFY2(component.isReady(), qPrintable(component.errorString()));
+
+    delete component.create();
+
+    QList<QObject *> delegates;
+    delegates.reserve(100);
+    QBENCHMARK {
+        for (int i = 0; i < 100; ++i)
+            delegates.append(component.create());
+        qDeleteAll(delegates);
+        delegates.clear();
+    }
+}
+
 QTEST_MAIN(tst_creation)
 
 #include "tst_creation.moc"
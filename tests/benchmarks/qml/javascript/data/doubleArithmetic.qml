@@ -0,0 +1,27 @@
+// Benchmarks floating point arithmetic and comparisons in a small, frequently called function.
+
+import QtQuick 2.0
+
+QtObject {
+    function mandelbrotIterations(cr, ci) {
+        var zr = 0.0;
+        var zi = 0.0;
+        var iterations = 0;
+        while (iterations < 64 && zr * zr + zi * zi <= 4.0) {
+            var t = zr * zr - zi * zi + cr;
+            zi = 2.0 * zr * zi + ci;
+            zr = t;
+            ++iterations;
+        }
+        return iterations;
+    }
+
+    function runtest() {
+        var total = 0;
+        for (var y = 0; y < 200; ++y) {
+            for (var x = 0; x < 300; ++x)
+                total += mandelbrotIterations(x / 100 - 2.0, y / 100 - 1.0);
+        }
+        return total;
+    }
+}
@@ -0,0 +1,22 @@
+// Benchmarks integer arithmetic and comparisons in a small, frequently called function.
+
+import QtQuick 2.0
+
+QtObject {
+    function collatzSteps(n) {
+        var steps = 0;
+        while (n > 1) {
+            var half = n >> 1;
+            n = (n - half * 2 === 0) ? half : n * 3 + 1;
+            ++steps;
+        }
+        return steps;
+    }
+
+    function runtest() {
+        var total = 0;
+        for (var ii = 1; ii < 100000; ++ii)
+            total += collatzSteps(ii);
+        return total;
+    }
+}
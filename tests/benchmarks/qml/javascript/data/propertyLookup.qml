@@ -0,0 +1,25 @@
+// Benchmarks reading the properties of plain JavaScript objects in a numeric loop.
+
+import QtQuick 2.0
+
+QtObject {
+    function length(points) {
+        var total = 0.0;
+        for (var i = 1; i < points.length; ++i) {
+            var dx = points[i].x - points[i - 1].x;
+            var dy = points[i].y - points[i - 1].y;
+            total += dx * dx + dy * dy;
+        }
+        return total;
+    }
+
+    function runtest() {
+        var points = [];
+        for (var i = 0; i < 1000; ++i)
+            points.push({ x: i * 0.5, y: i % 7 });
+        var total = 0.0;
+        for (var j = 0; j < 100; ++j)
+            total += length(points);
+        return total;
+    }
+}
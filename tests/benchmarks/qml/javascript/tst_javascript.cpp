@@ -21,27 +21,45 @@ public:
 private slots:
     void run_data();
     void run();
-
-private:
-    QQmlEngine engine;
 };
 
+// The execution tiers are chosen through the environment, which the engine reads on
+// construction. Every row therefore runs in its own engine.
+static void selectTier(const QString &tier)
+{
+    qunsetenv("QV4_FORCE_INTERPRETER");
+    qunsetenv("QV4_JIT_OPTIMIZE_THRESHOLD");
+    qputenv("QV4_JIT_CALL_THRESHOLD", "0");
+
+    if (tier == u"interpreter"_s)
+        qputenv("QV4_FORCE_INTERPRETER", "1");
+    else if (tier == u"optimizing"_s)
+        qputenv("QV4_JIT_OPTIMIZE_THRESHOLD", "0");
+}
+
 void tst_javascript::run_data()
 {
     QTest::addColumn<QString>("file");
+    QTest::addColumn<QString>("tier");
     QDirIterator listing(SRCDIR "/data", QStringList{u"*.qml"_s},
                          QDir::Files | QDir::NoDotAndDotDot);
     while (listing.hasNext()) {
         auto info = listing.nextFileInfo();
         const QString base = info.baseName();
-        if (!base.isEmpty() && base.at(0).isLower())
-            QTest::newRow(qPrintable(base)) << info.filePath();
+        if (base.isEmpty() || !base.at(0).isLower())
+            continue;
+        for (const QString &tier : { u"interpreter"_s, u"baseline"_s, u"optimizing"_s })
+            QTest::addRow("%s:%s", qPrintable(base), qPrintable(tier)) << info.filePath() << tier;
     }
 }
 
 void tst_javascript::run()
 {
     QFETCH(QString, file);
+    QFETCH(QString, tier);
+
+    selectTier(tier);
+    QQmlEngine engine;
     QQmlComponent c(&engine, file);
 
     if (c.isError())
@@ -0,0 +1,185 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only WITH Qt-GPL-exception-1.0
+
+#include <qtest.h>
+#include <QtQml/qjsvalue.h>
+#include <QtQml/qjsengine.h>
+
+// Measures a fixed number of Map/Set operations on collections of growing
+// size. With a hashed ESTable the time per iteration should stay (roughly)
+// flat, regardless of the number of entries in the collection.
+
+class tst_ESTable : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void mapGet_data();
+    void mapGet();
+    void mapSet_data();
+    void mapSet();
+    void mapDelete_data();
+    void mapDelete();
+    void setHas_data();
+    void setHas();
+    void stringKeys_data();
+    void stringKeys();
+
+private:
+    void addSizes();
+    QJSValue populate(QJSEngine *engine, const QString &kind, int size);
+};
+
+static const int operationCount = 10000;
+
+void tst_ESTable::addSizes()
+{
+    QTest::addColumn<int>("size");
+    QTest::newRow("1k") << 1000;
+    QTest::newRow("10k") << 10000;
+    QTest::newRow("100k") << 100000;
+    QTest::newRow("1M") << 1000000;
+}
+
+QJSValue tst_ESTable::populate(QJSEngine *engine, const QString &kind, int size)
+{
+    QJSValue fill = engine->evaluate(QStringLiteral(
+            "(function(kind, size) {"
+            "    var c = kind === 'Map' ? new Map : new Set;"
+            "    for (var i = 0; i < size; ++i) {"
+            "        if (kind === 'Map')"
+            "            c.set(i, i);"
+            "        else"
+            "            c.add(i);"
+            "    }"
+            "    return c;"
+            "})"));
+    return fill.call(QJSValueList() << kind << size);
+}
+
+void tst_ESTable::mapGet_data()
+{
+    addSizes();
+}
+
+void tst_ESTable::mapGet()
+{
+    QFETCH(int, size);
+    QJSEngine engine;
+    QJSValue map = populate(&engine, QStringLiteral("Map"), size);
+    QJSValue lookup = engine.evaluate(QStringLiteral(
+            "(function(m, size, count) {"
+            "    var sum = 0;"
+            "    for (var i = 0; i < count; ++i)"
+            "        sum += m.get((i * 7919) % size);"
+            "    return sum;"
+            "})"));
+    QJSValueList args = QJSValueList() << map << size << operationCount;
+    QBENCHMARK {
+        lookup.call(args);
+    }
+}
+
+void tst_ESTable::mapSet_data()
+{
+    addSizes();
+}
+
+void tst_ESTable::mapSet()
+{
+    QFETCH(int, size);
+    QJSEngine engine;
+    QJSValue map = populate(&engine, QStringLiteral("Map"), size);
+    QJSValue update = engine.evaluate(QStringLiteral(
+            "(function(m, size, count) {"
+            "    for (var i = 0; i < count; ++i)"
+            "        m.set((i * 7919) % size, i);"
+            "})"));
+    QJSValueList args = QJSValueList() << map << size << operationCount;
+    QBENCHMARK {
+        update.call(args);
+    }
+}
+
+void tst_ESTable::mapDelete_data()
+{
+    addSizes();
+}
+
+void tst_ESTable::mapDelete()
+{
+    QFETCH(int, size);
+    QJSEngine engine;
+    QJSValue map = populate(&engine, QStringLiteral("Map"), size);
+    // Deletes and re-adds the same keys, so that the map keeps its size.
+    QJSValue churn = engine.evaluate(QStringLiteral(
+            "(function(m, size, count) {"
+            "    for (var i = 0; i < count; ++i) {"
+            "        var k = (i * 7919) % size;"
+            "        m.delete(k);"
+            "        m.set(k, i);"
+            "    }"
+            "})"));
+    QJSValueList args = QJSValueList() << map << size << operationCount;
+    QBENCHMARK {
+        churn.call(args);
+    }
+}
+
+void tst_ESTable::setHas_data()
+{
+    addSizes();
+}
+
+void tst_ESTable::setHas()
+{
+    QFETCH(int, size);
+    QJSEngine engine;
+    QJSValue set = populate(&engine, QStringLiteral("Set"), size);
+    QJSValue lookup = engine.evaluate(QStringLiteral(
+            "(function(s, size, count) {"
+            "    var found = 0;"
+            "    for (var i = 0; i < count; ++i) {"
+            "        if (s.has(i * 2))"
+            "            ++found;"
+            "    }"
+            "    return found;"
+            "})"));
+    QJSValueList args = QJSValueList() << set << size << operationCount;
+    QBENCHMARK {
+        lookup.call(args);
+    }
+}
+
+void tst_ESTable::stringKeys_data()
+{
+    addSizes();
+}
+
+void tst_ESTable::stringKeys()
+{
+    QFETCH(int, size);
+    QJSEngine engine;
+    QJSValue map = engine.evaluate(QStringLiteral(
+            "(function(size) {"
+            "    var m = new Map;"
+            "    for (var i = 0; i < size; ++i)"
+            "        m.set('key' + i, i);"
+            "    return m;"
+            "})")).call(QJSValueList() << size);
+    QJSValue lookup = engine.evaluate(QStringLiteral(
+            "(function(m, size, count) {"
+            "    var sum = 0;"
+            "    for (var i = 0; i < count; ++i)"
+            "        sum += m.get('key' + ((i * 7919) % size));"
+            "    return sum;"
+            "})"));
+    QJSValueList args = QJSValueList() << map << size << operationCount;
+    QBENCHMARK {
+        lookup.call(args);
+    }
+}
+
+QTEST_MAIN(tst_ESTable)
+
+#include "tst_estable.moc"
@@ -0,0 +1,176 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only WITH Qt-GPL-exception-1.0
+
+#include <qtest.h>
+#include <QtCore/qelapsedtimer.h>
+#include <QtCore/qjsondocument.h>
+#include <QtQml/qjsvalue.h>
+#include <QtQml/qjsengine.h>
+
+// Measures the throughput of JSON.parse on documents of a few megabytes, as they are
+// typically received from a web service. The result is reported in bytes of input per
+// second. QJsonDocument parsing the same document as UTF-8 is given for comparison.
+// To compare against an earlier version of the parser, run the benchmark on both versions.
+
+class tst_JsonParse : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void jsonParse_data();
+    void jsonParse();
+    void qJsonDocument_data();
+    void qJsonDocument();
+
+private:
+    void addDocuments();
+
+    QHash<QString, QString> documents;
+};
+
+static const int documentSize = 5 * 1024 * 1024;
+static const int iterations = 5;
+
+// An array of records that all have the same keys.
+static QString records()
+{
+    QString json = QStringLiteral("[");
+    for (int i = 0; json.size() < documentSize; ++i) {
+        if (i)
+            json += u',';
+        json += QStringLiteral(
+                    "{\"id\":%1,\"name\":\"Item number %1\",\"price\":%2,\"available\":%3,"
+                    "\"tags\":[\"red\",\"green\",\"blue\"],\"owner\":null}")
+                .arg(i).arg(i * 0.25).arg(i % 2 ? QStringLiteral("true") : QStringLiteral("false"));
+    }
+    json += u']';
+    return json;
+}
+
+// The same records, with indentation and line breaks.
+static QString indentedRecords()
+{
+    QString json = QStringLiteral("[\n");
+    for (int i = 0; json.size() < documentSize; ++i) {
+        if (i)
+            json += QStringLiteral(",\n");
+        json += QStringLiteral(
+                    "    {\n"
+                    "        \"id\": %1,\n"
+                    "        \"name\": \"Item number %1\",\n"
+                    "        \"price\": %2,\n"
+                    "        \"available\": %3,\n"
+                    "        \"tags\": [\n"
+                    "            \"red\",\n"
+                    "            \"green\",\n"
+                    "            \"blue\"\n"
+                    "        ],\n"
+                    "        \"owner\": null\n"
+                    "    }")
+                .arg(i).arg(i * 0.25).arg(i % 2 ? QStringLiteral("true") : QStringLiteral("false"));
+    }
+    json += QStringLiteral("\n]\n");
+    return json;
+}
+
+// Long strings, with an occasional escape sequence.
+static QString longStrings()
+{
+    const QString text = QStringLiteral(
+                "Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod tempor "
+                "incididunt ut labore et dolore magna aliqua. Ut enim ad minim veniam, quis "
+                "nostrud exercitation ullamco laboris nisi ut aliquip ex ea commodo consequat.");
+    QString json = QStringLiteral("[");
+    for (int i = 0; json.size() < documentSize; ++i) {
+        if (i)
+            json += u',';
+        json += u'"' + text + QStringLiteral("\\n\\u00e9\\\"") + text + u'"';
+    }
+    json += u']';
+    return json;
+}
+
+// Mostly numbers, small and large integers as well as fractions.
+static QString numbers()
+{
+    QString json = QStringLiteral("[");
+    for (int i = 0; json.size() < documentSize; ++i) {
+        if (i)
+            json += u',';
+        json += QStringLiteral("%1,%2,%3e-3").arg(i).arg(i * 1234567).arg(i * 3.75);
+    }
+    json += u']';
+    return json;
+}
+
+void tst_JsonParse::initTestCase()
+{
+    documents.insert(QStringLiteral("records"), records());
+    documents.insert(QStringLiteral("indented records"), indentedRecords());
+    documents.insert(QStringLiteral("long strings"), longStrings());
+    documents.insert(QStringLiteral("numbers"), numbers());
+}
+
+void tst_JsonParse::addDocuments()
+{
+    QTest::addColumn<QString>("document");
+    QTest::newRow("records") << QStringLiteral("records");
+    QTest::newRow("indented records") << QStringLiteral("indented records");
+    QTest::newRow("long strings") << QStringLiteral("long strings");
+    QTest::newRow("numbers") << QStringLiteral("numbers");
+}
+
+void tst_JsonParse::jsonParse_data()
+{
+    addDocuments();
+}
+
+void tst_JsonParse::jsonParse()
+{
+    QFETCH(QString, document);
+    const QString json = documents.value(document);
+
+    QJSEngine engine;
+    QJSValue parse = engine.globalObject().property(QStringLiteral("JSON"))
+            .property(QStringLiteral("parse"));
+    QJSValueList args = QJSValueList() << json;
+
+    QVERIFY(parse.call(args).isArray());
+
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < iterations; ++i)
+        parse.call(args);
+    const qint64 elapsed = timer.nsecsElapsed();
+
+    QTest::setBenchmarkResult(qreal(json.size()) * sizeof(QChar) * iterations * 1e9 / elapsed,
+                              QTest::BytesPerSecond);
+}
+
+void tst_JsonParse::qJsonDocument_data()
+{
+    addDocuments();
+}
+
+void tst_JsonParse::qJsonDocument()
+{
+    QFETCH(QString, document);
+    const QString json = documents.value(document);
+    const QByteArray utf8 = json.toUtf8();
+
+    QVERIFY(QJsonDocument::fromJson(utf8).isArray());
+
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < iterations; ++i)
+        QJsonDocument::fromJson(utf8);
+    const qint64 elapsed = timer.nsecsElapsed();
+
+    QTest::setBenchmarkResult(qreal(utf8.size()) * iterations * 1e9 / elapsed,
+                              QTest::BytesPerSecond);
+}
+
+QTEST_MAIN(tst_JsonParse)
+
+#include "tst_jsonparse.moc"
@@ -0,0 +1,113 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only WITH Qt-GPL-exception-1.0
+
+#include <qtest.h>
+#include <QtCore/qcoreapplication.h>
+#include <QtQml/qjsvalue.h>
+#include <QtQml/qjsengine.h>
+
+// Resolves long chains of promises. Every step in a chain is a separate job, so this mostly
+// measures how quickly the jobs are queued and run once control returns to the event loop.
+
+class tst_Promises : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void thenChain_data();
+    void thenChain();
+    void nestedChain_data();
+    void nestedChain();
+    void promiseAll_data();
+    void promiseAll();
+
+private:
+    void addLengths();
+    void run(const QString &function, int length);
+};
+
+void tst_Promises::addLengths()
+{
+    QTest::addColumn<int>("length");
+    QTest::newRow("100") << 100;
+    QTest::newRow("10k") << 10000;
+    QTest::newRow("100k") << 100000;
+}
+
+void tst_Promises::run(const QString &function, int length)
+{
+    QJSEngine engine;
+    QJSValue start = engine.evaluate(function);
+    QVERIFY(start.isCallable());
+    engine.evaluate(QStringLiteral("var done = false"));
+    QJSValue isDone = engine.evaluate(QStringLiteral("(function() { return done; })"));
+
+    QBENCHMARK {
+        engine.evaluate(QStringLiteral("var done = false"));
+        start.call(QJSValueList() << length);
+        while (!isDone.call().toBool())
+            QCoreApplication::sendPostedEvents();
+    }
+}
+
+void tst_Promises::thenChain_data()
+{
+    addLengths();
+}
+
+void tst_Promises::thenChain()
+{
+    QFETCH(int, length);
+    run(QStringLiteral(
+            "(function(length) {"
+            "    var p = Promise.resolve(0);"
+            "    for (var i = 0; i < length; ++i)"
+            "        p = p.then(function(v) { return v + 1; });"
+            "    p.then(function(v) { done = (v === length); });"
+            "})"), length);
+}
+
+void tst_Promises::nestedChain_data()
+{
+    addLengths();
+}
+
+void tst_Promises::nestedChain()
+{
+    QFETCH(int, length);
+    // Each reaction returns a new promise, which the outer promise then has to adopt.
+    run(QStringLiteral(
+            "(function(length) {"
+            "    function step(v) {"
+            "        if (v === length) {"
+            "            done = true;"
+            "            return v;"
+            "        }"
+            "        return new Promise(function(resolve) { resolve(v + 1); }).then(step);"
+            "    }"
+            "    Promise.resolve(0).then(step);"
+            "})"), length);
+}
+
+void tst_Promises::promiseAll_data()
+{
+    addLengths();
+}
+
+void tst_Promises::promiseAll()
+{
+    QFETCH(int, length);
+    run(QStringLiteral(
+            "(function(length) {"
+            "    var promises = [];"
+            "    for (var i = 0; i < length; ++i)"
+            "        promises.push(new Promise(function(resolve) { resolve(i); }));"
+            "    Promise.all(promises).then(function(values) {"
+            "        done = (values.length === length);"
+            "    });"
+            "})"), length);
+}
+
+QTEST_MAIN(tst_Promises)
+
+#include "tst_promises.moc"
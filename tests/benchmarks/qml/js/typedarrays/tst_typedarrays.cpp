@@ -0,0 +1,83 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only WITH Qt-GPL-exception-1.0
+
+#include <qtest.h>
+#include <QtCore/qelapsedtimer.h>
+#include <QtQml/qjsvalue.h>
+#include <QtQml/qjsengine.h>
+
+// Measures the throughput of the bulk operations of typed arrays on buffers of a few million
+// elements, as they are used to move sensor data around. The result is reported in bytes
+// processed per second.
+
+class tst_TypedArrays : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void operation_data();
+    void operation();
+};
+
+static const int elements = 4 * 1024 * 1024;
+static const int iterations = 10;
+
+void tst_TypedArrays::operation_data()
+{
+    QTest::addColumn<QString>("operation");
+    QTest::addColumn<int>("bytesPerElement");
+
+    QTest::newRow("fill Float32Array") << "f32.fill(1.5)" << 4;
+    QTest::newRow("fill Int16Array") << "i16.fill(-3)" << 2;
+    QTest::newRow("set Float32Array from Float32Array") << "f32.set(f32b)" << 4;
+    QTest::newRow("set Int16Array from Int16Array") << "i16.set(i16b)" << 2;
+    QTest::newRow("set Int16Array from Float32Array") << "i16.set(f32)" << 2;
+    QTest::newRow("set Float32Array from Int16Array") << "f32.set(i16)" << 4;
+    QTest::newRow("set Int32Array from Float64Array") << "i32.set(f64)" << 4;
+    QTest::newRow("set Float64Array from Int32Array") << "f64.set(i32)" << 8;
+    QTest::newRow("new Int16Array from Float32Array") << "new Int16Array(f32)" << 2;
+    QTest::newRow("new Float32Array from Int16Array") << "new Float32Array(i16)" << 4;
+    QTest::newRow("slice Float32Array") << "f32.slice(0)" << 4;
+    QTest::newRow("indexOf Int16Array") << "i16.indexOf(12345)" << 2;
+    QTest::newRow("indexOf Float32Array") << "f32.indexOf(0.25)" << 4;
+    QTest::newRow("reverse Int16Array") << "i16.reverse()" << 2;
+    QTest::newRow("reverse Float64Array") << "f64.reverse()" << 8;
+}
+
+void tst_TypedArrays::operation()
+{
+    QFETCH(QString, operation);
+    QFETCH(int, bytesPerElement);
+
+    QJSEngine engine;
+    QJSValue setup = engine.evaluate(QStringLiteral(
+            "var f32 = new Float32Array(%1);"
+            "var f32b = new Float32Array(%1);"
+            "var f64 = new Float64Array(%1);"
+            "var i16 = new Int16Array(%1);"
+            "var i16b = new Int16Array(%1);"
+            "var i32 = new Int32Array(%1);"
+            "for (var i = 0; i < %1; ++i) {"
+            "    f32[i] = f32b[i] = f64[i] = (i % 65536) - 32768.5;"
+            "    i16[i] = i16b[i] = i32[i] = i;"
+            "}").arg(elements));
+    QVERIFY2(!setup.isError(), qPrintable(setup.toString()));
+
+    QJSValue function = engine.evaluate(QStringLiteral("(function() { return %1; })").arg(operation));
+    QVERIFY(function.isCallable());
+    QJSValue result = function.call();
+    QVERIFY2(!result.isError(), qPrintable(result.toString()));
+
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < iterations; ++i)
+        function.call();
+    const qint64 elapsed = timer.nsecsElapsed();
+
+    QTest::setBenchmarkResult(qreal(elements) * bytesPerElement * iterations * 1e9 / elapsed,
+                              QTest::BytesPerSecond);
+}
+
+QTEST_MAIN(tst_TypedArrays)
+
+#include "tst_typedarrays.moc"
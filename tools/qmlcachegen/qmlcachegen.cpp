@@ -4,6 +4,7 @@
 #include <QCoreApplication>
 #include <QStringList>
 #include <QCommandLineParser>
+#include <QDir>
 #include <QFile>
 #include <QFileInfo>
 #include <QDateTime>
@@ -21,6 +22,7 @@
 #include <private/qqmljsloadergenerator_p.h>
 #include <private/qqmljscompiler_p.h>
 #include <private/qresourcerelocater_p.h>
+#include <private/qv4cachearchive_p.h>
 
 #include <algorithm>
 
@@ -53,6 +55,69 @@ static bool argumentsFromCommandLineAndFile(QStringList& allArguments, const QSt
     return true;
 }
 
+static int generateCacheArchive(const QStringList &sources, const QString &archiveFileName)
+{
+    const QDir archiveDirectory = QFileInfo(archiveFileName).absoluteDir();
+    QList<QV4::CacheArchive::Entry> entries;
+    entries.reserve(sources.size());
+
+    for (const QString &source : sources) {
+        const QString sourcePath = QFileInfo(source).absoluteFilePath();
+        const QString relativePath = archiveDirectory.relativeFilePath(sourcePath);
+        if (relativePath.startsWith(QLatin1String("../")) || QDir::isAbsolutePath(relativePath)) {
+            fprintf(stderr, "%s is not in the directory of the cache archive or below\n",
+                    qPrintable(source));
+            return EXIT_FAILURE;
+        }
+
+        QByteArray unitData;
+        const QQmlJSSaveFunction saveFunction = [&unitData](
+                const QV4::CompiledData::SaveableUnitPointer &unit,
+                const QQmlJSAotFunctionMap &aotFunctions, QString *errorString) {
+            Q_UNUSED(aotFunctions);
+            Q_UNUSED(errorString);
+            return unit.saveToDisk<char>([&unitData](const char *data, quint32 size) {
+                unitData = QByteArray(data, size);
+                return true;
+            });
+        };
+
+        QQmlJSCompileError error;
+        if (source.endsWith(QLatin1String(".qml"))) {
+            if (!qCompileQmlFile(sourcePath, saveFunction, nullptr, &error,
+                                 /* storeSourceLocation */ false)) {
+                error.augment(QStringLiteral("Error compiling qml file: ")).print();
+                return EXIT_FAILURE;
+            }
+
+            // Make the unit relocatable, like the ones of JavaScript files. The type loader sets
+            // the location when restoring the IR from it.
+            auto *unit = reinterpret_cast<QV4::CompiledData::Unit *>(unitData.data());
+            unit->sourceFileIndex = 0;
+            unit->finalUrlIndex = 0;
+        } else if (source.endsWith(QLatin1String(".js")) || source.endsWith(QLatin1String(".mjs"))) {
+            if (!qCompileJSFile(sourcePath, sourcePath, saveFunction, &error)) {
+                error.augment(QLatin1String("Error compiling js file: ")).print();
+                return EXIT_FAILURE;
+            }
+        } else {
+            fprintf(stderr, "Ignoring %s input file as it is not QML source code\n",
+                    qPrintable(source));
+            continue;
+        }
+
+        entries.append({ relativePath, unitData });
+    }
+
+    QString errorString;
+    if (!QV4::CacheArchive::write(archiveFileName, entries, &errorString)) {
+        fprintf(stderr, "Error writing cache archive %s: %s\n", qPrintable(archiveFileName),
+                qPrintable(errorString));
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
+
 int main(int argc, char **argv)
 {
     // Produce reliably the same output for the same input by disabling QHash's random seeding.
@@ -98,6 +163,13 @@ int main(int argc, char **argv)
                 QCoreApplication::translate(
                     "main", "Generate only byte code for bindings and functions, no C++ code"));
     parser.addOption(onlyBytecode);
+    QCommandLineOption cacheArchiveOption(
+                QStringLiteral("cache-archive"),
+                QCoreApplication::translate(
+                    "main", "Compile all given QML and JavaScript files into a single cache "
+                            "archive, to be listed in QML_DISK_CACHE_ARCHIVE. The files have "
+                            "to be in the directory of the archive or below."));
+    parser.addOption(cacheArchiveOption);
 
     QCommandLineOption outputFileOption(QStringLiteral("o"), QCoreApplication::translate("main", "Output file name"), QCoreApplication::translate("main", "file name"));
     parser.addOption(outputFileOption);
@@ -137,6 +209,12 @@ int main(int argc, char **argv)
     const QStringList sources = parser.positionalArguments();
     if (sources.isEmpty()){
         parser.showHelp();
+    } else if (parser.isSet(cacheArchiveOption)) {
+        if (outputFileName.isEmpty()) {
+            fprintf(stderr, "The cache archive needs an output file name\n");
+            return EXIT_FAILURE;
+        }
+        return generateCacheArchive(sources, outputFileName);
     } else if (sources.size() > 1 && (target != GenerateLoader && target != GenerateLoaderStandAlone)) {
         fprintf(stderr, "%s\n", qPrintable(QStringLiteral("Too many input files specified: '") + sources.join(QStringLiteral("' '")) + QLatin1Char('\'')));
         return EXIT_FAILURE;
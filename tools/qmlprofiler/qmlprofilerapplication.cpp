@@ -59,6 +59,7 @@ QmlProfilerApplication::QmlProfilerApplication(int &argc, char **argv) :
     m_verbose(false),
     m_recording(true),
     m_interactive(false),
+    m_allocationSampleInterval(0),
     m_connectionAttempts(0)
 {
     m_connection.reset(new QQmlDebugConnection);
@@ -167,6 +168,15 @@ void QmlProfilerApplication::parseArguments()
                                       "does so in this case.") + QChar::Space + tr(commandTextC));
     parser.addOption(interactive);
 
+    QCommandLineOption allocationSampleInterval(
+                QLatin1String("allocation-sample-interval"),
+                tr("Record the JavaScript function and call stack of roughly one allocation of the "
+                   "JavaScript heap per this many bytes allocated. The samples are recorded as "
+                   "part of the \"memory\" feature. Only available when starting the "
+                   "application."),
+                QLatin1String("bytes"));
+    parser.addOption(allocationSampleInterval);
+
     QCommandLineOption verbose(QStringList() << QLatin1String("verbose"),
                                tr("Print debugging output."));
     parser.addOption(verbose);
@@ -207,6 +217,16 @@ void QmlProfilerApplication::parseArguments()
     m_recording = (parser.value(record) == QLatin1String("on"));
     m_interactive = parser.isSet(interactive);
 
+    if (parser.isSet(allocationSampleInterval)) {
+        bool isNumber;
+        m_allocationSampleInterval = parser.value(allocationSampleInterval).toInt(&isNumber);
+        if (!isNumber || m_allocationSampleInterval <= 0) {
+            logError(tr("'%1' is not a valid allocation sample interval.")
+                     .arg(parser.value(allocationSampleInterval)));
+            parser.showHelp(1);
+        }
+    }
+
     quint64 features = std::numeric_limits<quint64>::max();
     if (parser.isSet(include)) {
         if (parser.isSet(exclude)) {
@@ -446,6 +466,13 @@ void QmlProfilerApplication::run()
                      .arg(m_socketFile.isEmpty() ? QString::number(m_port) : m_socketFile);
         arguments << m_arguments;
 
+        if (m_allocationSampleInterval > 0) {
+            QProcessEnvironment environment = QProcessEnvironment::systemEnvironment();
+            environment.insert(QLatin1String("QV4_PROFILE_ALLOCATION_SAMPLE_INTERVAL"),
+                               QString::number(m_allocationSampleInterval));
+            m_process->setProcessEnvironment(environment);
+        }
+
         m_process->setProcessChannelMode(QProcess::MergedChannels);
         connect(m_process, &QIODevice::readyRead, this, &QmlProfilerApplication::processHasOutput);
         connect(m_process, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
@@ -81,6 +81,7 @@ private:
     bool m_verbose;
     bool m_recording;
     bool m_interactive;
+    int m_allocationSampleInterval;
 
     QScopedPointer<QQmlDebugConnection> m_connection;
     QScopedPointer<QmlProfilerClient> m_qmlProfilerClient;
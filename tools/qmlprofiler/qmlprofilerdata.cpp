@@ -135,7 +135,10 @@ void QmlProfilerData::addEventType(const QQmlProfilerEventType &type)
 
     QString details;
     // generate details string
-    if (!type.data().isEmpty()) {
+    if (type.message() == MemoryAllocation) {
+        // The call stack of allocation samples, one function per line.
+        details = type.data();
+    } else if (!type.data().isEmpty()) {
         details = type.data().simplified();
         QRegularExpression rewrite(QStringLiteral("^\\(function \\$(\\w+)\\(\\) \\{ (return |)(.+) \\}\\)$"));
         QRegularExpressionMatch match = rewrite.match(details);